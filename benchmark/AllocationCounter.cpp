@@ -0,0 +1,81 @@
+/**
+    \file AllocationCounter.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Replaces the global operator new to count heap allocations, linked into every benchmark.
+**/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "BenchmarkUtils.h"
+
+namespace
+{
+std::atomic<std::size_t> allocations {0};
+std::atomic<std::size_t> allocatedBytes {0};
+std::atomic<std::size_t> liveBytes {0};
+// Every allocation starts with its size, so freed bytes can be subtracted
+constexpr std::size_t headerSize = alignof(std::max_align_t);
+} // namespace
+
+namespace bench
+{
+AllocationCount countAllocations()
+{
+    return {allocations.load(), allocatedBytes.load(), liveBytes.load()};
+}
+
+void printAllocations(const std::string& name, AllocationCount before, AllocationCount after, int iterations)
+{
+    std::cout << name << ": " << static_cast<double>(after.count - before.count) / iterations << " allocations, "
+              << static_cast<double>(after.bytes - before.bytes) / iterations << " bytes per iteration\n";
+}
+} // namespace bench
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    allocatedBytes += size;
+    if (char* p = static_cast<char*>(std::malloc(size + headerSize)))
+    {
+        liveBytes += size;
+        *reinterpret_cast<std::size_t*>(p) = size;
+        return p + headerSize;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p != nullptr)
+    {
+        char* start = static_cast<char*>(p) - headerSize;
+        liveBytes -= *reinterpret_cast<std::size_t*>(start);
+        std::free(start);
+    }
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    operator delete(p);
+}
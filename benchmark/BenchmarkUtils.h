@@ -0,0 +1,93 @@
+/**
+    \file BenchmarkUtils.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef _BENCHMARK_UTILS_H
+#define _BENCHMARK_UTILS_H
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include <hueplusplus/BaseHttpHandler.h>
+#include <hueplusplus/LibConfig.h>
+
+namespace bench
+{
+//! \brief Config without any delays between requests
+class BenchmarkConfig : public hueplusplus::Config
+{
+public:
+    BenchmarkConfig()
+    {
+        preAlertDelay = postAlertDelay = upnpTimeout = bridgeRequestDelay = requestUsernameDelay
+            = requestUsernameAttemptInterval = std::chrono::seconds(0);
+    }
+};
+
+//! \brief Http handler which answers every request with a fixed body, without any network access
+class FixedResponseHandler : public hueplusplus::BaseHttpHandler
+{
+public:
+    explicit FixedResponseHandler(const std::string& body) : response("HTTP/1.0 200 OK\r\n\r\n" + body) { }
+
+    std::string send(const std::string& msg, const std::string& adr, int port = 80) const override { return response; }
+    std::vector<std::string> sendMulticast(const std::string& msg, const std::string& adr, int port,
+        std::chrono::steady_clock::duration timeout) const override
+    {
+        return {};
+    }
+
+private:
+    std::string response;
+};
+
+//! \brief Number and total size of heap allocations
+struct AllocationCount
+{
+    std::size_t count;
+    std::size_t bytes;
+    //! \brief Size of the allocations which are not freed yet
+    std::size_t liveBytes;
+};
+
+//! \brief Get number of allocations since program start, counted by the replaced operator new
+AllocationCount countAllocations();
+
+//! \brief Prints the average allocations per iteration between two counts
+void printAllocations(const std::string& name, AllocationCount before, AllocationCount after, int iterations);
+
+//! \brief Runs fun for the given number of iterations and prints the average time per iteration
+template <typename Fun>
+void measure(const std::string& name, int iterations, Fun fun)
+{
+    using namespace std::chrono;
+    auto start = steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        fun();
+    }
+    auto total = duration_cast<nanoseconds>(steady_clock::now() - start);
+    std::cout << name << ": " << total.count() / iterations << " ns/iteration\n";
+}
+} // namespace bench
+
+#endif
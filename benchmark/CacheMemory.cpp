@@ -0,0 +1,89 @@
+/**
+    \file CacheMemory.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Measures the heap memory per light which is used by the cached state of a bridge with many lights.
+    Compares the plain json tree to the compact storage of APICache, where every light is stored as MessagePack.
+**/
+
+#include <iostream>
+
+#include <hueplusplus/APICache.h>
+
+#include "BenchmarkUtils.h"
+
+namespace
+{
+nlohmann::json makeBridgeState(int numLights)
+{
+    nlohmann::json lights = nlohmann::json::object();
+    for (int i = 1; i <= numLights; ++i)
+    {
+        lights[std::to_string(i)] = {{"state",
+                                         {{"on", true}, {"bri", 254}, {"hue", 8418}, {"sat", 140}, {"effect", "none"},
+                                             {"xy", {0.4573, 0.41}}, {"ct", 366}, {"alert", "none"},
+                                             {"colormode", "ct"}, {"mode", "homeautomation"}, {"reachable", true}}},
+            {"type", "Extended color light"}, {"name", "Hue color lamp " + std::to_string(i)},
+            {"modelid", "LCT016"}, {"manufacturername", "Signify Netherlands B.V."},
+            {"productname", "Hue color lamp"}, {"uniqueid", "00:17:88:01:04:0b:8e:1a-0b"},
+            {"swversion", "1.50.2_r30933"}};
+    }
+    return {{"lights", lights}, {"groups", nlohmann::json::object()}, {"config", {{"name", "Philips hue"}}}};
+}
+
+void printBytesPerLight(const std::string& name, bench::AllocationCount before, int numLights)
+{
+    const bench::AllocationCount after = bench::countAllocations();
+    std::cout << name << ": " << (after.liveBytes - before.liveBytes) / numLights << " bytes/light\n";
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace hueplusplus;
+    constexpr int numLights = 200;
+    hueplusplus::Config::instance() = bench::BenchmarkConfig();
+
+    const std::string body = makeBridgeState(numLights).dump();
+    auto handler = std::make_shared<bench::FixedResponseHandler>(body);
+    HueCommandAPI commands("192.168.2.116", 80, "username", handler);
+
+    for (int depth : {0, 2})
+    {
+        const std::string name = depth == 0 ? "json tree" : "compact";
+        bench::AllocationCount before = bench::countAllocations();
+        {
+            auto cache = std::make_shared<APICache>("", commands, c_refreshNever, nullptr);
+            cache->setCompactDepth(depth);
+            cache->refresh();
+            printBytesPerLight(name, before, numLights);
+
+            // Accessing one light only decodes that light
+            APICache light(std::make_shared<APICache>(cache, "lights", c_refreshNever), "1", c_refreshNever);
+            (void)light.getValue();
+            printBytesPerLight(name + " after access of one light", before, numLights);
+            (void)cache->getValue();
+            printBytesPerLight(name + " after access of the whole state", before, numLights);
+            cache->compact();
+            printBytesPerLight(name + " after compact()", before, numLights);
+        }
+        printBytesPerLight(name + " after destruction", before, numLights);
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+    \file CacheRefresh.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Measures heap allocations and time of a full state refresh of a bridge with many lights.
+    Compares replacing the cached document with a freshly parsed one (previous behavior)
+    to APICache::refresh, which updates the cached document in place,
+    and to APICache::refresh with arena parsing, which parses the response into a reused RefreshArena.
+**/
+
+#include <iostream>
+
+#include <hueplusplus/APICache.h>
+
+#include "BenchmarkUtils.h"
+
+namespace
+{
+nlohmann::json makeBridgeState(int numLights)
+{
+    nlohmann::json lights = nlohmann::json::object();
+    for (int i = 1; i <= numLights; ++i)
+    {
+        lights[std::to_string(i)] = {{"state",
+                                         {{"on", true}, {"bri", 254}, {"hue", 8418}, {"sat", 140}, {"effect", "none"},
+                                             {"xy", {0.4573, 0.41}}, {"ct", 366}, {"alert", "none"},
+                                             {"colormode", "ct"}, {"mode", "homeautomation"}, {"reachable", true}}},
+            {"type", "Extended color light"}, {"name", "Hue color lamp " + std::to_string(i)},
+            {"modelid", "LCT016"}, {"manufacturername", "Signify Netherlands B.V."},
+            {"productname", "Hue color lamp"}, {"uniqueid", "00:17:88:01:04:0b:8e:1a-0b"},
+            {"swversion", "1.50.2_r30933"}};
+    }
+    return {{"lights", lights}, {"groups", nlohmann::json::object()}, {"config", {{"name", "Philips hue"}}}};
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace hueplusplus;
+    constexpr int iterations = 200;
+    hueplusplus::Config::instance() = bench::BenchmarkConfig();
+
+    const std::string body = makeBridgeState(50).dump();
+    auto handler = std::make_shared<bench::FixedResponseHandler>(body);
+    HueCommandAPI commands("192.168.2.116", 80, "username", handler);
+
+    // Previous behavior: the parsed response replaces the cached document
+    {
+        nlohmann::json cached;
+        bench::AllocationCount before = bench::countAllocations();
+        for (int i = 0; i < iterations; ++i)
+        {
+            cached = commands.GETRequest("", nlohmann::json::object());
+        }
+        bench::printAllocations("replace", before, bench::countAllocations(), iterations);
+        bench::measure("replace", iterations, [&]() { cached = commands.GETRequest("", nlohmann::json::object()); });
+    }
+    // APICache::refresh updates the cached document in place
+    {
+        APICache cache("", commands, c_refreshNever, nullptr);
+        cache.refresh();
+        const nlohmann::json* state = &cache.getValue()["lights"]["1"]["state"];
+        bench::AllocationCount before = bench::countAllocations();
+        for (int i = 0; i < iterations; ++i)
+        {
+            cache.refresh();
+        }
+        bench::printAllocations("in place", before, bench::countAllocations(), iterations);
+        bench::measure("in place", iterations, [&]() { cache.refresh(); });
+        std::cout << "cached light state kept its address: " << std::boolalpha
+                  << (state == &cache.getValue()["lights"]["1"]["state"]) << "\n";
+    }
+    // The response is parsed into an arena and only merged into the cached document
+    {
+        APICache cache("", commands, c_refreshNever, nullptr);
+        cache.setArenaParsing(true);
+        cache.refresh();
+        const nlohmann::json* state = &cache.getValue()["lights"]["1"]["state"];
+        bench::AllocationCount before = bench::countAllocations();
+        for (int i = 0; i < iterations; ++i)
+        {
+            cache.refresh();
+        }
+        bench::printAllocations("arena", before, bench::countAllocations(), iterations);
+        bench::measure("arena", iterations, [&]() { cache.refresh(); });
+        std::cout << "cached light state kept its address: " << std::boolalpha
+                  << (state == &cache.getValue()["lights"]["1"]["state"]) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+    \file ColorConversion.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Measures the time to convert one entertainment frame of 20 lights between RGB and XYBrightness.
+    Compares converting each color with RGB::toXY() and RGB::fromXY(), with and without gamma tables,
+    GamutTable and the batch conversions convertToXY() and convertToRGB().
+**/
+
+#include <iostream>
+#include <vector>
+
+#include <hueplusplus/ColorConversion.h>
+
+#include "BenchmarkUtils.h"
+
+int main(int argc, char** argv)
+{
+    using namespace hueplusplus;
+    constexpr int iterations = 100000;
+    constexpr std::size_t lights = 20;
+
+    std::vector<RGB> rgb;
+    std::vector<ColorGamut> gamuts;
+    for (std::size_t i = 0; i < lights; ++i)
+    {
+        rgb.push_back(
+            RGB {static_cast<uint8_t>(i * 13), static_cast<uint8_t>(255 - i * 7), static_cast<uint8_t>(i * 5)});
+        gamuts.push_back(i % 2 == 0 ? gamut::gamutC : gamut::gamutA);
+    }
+    std::vector<XYBrightness> xy(lights);
+    std::vector<RGB> back(lights);
+
+    // Use the results, so the conversions are not optimized away
+    float sum = 0;
+    bench::measure("RGB::toXY", iterations, [&]() {
+        for (std::size_t i = 0; i < lights; ++i)
+        {
+            xy[i] = rgb[i].toXY(gamuts[i]);
+        }
+        sum += xy[lights - 1].xy.x;
+    });
+    bench::measure("RGB::toXY with table", iterations, [&]() {
+        for (std::size_t i = 0; i < lights; ++i)
+        {
+            xy[i] = rgb[i].toXY(gamuts[i], GammaCorrection::table);
+        }
+        sum += xy[lights - 1].xy.x;
+    });
+    const GamutTable tableA(gamut::gamutA);
+    const GamutTable tableC(gamut::gamutC);
+    bench::measure("GamutTable::toXY", iterations, [&]() {
+        for (std::size_t i = 0; i < lights; ++i)
+        {
+            xy[i] = (i % 2 == 0 ? tableC : tableA).toXY(rgb[i]);
+        }
+        sum += xy[lights - 1].xy.x;
+    });
+    bench::measure("convertToXY", iterations, [&]() {
+        convertToXY(rgb.data(), lights, xy.data(), gamuts.data());
+        sum += xy[lights - 1].xy.x;
+    });
+    bench::measure("RGB::fromXY", iterations, [&]() {
+        for (std::size_t i = 0; i < lights; ++i)
+        {
+            back[i] = RGB::fromXY(xy[i], gamuts[i]);
+        }
+        sum += back[lights - 1].r;
+    });
+    bench::measure("RGB::fromXY with table", iterations, [&]() {
+        for (std::size_t i = 0; i < lights; ++i)
+        {
+            back[i] = RGB::fromXY(xy[i], gamuts[i], GammaCorrection::table);
+        }
+        sum += back[lights - 1].r;
+    });
+    bench::measure("convertToRGB", iterations, [&]() {
+        convertToRGB(xy.data(), lights, back.data(), gamuts.data());
+        sum += back[lights - 1].r;
+    });
+
+    std::cout << "checksum: " << sum << "\n";
+    return 0;
+}
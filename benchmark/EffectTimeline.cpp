@@ -0,0 +1,89 @@
+/**
+    \file EffectTimeline.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Measures the time to evaluate an effect timeline for one entertainment frame of 20 lights with 8 keyframes each,
+    in both color spaces, and the heap allocations per frame.
+    Also measures rendering one second at 50 frames per second.
+**/
+
+#include <iostream>
+#include <vector>
+
+#include <hueplusplus/EffectTimeline.h>
+#include <hueplusplus/HueStream.h>
+
+#include "BenchmarkUtils.h"
+
+int main(int argc, char** argv)
+{
+    using namespace hueplusplus;
+    using std::chrono::milliseconds;
+    constexpr int iterations = 100000;
+    constexpr std::size_t lights = 20;
+    constexpr int keyframes = 8;
+
+    // Chase: each light fades through the same colors, shifted in time
+    EffectTimeline timeline(lights);
+    std::vector<int> ids;
+    std::vector<ColorGamut> gamuts;
+    const Easing easings[] = {Easing::linear, Easing::easeIn, Easing::easeOut, Easing::easeInOut};
+    for (std::size_t i = 0; i < lights; ++i)
+    {
+        for (int k = 0; k < keyframes; ++k)
+        {
+            timeline.addKeyframe(i, milliseconds(250 * k + 25 * i),
+                RGB {static_cast<uint8_t>(k * 37), static_cast<uint8_t>(255 - k * 29), static_cast<uint8_t>(k * 13)},
+                easings[k % 4]);
+        }
+        ids.push_back(static_cast<int>(i + 1));
+        gamuts.push_back(i % 2 == 0 ? gamut::gamutC : gamut::gamutA);
+    }
+    timeline.setLoopDuration(milliseconds(250 * keyframes));
+
+    std::vector<uint8_t> rgb = huestream::createMessage(ids, huestream::ColorSpace::rgb);
+    std::vector<uint8_t> xy = huestream::createMessage(ids, huestream::ColorSpace::xyBrightness);
+
+    // Use the results, so the evaluation is not optimized away
+    long sum = 0;
+    int frame = 0;
+    bench::AllocationCount before = bench::countAllocations();
+    for (int i = 0; i < iterations; ++i)
+    {
+        timeline.evaluate(milliseconds(20 * i), rgb);
+    }
+    bench::printAllocations("evaluate", before, bench::countAllocations(), iterations);
+    bench::measure("evaluate rgb", iterations, [&]() {
+        timeline.evaluate(milliseconds(20 * ++frame), rgb);
+        sum += rgb.back();
+    });
+    bench::measure("evaluate xy with gamut", iterations, [&]() {
+        timeline.evaluate(milliseconds(20 * ++frame), xy, gamuts.data());
+        sum += xy.back();
+    });
+    std::vector<uint8_t> output;
+    bench::measure("render 50 frames", iterations / 50, [&]() {
+        output.clear();
+        timeline.render(milliseconds(20 * ++frame), milliseconds(20), 50, rgb, output);
+        sum += output.back();
+    });
+
+    std::cout << "checksum: " << sum << "\n";
+    return 0;
+}
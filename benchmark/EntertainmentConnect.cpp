@@ -0,0 +1,73 @@
+/**
+    \file EntertainmentConnect.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Measures the time to connect an EntertainmentMode to a local DTLS-PSK server.
+    Compares a full handshake in connect() to resuming the previous session with reconnect().
+    The server is the DtlsTestServer of the unit tests and listens on port 2100 of localhost.
+**/
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <hueplusplus/Bridge.h>
+#include <hueplusplus/EntertainmentMode.h>
+
+#include "../test/DtlsTestServer.h"
+#include "BenchmarkUtils.h"
+
+int main(int argc, char** argv)
+{
+    using namespace hueplusplus;
+    constexpr int iterations = 50;
+    hueplusplus::Config::instance() = bench::BenchmarkConfig();
+
+    const std::string username = "username";
+    const std::string clientKey = "0123456789abcdef0123456789abcdef";
+    // Every request enables streaming, so disconnect() reports a failure, which does not matter here
+    auto handler
+        = std::make_shared<bench::FixedResponseHandler>(R"([{"success":{"/groups/1/stream/active":true}}])");
+    Bridge bridge("127.0.0.1", 80, username, handler, clientKey);
+    Group group(1, HueCommandAPI("127.0.0.1", 80, username, handler), std::chrono::steady_clock::duration::max(),
+        {{"name", "Entertainment"}, {"type", "Entertainment"}, {"lights", nlohmann::json::array()},
+            {"action", nlohmann::json::object()}, {"state", nlohmann::json::object()}});
+
+    DtlsTestServer server(username, clientKey);
+    server.start();
+    EntertainmentMode entertainment(bridge, group);
+
+    bool success = true;
+    bench::measure("full handshake", iterations, [&]() {
+        success = entertainment.connect() && success;
+        entertainment.disconnect();
+    });
+    success = entertainment.connect() && success;
+    bench::measure("resumed handshake", iterations, [&]() { success = entertainment.reconnect() && success; });
+    entertainment.disconnect();
+    server.stop();
+
+    std::cout << "handshakes: " << server.getHandshakeCount() << ", resumed: " << server.getResumedCount() << "\n";
+    if (!success)
+    {
+        std::cout << "connecting failed\n";
+        return 1;
+    }
+    return 0;
+}
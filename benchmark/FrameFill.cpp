@@ -0,0 +1,68 @@
+/**
+    \file FrameFill.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Measures the time to write the channels of an entertainment frame with 300 lights.
+    Compares calling huestream::setChannels() for each light, like EntertainmentMode::setColorRGB16(),
+    to the bulk huestream::setChannels(), which is used by EntertainmentMode::setChannels().
+**/
+
+#include <iostream>
+#include <vector>
+
+#include <hueplusplus/HueStream.h>
+
+#include "BenchmarkUtils.h"
+
+int main(int argc, char** argv)
+{
+    using namespace hueplusplus;
+    constexpr int iterations = 100000;
+    constexpr std::size_t lights = 300;
+
+    std::vector<int> lightIds;
+    std::vector<uint16_t> channels;
+    for (std::size_t i = 0; i < lights; ++i)
+    {
+        lightIds.push_back(static_cast<int>(i + 1));
+        channels.push_back(static_cast<uint16_t>(i * 211));
+        channels.push_back(static_cast<uint16_t>(65535 - i * 97));
+        channels.push_back(static_cast<uint16_t>(i * 53));
+    }
+    std::vector<uint8_t> message = huestream::createMessage(lightIds, huestream::ColorSpace::rgb);
+
+    // Use the results, so the writes are not optimized away
+    unsigned sum = 0;
+    bench::measure("setChannels per light", iterations, [&]() {
+        for (std::size_t i = 0; i < lights; ++i)
+        {
+            huestream::setChannels(message, i, channels[i * 3], channels[i * 3 + 1], channels[i * 3 + 2]);
+        }
+        sum += message.back();
+        ++channels[0];
+    });
+    bench::measure("setChannels bulk", iterations, [&]() {
+        huestream::setChannels(message, 0, channels.data(), lights);
+        sum += message.back();
+        ++channels[0];
+    });
+
+    std::cout << "checksum: " << sum << "\n";
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+    \file JsonAccess.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Measures heap allocations and time of looking up members in a light state.
+    Compares the copying safeGetMember to safeGetMemberRef and a precompiled MemberPath.
+**/
+
+#include <iostream>
+
+#include <hueplusplus/Utils.h>
+
+#include "BenchmarkUtils.h"
+
+namespace
+{
+const nlohmann::json lightState = nlohmann::json::parse(R"({
+    "state": {"on": true, "bri": 254, "hue": 8402, "sat": 140, "effect": "none", "xy": [0.4575, 0.4099],
+        "ct": 366, "alert": "none", "colormode": "ct", "mode": "homeautomation", "reachable": true},
+    "type": "Extended color light", "name": "Hue color lamp", "modelid": "LCT015", "manufacturername": "Signify",
+    "productname": "Hue color lamp",
+    "capabilities": {"certified": true,
+        "control": {"mindimlevel": 1000, "maxlumen": 806, "colorgamuttype": "C",
+            "colorgamut": [[0.6915, 0.3083], [0.17, 0.7], [0.1532, 0.0475]], "ct": {"min": 153, "max": 500}},
+        "streaming": {"renderer": true, "proxy": true}},
+    "config": {"archetype": "sultanbulb", "function": "mixed", "direction": "omnidirectional"},
+    "uniqueid": "00:17:88:01:04:00:00:00-0b", "swversion": "1.50.2_r30933"})");
+} // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace hueplusplus;
+    constexpr int iterations = 100000;
+
+    std::size_t found = 0;
+    const auto copy = [&]() {
+        nlohmann::json type = utils::safeGetMember(lightState, "capabilities", "control", "colorgamuttype");
+        nlohmann::json gamut = utils::safeGetMember(lightState, "capabilities", "control", "colorgamut");
+        found += type.is_string() + gamut.size();
+    };
+    const auto reference = [&]() {
+        const nlohmann::json& type = utils::safeGetMemberRef(lightState, "capabilities", "control", "colorgamuttype");
+        const nlohmann::json& gamut = utils::safeGetMemberRef(lightState, "capabilities", "control", "colorgamut");
+        found += type.is_string() + gamut.size();
+    };
+    const utils::MemberPath typePath {"capabilities", "control", "colorgamuttype"};
+    const utils::MemberPath gamutPath {"capabilities", "control", "colorgamut"};
+    const auto path = [&]() {
+        const nlohmann::json& type = typePath.get(lightState);
+        const nlohmann::json& gamut = gamutPath.get(lightState);
+        found += type.is_string() + gamut.size();
+    };
+
+    bench::AllocationCount before = bench::countAllocations();
+    for (int i = 0; i < iterations; ++i)
+    {
+        copy();
+    }
+    bench::printAllocations("safeGetMember", before, bench::countAllocations(), iterations);
+    bench::measure("safeGetMember", iterations, copy);
+
+    before = bench::countAllocations();
+    for (int i = 0; i < iterations; ++i)
+    {
+        reference();
+    }
+    bench::printAllocations("safeGetMemberRef", before, bench::countAllocations(), iterations);
+    bench::measure("safeGetMemberRef", iterations, reference);
+
+    before = bench::countAllocations();
+    for (int i = 0; i < iterations; ++i)
+    {
+        path();
+    }
+    bench::printAllocations("MemberPath", before, bench::countAllocations(), iterations);
+    bench::measure("MemberPath", iterations, path);
+
+    if (found == 0)
+    {
+        std::cerr << "Members not found\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+/**
+    \file RequestWriter.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Measures heap allocations and time of writing a PUT request to the http handler.
+    Compares the json request, which is combined into one string, to the serialized request sent in parts.
+**/
+
+#include <iostream>
+
+#include <hueplusplus/HueCommandAPI.h>
+#include <hueplusplus/StateRequest.h>
+
+#include "BenchmarkUtils.h"
+
+namespace
+{
+// Short response which fits into the small string buffer, so mostly the request is measured.
+// Parsing the response still allocates the token buffer of the parser.
+const std::string response = "\r\n\r\n1";
+
+//! \brief Http handler which discards the request, like a socket write
+class DiscardHandler : public hueplusplus::BaseHttpHandler
+{
+public:
+    std::string send(const std::string& msg, const std::string& adr, int port = 80) const override
+    {
+        written += msg.size();
+        return response;
+    }
+    std::string sendParts(
+        const hueplusplus::MessagePart* parts, std::size_t count, const std::string& adr, int port = 80) const override
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            written += parts[i].size;
+        }
+        return response;
+    }
+    std::vector<std::string> sendMulticast(const std::string& msg, const std::string& adr, int port,
+        std::chrono::steady_clock::duration timeout) const override
+    {
+        return {};
+    }
+
+    mutable std::size_t written = 0;
+};
+} // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace hueplusplus;
+    constexpr int iterations = 10000;
+    hueplusplus::Config::instance() = bench::BenchmarkConfig();
+
+    const std::string path = "/lights/1/state";
+    auto handler = std::make_shared<DiscardHandler>();
+    HueCommandAPI commands("192.168.2.116", 80, "username", handler);
+
+    StateRequest request;
+    request.setOn(true);
+    request.setBrightness(200);
+    request.setXY(0.5f, 0.4f);
+    request.setTransition(1);
+    const nlohmann::json jsonRequest = request.toJson();
+    std::string body;
+    body.reserve(256);
+
+    const auto putJson = [&]() { handler->PUTJson(commands.combinedPath(path), jsonRequest, "192.168.2.116", 80); };
+    const std::string prefix = "/api/username";
+    const auto putSerialized = [&]() {
+        request.serialize(body);
+        handler->PUTSerialized({prefix.data(), prefix.size()}, path, body, "192.168.2.116", 80);
+    };
+    // Includes the FileInfo and timeout handling of HueCommandAPI
+    const auto commandSerialized = [&]() {
+        request.serialize(body);
+        commands.PUTSerializedRequest(path, body);
+    };
+
+    bench::AllocationCount before = bench::countAllocations();
+    for (int i = 0; i < iterations; ++i)
+    {
+        putJson();
+    }
+    bench::printAllocations("json PUT", before, bench::countAllocations(), iterations);
+    bench::measure("json PUT", iterations, putJson);
+
+    before = bench::countAllocations();
+    for (int i = 0; i < iterations; ++i)
+    {
+        putSerialized();
+    }
+    bench::printAllocations("serialized PUT", before, bench::countAllocations(), iterations);
+    bench::measure("serialized PUT", iterations, putSerialized);
+
+    before = bench::countAllocations();
+    for (int i = 0; i < iterations; ++i)
+    {
+        commandSerialized();
+    }
+    bench::printAllocations("HueCommandAPI serialized PUT", before, bench::countAllocations(), iterations);
+    bench::measure("HueCommandAPI serialized PUT", iterations, commandSerialized);
+
+    if (handler->written == 0)
+    {
+        std::cerr << "Nothing was written\n";
+        return 1;
+    }
+    return 0;
+}
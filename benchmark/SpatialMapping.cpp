@@ -0,0 +1,118 @@
+/**
+    \file SpatialMapping.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Measures the time to sample a 32x32x8 ColorGrid at the locations of 300 lights for one frame.
+    Compares computing the cells and weights of each light in every frame to SpatialMapping::sample(),
+    which uses the weights computed in the constructor.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <hueplusplus/HueStream.h>
+#include <hueplusplus/SpatialMapping.h>
+
+#include "BenchmarkUtils.h"
+
+namespace
+{
+// Samples one channel with trilinear interpolation, without precomputed weights
+float sampleDirect(const hueplusplus::ColorGrid& grid, std::size_t channel, const hueplusplus::LightLocation& location)
+{
+    const float coordinates[] = {location.x, location.y, location.z};
+    const std::size_t sizes[] = {grid.getWidth(), grid.getHeight(), grid.getDepth()};
+    std::size_t low[3];
+    std::size_t high[3];
+    float fraction[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const float clamped = std::min(std::max(coordinates[axis], -1.f), 1.f);
+        const float position = std::min(
+            std::max((clamped + 1.f) / 2.f * sizes[axis] - 0.5f, 0.f), static_cast<float>(sizes[axis] - 1));
+        low[axis] = static_cast<std::size_t>(position);
+        high[axis] = std::min(low[axis] + 1, sizes[axis] - 1);
+        fraction[axis] = position - low[axis];
+    }
+    float result = 0.f;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        float weight = 1.f;
+        std::size_t cell[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const bool upper = (corner >> axis & 1) != 0;
+            cell[axis] = upper ? high[axis] : low[axis];
+            weight *= upper ? fraction[axis] : 1.f - fraction[axis];
+        }
+        result += weight * grid.getChannel(channel)[grid.getIndex(cell[0], cell[1], cell[2])];
+    }
+    return result;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace hueplusplus;
+    constexpr int iterations = 20000;
+    constexpr std::size_t lights = 300;
+
+    ColorGrid grid(32, 32, 8);
+    for (std::size_t channel = 0; channel < 3; ++channel)
+    {
+        for (std::size_t i = 0; i < 32 * 32 * 8; ++i)
+        {
+            grid.getChannel(channel)[i] = static_cast<float>((i * 37 + channel * 11) % 101) / 100.f;
+        }
+    }
+    std::vector<LightLocation> locations;
+    for (std::size_t i = 0; i < lights; ++i)
+    {
+        locations.push_back(
+            LightLocation {std::sin(i * 1.3f), std::cos(i * 0.7f), static_cast<float>(i % 9) / 4.f - 1.f});
+    }
+    std::vector<uint16_t> channels(lights * 3);
+
+    // Use the results, so the sampling is not optimized away
+    unsigned sum = 0;
+    bench::measure("sample each light", iterations, [&]() {
+        for (std::size_t i = 0; i < lights; ++i)
+        {
+            for (std::size_t channel = 0; channel < 3; ++channel)
+            {
+                channels[i * 3 + channel] = huestream::toChannel(sampleDirect(grid, channel, locations[i]));
+            }
+        }
+        sum += channels.back();
+        grid.getChannel(0)[0] += 0.001f;
+    });
+    const SpatialMapping mapping(locations, 32, 32, 8);
+    const bench::AllocationCount before = bench::countAllocations();
+    bench::measure("SpatialMapping::sample", iterations, [&]() {
+        mapping.sample(grid, 0, lights, channels.data());
+        sum += channels.back();
+        grid.getChannel(0)[0] += 0.001f;
+    });
+    bench::printAllocations("SpatialMapping::sample", before, bench::countAllocations(), iterations);
+
+    std::cout << "checksum: " << sum << "\n";
+    return 0;
+}
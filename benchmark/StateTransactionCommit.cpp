@@ -0,0 +1,120 @@
+/**
+    \file StateTransactionCommit.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Measures heap allocations and time of building, serializing and validating a light state request.
+    Compares a request built as json DOM to the typed StateRequest, and measures a complete StateTransaction commit.
+**/
+
+#include <iostream>
+
+#include <hueplusplus/StateRequest.h>
+#include <hueplusplus/StateTransaction.h>
+#include <hueplusplus/Utils.h>
+
+#include "BenchmarkUtils.h"
+
+namespace
+{
+const std::string path = "/lights/1/state";
+
+const nlohmann::json reply = {{{"success", {{path + "/on", true}}}}, {{"success", {{path + "/bri", 200}}}},
+    {{"success", {{path + "/xy", {0.5, 0.4}}}}}, {{"success", {{path + "/transitiontime", 1}}}}};
+
+std::string makeResponse()
+{
+    return reply.dump();
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace hueplusplus;
+    constexpr int iterations = 10000;
+    hueplusplus::Config::instance() = bench::BenchmarkConfig();
+
+    std::string buffer;
+    buffer.reserve(256);
+    bool valid = true;
+    const auto buildJson = [&]() {
+        nlohmann::json request = nlohmann::json::object();
+        request["on"] = true;
+        request["bri"] = 200;
+        request["xy"] = {0.5f, 0.4f};
+        request["transitiontime"] = 1;
+        buffer = request.dump();
+        valid &= utils::validatePUTReply(path, request, reply);
+    };
+    const auto buildTyped = [&]() {
+        StateRequest request;
+        request.setOn(true);
+        request.setBrightness(200);
+        request.setXY(0.5f, 0.4f);
+        request.setTransition(1);
+        request.serialize(buffer);
+        valid &= request.validateReply(path, reply);
+    };
+
+    bench::AllocationCount before = bench::countAllocations();
+    for (int i = 0; i < iterations; ++i)
+    {
+        buildJson();
+    }
+    bench::printAllocations("json request", before, bench::countAllocations(), iterations);
+    bench::measure("json request", iterations, buildJson);
+
+    before = bench::countAllocations();
+    for (int i = 0; i < iterations; ++i)
+    {
+        buildTyped();
+    }
+    bench::printAllocations("typed request", before, bench::countAllocations(), iterations);
+    bench::measure("typed request", iterations, buildTyped);
+
+    // Complete commit including the http layer
+    auto handler = std::make_shared<bench::FixedResponseHandler>(makeResponse());
+    HueCommandAPI commands("192.168.2.116", 80, "username", handler);
+    nlohmann::json state = {{"on", false}, {"bri", 1}, {"xy", {0.1, 0.1}}, {"colormode", "xy"}};
+    const auto commit = [&]() {
+        // Reset the values applied by the previous commit, so nothing is trimmed
+        state["on"] = false;
+        state["bri"] = 1;
+        state["xy"][0] = 0.1;
+        valid &= StateTransaction(commands, path, &state)
+                     .setOn(true)
+                     .setBrightness(200)
+                     .setColor(XY {0.5f, 0.4f})
+                     .setTransition(1)
+                     .commit();
+    };
+    before = bench::countAllocations();
+    for (int i = 0; i < iterations; ++i)
+    {
+        commit();
+    }
+    bench::printAllocations("commit", before, bench::countAllocations(), iterations);
+    bench::measure("commit", iterations, commit);
+
+    if (!valid)
+    {
+        std::cerr << "Reply validation failed\n";
+        return 1;
+    }
+    return 0;
+}
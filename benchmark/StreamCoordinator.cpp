@@ -0,0 +1,136 @@
+/**
+    \file StreamCoordinator.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+
+    Measures the time between the frames of four entertainment sessions which are sent at 50 frames per second.
+    Compares one StreamingEngine per session to a StreamCoordinator for all sessions.
+    Each send busy waits for 30 us to simulate writing a DTLS record.
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <hueplusplus/StreamCoordinator.h>
+
+namespace
+{
+using std::chrono::steady_clock;
+
+constexpr std::size_t sessionCount = 4;
+constexpr int rate = 50;
+constexpr std::size_t maxFrames = 200;
+
+// Records the send times of one session
+class Recorder
+{
+public:
+    Recorder() { times.reserve(maxFrames); }
+
+    bool operator()(const std::vector<uint8_t>&)
+    {
+        const steady_clock::time_point now = steady_clock::now();
+        if (times.size() < maxFrames)
+        {
+            times.push_back(now);
+        }
+        while (steady_clock::now() - now < std::chrono::microseconds(30)) { }
+        return true;
+    }
+
+    std::vector<steady_clock::time_point> times;
+};
+
+// Prints the time between the first and the last session for each frame number
+void printSkew(const std::string& name, const std::vector<std::unique_ptr<Recorder>>& recorders)
+{
+    std::size_t frames = maxFrames;
+    for (const std::unique_ptr<Recorder>& r : recorders)
+    {
+        frames = std::min(frames, r->times.size());
+    }
+    std::chrono::nanoseconds total {0};
+    std::chrono::nanoseconds max {0};
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        steady_clock::time_point first = recorders[0]->times[i];
+        steady_clock::time_point last = first;
+        for (const std::unique_ptr<Recorder>& r : recorders)
+        {
+            first = std::min(first, r->times[i]);
+            last = std::max(last, r->times[i]);
+        }
+        total += last - first;
+        max = std::max<std::chrono::nanoseconds>(max, last - first);
+    }
+    std::cout << name << ": mean skew " << (frames > 0 ? total.count() / static_cast<long>(frames) : 0)
+              << " ns, max skew " << max.count() << " ns over " << frames << " frames\n";
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace hueplusplus;
+    const std::vector<uint8_t> frame(16 + 10 * 9);
+
+    // Previous behavior: each session has its own sender thread
+    {
+        std::vector<std::unique_ptr<Recorder>> recorders;
+        std::vector<std::unique_ptr<StreamingEngine>> engines;
+        for (std::size_t i = 0; i < sessionCount; ++i)
+        {
+            recorders.push_back(std::make_unique<Recorder>());
+            Recorder* recorder = recorders.back().get();
+            engines.push_back(std::make_unique<StreamingEngine>(
+                frame, [recorder](const std::vector<uint8_t>& msg) { return (*recorder)(msg); }));
+            engines.back()->start(rate);
+            // Sessions are started one after another, like EntertainmentMode::startSending
+            std::this_thread::sleep_for(std::chrono::milliseconds(3));
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+        for (std::unique_ptr<StreamingEngine>& engine : engines)
+        {
+            engine->stop();
+        }
+        printSkew("StreamingEngine per session", recorders);
+    }
+    // All sessions are sent from one clock
+    {
+        std::vector<std::unique_ptr<Recorder>> recorders;
+        StreamCoordinator coordinator;
+        for (std::size_t i = 0; i < sessionCount; ++i)
+        {
+            recorders.push_back(std::make_unique<Recorder>());
+            Recorder* recorder = recorders.back().get();
+            coordinator.addSession(frame, [recorder](const std::vector<uint8_t>& msg) { return (*recorder)(msg); });
+        }
+        coordinator.start(rate);
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+        coordinator.stop();
+        printSkew("StreamCoordinator", recorders);
+        const SkewStatistics skew = coordinator.getSkewStatistics();
+        std::cout << "StreamCoordinator statistics: mean skew " << skew.meanSkew.count() << " ns, max skew "
+                  << skew.maxSkew.count() << " ns over " << skew.ticks << " frames\n";
+    }
+    return 0;
+}
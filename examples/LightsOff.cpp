@@ -84,14 +84,14 @@ hue::Bridge connectToBridge()
 // Only turns the lights back on that were on before.
 void lightsOff(hue::Bridge& hue)
 {
-    std::vector<hue::Light> lights = hue.lights().getAll();
+    std::vector<hue::ResourceHandle<hue::Light>> lights = hue.lights().getAll();
 
     // Save current on state of the lights
     std::map<int, bool> onMap;
-    for (hue::Light& l : lights)
+    for (const hue::ResourceHandle<hue::Light>& l : lights)
     {
-        onMap.emplace(l.getId(), l.isOn());
-        l.off();
+        onMap.emplace(l->getId(), l->isOn());
+        l->off();
     }
 
     // This would be preferrable, but does not work because it also resets the brightness of all lights
@@ -104,11 +104,11 @@ void lightsOff(hue::Bridge& hue)
     std::this_thread::sleep_for(std::chrono::seconds(20));
 
     // Restore the original state of the lights
-    for (hue::Light& l : lights)
+    for (const hue::ResourceHandle<hue::Light>& l : lights)
     {
-        if (onMap[l.getId()])
+        if (onMap[l->getId()])
         {
-            l.on();
+            l->on();
         }
     }
 
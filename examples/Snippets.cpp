@@ -64,7 +64,7 @@ void snippet1()
     hueplusplus::Light light1 = bridge.lights().get(1);
     //! [light-1]
     //! [light-2]
-    std::vector<hueplusplus::Light> lights = bridge.lights().getAll();
+    std::vector<hueplusplus::ResourceHandle<hueplusplus::Light>> lights = bridge.lights().getAll();
     //! [light-2]
     //! [light-3]
     light1.on();
@@ -72,8 +72,8 @@ void snippet1()
     light1.alertHueSaturation({25500, 254});
     light1.setColorLoop(true);
     light1.setColorRGB({255, 128, 0});
-    lights[1].off();
-    lights.at(1).setColorHue(4562);
+    lights[1]->off();
+    lights.at(1)->setColorHue(4562);
     //! [light-3]
     //! [light-4]
     hueplusplus::ColorType type1 = light1.getColorType();
@@ -23,8 +23,13 @@
 #ifndef INCLUDE_API_CACHE_H
 #define INCLUDE_API_CACHE_H
 
+#include <atomic>
 #include <chrono>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <vector>
 
 #include "HueCommandAPI.h"
 
@@ -34,6 +39,11 @@ namespace hueplusplus
 constexpr std::chrono::steady_clock::duration c_refreshNever = std::chrono::steady_clock::duration::max();
 
 //! \brief Caches API GET requests and refreshes regularly.
+//!
+//! All caches of a bridge share the state mutex of their HueCommandAPI.
+//! Refresh requests are sent without holding it, only updating the cached value locks the mutex exclusively.
+//! Reading locks it shared, so readers run in parallel. References returned by getValue() must only be used
+//! while holding lockShared() or lock(), see \ref concurrency.
 class APICache
 {
 public:
@@ -60,11 +70,56 @@ public:
     //! \throws HueException when response contained no body
     //! \throws HueAPIResponseException when response contains an error
     //! \throws nlohmann::json::parse_error when response could not be parsed
+    //! \throws HueException when the entry of this cache is not loaded by the base cache, see setEntries()
     //!
     //! If there is a base cache, refreshes only the used part of that cache.
+    //! When the loaded entries are restricted with setEntries(), requests each of them with refreshEntry().
+    //! The cached document is updated in place: entries which are still present keep their storage,
+    //! so references obtained from getValue() to those entries stay valid across refreshes.
+    //! Entries which are no longer present in the response are removed.
+    //! With a compact depth, see setCompactDepth(), the response is encoded instead.
     void refresh();
 
+    //! \brief Refresh one entry of the cached object now.
+    //! \param entry Key of the entry, which is requested from <tt>getRequestPath() + '/' + entry</tt>
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws HueAPIResponseException when response contains an error
+    //! \throws nlohmann::json::parse_error when response could not be parsed
+    //!
+    //! Only updates the entry in place and does not refresh the base cache, even if it is outdated.
+    //! The time of the last refresh is unchanged, call markRefreshed() when all entries are requested.
+    void refreshEntry(const std::string& entry);
+
+    //! \brief Mark the cached value as up to date without a request.
+    //!
+    //! Used after the value was assembled with refreshEntry().
+    void markRefreshed();
+
+    //! \brief Replace the cached value with a value that was requested elsewhere.
+    //!
+    //! Used by ResourceList to pass the state of a refreshed list to the resources, so they do not need
+    //! their own request. Does nothing when this cache forwards to a base cache, or when it was refreshed
+    //! after \c refreshTime.
+    //! \param newValue Value of this cache, may be encoded like the members of a compact cache
+    //! \param refreshTime Time at which \c newValue was requested
+    void updateValue(const nlohmann::json& newValue, std::chrono::steady_clock::time_point refreshTime);
+
+    //! \brief Mark the cached value as outdated, so the next non-const getValue() refreshes it.
+    //!
+    //! Also applies to all copies of this cache and ignores the refresh duration, even \ref c_refreshNever.
+    void invalidate();
+
+    //! \brief Get a function which calls invalidate() on this cache and its copies
+    //!
+    //! The function can be called from any thread and does nothing when all copies are destroyed,
+    //! so it can be used by tasks which outlive the cached resource, like asynchronous alerts.
+    std::function<void()> getInvalidator() const;
+
     //! \brief Get cached value, refresh if necessary.
+    //!
+    //! Must not be called while holding lock(), because the request of the refresh would block all other threads.
+    //! Call it before locking and read with getValue() const while holding the lock.
     //! \throws std::system_error when system or socket operations fail
     //! \throws HueException when response contained no body
     //! \throws HueAPIResponseException when response contains an error
@@ -72,8 +127,105 @@ public:
     nlohmann::json& getValue();
     //! \brief Get cached value, does not refresh.
     //! \throws HueException when no previous request was cached
+    //! \throws HueException when the value is encoded and the thread already holds a shared lock,
+    //! which cannot be upgraded to decode it. Use lockShared() instead of std::shared_lock.
     const nlohmann::json& getValue() const;
 
+    //! \brief Refresh cache now, without throwing.
+    //! \returns Error of the request, ErrorCode::none if successful. The cached value is unchanged on failure.
+    //! \see refresh()
+    Error tryRefresh();
+
+    //! \brief Get cached value, refresh if necessary, without throwing.
+    //! \returns The cached value, ErrorCode::notFound when the entry is not present in the base cache
+    //! or the error of the refresh, see HueCommandAPI::tryGETRequest()
+    Result<nlohmann::json&> tryGetValue();
+    //! \brief Get cached value without refreshing and without throwing.
+    //! \returns The cached value, ErrorCode::noValue when no previous request was cached
+    //! or ErrorCode::notFound when the entry is not present in the base cache.
+    //! Also ErrorCode::noValue when the value is encoded and cannot be decoded, see getValue() const.
+    Result<const nlohmann::json&> tryGetValue() const;
+
+    //! \brief Get cached value for modification, without refreshing and without throwing.
+    //! \returns Same as tryGetValue() const
+    //!
+    //! Used to apply the changes of a successful request to the cached value. Must be called with lock(),
+    //! the reference is only valid while holding it.
+    Result<nlohmann::json&> tryGetCachedValue();
+
+    //! \brief Restrict the entries which are loaded into this cache
+    //! \param entries Keys of the entries to load, or empty to load the whole value
+    //!
+    //! When restricted, refresh() requests each entry on its own instead of the whole value,
+    //! so the other entries are neither transferred nor stored. Entries which are already cached
+    //! and not in \c entries are removed immediately. Child caches of other entries cannot be refreshed.
+    void setEntries(std::vector<std::string> entries);
+
+    //! \brief Get the entries which are loaded into this cache
+    //! \returns Keys passed to setEntries(), empty when the whole value is loaded
+    std::vector<std::string> getEntries() const;
+
+    //! \brief Keep members of the cached value encoded as MessagePack until they are accessed.
+    //! \param depth Level of the members which are encoded, 0 to store the whole value as json.
+    //! For example, 2 encodes every resource of the bridge state (e.g. <tt>lights/1</tt>) on its own.
+    //!
+    //! An encoded member takes up one byte array instead of a heap allocation for every node and key.
+    //! getValue() of this cache decodes all members, getValue() of a child cache only decodes its entry.
+    //! Decoding writes to the cached value, so it is done under the exclusive lock by getValue() and lockShared(),
+    //! before reading under the shared lock.
+    //! Decoded members stay decoded until compact(). Refreshes update them in place and only encode members
+    //! which were encoded before or are new, so references returned by getValue() stay valid for entries
+    //! which are still present, like without a compact depth.
+    void setCompactDepth(int depth);
+
+    //! \brief Get the level of encoded members, 0 if the value is stored as json
+    int getCompactDepth() const;
+
+    //! \brief Encode all members which were decoded
+    //!
+    //! Invalidates all references returned by getValue() of this cache and its child caches.
+    //! Has no effect when the compact depth is 0.
+    void compact();
+
+    //! \brief Parse responses into a thread local arena instead of the heap.
+    //! \param enabled Whether refreshes of this cache and all caches sharing its root use the arena
+    //!
+    //! The response of a refresh is only needed until it is merged into the cached value, so it is parsed
+    //! as ArenaJson into a RefreshArena which is reset after the refresh. The arena keeps its memory for the
+    //! next refresh on the same thread, so only the members which changed are allocated on the heap.
+    //! The cached value and the references into it behave the same as without arena.
+    void setArenaParsing(bool enabled);
+
+    //! \brief Get whether responses are parsed into an arena, see setArenaParsing()
+    bool getArenaParsing() const;
+
+    //! \brief Set the members of responses which are kept
+    //! \param filter Filter applied while parsing the responses of this cache
+    //!
+    //! Caches without an own filter use the part of the filter of their base cache below their path.
+    //! Members which are already cached are only dropped at the next refresh.
+    void setFilter(JsonFilter filter);
+
+    //! \brief Get the filter set with setFilter()
+    JsonFilter getFilter() const;
+
+    //! \brief Lock the cached state of the bridge
+    //! \returns Lock on the state mutex of the HueCommandAPI, which is shared by all caches of the bridge
+    //!
+    //! Hold the lock while changing the cached value. The mutex is recursive, so functions that lock
+    //! can be called while holding it. Use lockShared() to only read.
+    std::unique_lock<StateMutex> lock() const;
+
+    //! \brief Lock the cached state of the bridge for reading
+    //! \returns Shared lock on the state mutex of the HueCommandAPI
+    //!
+    //! Hold the lock while using references returned by getValue(), so they are not changed by a concurrent
+    //! refresh. Other threads can read at the same time. When the value of this cache is encoded,
+    //! see setCompactDepth(), it is decoded under the exclusive lock before locking shared.
+    //! That is not possible when the thread already holds a shared lock, so lock the cache before
+    //! locking the state mutex in other ways.
+    std::shared_lock<StateMutex> lockShared() const;
+
     //! \brief Set duration after which the cache is refreshed.
     //! \param refreshDuration Interval between cache refreshing.
     //! May be 0 to always refresh, or \ref c_refreshNever to never refresh.
@@ -95,8 +247,54 @@ public:
     //! \returns Request path as passed to HueCommandAPI::GETRequest
     std::string getRequestPath() const;
 
+    //! \brief Get time of the last refresh
+    //! \returns Time point of the last refresh of this cache or its base cache,
+    //! or a default constructed time point when nothing was cached yet.
+    std::chrono::steady_clock::time_point getLastRefresh() const;
+
 private:
     bool needsRefresh();
+    //! \brief Check whether entry is loaded, must be called with the lock
+    bool isLoaded(const std::string& entry) const;
+    //! \brief Get the json value of this cache in the root cache, must be called with the lock
+    //!
+    //! Creates the value if it does not exist.
+    nlohmann::json& getStorage();
+    //! \brief Get the filter for requests of this cache, must be called with the lock
+    JsonFilter getRequestFilter() const;
+    //! \brief Get value without decoding members, but decode the path to it. Must be called with the lock
+    //! \throws HueException when the path is encoded and the thread does not hold the exclusive lock
+    nlohmann::json& getStoredValue() const;
+    //! \brief Same as getStoredValue(), but without throwing
+    Result<nlohmann::json&> tryGetStoredValue() const;
+    //! \brief Update value with a response and encode it, must be called with the lock
+    //! \tparam Json nlohmann::json or ArenaJson
+    template <typename Json>
+    void storeValue(Json&& result);
+    //! \brief Update an entry of the value with a response and encode it, must be called with the lock
+    template <typename Json>
+    void storeEntry(const std::string& entry, Json&& result);
+    //! \brief Find value in the root cache without creating it, must be called with the lock
+    //! \returns Pointer to the value or nullptr if it does not exist, or if the path to it is encoded
+    //! and the thread does not hold the exclusive lock
+    nlohmann::json* findStorage() const;
+    //! \brief Find value in the root cache without creating or decoding anything, must be called with the lock
+    //! \param encoded Set to true when the path to the value is encoded
+    //! \returns Pointer to the value or nullptr if it does not exist or is encoded
+    const nlohmann::json* peekStorage(bool& encoded) const;
+    //! \brief Check whether the value and its members are decoded, must be called with the lock
+    bool isDecoded() const;
+    //! \brief Decode the value and its members, must be called with the exclusive lock
+    void decodeStorage() const;
+    //! \brief Decode a stored node with the exclusive lock, otherwise only check that it is decoded
+    //! \returns false when the node is encoded and the thread does not hold the exclusive lock
+    bool decodeStored(nlohmann::json& node, int level, int depth) const;
+    //! \brief Mark invalidations up to \c generation as refreshed
+    void markSeen(unsigned int generation);
+    //! \brief Get number of base caches
+    int getLevel() const;
+    //! \brief Get cache without base cache, which contains the whole value
+    const APICache& getRoot() const;
 
 private:
     std::shared_ptr<APICache> base;
@@ -104,7 +302,16 @@ private:
     HueCommandAPI commands;
     std::chrono::steady_clock::duration refreshDuration;
     std::chrono::steady_clock::time_point lastRefresh;
-    nlohmann::json value;
+    std::vector<std::string> entries;
+    JsonFilter filter;
+    int compactDepth = 0;
+    bool arenaParsing = false;
+    //! Number of invalidate() calls, shared by all copies
+    std::shared_ptr<std::atomic<unsigned int>> invalidations;
+    //! Number of invalidations when the last refresh was requested
+    unsigned int seenInvalidations = 0;
+    //! Mutable, because encoded members are decoded on access under the exclusive lock
+    mutable nlohmann::json value;
 };
 } // namespace hueplusplus
 
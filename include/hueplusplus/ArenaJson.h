@@ -0,0 +1,173 @@
+/**
+    \file ArenaJson.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_ARENA_JSON_H
+#define INCLUDE_HUEPLUSPLUS_ARENA_JSON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace hueplusplus
+{
+//! \brief Monotonic memory arena for the documents parsed during one refresh
+//!
+//! Allocations are taken from large chunks and are not freed one by one.
+//! reset() releases the whole generation at once and keeps a single chunk which fits it,
+//! so the next generation of the same size does not allocate from the heap.
+//! An arena must only be used by one thread.
+class RefreshArena
+{
+public:
+    //! \brief Creates an arena without memory
+    //! \param chunkSize Size of the first chunk in bytes
+    explicit RefreshArena(std::size_t chunkSize = 16 * 1024);
+    RefreshArena(const RefreshArena&) = delete;
+    RefreshArena& operator=(const RefreshArena&) = delete;
+
+    //! \brief Allocate memory which stays valid until the next reset()
+    //! \param size Size in bytes
+    //! \param alignment Alignment in bytes, must be a power of two
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    //! \brief Check whether \c p points into memory of this arena
+    bool owns(const void* p) const;
+
+    //! \brief Release all allocations at once
+    //!
+    //! When the generation needed more than one chunk, they are replaced by one chunk of their total size.
+    void reset();
+
+    //! \brief Get the number of bytes allocated since the last reset()
+    std::size_t getUsedBytes() const;
+
+    //! \brief Get the number of chunks the arena holds
+    std::size_t getChunkCount() const;
+
+    //! \brief Get the arena used by ArenaAllocator on the calling thread, or nullptr
+    static RefreshArena* current();
+
+    //! \brief Makes an arena current on the calling thread while the scope exists
+    //!
+    //! The arena is reset when the outermost scope of it ends,
+    //! so all ArenaJson values created in the scope must be destroyed before.
+    class Scope
+    {
+    public:
+        //! \brief Makes \c arena current
+        explicit Scope(RefreshArena& arena);
+        //! \brief Restores the previous arena and resets \c arena
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        RefreshArena& arena;
+        RefreshArena* previous;
+    };
+
+private:
+    void addChunk(std::size_t size);
+
+private:
+    struct Chunk
+    {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size;
+    };
+    std::vector<Chunk> chunks;
+    std::size_t chunkSize;
+    //! Offset of the free memory in the last chunk
+    std::size_t offset = 0;
+    std::size_t used = 0;
+};
+
+//! \brief Stateless allocator which allocates from the current RefreshArena of the thread
+//! \tparam T Type of the allocated objects
+//!
+//! Without a current arena, memory is allocated from the heap. Memory of the arena is only released
+//! with RefreshArena::reset(), so objects must be destroyed on the thread and in the scope they were created in.
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    ArenaAllocator() = default;
+    //! \brief Converting constructor, the allocator has no state
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) noexcept
+    { }
+
+    //! \brief Allocate memory for \c n objects
+    T* allocate(std::size_t n)
+    {
+        RefreshArena* arena = RefreshArena::current();
+        if (arena == nullptr)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    //! \brief Free memory, does nothing when it belongs to the current arena
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        RefreshArena* arena = RefreshArena::current();
+        if (arena == nullptr || !arena->owns(p))
+        {
+            ::operator delete(p);
+        }
+    }
+
+    //! \brief All ArenaAllocator%s are equal
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const noexcept
+    {
+        return true;
+    }
+    //! \brief All ArenaAllocator%s are equal
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+
+//! \brief String type of ArenaJson
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+//! \brief Json document which allocates its nodes and strings from the current RefreshArena
+//!
+//! Used for responses which are only parsed to update the cache, see APICache::setArenaParsing().
+using ArenaJson = nlohmann::basic_json<std::map, std::vector, ArenaString, bool, std::int64_t, std::uint64_t, double,
+    ArenaAllocator>;
+
+//! \brief Copy an ArenaJson document to the heap
+nlohmann::json toJson(const ArenaJson& value);
+} // namespace hueplusplus
+
+#endif
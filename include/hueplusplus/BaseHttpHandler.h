@@ -51,6 +51,20 @@ public:
     //! \throws HueException when response contained no body
     std::string sendGetHTTPBody(const std::string& msg, const std::string& adr, int port = 80) const override;
 
+    //! \brief Send a message consisting of multiple parts to a specified host and return the response.
+    //!
+    //! \param parts Parts of the message, which are sent in order
+    //! \param count Number of parts
+    //! \param adr Ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional port the request is sent to, default is 80
+    //! \return The response of the host as a string
+    //! \throws std::system_error when system or socket operations fail
+    //!
+    //! The default implementation concatenates the parts and calls send.
+    //! Override to write the parts directly, e.g. with a gather write.
+    virtual std::string sendParts(
+        const MessagePart* parts, std::size_t count, const std::string& adr, int port = 80) const;
+
     //! \brief Send a HTTP request with the given method to the specified host and return the body of the response.
     //!
     //! \param method HTTP method type e.g. GET, HEAD, POST, PUT, DELETE, ...
@@ -134,6 +148,22 @@ public:
     nlohmann::json GETJson(
         const std::string& uri, const nlohmann::json& body, const std::string& adr, int port = 80) const override;
 
+    //! \brief Send a HTTP GET request to the specified host and return only the filtered parts of the response.
+    //!
+    //! \param uri Uniform Resource Identifier in the request
+    //! \param body Request body, may be empty
+    //! \param filter Members of the response to keep
+    //! \param adr Ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional port the request is sent to, default is 80
+    //! \return Parsed and filtered body of the response of the host
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws nlohmann::json::parse_error when the body could not be parsed
+    //!
+    //! Drops the members which are not kept while parsing, so they are never stored.
+    nlohmann::json GETJsonFiltered(const std::string& uri, const nlohmann::json& body, const JsonFilter& filter,
+        const std::string& adr, int port = 80) const override;
+
     //! \brief Send a HTTP POST request to the specified host and return the body of the response parsed as JSON.
     //!
     //! \param uri Uniform Resource Identifier in the request
@@ -172,6 +202,24 @@ public:
     //! \throws nlohmann::json::parse_error when the body could not be parsed
     nlohmann::json DELETEJson(
         const std::string& uri, const nlohmann::json& body, const std::string& adr, int port = 80) const override;
+
+    //! \brief Send a HTTP PUT request with an already serialized body and return the body of the response parsed as
+    //! JSON.
+    //!
+    //! \param uriPrefix Start of the Uniform Resource Identifier, e.g. "/api/<username>"
+    //! \param uri Rest of the Uniform Resource Identifier, appended to uriPrefix
+    //! \param body Request body, must be valid JSON
+    //! \param adr Ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional port the request is sent to, default is 80
+    //! \return Parsed body of the response of the host
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws nlohmann::json::parse_error when the body could not be parsed
+    //!
+    //! Sends the same message as PUTJson, but passes the request line, headers and body as separate parts
+    //! to sendParts, so no request string is built.
+    nlohmann::json PUTSerialized(MessagePart uriPrefix, const std::string& uri, const std::string& body,
+        const std::string& adr, int port = 80) const override;
 };
 } // namespace hueplusplus
 
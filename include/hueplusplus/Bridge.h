@@ -25,6 +25,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -58,6 +59,9 @@ class Bridge;
 //!
 //! Class to find all Hue bridges on the network and create usernames for them.
 //!
+//! The username and client key maps are protected by a mutex, so bridges can be found, created and
+//! added from multiple threads.
+//!
 class BridgeFinder
 {
 public:
@@ -109,9 +113,9 @@ public:
     //! \brief Function that returns a map of mac addresses and usernames.
     //!
     //! Note these should be saved at the end and re-loaded with \ref addUsername
-    //! next time, so only one username is generated per bridge. \returns A map
+    //! next time, so only one username is generated per bridge. \returns A copy of the map
     //! mapping mac address to username for every bridge
-    const std::map<std::string, std::string>& getAllUsernames() const;
+    std::map<std::string, std::string> getAllUsernames() const;
 
     //! \brief Normalizes mac address to plain hex number.
     //! \returns \p input without separators and whitespace, in lower case.
@@ -129,6 +133,7 @@ private:
                                                   //!< BridgeFinder::addUsername
     std::map<std::string, std::string> clientkeys; //!< Maps all macs to clientkeys added by \ref
                                                    //!< BridgeFinder::addClientKey
+    std::shared_ptr<std::mutex> mapMutex; //!< Protects usernames and clientkeys, shared by copies
     std::shared_ptr<const IHttpHandler> http_handler;
 };
 
@@ -147,6 +152,51 @@ public:
     using RuleList = CreateableResourceList<ResourceList<Rule, int>, CreateRule>;
 
 public:
+    //! \brief Sections of the bridge state, which can be loaded selectively with setSections()
+    enum class Section
+    {
+        config, //!< config()
+        lights, //!< lights()
+        groups, //!< groups()
+        schedules, //!< schedules()
+        scenes, //!< scenes()
+        sensors, //!< sensors()
+        rules //!< rules()
+    };
+
+    //! \brief How bootstrap() requests the initial state
+    enum class LoadMode
+    {
+        fullState, //!< One request for the full state, which contains all lists
+        perList //!< One request per list, for bridges with a full state too large to request at once
+    };
+
+    //! \brief Time it took to load one list in bootstrap()
+    struct ListTiming
+    {
+        //! \brief Name of the list in the API, for example "lights"
+        std::string name;
+        //! \brief Duration of the request, including the wait for the request delay.
+        //!
+        //! With LoadMode::fullState, all lists are loaded by the same request and have its duration.
+        std::chrono::steady_clock::duration duration;
+        //! \brief Number of resources in the list, 1 for "config" when it was returned
+        std::size_t count;
+    };
+
+    //! \brief Result of bootstrap()
+    struct LoadReport
+    {
+        //! \brief Mode that was used
+        LoadMode mode;
+        //! \brief Total duration of all requests
+        std::chrono::steady_clock::duration total;
+        //! \brief Timings of config, lights, groups, schedules, scenes, sensors and rules, in that order.
+        //!
+        //! Only contains the sections selected with setSections().
+        std::vector<ListTiming> lists;
+    };
+
     //! \brief Constructor of Bridge class
     //!
     //! \param ip IP address in dotted decimal notation like "192.168.2.1"
@@ -172,6 +222,73 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     void refresh();
 
+    //! \brief Loads the initial state of all lists on the bridge.
+    //! \param mode Whether to request the full state at once or each list separately
+    //! \returns Timings of the requests and number of resources per list
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws HueAPIResponseException when response contains an error
+    //! \throws nlohmann::json::parse_error when response could not be parsed
+    //!
+    //! Afterwards all lists are up to date, so the first access to any of them does not send a request.
+    //! With LoadMode::perList, the requests are sent one after another, paced by the request delay of the bridge.
+    //! When one of them fails, the lists loaded before are kept, but the bridge state is not marked as up to date.
+    //! When only some sections are loaded (see setSections()), always uses LoadMode::perList.
+    //! To load multiple bridges in parallel, use BridgeManager::bootstrapAll().
+    LoadReport bootstrap(LoadMode mode = LoadMode::fullState);
+
+    //! \brief Restrict the sections of the bridge state which are loaded.
+    //! \param sections Sections to load, or empty to load all of them
+    //!
+    //! By default, a refresh requests the full state of the bridge, including all scenes, rules, schedules and
+    //! resource links. When only some sections are used, the others take up most of the transfer and memory.
+    //! With restricted sections, refreshes request each selected section on its own and
+    //! sections which are not selected are removed from the cache.
+    //! Accessing the list of a section which is not selected throws HueException.
+    //!
+    //! Should be called before the bridge is used, must not run concurrently with other calls on the bridge.
+    void setSections(const std::vector<Section>& sections);
+
+    //! \brief Get the sections of the bridge state which are loaded.
+    //! \returns Sections passed to setSections(), empty when all sections are loaded
+    std::vector<Section> getSections() const;
+
+    //! \brief Set the members of the bridge state which are kept.
+    //! \param filter Paths relative to the full state, like <tt>"lights/*/state"</tt>
+    //!
+    //! All responses of the bridge state, lists and resources are filtered while parsing with the part of
+    //! \c filter below their path, so dropped members are never stored. This reduces the memory for a large
+    //! state on constrained devices. Functions which need a dropped member throw or return default values,
+    //! so keep all members that are used. Lights need at least \c type, \c modelid and \c state,
+    //! and \c capabilities/control for color lights.
+    //! Requests of resources which are not part of the bridge state, like new devices, are not filtered.
+    //!
+    //! Should be called before the bridge is used, must not run concurrently with other calls on the bridge.
+    void setFilter(const JsonFilter& filter);
+
+    //! \brief Get the filter set with setFilter()
+    JsonFilter getFilter() const;
+
+    //! \brief Keep the resources of the bridge state encoded until they are accessed.
+    //! \param compact Whether to encode every resource on its own, see APICache::setCompactDepth()
+    //!
+    //! Reduces the memory for resources which are cached, but rarely used. A resource is decoded when
+    //! it or its list is accessed and stays decoded until compactState(), even across refreshes.
+    //! Works best with shared state, because otherwise every resource keeps its own decoded copy.
+    void setCompactState(bool compact);
+
+    //! \brief Encode all resources which were decoded.
+    //!
+    //! Has no effect unless enabled with setCompactState().
+    //! Must not run concurrently with code that holds references into the state, see \ref concurrency.
+    void compactState();
+
+    //! \brief Parse state refreshes into a reused arena instead of the heap.
+    //! \param enabled Whether to parse responses into an arena, see APICache::setArenaParsing()
+    //!
+    //! Reduces the heap allocations of frequent refreshes, because only changed members are copied into the state.
+    void setArenaParsing(bool enabled);
+
     //! \brief Sets refresh interval for the whole bridge state.
     //! \param refreshDuration The new minimum duration between refreshes. May be 0 or \ref c_refreshNever.
     //! 
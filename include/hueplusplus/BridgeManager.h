@@ -0,0 +1,182 @@
+/**
+    \file BridgeManager.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_BRIDGE_MANAGER_H
+#define INCLUDE_HUEPLUSPLUS_BRIDGE_MANAGER_H
+
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Bridge.h"
+#include "Executor.h"
+
+namespace hueplusplus
+{
+//! \brief Identifies a light across all bridges of a BridgeManager
+struct LightHandle
+{
+    //! \brief Name of the bridge in the BridgeManager
+    std::string bridge;
+    //! \brief Id of the light on the bridge
+    int id = 0;
+
+    //! \brief Get string representation "<bridge>/<id>"
+    std::string toString() const;
+
+    //! \brief Equality comparison
+    bool operator==(const LightHandle& other) const { return id == other.id && bridge == other.bridge; }
+    //! \brief Inequality comparison
+    bool operator!=(const LightHandle& other) const { return !(*this == other); }
+    //! \brief Order by bridge name, then by id
+    bool operator<(const LightHandle& other) const
+    {
+        return bridge < other.bridge || (bridge == other.bridge && id < other.id);
+    }
+};
+
+//! \brief Owns multiple bridges and runs their requests on a shared Executor
+//!
+//! Every bridge has its own strand on the executor: Tasks for one bridge run one after another,
+//! so they respect the request rate limit of the bridge, while different bridges are used in parallel.
+//! With at least as many threads as bridges, no bridge waits for another.
+//!
+//! Bridges can still be used directly from any thread, see \ref concurrency.
+//! Adding and removing bridges is also thread safe, but removeBridge() must not be called from a task.
+class BridgeManager
+{
+public:
+    //! \brief Command which is run on a light by forEachLight()
+    using LightCommand = std::function<bool(Light&)>;
+
+    //! \brief Creates manager without bridges
+    //! \param threadCount Number of threads of the executor
+    explicit BridgeManager(std::size_t threadCount = Executor::defaultThreadCount());
+    BridgeManager(const BridgeManager&) = delete;
+    BridgeManager& operator=(const BridgeManager&) = delete;
+
+    //! \brief Add a bridge
+    //! \param name Unique name of the bridge, for example its MAC address
+    //! \param bridge Bridge to add
+    //! \returns Reference to the added bridge, which stays valid until the bridge is removed
+    //! \throws HueException when a bridge with the same name exists
+    Bridge& addBridge(const std::string& name, Bridge bridge);
+
+    //! \brief Remove a bridge
+    //! \param name Name of the bridge
+    //! \returns true when the bridge was removed, false when it does not exist
+    //!
+    //! Waits until all tasks posted for the bridge have run.
+    //! Tasks submitted while the bridge is removed may still run afterwards, they keep the bridge alive until then.
+    bool removeBridge(const std::string& name);
+
+    //! \brief Get a bridge
+    //! \param name Name of the bridge
+    //! \throws HueException when the bridge does not exist
+    Bridge& getBridge(const std::string& name);
+
+    //! \brief Check whether a bridge exists
+    bool hasBridge(const std::string& name) const;
+
+    //! \brief Get names of all bridges in ascending order
+    std::vector<std::string> getBridgeNames() const;
+
+    //! \brief Get the executor which runs the tasks
+    Executor& getExecutor();
+
+    //! \brief Run a function on the strand of a bridge
+    //! \param name Name of the bridge
+    //! \param f Function taking a Bridge&
+    //! \returns Future of the return value, contains the exception if \c f throws
+    //! \throws HueException when the bridge does not exist
+    template <typename F>
+    auto submit(const std::string& name, F f) -> std::future<decltype(f(std::declval<Bridge&>()))>
+    {
+        std::pair<std::shared_ptr<Bridge>, std::size_t> entry = getEntry(name);
+        std::shared_ptr<Bridge> bridge = std::move(entry.first);
+        return executor.submit(entry.second, [bridge, f]() { return f(*bridge); });
+    }
+
+    //! \brief Refresh all bridges in parallel
+    //!
+    //! Waits until all bridges are refreshed.
+    //! \throws The first exception thrown by a refresh, after all refreshes are finished.
+    //! See Bridge::refresh() for possible exceptions.
+    void refreshAll();
+
+    //! \brief Load the initial state of all bridges in parallel
+    //! \param mode Mode passed to Bridge::bootstrap()
+    //! \returns Reports of all bridges by name
+    //!
+    //! Waits until all bridges are loaded.
+    //! \throws The first exception thrown by a bridge, after all bridges are finished.
+    //! See Bridge::bootstrap() for possible exceptions.
+    std::map<std::string, Bridge::LoadReport> bootstrapAll(Bridge::LoadMode mode = Bridge::LoadMode::fullState);
+
+    //! \brief Get all lights of all bridges
+    //! \returns Handles of all lights, ordered by bridge name and id
+    //!
+    //! The light lists are requested in parallel if necessary, waits until all are finished.
+    //! \throws The first exception thrown by a bridge, after all bridges are finished.
+    //! See ResourceList::getAll() for possible exceptions.
+    std::vector<LightHandle> getAllLights();
+
+    //! \brief Get a light
+    //! \param handle Handle of the light
+    //! \throws HueException when the bridge or the light does not exist
+    //! \see ResourceList::get()
+    ResourceHandle<Light> getLight(const LightHandle& handle);
+
+    //! \brief Run a command on multiple lights
+    //! \param lights Handles of the lights
+    //! \param command Command to run on each light, for example sending a transaction
+    //! \returns Futures of the command results, in the order of \c lights.
+    //! A future contains the exception if the bridge, the light or the command failed.
+    //!
+    //! Commands for lights on the same bridge run one after another on its strand,
+    //! commands for different bridges run in parallel. Does not wait for the commands.
+    std::vector<std::future<bool>> forEachLight(const std::vector<LightHandle>& lights, LightCommand command);
+
+private:
+    struct Entry
+    {
+        //! Shared with submitted tasks, so they can still run when the bridge is removed
+        std::shared_ptr<Bridge> bridge;
+        std::size_t strand;
+    };
+
+    std::pair<std::shared_ptr<Bridge>, std::size_t> getEntry(const std::string& name) const;
+
+private:
+    mutable std::mutex mutex;
+    std::map<std::string, Entry> bridges;
+    std::size_t nextStrand = 0;
+    //! Declared last, so remaining tasks run before the bridges are destroyed
+    Executor executor;
+};
+} // namespace hueplusplus
+
+#endif
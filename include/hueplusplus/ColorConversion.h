@@ -0,0 +1,54 @@
+/**
+    \file ColorConversion.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_COLOR_CONVERSION_H
+#define INCLUDE_HUEPLUSPLUS_COLOR_CONVERSION_H
+
+#include <cstddef>
+
+#include "ColorUnits.h"
+
+namespace hueplusplus
+{
+//! \brief Convert many RGB colors to XYBrightness at once
+//!
+//! Converts a whole frame of colors, for example for all lights of an EntertainmentMode,
+//! with the same formula as RGB::toXY(). The gamma correction uses srgb::toLinear() and
+//! the color matrix is applied to four colors at once with SSE2 or NEON, if available.
+//! Define \c HUEPLUSPLUS_NO_SIMD when building the library to always use scalar code.
+//! \param rgb Colors to convert
+//! \param count Number of colors
+//! \param result Array for \c count converted colors
+//! \param gamuts Gamut of each color to clip to, or nullptr to not clip the colors
+void convertToXY(const RGB* rgb, std::size_t count, XYBrightness* result, const ColorGamut* gamuts = nullptr);
+
+//! \brief Convert many XYBrightness colors to RGB at once
+//!
+//! Converts a whole frame of colors with the same formula as RGB::fromXY(). The gamma correction uses
+//! srgb::fromLinear(), the results can differ by one from RGB::fromXY().
+//! \param xy Colors to convert
+//! \param count Number of colors
+//! \param result Array for \c count converted colors
+//! \param gamuts Gamut of each color to clip to, or nullptr to not clip the colors
+void convertToRGB(const XYBrightness* xy, std::size_t count, RGB* result, const ColorGamut* gamuts = nullptr);
+} // namespace hueplusplus
+
+#endif
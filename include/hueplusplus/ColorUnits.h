@@ -24,6 +24,7 @@
 #define INCLUDE_HUEPLUSPLUS_UNITS_H
 
 #include <cstdint>
+#include <vector>
 
 namespace hueplusplus
 {
@@ -105,6 +106,38 @@ constexpr ColorGamut gamutC {{0.692f, 0.308f}, {0.17f, 0.7f}, {0.153f, 0.048f}};
 constexpr ColorGamut maxGamut {{1.f, 0.f}, {0.f, 1.f}, {0.f, 0.f}};
 } // namespace gamut
 
+//! \brief Method of the sRGB gamma correction in RGB conversions
+enum class GammaCorrection
+{
+    exact, //!< Calculate the gamma curve with pow
+    table //!< Use lookup tables, see srgb::toLinear() and srgb::fromLinear()
+};
+
+//! \brief Gamma correction of sRGB colors
+namespace srgb
+{
+//! \brief Convert a color channel to linear intensity with the sRGB gamma curve
+//! \param value Channel value from 0 to 1
+float toLinearExact(float value);
+//! \brief Convert an 8 bit color channel to linear intensity from 0 to 1
+//!
+//! Uses a table of all 256 values, so the result is the same as toLinearExact().
+float toLinear(uint8_t value);
+
+//! \brief Convert linear intensity to a color channel with the sRGB gamma curve
+//! \param value Linear intensity, may be larger than 1
+float fromLinearExact(float value);
+//! \brief Convert linear intensity to a color channel with a lookup table
+//!
+//! Interpolates in a table of the gamma curve. The relative difference to fromLinearExact() is below 1e-5.
+//! \param value Linear intensity, may be larger than 1
+float fromLinear(float value);
+
+//! \brief Convert linear color channels to CIE xy coordinates, with the same formula as RGB::toXY()
+//! \note The result is undefined for black.
+XY linearToXY(float red, float green, float blue);
+} // namespace srgb
+
 //! \brief Color in RGB
 struct RGB
 {
@@ -121,11 +154,15 @@ struct RGB
     //! \brief Convert to XYBrightness without clamping
     //!
     //! Performs gamma correction so the light color matches the screen color better.
-    XYBrightness toXY() const;
+    //! \param gamma Method of the gamma correction, both have the same result
+    XYBrightness toXY(GammaCorrection gamma = GammaCorrection::exact) const;
     //! \brief Convert to XYBrightness and clip to \c gamut
     //!
     //! Performs gamma correction so the light color matches the screen color better.
-    XYBrightness toXY(const ColorGamut& gamut) const;
+    //! \param gamut Gamut to clip to
+    //! \param gamma Method of the gamma correction, both have the same result
+    //! \see GamutTable to convert many colors for the same gamut
+    XYBrightness toXY(const ColorGamut& gamut, GammaCorrection gamma = GammaCorrection::exact) const;
 
     //! \brief Convert to HueSaturation
     //!
@@ -137,7 +174,9 @@ struct RGB
     //! Performs gamma correction so the light color matches the screen color better.
     //! \note The conversion formula is not exact, it can be off by up to 9 for each channel.
     //! This is because the color luminosity is not saved.
-    static RGB fromXY(const XYBrightness& xy);
+    //! \param xy Color to convert
+    //! \param gamma Method of the gamma correction, GammaCorrection::table can differ by 1 for each channel
+    static RGB fromXY(const XYBrightness& xy, GammaCorrection gamma = GammaCorrection::exact);
     //! \brief Create from XYBrightness and clip to \c gamut
     //!
     //! A light may have XY set out of its range. Then this function returns the actual color
@@ -145,7 +184,48 @@ struct RGB
     //! Performs gamma correction so the light color matches the screen color better.
     //! \note The conversion formula is not exact, it can be off by up to 9 for each channel.
     //! This is because the color luminosity is not saved.
-    static RGB fromXY(const XYBrightness& xy, const ColorGamut& gamut);
+    //! \param xy Color to convert
+    //! \param gamut Gamut to clip to
+    //! \param gamma Method of the gamma correction, GammaCorrection::table can differ by 1 for each channel
+    static RGB fromXY(
+        const XYBrightness& xy, const ColorGamut& gamut, GammaCorrection gamma = GammaCorrection::exact);
+};
+
+//! \brief Precomputed conversion from RGB to XYBrightness clipped to one gamut
+//!
+//! The xy coordinates only depend on the ratios of the linear color channels. The table stores
+//! the clipped xy coordinates for a grid of these ratios and interpolates between them.
+//! This avoids the gamma calculation and the gamut check for every color, which is useful when
+//! many colors are converted for the same gamut, e.g. for every frame in entertainment mode.
+//! Colors near the borders of the gamut correction are converted without the table.
+//! The table takes about 100 kB of memory.
+class GamutTable
+{
+public:
+    //! \brief Calculates the table for \c gamut
+    explicit GamutTable(const ColorGamut& gamut);
+
+    //! \brief Get the gamut of the table
+    const ColorGamut& getGamut() const;
+
+    //! \brief Convert to XYBrightness clipped to the gamut
+    //!
+    //! Same as RGB::toXY(const ColorGamut&) const, but x and y differ by less than 2e-4.
+    XYBrightness toXY(const RGB& rgb) const;
+
+private:
+    //! \brief Clip xy to the gamut
+    XY corrected(const XY& xy) const;
+
+private:
+    //! Number of grid points for each ratio
+    static constexpr int gridSize = 65;
+
+    ColorGamut gamut;
+    //! xy for each brightest channel (red, green, blue) and ratios of the two following channels
+    std::vector<XY> grid;
+    //! Whether the cell starting at the grid point can be interpolated
+    std::vector<bool> interpolated;
 };
 
 //! \brief Const function that converts Kelvin to Mired.
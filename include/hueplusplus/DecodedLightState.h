@@ -0,0 +1,73 @@
+/**
+    \file DecodedLightState.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_DECODED_LIGHT_STATE_H
+#define INCLUDE_HUEPLUSPLUS_DECODED_LIGHT_STATE_H
+
+#include <cstdint>
+
+#include "ColorUnits.h"
+
+#include <nlohmann/json.hpp>
+
+namespace hueplusplus
+{
+//! \brief Color mode that is currently used by a light
+enum class ColorMode : uint8_t
+{
+    NONE, //!< Light has no color mode or it is unknown
+    HUE_SATURATION, //!< Color is set by hue and saturation ("hs")
+    XY, //!< Color is set in CIE xy ("xy")
+    TEMPERATURE //!< Color is set by color temperature ("ct")
+};
+
+//! \brief Light state decoded into plain values
+//!
+//! Contains the values of the \c state object of a light, so they can be read
+//! without looking up json members every time.
+//! Values that are not present in the state are zero.
+struct DecodedLightState
+{
+    //! \brief Color in CIE xy
+    XY xy;
+    //! \brief Color hue from 0 to 65535
+    uint16_t hue;
+    //! \brief Color temperature in mired
+    uint16_t ct;
+    //! \brief Brightness from 0 to 254
+    uint8_t bri;
+    //! \brief Saturation from 0 to 254
+    uint8_t sat;
+    //! \brief Active color mode
+    ColorMode colormode;
+    //! \brief Whether the light is on
+    bool on;
+    //! \brief Whether the light is reachable by the bridge
+    bool reachable;
+
+    //! \brief Parse from the \c state object of a light
+    //! \param state Light state json (only the "state" part of the light)
+    //! \throws nlohmann::json::type_error when a value has the wrong type
+    static DecodedLightState parse(const nlohmann::json& state);
+};
+} // namespace hueplusplus
+
+#endif
@@ -0,0 +1,167 @@
+/**
+    \file EffectTimeline.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_EFFECT_TIMELINE_H
+#define INCLUDE_HUEPLUSPLUS_EFFECT_TIMELINE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ColorUnits.h"
+
+namespace hueplusplus
+{
+//! \brief Curve of the transition from one keyframe to the next
+enum class Easing
+{
+    step, //!< Keep the color until the next keyframe
+    linear, //!< Constant speed
+    easeIn, //!< Start slow, cubic
+    easeOut, //!< End slow, cubic
+    easeInOut //!< Start and end slow, cubic
+};
+
+//! \brief Timeline of colors for the lights of an EntertainmentMode
+//!
+//! Effects like fades, chases and waves are described by keyframes for each light.
+//! Between two keyframes, the color is interpolated in the Oklab color space, so the brightness
+//! and hue change evenly for the eye. The easing of a keyframe applies to the transition to the next keyframe.
+//! Before the first keyframe of a light, it has the color of the first keyframe,
+//! after the last keyframe the color of the last one.
+//!
+//! evaluate() writes the colors of all lights for one point in time into a HueStream message
+//! without allocating memory, so it can be called for every frame. render() creates frames in advance.
+class EffectTimeline
+{
+public:
+    //! \brief Constructor
+    //! \param lightCount Number of lights, the same as in the entertainment group
+    explicit EffectTimeline(std::size_t lightCount);
+
+    //! \brief Get number of lights
+    std::size_t getLightCount() const;
+
+    //! \brief Add a keyframe for a light
+    //!
+    //! A keyframe at the same time as an existing one is inserted after it,
+    //! so the color jumps at that time.
+    //! \param lightIndex Index of the light in the group
+    //! \param time Time of the keyframe from the start of the timeline
+    //! \param color Color of the light at \c time
+    //! \param easing Curve of the transition to the next keyframe
+    //! \throws HueException when lightIndex is invalid
+    void addKeyframe(std::size_t lightIndex, std::chrono::steady_clock::duration time, const RGB& color,
+        Easing easing = Easing::linear);
+
+    //! \brief Remove all keyframes of a light
+    //! \throws HueException when lightIndex is invalid
+    void clear(std::size_t lightIndex);
+
+    //! \brief Remove all keyframes
+    void clear();
+
+    //! \brief Get number of keyframes of a light
+    //! \throws HueException when lightIndex is invalid
+    std::size_t getKeyframeCount(std::size_t lightIndex) const;
+
+    //! \brief Repeat the timeline
+    //! \param duration Length of one repetition, or zero to not repeat
+    void setLoopDuration(std::chrono::steady_clock::duration duration);
+
+    //! \brief Get the length of one repetition, or zero when not repeating
+    std::chrono::steady_clock::duration getLoopDuration() const;
+
+    //! \brief Get the color of a light at a point in time
+    //! \param lightIndex Index of the light in the group
+    //! \param time Time from the start of the timeline
+    //! \returns Interpolated color, or black when the light has no keyframes
+    //! \throws HueException when lightIndex is invalid
+    RGB getColor(std::size_t lightIndex, std::chrono::steady_clock::duration time) const;
+
+    //! \brief Write the colors of all lights at a point in time into a message
+    //!
+    //! The color space of the message is kept. RGB colors are sent with 16 bit precision, xy colors are corrected
+    //! to the gamut of the light. Lights without keyframes are not changed. When the message and the timeline
+    //! have a different number of lights, only the lights present in both are written.
+    //! \param time Time from the start of the timeline
+    //! \param message HueStream message, see huestream::createMessage()
+    //! \param gamuts Gamut of each light in the message, or nullptr to not correct xy colors
+    void evaluate(std::chrono::steady_clock::duration time, std::vector<uint8_t>& message,
+        const ColorGamut* gamuts = nullptr) const;
+
+    //! \brief Render frames at a fixed rate into a buffer
+    //!
+    //! Each frame is a copy of \c message evaluated at its time. The frames are appended
+    //! to \c output one after another, so they can be tested or sent later.
+    //! \param start Time of the first frame
+    //! \param period Time between two frames
+    //! \param count Number of frames
+    //! \param message HueStream message with the light ids and color space
+    //! \param output Buffer the frames are appended to
+    //! \param gamuts Gamut of each light in the message, or nullptr to not correct xy colors
+    void render(std::chrono::steady_clock::duration start, std::chrono::steady_clock::duration period,
+        std::size_t count, const std::vector<uint8_t>& message, std::vector<uint8_t>& output,
+        const ColorGamut* gamuts = nullptr) const;
+
+private:
+    //! \brief Color in the Oklab color space
+    struct Lab
+    {
+        float l;
+        float a;
+        float b;
+    };
+    //! \brief Color with linear intensity from 0 to 1
+    struct Linear
+    {
+        float red;
+        float green;
+        float blue;
+    };
+    struct Keyframe
+    {
+        std::chrono::steady_clock::duration time;
+        //! \brief Color of the keyframe, so it is kept exactly without interpolation
+        Linear color;
+        //! \brief Color for the interpolation
+        Lab lab;
+        Easing easing;
+    };
+
+private:
+    //! \brief Check the light index and throw
+    void checkIndex(std::size_t lightIndex) const;
+    //! \brief Interpolate the color of one light, which has keyframes
+    Linear interpolate(const std::vector<Keyframe>& keyframes, std::chrono::steady_clock::duration time) const;
+    //! \brief Convert linear sRGB to Oklab
+    static Lab toLab(float red, float green, float blue);
+    //! \brief Convert Oklab to linear sRGB, clamped from 0 to 1
+    static Linear fromLab(const Lab& lab);
+
+private:
+    std::vector<std::vector<Keyframe>> lights;
+    std::chrono::steady_clock::duration loopDuration;
+};
+} // namespace hueplusplus
+
+#endif
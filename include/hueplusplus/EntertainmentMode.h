@@ -24,12 +24,26 @@
 #define INCLUDE_HUEPLUSPLUS_HUE_ENTERTAINMENT_MODE_H
 
 #include "Bridge.h"
+#include "ColorUnits.h"
+#include "EffectTimeline.h"
 #include "Group.h"
+#include "HueStream.h"
+#include "SpatialMapping.h"
+#include "StreamCoordinator.h"
+#include "StreamingEngine.h"
 
 namespace hueplusplus
 {
 struct TLSContext;
 
+//! \brief State of the connection of an EntertainmentMode
+enum class ConnectionState
+{
+    disconnected, //!< Not connected, or the connection failed
+    handshaking, //!< The DTLS handshake of a connect or reconnect is in progress
+    connected //!< Ready to send colors
+};
+
 //! \brief Class for Hue Entertainment Mode
 //!
 //! Provides methods to initialize and control Entertainment groups.
@@ -40,20 +54,77 @@ public:
     //!
     //! \param b Bridge reference
     //! \param g Group to control in entertainment mode reference
+    //! \param colorSpace Color space of the sent colors. With huestream::ColorSpace::xyBrightness,
+    //! colors are corrected to the gamut of each light.
     //! 
     //! \note References are held to both \c b and \c g. 
     //! They must stay valid until EntertainmentMode ist destroyed.
-    EntertainmentMode(Bridge& b, Group& g);
+    EntertainmentMode(Bridge& b, Group& g, huestream::ColorSpace colorSpace = huestream::ColorSpace::rgb);
+
+    //! \brief Constructor for the HueStream version 2 protocol
+    //!
+    //! The frames address the channels of an entertainment configuration instead of lights,
+    //! which allows more channels per frame on newer bridges. The light indices of all methods are then
+    //! the positions in \c channelIds. The gamut of all channels is gamut::gamutC, see \ref setColorGamut.
+    //! \param b Bridge reference
+    //! \param g Group to control in entertainment mode reference, used to start streaming
+    //! \param configurationId Id of the entertainment configuration of the group, a UUID with 36 characters
+    //! \param channelIds Ids of the channels in the entertainment configuration
+    //! \param colorSpace Color space of the sent colors
+    //! \throws HueException when configurationId does not have 36 characters
+    //!
+    //! \note References are held to both \c b and \c g.
+    //! They must stay valid until EntertainmentMode ist destroyed.
+    EntertainmentMode(Bridge& b, Group& g, const std::string& configurationId, const std::vector<uint8_t>& channelIds,
+        huestream::ColorSpace colorSpace = huestream::ColorSpace::rgb);
 
     //! \brief Destroy the Entertainment Mode object
     ~EntertainmentMode();
 
     //! \brief Connect and start streaming
     //!
+    //! Blocks until the DTLS handshake is finished, at most for Config::getEntertainmentHandshakeTimeout().
+    //! When connected, the last frame is sent again when no frame was sent for
+    //! Config::getEntertainmentKeepAliveInterval(), so the bridge does not close the connection.
     //! \return true If conected and ready to receive commands
     //! \return false If an error occured
     bool connect();
 
+    //! \brief Start to connect without blocking
+    //!
+    //! Enables streaming on the bridge and sets up the socket, the handshake is done by \ref pollConnect.
+    //! \return true If the handshake was started
+    //! \return false If an error occured or already connected
+    bool startConnect();
+
+    //! \brief Continue the handshake started by \ref startConnect or a reconnect without blocking
+    //!
+    //! Must be called until it does not return ConnectionState::handshaking anymore.
+    //! A reconnect is also continued by sending.
+    //! When the handshake is not finished within Config::getEntertainmentHandshakeTimeout(),
+    //! the connection fails.
+    //! \return State of the connection after the received messages were processed
+    ConnectionState pollConnect();
+
+    //! \brief Get the state of the connection
+    ConnectionState getConnectionState() const;
+
+    //! \brief Connect again after the connection was lost
+    //!
+    //! Resumes the previous DTLS session if the bridge allows it, which is faster than a full handshake.
+    //! Blocks until the handshake is finished, like \ref connect.
+    //! A reconnect is started automatically when sending fails or the bridge closed the connection.
+    //! It does not block: the state is ConnectionState::handshaking and every send or \ref pollConnect
+    //! continues the handshake, frames are dropped until it is finished. When a reconnect is in progress,
+    //! this function waits for it. It is only needed to wait for a reconnect or after one failed.
+    //! The group must still be streaming on the bridge, otherwise use \ref connect.
+    //! \return true If connected again
+    //! \return false If the handshake failed or \ref connect did not succeed before
+    bool reconnect();
+
+    //! \brief Get number of reconnects since construction, including the automatic ones
+    std::size_t getReconnectCount() const;
+
     //! \brief Disconnect and stop streaming
     //!
     //! \return true If disconnected successfully
@@ -68,22 +139,179 @@ public:
     //! \param blue Blue color value (0-255)
     //! \return true If light_index was valid
     //! \return false If light_index was invalid
-    bool setColorRGB(uint8_t light_index, uint8_t red, uint8_t green, uint8_t blue);
+    bool setColorRGB(std::size_t light_index, uint8_t red, uint8_t green, uint8_t blue);
+
+    //! \brief Set the color of the given light in RGB format with 16 bit precision
+    //!
+    //! \param light_index Light index inside the group
+    //! \param red Red color value (0-65535)
+    //! \param green Green color value (0-65535)
+    //! \param blue Blue color value (0-65535)
+    //! \return true If light_index was valid
+    //! \return false If light_index was invalid
+    //! \throws HueException when the color space is not huestream::ColorSpace::rgb
+    bool setColorRGB16(std::size_t light_index, uint16_t red, uint16_t green, uint16_t blue);
+
+    //! \brief Set the color of the given light in CIE xy coordinates and brightness
+    //!
+    //! The color is corrected to the gamut of the light. With huestream::ColorSpace::xyBrightness,
+    //! the values are sent with 16 bit precision, otherwise they are converted to 8 bit RGB.
+    //! \param light_index Light index inside the group
+    //! \param xy Color and brightness
+    //! \return true If light_index was valid
+    //! \return false If light_index was invalid
+    bool setColorXY(std::size_t light_index, const XYBrightness& xy);
+
+    //! \brief Set the colors of consecutive lights in RGB format
+    //!
+    //! Faster than calling \ref setColorRGB for each light. With huestream::ColorSpace::xyBrightness,
+    //! the colors are converted with convertToXY() and corrected to the gamut of each light.
+    //! \param colors Colors of the lights from \c first to <tt>first + count - 1</tt>
+    //! \param count Number of colors
+    //! \param first Light index of the first color
+    //! \return true If all light indices were valid
+    //! \return false If <tt>first + count</tt> is greater than the number of lights, nothing is changed
+    bool setColorsRGB(const RGB* colors, std::size_t count, std::size_t first = 0);
+
+    //! \brief Set the colors of consecutive lights in CIE xy coordinates and brightness
+    //!
+    //! Faster than calling \ref setColorXY for each light. The colors are corrected to the gamut of each light.
+    //! Without huestream::ColorSpace::xyBrightness, they are converted with convertToRGB().
+    //! \param colors Colors of the lights from \c first to <tt>first + count - 1</tt>
+    //! \param count Number of colors
+    //! \param first Light index of the first color
+    //! \return true If all light indices were valid
+    //! \return false If <tt>first + count</tt> is greater than the number of lights, nothing is changed
+    bool setColorsXY(const XYBrightness* colors, std::size_t count, std::size_t first = 0);
+
+    //! \brief Set the channels of consecutive lights without any conversion
+    //!
+    //! The channels are copied into the message like huestream::setChannels(), which is the fastest way
+    //! to fill a frame. They are red, green and blue or x, y and brightness with 16 bits each,
+    //! depending on \ref getColorSpace. They are not corrected to the gamuts of the lights.
+    //! \param channels Three channels for each light from \c first to <tt>first + count - 1</tt>
+    //! \param count Number of lights
+    //! \param first Light index of the first channels
+    //! \return true If all light indices were valid
+    //! \return false If <tt>first + count</tt> is greater than the number of lights, nothing is changed
+    bool setChannels(const uint16_t* channels, std::size_t count, std::size_t first = 0);
+
+    //! \brief Get number of lights in the group
+    std::size_t getLightCount() const;
+
+    //! \brief Get ids of the lights in the group, the position of an id is its light index
+    //!
+    //! With the HueStream version 2 protocol, these are the channel ids.
+    const std::vector<int>& getLightIds() const;
+
+    //! \brief Get the color space of the sent colors
+    huestream::ColorSpace getColorSpace() const;
+
+    //! \brief Get the gamut of the given light
+    //!
+    //! \param light_index Light index inside the group
+    //! \throws HueException when light_index is invalid
+    ColorGamut getColorGamut(std::size_t light_index) const;
+
+    //! \brief Set the gamut of the given light
+    //!
+    //! The gamuts are initialized from the lights of the group, so this is only needed
+    //! when the light reports a wrong gamut.
+    //! \param light_index Light index inside the group
+    //! \param gamut Gamut the colors are corrected to
+    //! \throws HueException when light_index is invalid
+    void setColorGamut(std::size_t light_index, const ColorGamut& gamut);
 
     //! \brief Update all set colors by \ref setColorRGB
     //!
+    //! When sending at a fixed rate with \ref startSending, the colors are only published
+    //! and sent by the sender thread at its next send time. This never blocks.
     //! \return true If all color values for all lights have ben written/sent
-    //! \return false If there was an error while writing
+    //! \return false If there was an error while writing, or a reconnect is not finished yet
     bool update();
 
+    //! \brief Set the colors of all lights from a timeline and update
+    //!
+    //! Lights without keyframes keep their colors. In huestream::ColorSpace::xyBrightness,
+    //! the colors are corrected to the gamut of each light.
+    //! \param timeline Effect with keyframes for the lights of the group
+    //! \param time Time from the start of the effect
+    //! \return Same as \ref update()
+    bool update(const EffectTimeline& timeline, std::chrono::steady_clock::duration time);
+
+    //! \brief Set the colors of all lights from a color grid and update
+    //!
+    //! Each light gets the color of the grid at its location. In huestream::ColorSpace::xyBrightness,
+    //! the colors are converted with 8 bits per channel and corrected to the gamut of each light.
+    //! \param mapping Mapping created from the locations of the lights, see Group::getLightLocations()
+    //! \param grid Colors of the entertainment area, with the size of the mapping
+    //! \return Same as \ref update()
+    //! \throws HueException when the mapping does not have the number of lights of the group
+    //! or the grid does not have the size of the mapping
+    bool update(const SpatialMapping& mapping, const ColorGrid& grid);
+
+    //! \brief Start sending the colors at a fixed rate from a separate thread
+    //!
+    //! The last updated colors are sent repeatedly at the given rate, independent of how often
+    //! \ref update is called. \ref setColorRGB and \ref update must then only be called from one thread at a time.
+    //! \param rate Frames per second, 25, 50 or 60 are recommended
+    //! \throws HueException when rate is not positive or already sending
+    //! \note Must be connected with \ref connect first.
+    void startSending(int rate = 50);
+
+    //! \brief Start sending the colors together with other sessions
+    //!
+    //! The colors are sent by the sender thread of the coordinator, at the same time as the colors of the
+    //! other EntertainmentMode%s which use it. \ref update only publishes the colors of this group,
+    //! use StreamCoordinator::publish() after updating all groups to send them in the same frame.
+    //! \param coordinator Coordinator which is started separately. It must stay valid until \ref stopSending.
+    //! \throws HueException when already sending
+    //! \note Must be connected with \ref connect first.
+    void startSending(StreamCoordinator& coordinator);
+
+    //! \brief Stop sending at a fixed rate
+    //!
+    //! Colors are sent by \ref update again afterwards. Also done by \ref disconnect.
+    void stopSending();
+
+    //! \brief Check whether the colors are sent at a fixed rate
+    bool isSending() const;
+
+    //! \brief Get statistics of the sender thread since \ref startSending
+    //!
+    //! Contains send jitter and dropped frames, see StreamStatistics.
+    StreamStatistics getStreamStatistics() const;
+
+private:
+    //! \brief Initialize the mbedtls contexts, called by the constructors
+    void initTLSContext();
+    //! \brief Get message which is written by \ref setColorRGB
+    std::vector<uint8_t>& getMessage();
+    //! \brief Send a message over the connection
+    bool send(const std::vector<uint8_t>& msg);
+    //! \brief Send a message and start a reconnect when the connection was lost, the tls mutex must be locked
+    bool sendLocked(const std::vector<uint8_t>& msg);
+    //! \brief Continue the handshake, the tls mutex must be locked
+    ConnectionState pollConnectLocked();
+    //! \brief Start a handshake which resumes the last session, the tls mutex must be locked
+    bool startReconnectLocked();
+    //! \brief Send the last message again, called by the keep alive timer
+    void keepAlive();
+
 protected:
     Bridge* bridge; //!< Associated bridge
     Group* group; //!< Associated group
 
     std::vector<uint8_t> entertainment_msg; //!< buffer containing the entertainment mode packet data
-    uint8_t entertainment_num_lights; //!< number of lights in entertainment mode group
+    std::vector<int> entertainment_light_ids; //!< light ids in the order of the light indices
+    std::size_t entertainment_num_lights; //!< number of lights in entertainment mode group
+    std::vector<ColorGamut> entertainment_gamuts; //!< color gamut of every light in the group
 
     std::unique_ptr<TLSContext> tls_context; //!< tls context
+    std::unique_ptr<StreamingEngine> streaming_engine; //!< sender thread, only present while sending at a fixed rate
+    std::unique_ptr<IdleTimer> keep_alive; //!< resends the last frame when idle, only present while connected
+    StreamCoordinator* coordinator; //!< coordinator which sends the colors, or nullptr
+    std::size_t coordinator_session; //!< session id of this group in the coordinator
 };
 } // namespace hueplusplus
 
@@ -0,0 +1,114 @@
+/**
+    \file Executor.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_EXECUTOR_H
+#define INCLUDE_HUEPLUSPLUS_EXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hueplusplus
+{
+//! \brief Runs tasks on a fixed pool of threads, serialized per strand
+//!
+//! Every task belongs to a strand, identified by a number. Tasks of the same strand run one after another
+//! in order of posting, tasks of different strands run in parallel. Strands with pending tasks take turns,
+//! so one strand with many tasks does not delay the others.
+//! BridgeManager uses one strand per bridge, so requests to a bridge are never sent in parallel
+//! and the rate limit of its HueCommandAPI only delays that bridge.
+//! Exceptions thrown by posted tasks are caught and printed to std::cerr.
+class Executor
+{
+public:
+    //! \brief Task which is run on a worker thread
+    using Task = std::function<void()>;
+
+    //! \brief Creates executor and starts the threads
+    //! \param threadCount Number of worker threads, at least 1
+    explicit Executor(std::size_t threadCount = defaultThreadCount());
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+    //! \brief Runs all tasks which are already posted, then stops the threads
+    ~Executor();
+
+    //! \brief Post a task
+    //! \param strand Strand of the task
+    //! \param task Task to run, may post further tasks
+    void post(std::size_t strand, Task task);
+
+    //! \brief Post a task and get its result
+    //! \param strand Strand of the task
+    //! \param f Function to run, may post further tasks
+    //! \returns Future of the return value, contains the exception if \c f throws
+    template <typename F>
+    auto submit(std::size_t strand, F f) -> std::future<decltype(f())>
+    {
+        // std::function needs a copyable function, so the packaged_task is shared
+        auto task = std::make_shared<std::packaged_task<decltype(f())()>>(std::move(f));
+        std::future<decltype(f())> result = task->get_future();
+        post(strand, [task]() { (*task)(); });
+        return result;
+    }
+
+    //! \brief Get number of worker threads
+    std::size_t getThreadCount() const;
+
+    //! \brief Get number of posted and currently running tasks
+    std::size_t getPendingCount() const;
+
+    //! \brief Block until all posted tasks, including tasks posted by them, have run
+    //! \note Must not be called from a task.
+    void waitIdle();
+
+    //! \brief Default number of threads, the number of hardware threads but at least 4
+    //!
+    //! Tasks of the executor mostly wait for network requests, so more threads than cores are useful.
+    static std::size_t defaultThreadCount();
+
+private:
+    struct Strand
+    {
+        std::deque<Task> tasks;
+        bool running = false;
+    };
+
+    void run();
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    std::map<std::size_t, Strand> strands;
+    //! Strands which have tasks and are not running, in order of their turn
+    std::deque<std::size_t> ready;
+    std::size_t pending = 0;
+    bool stopped = false;
+    std::vector<std::thread> threads;
+};
+} // namespace hueplusplus
+
+#endif
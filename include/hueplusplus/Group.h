@@ -35,6 +35,17 @@
 
 namespace hueplusplus
 {
+//! \brief Position of a light in an entertainment group
+//!
+//! The coordinates are from -1 to 1, as set up in the Hue app.
+//! x goes from left to right, y from back to front and z from the floor to the ceiling.
+struct LightLocation
+{
+    float x;
+    float y;
+    float z;
+};
+
 //! \brief Class for Groups of lights.
 //!
 //! Provides methods to control groups.
@@ -65,6 +76,11 @@ public:
     //! \param refreshDuration The new minimum duration between refreshes. May be 0 or \ref c_refreshNever.
     void setRefreshDuration(std::chrono::steady_clock::duration refreshDuration);
 
+    //! \brief Update the cached state with the state from a newer refresh of the resource list
+    //! \param listState State of this group in the list
+    //! \param refreshTime Time of the list refresh, nothing happens when the cached state is newer
+    void updateState(const nlohmann::json& listState, std::chrono::steady_clock::time_point refreshTime);
+
     //! \name General information
     ///@{
 
@@ -91,6 +107,11 @@ public:
     //! \returns Ids of the lights in the group.
     std::vector<int> getLightIds() const;
 
+    //! \brief Get locations of the lights, only for type entertainment.
+    //! \returns Location of each light in the same order as \ref getLightIds.
+    //! Lights without a location are at the center.
+    std::vector<LightLocation> getLightLocations() const;
+
     //! \brief Set group name.
     //! \param name New name for the group.
     //! Must be unique for all groups, otherwise a number is added.
@@ -27,8 +27,12 @@
 #include <chrono>
 #include <mutex>
 
+#include "ArenaJson.h"
 #include "HueException.h"
 #include "IHttpHandler.h"
+#include "JsonFilter.h"
+#include "Result.h"
+#include "StateMutex.h"
 
 namespace hueplusplus
 {
@@ -74,6 +78,23 @@ public:
     //! \overload
     nlohmann::json PUTRequest(const std::string& path, const nlohmann::json& request) const;
 
+    //! \brief Sends a HTTP PUT request with an already serialized body to the bridge and returns the response
+    //!
+    //! This function will block until at least Config::getBridgeRequestDelay() has passed to any previous request.
+    //! Uses the cached api prefix instead of combining the path, so sending the request does not allocate
+    //! if the IHttpHandler writes it in parts.
+    //! \param path API request path (appended after /api/{username})
+    //! \param body Serialized JSON request, must not be empty
+    //! \param fileInfo File information for thrown exceptions.
+    //! \returns The return value of the underlying \ref IHttpHandler::PUTSerialized call
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contains no body
+    //! \throws HueAPIResponseException when response contains an error
+    //! \throws nlohmann::json::parse_error when response could not be parsed
+    nlohmann::json PUTSerializedRequest(const std::string& path, const std::string& body, FileInfo fileInfo) const;
+    //! \overload
+    nlohmann::json PUTSerializedRequest(const std::string& path, const std::string& body) const;
+
     //! \brief Sends a HTTP GET request to the bridge and returns the response
     //!
     //! This function will block until at least Config::getBridgeRequestDelay() has passed to any previous request
@@ -88,6 +109,29 @@ public:
     nlohmann::json GETRequest(const std::string& path, const nlohmann::json& request, FileInfo fileInfo) const;
     //! \overload
     nlohmann::json GETRequest(const std::string& path, const nlohmann::json& request) const;
+    //! \brief Sends a HTTP GET request to the bridge and returns the filtered response
+    //!
+    //! Same as GETRequest, but only keeps the members of the response selected by \c filter.
+    //! \param path API request path (appended after /api/{username})
+    //! \param request Request to the api, may be empty
+    //! \param filter Members of the response to keep
+    //! \param fileInfo File information for thrown exceptions.
+    //! \returns The return value of the underlying \ref IHttpHandler::GETJsonFiltered call,
+    //! or of IHttpHandler::GETJson when \c filter keeps everything
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contains no body
+    //! \throws HueAPIResponseException when response contains an error
+    //! \throws nlohmann::json::parse_error when response could not be parsed
+    nlohmann::json GETRequest(
+        const std::string& path, const nlohmann::json& request, const JsonFilter& filter, FileInfo fileInfo) const;
+    //! \brief Sends a HTTP GET request to the bridge and parses the filtered response into the current RefreshArena
+    //!
+    //! Same as GETRequest, but the response is an ArenaJson which is allocated from RefreshArena::current(),
+    //! so parsing does not allocate from the heap once the arena is large enough.
+    //! The result must be destroyed before the RefreshArena::Scope ends.
+    //! \see GETRequest(const std::string&, const nlohmann::json&, const JsonFilter&, FileInfo) const
+    ArenaJson GETRequestArena(
+        const std::string& path, const nlohmann::json& request, const JsonFilter& filter, FileInfo fileInfo) const;
 
     //! \brief Sends a HTTP DELETE request to the bridge and returns the response
     //!
@@ -119,9 +163,59 @@ public:
     //! \overload
     nlohmann::json POSTRequest(const std::string& path, const nlohmann::json& request) const;
 
+    //! \brief Sends a HTTP PUT request to the bridge and returns the response or an error
+    //!
+    //! Same as PUTRequest, but reports failures in the result instead of throwing.
+    //! \param path API request path (appended after /api/{username})
+    //! \param request Request to the api, may be empty
+    //! \returns The response, or an error with ErrorCode::apiError and the Hue API error number,
+    //! ErrorCode::busy, ErrorCode::connectionFailed or ErrorCode::invalidResponse.
+    Result<nlohmann::json> tryPUTRequest(const std::string& path, const nlohmann::json& request) const;
+
+    //! \brief Sends a HTTP GET request to the bridge and returns the response or an error
+    //!
+    //! Same as GETRequest, but reports failures in the result instead of throwing.
+    //! \param path API request path (appended after /api/{username})
+    //! \param request Request to the api, may be empty
+    //! \returns The response or an error, see tryPUTRequest()
+    Result<nlohmann::json> tryGETRequest(const std::string& path, const nlohmann::json& request) const;
+    //! \brief Sends a HTTP GET request to the bridge and returns the filtered response or an error
+    //! \see GETRequest(const std::string&, const nlohmann::json&, const JsonFilter&, FileInfo) const
+    Result<nlohmann::json> tryGETRequest(
+        const std::string& path, const nlohmann::json& request, const JsonFilter& filter) const;
+    //! \brief Sends a HTTP GET request to the bridge and parses the filtered response into the current RefreshArena
+    //! or returns an error
+    //! \see GETRequestArena()
+    Result<ArenaJson> tryGETRequestArena(
+        const std::string& path, const nlohmann::json& request, const JsonFilter& filter) const;
+
+    //! \brief Sends a HTTP DELETE request to the bridge and returns the response or an error
+    //!
+    //! Same as DELETERequest, but reports failures in the result instead of throwing.
+    //! \param path API request path (appended after /api/{username})
+    //! \param request Request to the api, may be empty
+    //! \returns The response or an error, see tryPUTRequest()
+    Result<nlohmann::json> tryDELETERequest(const std::string& path, const nlohmann::json& request) const;
+
+    //! \brief Sends a HTTP POST request to the bridge and returns the response or an error
+    //!
+    //! Same as POSTRequest, but reports failures in the result instead of throwing.
+    //! \param path API request path (appended after /api/{username})
+    //! \param request Request to the api, may be empty
+    //! \returns The response or an error, see tryPUTRequest()
+    Result<nlohmann::json> tryPOSTRequest(const std::string& path, const nlohmann::json& request) const;
+
     //! \brief Combines path with api prefix and username
     //! \returns "/api/<username>/<path>"
     std::string combinedPath(const std::string& path) const;
+
+    //! \brief Get the mutex which protects the cached state of the bridge
+    //!
+    //! All copies refer to the same mutex, like the timeout data.
+    //! Const getters lock it shared, so they can read in parallel. Refreshes and changes of the cached state
+    //! lock it exclusively, see \ref concurrency.
+    StateMutex& getStateMutex() const;
+
 private:
     struct TimeoutData
     {
@@ -134,12 +228,18 @@ private:
     //! \returns \ref response if there is no error
     nlohmann::json HandleError(FileInfo fileInfo, const nlohmann::json& response) const;
 
+    //! \brief Get the part of apiPrefix that has to be put before path
+    MessagePart getPathPrefix(const std::string& path) const;
+
 private:
     std::string ip;
     int port;
     std::string username;
+    //! \brief "/api/<username>/", cached so the path does not need to be combined for every request
+    std::string apiPrefix;
     std::shared_ptr<const IHttpHandler> httpHandler;
     std::shared_ptr<TimeoutData> timeout;
+    std::shared_ptr<StateMutex> stateMutex;
 };
 } // namespace hueplusplus
 
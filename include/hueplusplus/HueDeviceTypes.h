@@ -54,7 +54,7 @@ private:
     //! \param lightState Light JSON as returned from the bridge (not only the "state" part of it).
     //! \param hasCt Whether the light has color temperature control.
     //! \returns The color gamut specified in the light capabilities or,
-    //! if that does not exist, from a set of known models. Returns GAMUT_X_TEMPERATURE when \ref hasCt is true.
+    //! if that does not exist, from the ModelDatabase. Returns GAMUT_X_TEMPERATURE when \ref hasCt is true.
     //! \throws HueException when the light has no capabilities and the model is not known.
     ColorType getColorType(const nlohmann::json& lightState, bool hasCt) const;
 
@@ -0,0 +1,142 @@
+/**
+    \file HueStream.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_HUE_STREAM_H
+#define INCLUDE_HUEPLUSPLUS_HUE_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ColorUnits.h"
+
+namespace hueplusplus
+{
+//! \brief Messages of the HueStream protocol, which is used by EntertainmentMode
+//!
+//! A message consists of a header and one entry for each light. Each entry has three 16 bit channels,
+//! which contain either red, green and blue or x, y and brightness, depending on the color space of the message.
+//! In version 1, the entries are addressed by light id. In version 2, the header also contains the id of the
+//! entertainment configuration and the entries are addressed by the channel ids of the configuration.
+//! All functions which access entries work with both versions, an entry index is the position of the
+//! light or channel in the message.
+namespace huestream
+{
+//! \brief Version of the protocol
+enum class Version : uint8_t
+{
+    v1 = 0x01, //!< Entries for light ids
+    v2 = 0x02 //!< Entries for channels of an entertainment configuration
+};
+
+//! \brief Color space of the channels in a message
+enum class ColorSpace : uint8_t
+{
+    rgb = 0x00, //!< red, green and blue
+    xyBrightness = 0x01 //!< CIE x and y coordinates and brightness
+};
+
+//! \brief Size of the message header in bytes
+constexpr std::size_t headerSize = 16;
+//! \brief Size of a light entry in bytes
+constexpr std::size_t lightSize = 9;
+//! \brief Length of the entertainment configuration id in a version 2 header
+constexpr std::size_t configurationIdSize = 36;
+//! \brief Size of the version 2 message header in bytes, including the entertainment configuration id
+constexpr std::size_t headerSizeV2 = headerSize + configurationIdSize;
+//! \brief Size of a version 2 channel entry in bytes
+constexpr std::size_t channelSize = 7;
+
+//! \brief Create a version 1 message where all channels are zero
+//! \param lightIds Ids of the lights in the message
+//! \param colorSpace Color space of the channels
+std::vector<uint8_t> createMessage(const std::vector<int>& lightIds, ColorSpace colorSpace);
+
+//! \brief Create a version 2 message where all channels are zero
+//! \param configurationId Id of the entertainment configuration, a UUID with 36 characters
+//! \param channelIds Ids of the channels in the message
+//! \param colorSpace Color space of the channels
+//! \throws HueException when configurationId does not have 36 characters
+std::vector<uint8_t> createMessageV2(
+    const std::string& configurationId, const std::vector<uint8_t>& channelIds, ColorSpace colorSpace);
+
+//! \brief Get the protocol version of a message
+Version getVersion(const std::vector<uint8_t>& message);
+
+//! \brief Get number of light or channel entries in a message
+std::size_t getLightCount(const std::vector<uint8_t>& message);
+
+//! \brief Get the color space of a message
+ColorSpace getColorSpace(const std::vector<uint8_t>& message);
+
+//! \brief Set the color space of a message
+//!
+//! Does not convert the channels, they are interpreted in the new color space afterwards.
+void setColorSpace(std::vector<uint8_t>& message, ColorSpace colorSpace);
+
+//! \brief Set the channels of a light entry
+//! \param message Message to modify
+//! \param index Index of the light entry, must be less than getLightCount()
+//! \param first Red or x
+//! \param second Green or y
+//! \param third Blue or brightness
+void setChannels(std::vector<uint8_t>& message, std::size_t index, uint16_t first, uint16_t second, uint16_t third);
+
+//! \brief Set the channels of consecutive light entries
+//!
+//! Faster than calling setChannels() for each light entry.
+//! \param message Message to modify
+//! \param first Index of the first light entry
+//! \param channels Three channels for each light entry, in the order of the entries
+//! \param count Number of light entries, <tt>first + count</tt> must not be greater than getLightCount()
+void setChannels(std::vector<uint8_t>& message, std::size_t first, const uint16_t* channels, std::size_t count);
+
+//! \brief Get the three channels of a light entry
+//! \param message Message to read
+//! \param index Index of the light entry, must be less than getLightCount()
+//! \param channel Index of the channel from 0 to 2
+uint16_t getChannel(const std::vector<uint8_t>& message, std::size_t index, std::size_t channel);
+
+//! \brief Scale an 8 bit value to the full 16 bit range
+//!
+//! 255 is scaled to 65535, so full intensity stays full intensity.
+constexpr uint16_t to16Bit(uint8_t value)
+{
+    return static_cast<uint16_t>(value * 257);
+}
+
+//! \brief Convert a value from 0 to 1 to 16 bits
+//!
+//! Values out of range are clamped.
+uint16_t toChannel(float value);
+
+//! \brief Set the channels of a light entry from x, y and brightness
+//!
+//! The message must use ColorSpace::xyBrightness.
+//! \param message Message to modify
+//! \param index Index of the light entry, must be less than getLightCount()
+//! \param xy Color and brightness, all from 0 to 1
+void setXYBrightness(std::vector<uint8_t>& message, std::size_t index, const XYBrightness& xy);
+} // namespace huestream
+} // namespace hueplusplus
+
+#endif
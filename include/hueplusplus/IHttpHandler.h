@@ -24,15 +24,27 @@
 #define INCLUDE_HUEPLUSPLUS_IHTTPHANDLER_H
 
 #include <chrono>
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "JsonFilter.h"
+
 #include <nlohmann/json.hpp>
 
 namespace hueplusplus
 {
+//! \brief Contiguous piece of a message, refers to memory owned by the caller
+struct MessagePart
+{
+    //! \brief Start of the data, does not need to be null terminated
+    const char* data;
+    //! \brief Length of the data in bytes
+    std::size_t size;
+};
+
 //! Abstract class for classes that handle http requests and multicast requests
 class IHttpHandler
 {
@@ -156,6 +168,26 @@ public:
     virtual nlohmann::json GETJson(
         const std::string& uri, const nlohmann::json& body, const std::string& adr, int port = 80) const = 0;
 
+    //! \brief Send a HTTP GET request to the specified host and return only the filtered parts of the response.
+    //!
+    //! \param uri Uniform Resource Identifier in the request
+    //! \param body Request body, may be empty
+    //! \param filter Members of the response to keep
+    //! \param adr Ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional port the request is sent to, default is 80
+    //! \return Parsed and filtered body of the response of the host
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws nlohmann::json::parse_error when the body could not be parsed
+    //!
+    //! The default implementation calls GETJson and filters the parsed response.
+    //! Handlers that parse the response themselves override this to drop the members while parsing.
+    virtual nlohmann::json GETJsonFiltered(const std::string& uri, const nlohmann::json& body,
+        const JsonFilter& filter, const std::string& adr, int port = 80) const
+    {
+        return filter.apply(GETJson(uri, body, adr, port));
+    }
+
     //! \brief Send a HTTP POST request to the specified host and return the body of the response parsed as JSON.
     //!
     //! \param uri Uniform Resource Identifier in the request
@@ -194,6 +226,29 @@ public:
     //! \throws nlohmann::json::parse_error when the body could not be parsed
     virtual nlohmann::json DELETEJson(
         const std::string& uri, const nlohmann::json& body, const std::string& adr, int port = 80) const = 0;
+
+    //! \brief Send a HTTP PUT request with an already serialized body and return the body of the response parsed as
+    //! JSON.
+    //!
+    //! \param uriPrefix Start of the Uniform Resource Identifier, e.g. "/api/<username>"
+    //! \param uri Rest of the Uniform Resource Identifier, appended to uriPrefix
+    //! \param body Request body, must be valid JSON
+    //! \param adr Ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional port the request is sent to, default is 80
+    //! \return Parsed body of the response of the host
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws nlohmann::json::parse_error when the body could not be parsed
+    //!
+    //! The default implementation combines the uri, parses the body and calls PUTJson.
+    //! Handlers that can send the request in parts override this to avoid the temporary strings.
+    virtual nlohmann::json PUTSerialized(MessagePart uriPrefix, const std::string& uri, const std::string& body,
+        const std::string& adr, int port = 80) const
+    {
+        std::string combinedUri(uriPrefix.data, uriPrefix.size);
+        combinedUri.append(uri);
+        return PUTJson(combinedUri, nlohmann::json::parse(body), adr, port);
+    }
 };
 } // namespace hueplusplus
 
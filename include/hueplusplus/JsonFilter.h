@@ -0,0 +1,90 @@
+/**
+    \file JsonFilter.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_JSON_FILTER_H
+#define INCLUDE_HUEPLUSPLUS_JSON_FILTER_H
+
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "ArenaJson.h"
+
+namespace hueplusplus
+{
+//! \brief Selects the members of a json document which are kept while parsing
+//!
+//! The filter consists of paths like <tt>"lights/*/state"</tt>, with keys separated by '/'.
+//! A \c * matches any key or array element. A path keeps its whole subtree and the members on the way to it,
+//! everything else is dropped. Filtering during parse() never builds the dropped parts of the document,
+//! so the memory for a response is only needed for the kept members.
+//!
+//! Only objects are filtered. Documents with an array at the top level, like error responses of the bridge,
+//! are always kept completely.
+class JsonFilter
+{
+public:
+    //! \brief Creates filter which keeps everything
+    JsonFilter() = default;
+
+    //! \brief Creates filter which keeps only the given paths
+    //! \param paths Paths of the members to keep. An empty path keeps everything.
+    explicit JsonFilter(const std::vector<std::string>& paths);
+
+    //! \brief Check whether the filter keeps the whole document
+    bool keepsAll() const;
+
+    //! \brief Check whether a member is kept
+    //! \param path Keys from the top level to the member, array elements are empty strings
+    //! \returns true when the member is part of a kept subtree or on the way to it
+    bool keeps(const std::vector<std::string>& path) const;
+
+    //! \brief Get the filter for a member
+    //! \param key Key of the member in the filtered document
+    //! \returns Filter with the paths below \c key
+    JsonFilter getChild(const std::string& key) const;
+
+    //! \brief Parse a json document, dropping all members which are not kept
+    //! \throws nlohmann::json::parse_error when the document could not be parsed
+    nlohmann::json parse(const std::string& text) const;
+
+    //! \brief Parse a json document into the current RefreshArena, dropping all members which are not kept
+    //! \throws nlohmann::json::parse_error when the document could not be parsed
+    ArenaJson parseArena(const std::string& text) const;
+
+    //! \brief Remove all members which are not kept from an already parsed document
+    //! \returns Filtered document, same as parse() of the serialized document
+    nlohmann::json apply(nlohmann::json json) const;
+
+private:
+    template <typename Json>
+    Json parseAs(const std::string& text) const;
+    void applyMembers(nlohmann::json& json, std::vector<std::string>& path) const;
+
+private:
+    //! Keys of the paths, split at '/'
+    std::vector<std::vector<std::string>> paths;
+    bool all = true;
+};
+} // namespace hueplusplus
+
+#endif
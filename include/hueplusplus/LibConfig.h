@@ -53,6 +53,14 @@ public:
     //! \brief Interval in which username requests are attempted
     duration getRequestUsernameAttemptInterval() const { return requestUsernameAttemptInterval; }
 
+    //! \brief Timeout for the DTLS handshake of EntertainmentMode
+    duration getEntertainmentHandshakeTimeout() const { return entertainmentHandshakeTimeout; }
+
+    //! \brief Time without sent frames until EntertainmentMode sends the last frame again
+    //!
+    //! The bridge closes the connection after about 10 seconds without frames.
+    duration getEntertainmentKeepAliveInterval() const { return entertainmentKeepAliveInterval; }
+
     //! \brief Get config instance
     static Config& instance()
     {
@@ -69,6 +77,8 @@ protected:
     duration bridgeRequestDelay = std::chrono::milliseconds(100);
     duration requestUsernameDelay = std::chrono::seconds(35);
     duration requestUsernameAttemptInterval = std::chrono::seconds(1);
+    duration entertainmentHandshakeTimeout = std::chrono::seconds(5);
+    duration entertainmentKeepAliveInterval = std::chrono::seconds(2);
 };
 } // namespace hueplusplus
 
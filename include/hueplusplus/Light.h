@@ -23,6 +23,7 @@
 #ifndef INCLUDE_HUEPLUSPLUS_HUE_LIGHT_H
 #define INCLUDE_HUEPLUSPLUS_HUE_LIGHT_H
 
+#include <functional>
 #include <memory>
 
 #include "APICache.h"
@@ -30,6 +31,7 @@
 #include "BrightnessStrategy.h"
 #include "ColorHueStrategy.h"
 #include "ColorTemperatureStrategy.h"
+#include "DecodedLightState.h"
 #include "HueCommandAPI.h"
 #include "StateTransaction.h"
 
@@ -124,6 +126,53 @@ public:
     //! \return Bool that is true, when the light is on and false, when off
     virtual bool isOn() const;
 
+    //! \brief Function that returns the light state decoded into plain values
+    //!
+    //! \return Copy of the current state of the light, so it can be used while other threads refresh
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws HueAPIResponseException when response contains an error
+    //! \throws nlohmann::json::parse_error when response could not be parsed
+    DecodedLightState getDecodedState();
+
+    //! \brief Const function that returns the light state decoded into plain values
+    //!
+    //! \note This will not refresh the light state. The cached decoded state is only updated
+    //! by non-const functions, so this decodes the state again when it is outdated.
+    //! \return Copy of the current state of the light
+    DecodedLightState getDecodedState() const;
+
+    //! \brief Function that enables or disables caching of the decoded light state
+    //!
+    //! When enabled, the light state is only decoded once per refresh and all getters
+    //! read from the \ref DecodedLightState instead of looking up the json values on every call.
+    //! Disabled by default.
+    //! \note When enabled, changes made through other Light objects with the same id
+    //! (e.g. copies using shared state) are only visible after the next refresh.
+    //! \param enabled Whether the decoded state is cached
+    void setStateDecoding(bool enabled);
+
+    //! \brief Const function to check whether the decoded light state is cached
+    //!
+    //! \return Bool that is true when getters read from the cached \ref DecodedLightState
+    bool isStateDecodingEnabled() const;
+
+    //! \brief Function that enables or disables asynchronous alerts
+    //!
+    //! When enabled, \ref alertTemperature, \ref alertHueSaturation and \ref alertXY return as soon as the
+    //! alert color is set. The alert and the restoration of the previous state are run on
+    //! \ref TimerScheduler::instance() after the configured alert delays, instead of blocking the caller.
+    //! Disabled by default.
+    //! \note The cached state of the light is invalidated when the previous state is restored,
+    //! so the next getter or transaction refreshes it. Errors are only printed to std::cerr.
+    //! \param enabled Whether alerts are asynchronous
+    void setAsyncAlerts(bool enabled);
+
+    //! \brief Const function to check whether alerts are asynchronous
+    //!
+    //! \return Bool that is true when alerts are run on the \ref TimerScheduler
+    bool isAsyncAlertsEnabled() const;
+
     //! \brief Const function to check whether this light has brightness control
     //!
     //! \return Bool that is true when the light has specified abilities and false
@@ -447,11 +496,27 @@ public:
     //! \throws nlohmann::json::parse_error when response could not be parsed
     virtual bool alert();
 
+    //! \brief Function that performs the alert and restores the previous state afterwards.
+    //!
+    //! Used by the strategies to finish an alert after the alert color was set.
+    //! Waits for the pre alert delay, calls \ref alert() and waits for the post alert delay
+    //! before committing the restoring transaction.
+    //! When asynchronous alerts are enabled, these steps are scheduled on \ref TimerScheduler::instance()
+    //! and the function returns immediately.
+    //! \param restore Function which adds the previous state to the transaction
+    //! \return Bool that is true on success or when the steps were scheduled
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws HueAPIResponseException when response contains an error
+    //! \throws nlohmann::json::parse_error when response could not be parsed
+    virtual bool alertAndRestore(const std::function<void(StateTransaction&)>& restore);
+
     //! \brief Function that lets the light perform one breath cycle in specified
     //! color temperature.
     //!
     //! \note The breath cylce will only be performed if the light has a reference
     //! to a specific \ref ColorTemperatureStrategy.
+    //! See \ref setAsyncAlerts to perform it without blocking.
     //! \param mired Color temperature in mired
     //! \return Bool that is true on success
     //! \throws std::system_error when system or socket operations fail
@@ -472,6 +537,7 @@ public:
     //!
     //! \note The breath cylce will only be performed if the light has a reference
     //! to a specific \ref ColorHueStrategy.
+    //! See \ref setAsyncAlerts to perform it without blocking.
     //! \param hueSat Color in hue and saturation
     //! \return Bool that is true on success
     //! \throws std::system_error when system or socket operations fail
@@ -492,6 +558,7 @@ public:
     //!
     //! \note The breath cylce will only be performed if the light has a reference
     //! to a specific \ref ColorHueStrategy.
+    //! See \ref setAsyncAlerts to perform it without blocking.
     //! \param xy The x,y coordinates in CIE and brightness
     //! \return Bool that is true on success
     //! \throws std::system_error when system or socket operations fail
@@ -609,9 +676,29 @@ protected:
         colorHueStrategy = std::move(strat);
     };
 
+    //! \brief Protected function that refreshes the state if necessary and updates the cached decoded state.
+    //!
+    //! The cached decoded state is only written while holding the exclusive lock,
+    //! so const functions can read it in parallel.
+    //! \throws std::system_error when system or socket operations fail
+    //! \throws HueException when response contained no body
+    //! \throws HueAPIResponseException when response contains an error
+    //! \throws nlohmann::json::parse_error when response could not be parsed
+    void refreshDecodedState();
+
+    //! \brief Protected function that checks whether the cached decoded state matches the last refresh.
+    //!
+    //! Must be called with the lock.
+    bool isDecodedStateCurrent() const;
+
 protected:
     ColorType colorType; //!< holds the \ref ColorType of the light
 
+    bool stateDecoding; //!< holds whether the decoded state is cached between refreshes
+    DecodedLightState decodedState; //!< holds the last decoded light state
+    std::chrono::steady_clock::time_point decodedRefresh; //!< holds the refresh time of decodedState
+    bool asyncAlerts; //!< holds whether alerts are run on the TimerScheduler
+
     std::shared_ptr<const BrightnessStrategy>
         brightnessStrategy; //!< holds a reference to the strategy that handles brightness commands
     std::shared_ptr<const ColorTemperatureStrategy>
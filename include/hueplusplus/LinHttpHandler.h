@@ -46,6 +46,19 @@ public:
     //! String containing the response of the host
     virtual std::string send(const std::string& msg, const std::string& adr, int port = 80) const override;
 
+    //! \brief Send a message consisting of multiple parts to a specified host and return the response.
+    //!
+    //! \param parts Parts of the message, which are sent in order
+    //! \param count Number of parts
+    //! \param adr Ip or hostname in dotted decimal notation like "192.168.2.1"
+    //! \param port Optional port the request is sent to, default is 80
+    //! \return The response of the host as a string
+    //! \throws std::system_error when system or socket operations fail
+    //!
+    //! The parts are written with writev, without copying them into one buffer.
+    std::string sendParts(
+        const MessagePart* parts, std::size_t count, const std::string& adr, int port = 80) const override;
+
     //! \brief Function that sends a multicast request with the specified message.
     //!
     //! \param msg String that contains the request that is sent to the specified
@@ -0,0 +1,115 @@
+/**
+    \file ModelDatabase.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_MODEL_DATABASE_H
+#define INCLUDE_HUEPLUSPLUS_MODEL_DATABASE_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace hueplusplus
+{
+enum class ColorType;
+
+//! \brief Color gamut of a known model
+enum class ModelGamut : uint8_t
+{
+    UNKNOWN, //!< Gamut is unknown or model has no color
+    A, //!< Gamut A, used by most color lights
+    B, //!< Gamut B, used by older extended color lights
+    C //!< Gamut C, used by newer extended color lights
+};
+
+//! \brief Feature flags of a known model, combined with bitwise or
+namespace modelfeature
+{
+//! \brief Brightness can be controlled
+constexpr uint8_t brightness = 1 << 0;
+//! \brief Color temperature can be controlled
+constexpr uint8_t colorTemperature = 1 << 1;
+//! \brief Color can be controlled with hue, saturation and xy
+constexpr uint8_t color = 1 << 2;
+} // namespace modelfeature
+
+//! \brief Capabilities of a device model
+struct ModelInfo
+{
+    //! \brief Model id as reported by the bridge, e.g. "LCT001"
+    const char* modelId;
+    //! \brief Picture file name without extension, may be empty
+    const char* picture;
+    //! \brief Color gamut
+    ModelGamut gamut;
+    //! \brief Known features as combination of \ref modelfeature flags, 0 when unknown
+    uint8_t features;
+
+    //! \brief Check whether all given \ref modelfeature flags are set
+    constexpr bool hasFeatures(uint8_t f) const { return (features & f) == f; }
+    //! \brief Get color type derived from gamut and features
+    //! \returns ColorType for the gamut, with temperature if the model supports it,
+    //! or ColorType::UNDEFINED when the gamut is unknown.
+    ColorType getColorType() const;
+};
+
+//! \brief Lookup table for capabilities of device models
+//!
+//! Known models are stored in a table sorted at compile time, which is searched without any allocations.
+//! New models can be added at runtime and take precedence over the built in table.
+//! \note Adding models is not thread safe. Add models before creating any Bridge that uses them.
+class ModelDatabase
+{
+public:
+    //! \brief Find capabilities of a model
+    //! \param modelId Model id as reported by the bridge
+    //! \returns Pointer to model info or nullptr when the model is unknown.
+    //! The pointer stays valid until clearAdded() is called.
+    const ModelInfo* find(const std::string& modelId) const;
+
+    //! \brief Add or replace a model
+    //! \param modelId Model id as reported by the bridge
+    //! \param picture Picture file name without extension, may be empty
+    //! \param gamut Color gamut of the model
+    //! \param features Combination of \ref modelfeature flags
+    void add(const std::string& modelId, const std::string& picture, ModelGamut gamut, uint8_t features);
+
+    //! \brief Remove all models added at runtime
+    void clearAdded();
+
+    //! \brief Get database instance
+    static ModelDatabase& instance();
+
+protected:
+    ModelDatabase() = default;
+
+private:
+    struct AddedModel
+    {
+        std::string modelId;
+        std::string picture;
+        ModelInfo info;
+    };
+    // deque does not move elements on insertion, so ModelInfo pointers into the strings stay valid
+    std::deque<AddedModel> added;
+};
+} // namespace hueplusplus
+
+#endif
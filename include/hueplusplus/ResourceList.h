@@ -24,16 +24,56 @@
 
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "APICache.h"
 #include "HueException.h"
 #include "NewDeviceList.h"
+#include "Result.h"
 #include "Utils.h"
 
 namespace hueplusplus
 {
+//! \brief Cheaply copyable handle to a resource owned by a ResourceList
+//! \tparam Resource Resource type that is referenced
+//!
+//! The handle shares ownership of the resource, so it stays valid when the resource is removed from the list
+//! or the list is destroyed. Copying the handle does not copy the resource.
+//! It can be converted to a copy of the resource, so <code>Light light = bridge.lights().get(1);</code> still works.
+template <typename Resource>
+class ResourceHandle
+{
+public:
+    //! \brief Creates an empty handle
+    ResourceHandle() = default;
+    //! \brief Creates a handle sharing ownership of \c resource
+    explicit ResourceHandle(std::shared_ptr<Resource> resource) : resource(std::move(resource)) { }
+
+    //! \brief Get the resource
+    Resource& operator*() const { return *resource; }
+    //! \brief Access members of the resource
+    Resource* operator->() const { return resource.get(); }
+    //! \brief Get a copy of the resource
+    operator Resource() const { return *resource; }
+
+    //! \brief Check whether the handle refers to a resource
+    explicit operator bool() const { return resource != nullptr; }
+
+    //! \brief Get the shared pointer owning the resource
+    const std::shared_ptr<Resource>& getShared() const { return resource; }
+
+    //! \brief Check whether both handles refer to the same resource
+    bool operator==(const ResourceHandle& other) const { return resource == other.resource; }
+    //! \brief Check whether the handles refer to different resources
+    bool operator!=(const ResourceHandle& other) const { return resource != other.resource; }
+
+private:
+    std::shared_ptr<Resource> resource;
+};
+
 //! \brief Handles a list of a certain API resource
 //! \tparam Resource Resource type that is in the list
 //! \tparam IdT Type of the resource id. int or std::string
@@ -42,12 +82,18 @@ namespace hueplusplus
 //! The Resource class needs a constructor that accepts \c id, HueCommandAPI, \c refreshDuration and \c state;
 //! otherwise a factory function needs to be provided that takes \c id, \c state 
 //! and a base cache that is null when shared state is disabled.
+//!
+//! Resources are only constructed once and kept until their id disappears from the list,
+//! so repeated calls to get() return handles to the same object.
+//! All member functions lock the state mutex of the bridge while they access the list, see \ref concurrency.
 template <typename Resource, typename IdT>
 class ResourceList
 {
 public:
     using ResourceType = Resource;
     using IdType = IdT;
+    //! \brief Handle returned by get() and getAll()
+    using Handle = ResourceHandle<Resource>;
     static_assert(std::is_integral<IdType>::value || std::is_same<std::string, IdType>::value,
         "IdType must be integral or string");
 
@@ -99,39 +145,68 @@ public:
     }
 
     //! \brief Get all resources that exist
-    //! \returns A vector of references to every Resource
+    //! \returns A vector of handles to every Resource.
+    //! Unlike the handle returned by get(), the vector cannot be converted to a vector of copies.
     //! \throws std::system_error when system or socket operations fail
     //! \throws HueException when response contains no body
     //! \throws HueAPIResponseException when response contains an error
     //! \throws nlohmann::json::parse_error when response could not be parsed
-    std::vector<Resource> getAll()
+    std::vector<Handle> getAll()
     {
-        nlohmann::json& state = stateCache->getValue();
-        std::vector<Resource> result;
+        // Refresh before locking, so the lock is not held during the request
+        stateCache->getValue();
+        auto lock = stateCache->lock();
+        const nlohmann::json& state = getListState();
+        std::vector<Handle> result;
         result.reserve(state.size());
         for (auto it = state.begin(); it != state.end(); ++it)
         {
-            result.emplace_back(construct(maybeStoi(it.key()), it.value()));
+            result.push_back(getCached(maybeStoi(it.key()), it.value()));
         }
         return result;
     }
 
     //! \brief Get resource specified by id
     //! \param id Identifier of the resource
-    //! \returns The resource matching the id
+    //! \returns Handle to the resource matching the id. Repeated calls return handles to the same resource
+    //! until the id is removed from the list.
     //! \throws std::system_error when system or socket operations fail
     //! \throws HueException when id does not exist
     //! \throws HueAPIResponseException when response contains an error
     //! \throws nlohmann::json::parse_error when response could not be parsed
-    Resource get(const IdType& id)
+    Handle get(const IdType& id)
     {
-        const nlohmann::json& state = stateCache->getValue();
-        std::string key = maybeToString(id);
-        if (!state.count(key))
+        stateCache->getValue();
+        auto lock = stateCache->lock();
+        const nlohmann::json& state = getListState();
+        auto pos = state.find(maybeToString(id));
+        if (pos == state.end())
         {
             throw HueException(FileInfo {__FILE__, __LINE__, __func__}, "Resource id is not valid");
         }
-        return construct(id, state[key]);
+        return getCached(id, *pos);
+    }
+
+    //! \brief Get resource specified by id, without throwing
+    //! \param id Identifier of the resource
+    //! \returns The resource matching the id, ErrorCode::notFound when the id does not exist
+    //! or the error of refreshing the list, see APICache::tryGetValue().
+    //! \throws HueException when the resource cannot be constructed, see get()
+    Result<Handle> tryGet(const IdType& id)
+    {
+        Result<nlohmann::json&> refreshed = stateCache->tryGetValue();
+        if (!refreshed)
+        {
+            return refreshed.error();
+        }
+        auto lock = stateCache->lock();
+        const nlohmann::json& state = getListState();
+        auto pos = state.find(maybeToString(id));
+        if (pos == state.end())
+        {
+            return ErrorCode::notFound;
+        }
+        return getCached(id, *pos);
     }
 
     //! \brief Checks whether resource with id exists
@@ -141,14 +216,22 @@ public:
     //! \throws HueException when response contains no body
     //! \throws HueAPIResponseException when response contains an error
     //! \throws nlohmann::json::parse_error when response could not be parsed
-    bool exists(const IdType& id) { return stateCache->getValue().count(maybeToString(id)) != 0; }
+    bool exists(const IdType& id)
+    {
+        stateCache->getValue();
+        return static_cast<const ResourceList&>(*this).exists(id);
+    }
 
     //! \brief Checks whether resource with id exists
     //! \param id Identifier of the resource to check
     //! \returns true when the resource with given id exists
     //! \note This will not update the cache
     //! \throws HueException when the cache is empty
-    bool exists(const IdType& id) const { return stateCache->getValue().count(maybeToString(id)) != 0; }
+    bool exists(const IdType& id) const
+    {
+        auto lock = stateCache->lock();
+        return stateCache->getValue().count(maybeToString(id)) != 0;
+    }
 
     //! \brief Removes the resource
     //! \param id Identifier of the resource to remove
@@ -158,13 +241,18 @@ public:
     //! \throws HueAPIResponseException when response contains an error
     //! \throws nlohmann::json::parse_error when response could not be parsed
     //!
-    //! If successful, invalidates references to the Resource removed.
+    //! If successful, the Resource is dropped from the list. Existing handles to it stay valid.
     bool remove(const IdType& id)
     {
         std::string requestPath = path + maybeToString(id);
         nlohmann::json result = stateCache->getCommandAPI().DELETERequest(
             requestPath, nlohmann::json::object(), FileInfo {__FILE__, __LINE__, __func__});
-        bool success = utils::safeGetMember(result, 0, "success") == requestPath + " deleted";
+        bool success = utils::safeGetMemberRef(result, 0, "success") == requestPath + " deleted";
+        if (success)
+        {
+            auto lock = stateCache->lock();
+            resources.erase(id);
+        }
         return success;
     }
 
@@ -184,6 +272,60 @@ protected:
                 const nlohmann::json&> {});
     }
 
+    //! \brief Get the list state without refreshing and drop cached resources that no longer exist
+    //!
+    //! Must be called while holding the lock, refresh with stateCache->getValue() before locking.
+    //! \throws HueException when the list state is not cached
+    const nlohmann::json& getListState()
+    {
+        const nlohmann::json& state = static_cast<const APICache&>(*stateCache).getValue();
+        removeDeleted(state);
+        return state;
+    }
+
+    //! \brief Drop cached resources that are not in the list state
+    //! \param state List state from stateCache
+    void removeDeleted(const nlohmann::json& state)
+    {
+        std::chrono::steady_clock::time_point lastRefresh = stateCache->getLastRefresh();
+        if (lastRefresh != resourcesRefresh)
+        {
+            // Only check for removed resources once per refresh
+            for (auto it = resources.begin(); it != resources.end();)
+            {
+                if (state.count(maybeToString(it->first)))
+                {
+                    ++it;
+                }
+                else
+                {
+                    it = resources.erase(it);
+                }
+            }
+            resourcesRefresh = lastRefresh;
+        }
+    }
+
+    //! \brief Get cached resource or construct it if it is not cached yet
+    //!
+    //! Cached resources with their own state take over the state of newer list refreshes,
+    //! so they do not need their own request.
+    //! \param id Identifier of the resource
+    //! \param state Current state of the resource in the list
+    Handle getCached(const IdType& id, const nlohmann::json& state)
+    {
+        auto pos = resources.find(id);
+        if (pos == resources.end())
+        {
+            pos = resources.emplace(id, std::make_shared<Resource>(construct(id, state))).first;
+        }
+        else if (!sharedState)
+        {
+            updateState(*pos->second, state, stateCache->getLastRefresh(), 0);
+        }
+        return Handle(pos->second);
+    }
+
     //! \brief Protected defaulted move constructor
     ResourceList(ResourceList&&) = default;
     //! \brief Protected defaulted move assignment
@@ -220,6 +362,18 @@ private:
         return factory(id, state, sharedState ? stateCache : std::shared_ptr<APICache>());
     }
 
+    // Resource can take over the list state
+    template <typename R>
+    static auto updateState(R& resource, const nlohmann::json& state,
+        std::chrono::steady_clock::time_point refreshTime, int) -> decltype(resource.updateState(state, refreshTime))
+    {
+        resource.updateState(state, refreshTime);
+    }
+    // Resource only refreshes on its own
+    template <typename R>
+    static void updateState(R&, const nlohmann::json&, std::chrono::steady_clock::time_point, long)
+    { }
+
 private:
     static IdType maybeStoi(const std::string& key, std::true_type) { return std::stoi(key); }
     static IdType maybeStoi(const std::string& key, std::false_type) { return key; }
@@ -231,6 +385,8 @@ protected:
     std::function<Resource(IdType, const nlohmann::json&, const std::shared_ptr<APICache>&)> factory;
     std::string path;
     bool sharedState;
+    std::map<IdType, std::shared_ptr<Resource>> resources;
+    std::chrono::steady_clock::time_point resourcesRefresh;
 };
 
 //! \brief Handles a ResourceList of physical devices which can be searched for
@@ -302,7 +458,7 @@ public:
         requestPath.pop_back();
         nlohmann::json response = this->stateCache->getCommandAPI().POSTRequest(
             requestPath, params.getRequest(), FileInfo {__FILE__, __LINE__, __func__});
-        nlohmann::json id = utils::safeGetMember(response, 0, "success", "id");
+        const nlohmann::json& id = utils::safeGetMemberRef(response, 0, "success", "id");
         if (id.is_string())
         {
             std::string idStr = id.get<std::string>();
@@ -336,15 +492,29 @@ public:
     using Base::Base;
     //! \brief Get group, specially handles group 0
     //! \see ResourceList::get
-    Resource get(const int& id)
+    typename Base::Handle get(const int& id)
     {
-        const nlohmann::json& state = this->stateCache->getValue();
-        std::string key = this->maybeToString(id);
-        if (!state.count(key) && id != 0)
+        if (id == 0)
         {
-            throw HueException(FileInfo {__FILE__, __LINE__, __func__}, "Resource id is not valid");
+            auto lock = this->stateCache->lock();
+            // Group 0 is not contained in the list, so it is stored separately and never removed
+            if (!allLightsGroup)
+            {
+                allLightsGroup = std::make_shared<Resource>(this->construct(id, nlohmann::json {nullptr}));
+            }
+            return typename Base::Handle(allLightsGroup);
         }
-        return this->construct(id, id == 0 ? nlohmann::json {nullptr} : state[key]);
+        return Base::get(id);
+    }
+    //! \brief Get group without throwing, specially handles group 0
+    //! \see ResourceList::tryGet
+    Result<typename Base::Handle> tryGet(const int& id)
+    {
+        if (id == 0)
+        {
+            return get(id);
+        }
+        return Base::tryGet(id);
     }
     //! \brief Get group, specially handles group 0
     //! \see ResourceList::exists
@@ -355,6 +525,9 @@ protected:
     GroupResourceList(GroupResourceList&&) = default;
     //! \brief Protected defaulted move assignment
     GroupResourceList& operator=(GroupResourceList&&) = default;
+
+private:
+    std::shared_ptr<Resource> allLightsGroup;
 };
 } // namespace hueplusplus
 
@@ -0,0 +1,174 @@
+/**
+    \file Result.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_RESULT_H
+#define INCLUDE_HUEPLUSPLUS_RESULT_H
+
+#include <system_error>
+#include <utility>
+
+#include "HueException.h"
+
+namespace hueplusplus
+{
+//! \brief Reason why a non-throwing function failed
+enum class ErrorCode
+{
+    none, //!< No error
+    notFound, //!< Resource or path does not exist
+    noValue, //!< Cache does not contain a value yet
+    apiError, //!< Bridge answered with an error response, see Error::apiError
+    busy, //!< Bridge was too busy and closed the connection or timed out, also after a retry
+    connectionFailed, //!< Other system or socket error, see Error::systemError
+    invalidResponse //!< Response contained no body or could not be parsed
+};
+
+//! \brief Error of a non-throwing function
+//!
+//! Does not contain any strings, so creating it does not allocate.
+struct Error
+{
+    //! \brief No error
+    Error() = default;
+    //! \brief Error without additional information
+    explicit Error(ErrorCode code) : code(code) { }
+    //! \brief Error with the Hue API error number or the system error
+    Error(ErrorCode code, int apiError, std::error_code systemError)
+        : code(code), apiError(apiError), systemError(systemError)
+    { }
+
+    //! \brief Reason of the error
+    ErrorCode code = ErrorCode::none;
+    //! \brief Error number from Hue API error response when code is ErrorCode::apiError, otherwise 0
+    //!
+    //! Refer to Hue developer documentation for meaning of error codes.
+    int apiError = 0;
+    //! \brief System error when code is ErrorCode::busy or ErrorCode::connectionFailed
+    std::error_code systemError;
+};
+
+//! \brief Value or error returned by non-throwing functions
+//! \tparam T Type of the value, must be default constructible. May be a reference.
+//!
+//! Accessing the value of a failed result throws, so check hasValue() first.
+template <typename T>
+class Result
+{
+public:
+    //! \brief Successful result
+    Result(T value) : v(std::move(value)) { }
+    //! \brief Failed result
+    Result(Error error) : e(error) { }
+    //! \brief Failed result without additional information
+    Result(ErrorCode code) : e(code) { }
+
+    //! \brief Check whether the result contains a value
+    bool hasValue() const { return e.code == ErrorCode::none; }
+    //! \brief Check whether the result contains a value
+    explicit operator bool() const { return hasValue(); }
+
+    //! \brief Get the value
+    //! \throws HueException when the result contains an error
+    T& value()
+    {
+        checkValue();
+        return v;
+    }
+    //! \brief Get the value
+    //! \throws HueException when the result contains an error
+    const T& value() const
+    {
+        checkValue();
+        return v;
+    }
+    //! \brief Get the value or a default
+    //! \param defaultValue Returned when the result contains an error
+    T valueOr(T defaultValue) const { return hasValue() ? v : std::move(defaultValue); }
+
+    //! \brief Get the value without checking
+    T& operator*() { return v; }
+    //! \brief Get the value without checking
+    const T& operator*() const { return v; }
+    //! \brief Access members of the value without checking
+    T* operator->() { return &v; }
+    //! \brief Access members of the value without checking
+    const T* operator->() const { return &v; }
+
+    //! \brief Get the error, ErrorCode::none if successful
+    const Error& error() const { return e; }
+
+private:
+    void checkValue() const
+    {
+        if (!hasValue())
+        {
+            throw HueException(FileInfo {__FILE__, __LINE__, __func__}, "Result contains no value");
+        }
+    }
+
+private:
+    T v {};
+    Error e;
+};
+
+//! \brief Result that refers to a value owned by someone else
+template <typename T>
+class Result<T&>
+{
+public:
+    //! \brief Successful result
+    Result(T& value) : v(&value) { }
+    //! \brief Failed result
+    Result(Error error) : e(error) { }
+    //! \brief Failed result without additional information
+    Result(ErrorCode code) : e(code) { }
+
+    //! \brief Check whether the result contains a value
+    bool hasValue() const { return e.code == ErrorCode::none; }
+    //! \brief Check whether the result contains a value
+    explicit operator bool() const { return hasValue(); }
+
+    //! \brief Get the value
+    //! \throws HueException when the result contains an error
+    T& value() const
+    {
+        if (!hasValue())
+        {
+            throw HueException(FileInfo {__FILE__, __LINE__, __func__}, "Result contains no value");
+        }
+        return *v;
+    }
+
+    //! \brief Get the value without checking
+    T& operator*() const { return *v; }
+    //! \brief Access members of the value without checking
+    T* operator->() const { return v; }
+
+    //! \brief Get the error, ErrorCode::none if successful
+    const Error& error() const { return e; }
+
+private:
+    T* v = nullptr;
+    Error e;
+};
+} // namespace hueplusplus
+
+#endif
@@ -66,6 +66,11 @@ public:
     //! \param refreshDuration The new minimum duration between refreshes. May be 0 or \ref c_refreshNever.
     void setRefreshDuration(std::chrono::steady_clock::duration refreshDuration);
 
+    //! \brief Update the cached state with the state from a newer refresh of the resource list
+    //! \param listState State of this rule in the list
+    //! \param refreshTime Time of the list refresh, nothing happens when the cached state is newer
+    void updateState(const nlohmann::json& listState, std::chrono::steady_clock::time_point refreshTime);
+
     //! \brief Get rule identifier
     int getId() const;
 
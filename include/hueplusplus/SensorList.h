@@ -46,7 +46,7 @@ public:
     template <typename T>
     T getAsType(int id)
     {
-        return get(id).asSensorType<T>();
+        return get(id)->asSensorType<T>();
     }
     //! \brief Get all sensors of type \c T
     //! \tparam T Sensor type to get (from \ref sensors)
@@ -58,6 +58,7 @@ public:
     template <typename T>
     std::vector<T> getAllByType()
     {
+        auto lock = this->stateCache->lock();
         nlohmann::json state = this->stateCache->getValue();
         std::vector<T> result;
         for (auto it = state.begin(); it != state.end(); ++it)
@@ -65,7 +66,7 @@ public:
             // Only parse the sensors with the correct type
             if (it->value("type", "") == T::typeStr)
             {
-                result.push_back(get(maybeStoi(it.key())).asSensorType<T>());
+                result.push_back(get(maybeStoi(it.key()))->asSensorType<T>());
             }
         }
         return result;
@@ -0,0 +1,37 @@
+/**
+    \file Simd.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_SIMD_H
+#define INCLUDE_HUEPLUSPLUS_SIMD_H
+
+// Selects the vector instructions used by ColorConversion and SpatialMapping. Only included by source files.
+// Defines HUEPLUSPLUS_SSE2 or HUEPLUSPLUS_NEON and includes the intrinsics, unless HUEPLUSPLUS_NO_SIMD is defined.
+#if defined(HUEPLUSPLUS_NO_SIMD)
+// Scalar code only
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HUEPLUSPLUS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define HUEPLUSPLUS_NEON
+#include <arm_neon.h>
+#endif
+
+#endif
@@ -0,0 +1,142 @@
+/**
+    \file SpatialMapping.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_SPATIAL_MAPPING_H
+#define INCLUDE_HUEPLUSPLUS_SPATIAL_MAPPING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ColorUnits.h"
+#include "Group.h"
+
+namespace hueplusplus
+{
+//! \brief Colors on a regular grid, which covers the area of an entertainment group
+//!
+//! The grid spans the coordinates from -1 to 1 of LightLocation on every axis, the cells are
+//! equally sized and their colors are at their centers. A depth of 1 is a 2D grid in the x-y plane,
+//! a height and depth of 1 a 1D gradient from left to right.
+//! The channels are stored in separate planes of floats from 0 to 1, so effects can write them directly.
+class ColorGrid
+{
+public:
+    //! \brief Constructor, all cells are black
+    //! \param width Number of cells along x
+    //! \param height Number of cells along y
+    //! \param depth Number of cells along z
+    //! \throws HueException when a size is zero
+    ColorGrid(std::size_t width, std::size_t height, std::size_t depth = 1);
+
+    //! \brief Get number of cells along x
+    std::size_t getWidth() const;
+    //! \brief Get number of cells along y
+    std::size_t getHeight() const;
+    //! \brief Get number of cells along z
+    std::size_t getDepth() const;
+
+    //! \brief Get index of a cell in the channel planes
+    std::size_t getIndex(std::size_t x, std::size_t y, std::size_t z = 0) const
+    {
+        return (z * height + y) * width + x;
+    }
+
+    //! \brief Set the color of a cell
+    //! \param x, y, z Cell coordinates, must be less than the sizes
+    //! \param red, green, blue Gamma corrected color values from 0 to 1
+    void setColor(std::size_t x, std::size_t y, std::size_t z, float red, float green, float blue);
+    //! \brief Set the color of a cell
+    //! \param x, y, z Cell coordinates, must be less than the sizes
+    //! \param color Color with 8 bits per channel
+    void setColor(std::size_t x, std::size_t y, std::size_t z, const RGB& color);
+
+    //! \brief Set all cells to the same color
+    void fill(const RGB& color);
+
+    //! \brief Get a channel plane
+    //! \param channel 0 for red, 1 for green and 2 for blue
+    //! \returns Values of all cells, ordered like \ref getIndex
+    float* getChannel(std::size_t channel);
+    //! \copydoc getChannel
+    const float* getChannel(std::size_t channel) const;
+
+private:
+    std::size_t width;
+    std::size_t height;
+    std::size_t depth;
+    std::vector<float> channels; //!< red, green and blue planes after each other
+};
+
+//! \brief Samples a ColorGrid at the locations of the lights of an entertainment group
+//!
+//! Effects can be authored once in space, for example as a wave moving through the room, instead of
+//! for each light. The cells around each light and their weights for linear interpolation are computed
+//! in the constructor, so sampling a frame only needs a few multiplications per light and does not allocate.
+//! Four lights are interpolated at once with SSE2 or NEON when available.
+class SpatialMapping
+{
+public:
+    //! \brief Constructor
+    //! \param locations Location of each light, usually Group::getLightLocations()
+    //! \param width, height, depth Size of the grids which are sampled
+    //! \throws HueException when a size is zero
+    SpatialMapping(const std::vector<LightLocation>& locations, std::size_t width, std::size_t height,
+        std::size_t depth = 1);
+
+    //! \brief Get number of lights
+    std::size_t getLightCount() const;
+
+    //! \brief Sample the colors of consecutive lights with 16 bits per channel
+    //! \param grid Grid with the size of the mapping
+    //! \param first Index of the first light
+    //! \param count Number of lights, <tt>first + count</tt> must not be greater than \ref getLightCount
+    //! \param channels Receives red, green and blue for each light, like EntertainmentMode::setChannels()
+    //! \throws HueException when the size of the grid does not match or the lights are out of range
+    void sample(const ColorGrid& grid, std::size_t first, std::size_t count, uint16_t* channels) const;
+
+    //! \brief Sample the colors of consecutive lights with 8 bits per channel
+    //! \param grid Grid with the size of the mapping
+    //! \param first Index of the first light
+    //! \param count Number of lights, <tt>first + count</tt> must not be greater than \ref getLightCount
+    //! \param colors Receives the color of each light, like EntertainmentMode::setColorsRGB()
+    //! \throws HueException when the size of the grid does not match or the lights are out of range
+    void sample(const ColorGrid& grid, std::size_t first, std::size_t count, RGB* colors) const;
+
+private:
+    //! \brief Check that the grid has the size of the mapping and the lights are in range
+    void checkArguments(const ColorGrid& grid, std::size_t first, std::size_t count) const;
+    //! \brief Interpolate the channels of four lights starting at \c light, with values from 0 to 1
+    void interpolate(const ColorGrid& grid, std::size_t light, float* red, float* green, float* blue) const;
+
+private:
+    std::size_t width;
+    std::size_t height;
+    std::size_t depth;
+    std::size_t lightCount;
+    std::size_t corners; //!< cells which are interpolated for each light, 2, 4 or 8
+    std::size_t stride; //!< light count plus three unused lights, so four lights can be loaded from any light
+    std::vector<uint32_t> indices; //!< cell index of each corner and light, corner * stride + light
+    std::vector<float> weights; //!< weight of each corner and light, ordered like indices
+};
+} // namespace hueplusplus
+
+#endif
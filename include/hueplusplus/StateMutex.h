@@ -0,0 +1,79 @@
+/**
+    \file StateMutex.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_STATE_MUTEX_H
+#define INCLUDE_HUEPLUSPLUS_STATE_MUTEX_H
+
+#include <atomic>
+#include <shared_mutex>
+#include <thread>
+
+namespace hueplusplus
+{
+//! \brief Recursive reader-writer mutex which protects the cached state of a bridge
+//!
+//! Readers lock it with lock_shared() and run in parallel, writers lock it exclusively with lock().
+//! Both can be locked again by the thread which holds them, so library functions can call each other.
+//! A thread which holds the exclusive lock can also lock it shared, which only counts as another exclusive lock.
+//! Locking exclusively while only holding a shared lock would deadlock and throws instead.
+//!
+//! Can be used with std::unique_lock, std::lock_guard and std::shared_lock.
+class StateMutex
+{
+public:
+    //! \brief Creates an unlocked mutex
+    StateMutex() = default;
+    StateMutex(const StateMutex&) = delete;
+    StateMutex& operator=(const StateMutex&) = delete;
+
+    //! \brief Lock exclusively, blocks until all other threads unlocked it
+    //! \throws std::system_error with std::errc::resource_deadlock_would_occur when the thread
+    //! only holds a shared lock
+    void lock();
+    //! \brief Try to lock exclusively without blocking
+    //! \returns true when the lock was acquired
+    bool try_lock();
+    //! \brief Release one exclusive lock
+    void unlock();
+
+    //! \brief Lock shared, blocks while another thread holds the exclusive lock
+    void lock_shared();
+    //! \brief Try to lock shared without blocking
+    //! \returns true when the lock was acquired
+    bool try_lock_shared();
+    //! \brief Release one shared lock
+    void unlock_shared();
+
+    //! \brief Check whether the calling thread holds the exclusive lock
+    bool isLockedExclusively() const;
+    //! \brief Check whether the calling thread holds the lock, shared or exclusively
+    bool isLocked() const;
+
+private:
+    std::shared_timed_mutex mutex;
+    //! Thread which holds the exclusive lock
+    std::atomic<std::thread::id> owner;
+    //! Number of exclusive locks of the owner, only accessed by the owner
+    unsigned int exclusiveCount = 0;
+};
+} // namespace hueplusplus
+
+#endif
@@ -0,0 +1,174 @@
+/**
+    \file StateRequest.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_STATE_REQUEST_H
+#define INCLUDE_HUEPLUSPLUS_STATE_REQUEST_H
+
+#include <cstdint>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+namespace hueplusplus
+{
+//! \brief Typed body of a light or group state request
+//!
+//! Stores the set fields as a bitmask and the values in a fixed layout, so building a request
+//! does not allocate. Used by StateTransaction, only converted to json where an API needs it.
+//! Values are stored as given, clamping is done by StateTransaction.
+class StateRequest
+{
+public:
+    //! \brief Fields of the request, in order of their json keys
+    enum Field : uint16_t
+    {
+        alert = 1 << 0, //!< "alert"
+        bri = 1 << 1, //!< "bri"
+        briInc = 1 << 2, //!< "bri_inc"
+        ct = 1 << 3, //!< "ct"
+        ctInc = 1 << 4, //!< "ct_inc"
+        effect = 1 << 5, //!< "effect"
+        hue = 1 << 6, //!< "hue"
+        hueInc = 1 << 7, //!< "hue_inc"
+        on = 1 << 8, //!< "on"
+        sat = 1 << 9, //!< "sat"
+        satInc = 1 << 10, //!< "sat_inc"
+        transitiontime = 1 << 11, //!< "transitiontime"
+        xy = 1 << 12, //!< "xy"
+        xyInc = 1 << 13 //!< "xy_inc"
+    };
+    //! \brief Number of fields
+    static constexpr int fieldCount = 14;
+
+    //! \brief Value of the alert field
+    enum class Alert : uint8_t
+    {
+        none, //!< "none"
+        select, //!< "select"
+        lselect //!< "lselect"
+    };
+    //! \brief Value of the effect field
+    enum class Effect : uint8_t
+    {
+        none, //!< "none"
+        colorloop //!< "colorloop"
+    };
+
+public:
+    //! \brief Get json key of a single field
+    static const char* getKey(Field field);
+
+    //! \brief Check whether a field is set
+    bool has(Field field) const { return (fields & field) != 0; }
+    //! \brief Get set fields as bitmask of \ref Field
+    uint16_t getFields() const { return fields; }
+    //! \brief Check whether no field is set
+    bool empty() const { return fields == 0; }
+    //! \brief Get number of set fields
+    int size() const;
+    //! \brief Remove a field
+    void remove(Field field) { fields &= static_cast<uint16_t>(~field); }
+
+    //! \brief Set "on"
+    void setOn(bool value);
+    //! \brief Set "bri"
+    void setBrightness(int value);
+    //! \brief Set "hue"
+    void setHue(int value);
+    //! \brief Set "sat"
+    void setSaturation(int value);
+    //! \brief Set "xy"
+    void setXY(float x, float y);
+    //! \brief Set "ct"
+    void setColorTemperature(int value);
+    //! \brief Set "effect"
+    void setEffect(Effect value);
+    //! \brief Set "alert"
+    void setAlert(Alert value);
+    //! \brief Set "transitiontime"
+    void setTransition(int value);
+    //! \brief Set "bri_inc"
+    void setBrightnessIncrement(int value);
+    //! \brief Set "sat_inc"
+    void setSaturationIncrement(int value);
+    //! \brief Set "hue_inc"
+    void setHueIncrement(int value);
+    //! \brief Set "ct_inc"
+    void setColorTemperatureIncrement(int value);
+    //! \brief Set "xy_inc"
+    void setXYIncrement(float x, float y);
+
+    //! \brief Get "on", only valid if the field is set
+    bool getOn() const { return onValue; }
+    //! \brief Get "bri", only valid if the field is set
+    int getBrightness() const { return briValue; }
+
+    //! \brief Remove fields which are already set in the state
+    //! \param state Light state (the "state" object of the light)
+    //!
+    //! Color fields are only removed when the colormode matches, xy is compared with a tolerance.
+    void trim(const nlohmann::json& state);
+
+    //! \brief Serialize request as compact json
+    //! \param buffer Output buffer, is overwritten. Does not allocate when its capacity is sufficient.
+    //!
+    //! The output is identical to toJson().dump().
+    void serialize(std::string& buffer) const;
+
+    //! \brief Convert request to json
+    nlohmann::json toJson() const;
+
+    //! \brief Check whether a PUT reply confirms all changes of the request
+    //! \param path Path the request was sent to
+    //! \param reply Reply from the bridge
+    //! \returns true when the reply is not empty and every entry is a success for a field of the request
+    //! with the same value, false otherwise.
+    //!
+    //! Same behavior as utils::validatePUTReply, but without converting the request to json.
+    bool validateReply(const std::string& path, const nlohmann::json& reply) const;
+
+    //! \brief Write all fields except transitiontime into state
+    //! \param state Light state (the "state" object of the light) to update
+    void applyTo(nlohmann::json& state) const;
+
+private:
+    bool valueMatches(Field field, const nlohmann::json& value) const;
+
+private:
+    uint16_t fields = 0;
+    uint16_t transitionValue = 0;
+    int32_t hueValue = 0;
+    int32_t hueIncValue = 0;
+    int32_t ctIncValue = 0;
+    float xyValue[2] = {0.f, 0.f};
+    float xyIncValue[2] = {0.f, 0.f};
+    int16_t briValue = 0;
+    int16_t briIncValue = 0;
+    int16_t satValue = 0;
+    int16_t satIncValue = 0;
+    int16_t ctValue = 0;
+    bool onValue = false;
+    Effect effectValue = Effect::none;
+    Alert alertValue = Alert::none;
+};
+} // namespace hueplusplus
+
+#endif
@@ -25,9 +25,12 @@
 
 #include <string>
 
+#include "APICache.h"
 #include "Action.h"
 #include "ColorUnits.h"
+#include "DecodedLightState.h"
 #include "HueCommandAPI.h"
+#include "StateRequest.h"
 
 #include <nlohmann/json.hpp>
 
@@ -39,9 +42,9 @@ namespace hueplusplus
 //! \code
 //! light.transaction().setOn(true).setBrightness(29).setColorHue(3000).setColorSaturation(128).commit();
 //! \endcode
-//! \note The transaction has an internal reference to the light state.
-//! You must not cause a refresh of the state between creating and committing the transaction
-//! (e.g. non-const getters/setters), because that invalidates the reference.
+//! \note The transaction of a light refers to the state cache of the light, which has to live longer
+//! than the transaction. The current state is looked up while holding the state mutex when the transaction
+//! is committed, so refreshes in the meantime are taken into account.
 //!
 //! <h3>Advanced usage</h3>
 //! Another way to use the transaction is by storing it and building up the calls separately.
@@ -66,7 +69,15 @@ public:
     //! \param path Path to which the final PUT request is made (without username)
     //! \param currentState Optional, the current state to check whether changes are needed.
     //! Pass nullptr to always include all requests (for groups, because individual lights might be different).
-    StateTransaction(const HueCommandAPI& commands, const std::string& path, nlohmann::json* currentState);
+    //! \param decodedState Optional, decoded copy of \c currentState which is updated together with it.
+    StateTransaction(const HueCommandAPI& commands, const std::string& path, nlohmann::json* currentState,
+        DecodedLightState* decodedState = nullptr);
+    //! \brief Creates a StateTransaction to the cached state of a light
+    //! \param stateCache Cache of the light, the member \c "state" of its value is the current state.
+    //! It is looked up when the transaction is committed, so no reference into the cache is kept.
+    //! \param path Path to which the final PUT request is made (without username)
+    //! \param decodedState Optional, decoded state of the light which is updated together with the cache.
+    StateTransaction(APICache& stateCache, const std::string& path, DecodedLightState* decodedState = nullptr);
 
     //! \brief Deleted copy constructor, do not store StateTransaction in a variable.
     StateTransaction(const StateTransaction&) = delete;
@@ -79,6 +90,8 @@ public:
     //! \returns true on success or when no change was requested.
     //! \note After changing the state of a Light or Group,
     //! refresh() must be called if the updated values are needed immediately.
+    //! \note The state is read and updated while holding the state mutex of the bridge,
+    //! but the request is sent without it, see \ref concurrency.
     //! \throws std::system_error when system or socket operations fail
     //! \throws HueException when response contains no body
     //! \throws HueAPIResponseException when response contains an error
@@ -190,12 +203,17 @@ public:
 protected:
     //! \brief Remove parts from request that are already set in state
     void trimRequest();
+    //! \brief Get the current state, must be called with the state mutex
+    //! \returns The state passed to the constructor or the state in \ref stateCache, nullptr if there is none
+    nlohmann::json* getState();
 
 protected:
     const HueCommandAPI& commands;
     std::string path;
     nlohmann::json* state;
-    nlohmann::json request;
+    APICache* stateCache;
+    DecodedLightState* decodedState;
+    StateRequest request;
 };
 
 } // namespace hueplusplus
@@ -0,0 +1,175 @@
+/**
+    \file StreamCoordinator.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_STREAM_COORDINATOR_H
+#define INCLUDE_HUEPLUSPLUS_STREAM_COORDINATOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "StreamingEngine.h"
+
+namespace hueplusplus
+{
+//! \brief Statistics of the time between the sessions of a StreamCoordinator
+struct SkewStatistics
+{
+    //! \brief Number of send times where frames were sent
+    std::size_t ticks = 0;
+    //! \brief Average time between sending the first and the last frame of a send time
+    std::chrono::nanoseconds meanSkew {0};
+    //! \brief Maximum time between sending the first and the last frame of a send time
+    std::chrono::nanoseconds maxSkew {0};
+};
+
+//! \brief Sends the frames of several streaming sessions from one clock
+//!
+//! Each session is usually an EntertainmentMode of a different group or bridge. Instead of a StreamingEngine
+//! for each session, which would send at unrelated points in time, one sender thread sends the frames of all
+//! sessions right after each other at every send time. This keeps the sessions frame aligned.
+//!
+//! Frames are written with getFrame() and published for one session or for all sessions together.
+//! Frames which are published together are always sent at the same send time.
+class StreamCoordinator
+{
+public:
+    //! \brief Function which sends one frame of a session
+    using SendFunction = StreamingEngine::SendFunction;
+
+    //! \brief Creates coordinator without sessions, does not start sending
+    StreamCoordinator() = default;
+    StreamCoordinator(const StreamCoordinator&) = delete;
+    StreamCoordinator& operator=(const StreamCoordinator&) = delete;
+    //! \brief Stops the sender thread
+    ~StreamCoordinator();
+
+    //! \brief Add a session
+    //!
+    //! Can be called while running, the session is sent from the next send time on.
+    //! \param initial Frame which is sent until the first frame is published
+    //! \param send Function which sends a frame, called from the sender thread.
+    //! Exceptions thrown by it are counted as send errors of the session.
+    //! \returns Id of the session, which stays valid until it is removed. Ids of removed sessions are reused.
+    //! \note Must be called from the thread which writes the frames.
+    std::size_t addSession(const std::vector<uint8_t>& initial, SendFunction send);
+
+    //! \brief Remove a session
+    //!
+    //! When running, waits until the frames of the current send time are sent,
+    //! so the send function is not called anymore afterwards.
+    //! \throws HueException when the session id is invalid
+    //! \note Must be called from the thread which writes the frames.
+    void removeSession(std::size_t session);
+
+    //! \brief Get number of sessions
+    std::size_t getSessionCount() const;
+
+    //! \brief Start the sender thread
+    //! \param rate Frames per second, usually 25, 50 or 60
+    //! \throws HueException when rate is not positive or the coordinator is already running
+    void start(int rate);
+
+    //! \brief Stop the sender thread
+    //!
+    //! Waits until the frames which are currently sent are finished. Does nothing when not running.
+    void stop();
+
+    //! \brief Check whether the sender thread is running
+    bool isRunning() const;
+
+    //! \brief Get the rate set with start()
+    int getRate() const;
+
+    //! \brief Get the frame of a session which is written by the producer
+    //!
+    //! Contains the last published frame. Changes are not sent until they are published.
+    //! The reference is valid until the session is removed.
+    //! \note Only one thread at a time may write and publish frames.
+    //! \throws HueException when the session id is invalid
+    std::vector<uint8_t>& getFrame(std::size_t session);
+
+    //! \brief Publish the frame of one session to be sent at the next send time
+    //! \throws HueException when the session id is invalid
+    void publish(std::size_t session);
+
+    //! \brief Publish the frames of all sessions to be sent at the same send time
+    void publish();
+
+    //! \brief Get the statistics of a session since start() or resetStatistics()
+    //!
+    //! The jitter includes the time until the frames of the sessions before were sent.
+    //! \throws HueException when the session id is invalid
+    StreamStatistics getStatistics(std::size_t session) const;
+
+    //! \brief Get the skew between the sessions since start() or resetStatistics()
+    SkewStatistics getSkewStatistics() const;
+
+    //! \brief Reset all statistics to zero
+    void resetStatistics();
+
+private:
+    struct Session
+    {
+        Session(const std::vector<uint8_t>& initial, SendFunction send);
+
+        FrameBuffer frames;
+        SendFunction send;
+        StatisticsCounter statistics;
+        //! Whether the frame taken at the current send time was published since the last one
+        bool fresh = false;
+    };
+
+private:
+    //! \brief Get session and throw when it does not exist, sessionMutex must be locked
+    Session& getSessionLocked(std::size_t session) const;
+    void run(std::chrono::steady_clock::duration period);
+
+private:
+    //! Removed sessions are null until the slot is reused, so the ids of the other sessions stay valid
+    std::vector<std::unique_ptr<Session>> sessions;
+    //! Sessions of the current send time, only used by the sender thread
+    std::vector<Session*> sending;
+    int rate = 0;
+    std::thread sender;
+
+    //! Held while frames are sent and while sessions are removed
+    std::mutex sendMutex;
+    //! Protects the list of sessions
+    mutable std::mutex sessionMutex;
+    //! Held while frames are published and taken, so frames published together are sent together
+    std::mutex publishMutex;
+    //! Protects the statistics and the stop request
+    mutable std::mutex mutex;
+    std::condition_variable stopped;
+    bool stopRequested = false;
+    SkewStatistics skew;
+    //! Sum of all skews, for the mean
+    std::chrono::nanoseconds totalSkew {0};
+};
+} // namespace hueplusplus
+
+#endif
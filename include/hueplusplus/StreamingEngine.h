@@ -0,0 +1,285 @@
+/**
+    \file StreamingEngine.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_STREAMING_ENGINE_H
+#define INCLUDE_HUEPLUSPLUS_STREAMING_ENGINE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hueplusplus
+{
+//! \brief Triple buffer which passes frames from one producer to one consumer without locking
+//!
+//! The producer writes into its back buffer and publishes it, the consumer takes the newest published frame.
+//! Neither side ever waits for the other and the consumer never sees a frame which is still written.
+//! When the producer publishes faster than the consumer takes frames, the older frames are overwritten.
+class FrameBuffer
+{
+public:
+    //! \brief Creates frame buffer where all frames are a copy of \c initial
+    explicit FrameBuffer(const std::vector<uint8_t>& initial);
+
+    //! \brief Get the frame which is written by the producer
+    //!
+    //! Contains the last published frame, so it can be updated partially.
+    //! \note Must only be used by the producer.
+    std::vector<uint8_t>& back();
+
+    //! \brief Publish the back buffer as the newest frame
+    //! \note Must only be called by the producer.
+    void publish();
+
+    //! \brief Take the newest published frame
+    //! \returns true when a new frame was published since the last call
+    //! \note Must only be called by the consumer.
+    bool consume();
+
+    //! \brief Get the frame which was taken by the last consume()
+    //! \note Must only be used by the consumer.
+    const std::vector<uint8_t>& front() const;
+
+    //! \brief Get number of published frames which were overwritten before the consumer took them
+    std::size_t getOverwrittenCount() const;
+
+private:
+    //! Bit of the middle index which is set when the middle buffer has not been consumed
+    static constexpr unsigned int freshBit = 4;
+
+    std::array<std::vector<uint8_t>, 3> buffers;
+    unsigned int backIndex = 0;
+    unsigned int frontIndex = 1;
+    //! Index of the last published buffer, combined with freshBit
+    std::atomic<unsigned int> middle {2};
+    std::atomic<std::size_t> overwritten {0};
+};
+
+//! \brief Statistics of a StreamingEngine
+struct StreamStatistics
+{
+    //! \brief Number of frames which were sent
+    std::size_t sentFrames = 0;
+    //! \brief Number of sent frames which contained no new data, because nothing was published in time
+    std::size_t repeatedFrames = 0;
+    //! \brief Number of send slots which were skipped, because the sender was late by more than one period
+    std::size_t droppedFrames = 0;
+    //! \brief Number of published frames which were replaced by a newer frame before they were sent
+    std::size_t overwrittenFrames = 0;
+    //! \brief Number of frames where the send function failed
+    std::size_t sendErrors = 0;
+    //! \brief Average delay of sending after the scheduled time
+    std::chrono::nanoseconds meanJitter {0};
+    //! \brief Maximum delay of sending after the scheduled time
+    std::chrono::nanoseconds maxJitter {0};
+};
+
+//! \brief Send times at a fixed rate, shared by the sender threads of StreamingEngine and StreamCoordinator
+//!
+//! The send times are scheduled from the start time, so delays of single frames do not accumulate.
+//! When the sender is late by more than one period, the send times which have passed completely are skipped
+//! instead of sending a burst of frames.
+class SendSchedule
+{
+public:
+    //! \brief Creates schedule where \c start is the first send time
+    SendSchedule(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::duration period);
+
+    //! \brief Get the current send time
+    std::chrono::steady_clock::time_point getNext() const;
+
+    //! \brief Skip the send times which have passed completely
+    //! \param now Time when the sender woke up
+    //! \returns Number of skipped send times
+    std::size_t skipPassed(std::chrono::steady_clock::time_point now);
+
+    //! \brief Get the delay of \c time after the current send time
+    std::chrono::nanoseconds getJitter(std::chrono::steady_clock::time_point time) const;
+
+    //! \brief Move to the next send time
+    void advance();
+
+private:
+    std::chrono::steady_clock::time_point next;
+    std::chrono::steady_clock::duration period;
+};
+
+//! \brief Counts the statistics of one stream
+//!
+//! Not synchronized, the owner locks its mutex while the sender thread counts frames.
+class StatisticsCounter
+{
+public:
+    //! \brief Count a frame which was sent
+    //! \param fresh Whether the frame was published since the previous send time
+    //! \param success Whether the send function succeeded
+    //! \param skipped Number of send times which were skipped before the frame
+    //! \param jitter Delay after the scheduled send time
+    void countFrame(bool fresh, bool success, std::size_t skipped, std::chrono::nanoseconds jitter);
+
+    //! \brief Get the statistics, including the overwritten frames of \c frames
+    StreamStatistics get(const FrameBuffer& frames) const;
+
+    //! \brief Reset all statistics to zero
+    //! \param frames Frame buffer of the stream, frames overwritten before are not counted
+    void reset(const FrameBuffer& frames);
+
+private:
+    StreamStatistics statistics;
+    //! Sum of all jitters, for the mean
+    std::chrono::nanoseconds totalJitter {0};
+    //! Value of FrameBuffer::getOverwrittenCount() at the last reset
+    std::size_t overwrittenBase = 0;
+};
+
+//! \brief Sends frames at a fixed rate from a dedicated thread
+//!
+//! Producers write frames with getFrame() and publish(), which never block. The sender thread wakes up
+//! at fixed points in time, takes the newest published frame and sends it. When nothing was published,
+//! the previous frame is sent again, so the receiver gets a steady stream independent of the producer.
+//! The send times are scheduled from the start time, so delays of single frames do not accumulate.
+class StreamingEngine
+{
+public:
+    //! \brief Function which sends one frame
+    //! \returns true when the frame was sent successfully
+    using SendFunction = std::function<bool(const std::vector<uint8_t>&)>;
+
+    //! \brief Creates streaming engine, does not start sending
+    //! \param initial Frame which is sent until the first frame is published
+    //! \param send Function which sends a frame, called from the sender thread.
+    //! Exceptions thrown by it are counted as send errors.
+    StreamingEngine(const std::vector<uint8_t>& initial, SendFunction send);
+    StreamingEngine(const StreamingEngine&) = delete;
+    StreamingEngine& operator=(const StreamingEngine&) = delete;
+    //! \brief Stops the sender thread
+    ~StreamingEngine();
+
+    //! \brief Start the sender thread
+    //! \param rate Frames per second, usually 25, 50 or 60
+    //! \throws HueException when rate is not positive or the engine is already running
+    void start(int rate);
+
+    //! \brief Stop the sender thread
+    //!
+    //! Waits until the frame which is currently sent is finished. Does nothing when not running.
+    void stop();
+
+    //! \brief Check whether the sender thread is running
+    bool isRunning() const;
+
+    //! \brief Get the rate set with start()
+    int getRate() const;
+
+    //! \brief Get the frame which is written by the producer
+    //!
+    //! Contains the last published frame. Changes are not sent until publish() is called.
+    //! \note Only one thread at a time may write and publish frames.
+    std::vector<uint8_t>& getFrame();
+
+    //! \brief Publish the frame from getFrame() to be sent at the next send time
+    void publish();
+
+    //! \brief Get the statistics since start() or resetStatistics()
+    StreamStatistics getStatistics() const;
+
+    //! \brief Reset all statistics to zero
+    void resetStatistics();
+
+    //! \brief Call \c send from a sender thread
+    //! \returns Result of \c send, false when it throws
+    static bool sendFrame(const SendFunction& send, const std::vector<uint8_t>& frame);
+
+private:
+    void run(std::chrono::steady_clock::duration period);
+
+private:
+    FrameBuffer frames;
+    SendFunction send;
+    int rate = 0;
+    std::thread sender;
+
+    mutable std::mutex mutex;
+    std::condition_variable stopped;
+    bool stopRequested = false;
+    StatisticsCounter statistics;
+};
+
+//! \brief Calls a function when nothing happened for some time
+//!
+//! Used to keep a connection alive, which is closed by the other side when it is idle for too long.
+//! Every activity is reported with touch(), which is cheap and never blocks. When there was no
+//! activity for the interval, the function is called from a separate thread, which counts as activity.
+class IdleTimer
+{
+public:
+    //! \brief Creates idle timer, does not start it
+    //! \param interval Time without activity until \c callback is called
+    //! \param callback Function which is called from the timer thread. Exceptions thrown by it are ignored.
+    IdleTimer(std::chrono::steady_clock::duration interval, std::function<void()> callback);
+    IdleTimer(const IdleTimer&) = delete;
+    IdleTimer& operator=(const IdleTimer&) = delete;
+    //! \brief Stops the timer thread
+    ~IdleTimer();
+
+    //! \brief Start the timer thread, the interval starts now
+    //! \throws HueException when the interval is not positive or the timer is already running
+    void start();
+
+    //! \brief Stop the timer thread
+    //!
+    //! Waits until a running callback is finished. Does nothing when not running.
+    void stop();
+
+    //! \brief Check whether the timer thread is running
+    bool isRunning() const;
+
+    //! \brief Report activity, so the interval starts again
+    void touch();
+
+    //! \brief Get number of times the callback was called
+    std::size_t getFireCount() const;
+
+private:
+    void run();
+
+private:
+    std::chrono::steady_clock::duration interval;
+    std::function<void()> callback;
+    std::thread timer;
+    //! Time of the last activity, as steady_clock::duration since the epoch
+    std::atomic<std::chrono::steady_clock::rep> lastActivity {0};
+    std::atomic<std::size_t> fireCount {0};
+
+    std::mutex mutex;
+    std::condition_variable stopped;
+    bool stopRequested = false;
+};
+} // namespace hueplusplus
+
+#endif
@@ -0,0 +1,97 @@
+/**
+    \file TimerScheduler.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_TIMER_SCHEDULER_H
+#define INCLUDE_HUEPLUSPLUS_TIMER_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace hueplusplus
+{
+//! \brief Runs delayed tasks on a single background thread
+//!
+//! Tasks are executed in order of their due time, tasks with the same due time in order of scheduling.
+//! The thread is only started when the first task is scheduled.
+//! Exceptions thrown by tasks are caught and printed to std::cerr.
+class TimerScheduler
+{
+public:
+    //! \brief Task which is run when the timer expires
+    using Task = std::function<void()>;
+
+    //! \brief Creates scheduler without starting the thread
+    TimerScheduler() = default;
+    TimerScheduler(const TimerScheduler&) = delete;
+    TimerScheduler& operator=(const TimerScheduler&) = delete;
+    //! \brief Stops the thread, tasks which are not yet due are discarded
+    ~TimerScheduler();
+
+    //! \brief Schedule a task
+    //! \param delay Duration after which the task is run
+    //! \param task Task to run, may schedule further tasks
+    void schedule(std::chrono::steady_clock::duration delay, Task task);
+
+    //! \brief Get number of scheduled and currently running tasks
+    std::size_t getPendingCount() const;
+
+    //! \brief Block until all scheduled tasks, including tasks scheduled by them, have run
+    //! \note Must not be called from a task.
+    void waitIdle();
+
+    //! \brief Get shared scheduler instance, used for asynchronous alerts
+    static TimerScheduler& instance();
+
+private:
+    struct Entry
+    {
+        std::chrono::steady_clock::time_point due;
+        uint64_t sequence;
+        Task task;
+    };
+    struct Later
+    {
+        bool operator()(const Entry& lhs, const Entry& rhs) const
+        {
+            return lhs.due > rhs.due || (lhs.due == rhs.due && lhs.sequence > rhs.sequence);
+        }
+    };
+
+    void run();
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    std::priority_queue<Entry, std::vector<Entry>, Later> tasks;
+    uint64_t nextSequence = 0;
+    std::size_t running = 0;
+    bool stopped = false;
+    std::thread thread;
+};
+} // namespace hueplusplus
+
+#endif
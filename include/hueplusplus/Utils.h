@@ -23,6 +23,9 @@
 #ifndef INCLUDE_HUEPLUSPLUS_UTILS_H
 #define INCLUDE_HUEPLUSPLUS_UTILS_H
 
+#include <string>
+#include <vector>
+
 #include <nlohmann/json.hpp>
 
 namespace hueplusplus
@@ -33,36 +36,39 @@ namespace utils
 namespace detail
 {
 // Forward declaration
-template <typename KeyT, typename... Paths>
-nlohmann::json safeGetMemberHelper(const nlohmann::json& json, std::size_t index, Paths&&... otherPaths);
+template <typename... Paths>
+const nlohmann::json* findMemberHelper(const nlohmann::json& json, std::size_t index, Paths&&... otherPaths);
 
-inline nlohmann::json safeGetMemberHelper(const nlohmann::json& json)
+inline const nlohmann::json* findMemberHelper(const nlohmann::json& json)
 {
-    return json;
+    return &json;
 }
 
 template <typename KeyT, typename... Paths,
     std::enable_if_t<!std::is_integral<std::remove_reference_t<KeyT>>::value>* = nullptr>
-nlohmann::json safeGetMemberHelper(const nlohmann::json& json, KeyT&& key, Paths&&... otherPaths)
+const nlohmann::json* findMemberHelper(const nlohmann::json& json, KeyT&& key, Paths&&... otherPaths)
 {
     auto memberIt = json.find(std::forward<KeyT>(key));
     if (memberIt == json.end())
     {
         return nullptr;
     }
-    return safeGetMemberHelper(*memberIt, std::forward<Paths>(otherPaths)...);
+    return findMemberHelper(*memberIt, std::forward<Paths>(otherPaths)...);
 }
 
-// Needs to be after the other safeGetMemberHelper, otherwise another forward declaration is needed
+// Needs to be after the other findMemberHelper, otherwise another forward declaration is needed
 template <typename... Paths>
-nlohmann::json safeGetMemberHelper(const nlohmann::json& json, std::size_t index, Paths&&... otherPaths)
+const nlohmann::json* findMemberHelper(const nlohmann::json& json, std::size_t index, Paths&&... otherPaths)
 {
     if (!json.is_array() || json.size() <= index)
     {
         return nullptr;
     }
-    return safeGetMemberHelper(json[index], std::forward<Paths>(otherPaths)...);
+    return findMemberHelper(json[index], std::forward<Paths>(otherPaths)...);
 }
+
+//! \brief Null value returned by reference when a member does not exist
+const nlohmann::json& nullValue();
 } // namespace detail
 
 //! \brief Function for validating that a request was executed correctly
@@ -83,17 +89,87 @@ inline bool floatEquals(float lhs, float rhs)
     return std::abs(lhs - rhs) <= 1E-4f;
 }
 
+//! \brief Returns a pointer to the object/array member or nullptr if it does not exist
+//!
+//! \param json The base json value
+//! \param paths Any number of child accesses (e.g. 0, "key" would access json[0]["key"])
+//! \returns Pointer to the specified member, valid as long as json is not modified,
+//! or nullptr if any intermediate object does not contain the specified child.
+template <typename... Paths>
+const nlohmann::json* findMember(const nlohmann::json& json, Paths&&... paths)
+{
+    return detail::findMemberHelper(json, std::forward<Paths>(paths)...);
+}
+
+//! \brief Returns a reference to the object/array member or to null if it does not exist
+//!
+//! Same as safeGetMember(), but does not copy the member.
+//! \param json The base json value
+//! \param paths Any number of child accesses (e.g. 0, "key" would access json[0]["key"])
+//! \returns Reference to the specified member, valid as long as json is not modified,
+//! or to null if any intermediate object does not contain the specified child.
+template <typename... Paths>
+const nlohmann::json& safeGetMemberRef(const nlohmann::json& json, Paths&&... paths)
+{
+    const nlohmann::json* member = findMember(json, std::forward<Paths>(paths)...);
+    return member != nullptr ? *member : detail::nullValue();
+}
+
 //! \brief Returns the object/array member or null if it does not exist
 //!
 //! \param json The base json value
 //! \param paths Any number of child accesses (e.g. 0, "key" would access json[0]["key"])
 //! \returns The specified member or null if any intermediate object does not contain the specified child.
+//! \note Copies the member, use safeGetMemberRef() or findMember() to avoid that.
 template <typename... Paths>
 nlohmann::json safeGetMember(const nlohmann::json& json, Paths&&... paths)
 {
-    return detail::safeGetMemberHelper(json, std::forward<Paths>(paths)...);
+    return safeGetMemberRef(json, std::forward<Paths>(paths)...);
 }
 
+//! \brief Precompiled path to an object/array member, for lookups which are repeated often
+//!
+//! The keys are stored as strings, so lookups do not create temporary key strings.
+//! Create paths once (e.g. as static const) and reuse them.
+class MemberPath
+{
+public:
+    //! \brief Key or array index in a path
+    class Element
+    {
+    public:
+        //! \brief Object key
+        Element(const char* key) : key(key), index(0), isIndex(false) { }
+        //! \brief Object key
+        Element(std::string key) : key(std::move(key)), index(0), isIndex(false) { }
+        //! \brief Array index
+        Element(std::size_t index) : index(index), isIndex(true) { }
+        //! \brief Array index
+        Element(int index) : index(static_cast<std::size_t>(index)), isIndex(true) { }
+
+    private:
+        friend class MemberPath;
+        std::string key;
+        std::size_t index;
+        bool isIndex;
+    };
+
+public:
+    //! \brief Create path from keys and indices
+    //! \param elements Child accesses (e.g. {0, "key"} would access json[0]["key"])
+    MemberPath(std::initializer_list<Element> elements) : elements(elements) { }
+
+    //! \brief Get pointer to the member
+    //! \returns Same as findMember() with the elements of the path
+    const nlohmann::json* find(const nlohmann::json& json) const;
+    //! \brief Get reference to the member
+    //! \returns Same as safeGetMemberRef() with the elements of the path
+    const nlohmann::json& get(const nlohmann::json& json) const;
+
+private:
+    std::vector<Element> elements;
+};
+
 } // namespace utils
 
 namespace detail
@@ -21,10 +21,244 @@
     along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
 **/
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 #include "hueplusplus/HueExceptionMacro.h"
 
 namespace hueplusplus
 {
+namespace
+{
+// Updates target to be equal to source, while reusing the existing nodes and key strings of target.
+// This keeps the long lived cache in place instead of freeing and reallocating the whole document on every refresh,
+// so references into the cache stay valid for entries which still exist.
+void updateInPlace(nlohmann::json& target, nlohmann::json&& source)
+{
+    if (target.is_object() && source.is_object())
+    {
+        for (auto it = target.begin(); it != target.end();)
+        {
+            if (source.find(it.key()) == source.end())
+            {
+                it = target.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        for (auto it = source.begin(); it != source.end(); ++it)
+        {
+            auto pos = target.find(it.key());
+            if (pos != target.end())
+            {
+                updateInPlace(*pos, std::move(*it));
+            }
+            else
+            {
+                target.emplace(it.key(), std::move(*it));
+            }
+        }
+    }
+    else if (target.is_array() && source.is_array() && target.size() == source.size())
+    {
+        for (std::size_t i = 0; i < source.size(); ++i)
+        {
+            updateInPlace(target[i], std::move(source[i]));
+        }
+    }
+    else if (target.is_string() && source.is_string())
+    {
+        // Copy assignment reuses the capacity of the cached string
+        target.get_ref<std::string&>() = source.get_ref<const std::string&>();
+    }
+    else
+    {
+        target = std::move(source);
+    }
+}
+
+// Orders a cached key and a key of a response the same way as the maps of both documents
+int compareKey(const std::string& key, const ArenaString& other)
+{
+    return key.compare(0, std::string::npos, other.data(), other.size());
+}
+
+// Same as above for a response parsed into the refresh arena, which is only copied where target changes.
+// Both objects are sorted maps, so their members are merged in one pass without converting the keys of source.
+void updateInPlace(nlohmann::json& target, const ArenaJson& source)
+{
+    if (target.is_object() && source.is_object())
+    {
+        nlohmann::json::object_t& targetMembers = target.get_ref<nlohmann::json::object_t&>();
+        auto it = targetMembers.begin();
+        for (const auto& member : source.get_ref<const ArenaJson::object_t&>())
+        {
+            // Cached members before the key of the response member are no longer present
+            while (it != targetMembers.end() && compareKey(it->first, member.first) < 0)
+            {
+                it = targetMembers.erase(it);
+            }
+            if (it != targetMembers.end() && compareKey(it->first, member.first) == 0)
+            {
+                updateInPlace(it->second, member.second);
+                ++it;
+            }
+            else
+            {
+                targetMembers.emplace_hint(
+                    it, std::string(member.first.data(), member.first.size()), toJson(member.second));
+            }
+        }
+        targetMembers.erase(it, targetMembers.end());
+    }
+    else if (target.is_array() && source.is_array() && target.size() == source.size())
+    {
+        for (std::size_t i = 0; i < source.size(); ++i)
+        {
+            updateInPlace(target[i], source[i]);
+        }
+    }
+    else if (target.is_string() && source.is_string())
+    {
+        const ArenaString& str = source.get_ref<const ArenaString&>();
+        target.get_ref<std::string&>().assign(str.data(), str.size());
+    }
+    else
+    {
+        target = toJson(source);
+    }
+}
+
+// Arena for parsing the responses of refreshes on this thread, keeps its memory for the next refresh
+RefreshArena& getRefreshArena()
+{
+    thread_local RefreshArena arena;
+    return arena;
+}
+
+// Encodes node as MessagePack, stored in a binary json value
+void pack(nlohmann::json& node)
+{
+    // Scalars are smaller than their encoding
+    if (node.is_object() || node.is_array())
+    {
+        std::vector<std::uint8_t> bytes = nlohmann::json::to_msgpack(node);
+        bytes.shrink_to_fit();
+        node = nlohmann::json::binary(std::move(bytes));
+    }
+}
+
+// Decodes node if it was encoded by pack()
+void unpack(nlohmann::json& node)
+{
+    if (node.is_binary())
+    {
+        node = nlohmann::json::from_msgpack(node.get_binary());
+    }
+}
+
+// Encodes the members of node at the compact depth, node is at level below the root cache
+void encodeAt(nlohmann::json& node, int level, int depth)
+{
+    if (level == depth && level > 0)
+    {
+        pack(node);
+    }
+    else if (level < depth && node.is_object())
+    {
+        for (nlohmann::json& member : node)
+        {
+            encodeAt(member, level + 1, depth);
+        }
+    }
+}
+
+// Collects the members of node at the compact depth which are decoded, node is at level below the root cache
+void findDecoded(const nlohmann::json& node, int level, int depth, std::vector<const nlohmann::json*>& decoded)
+{
+    if (level == depth && level > 0)
+    {
+        if (node.is_object() || node.is_array())
+        {
+            decoded.push_back(&node);
+        }
+    }
+    else if (level < depth && node.is_object())
+    {
+        for (const nlohmann::json& member : node)
+        {
+            findDecoded(member, level + 1, depth, decoded);
+        }
+    }
+}
+
+// Same as encodeAt, but skips the sorted nodes in decoded, so references into them stay valid.
+// A new member which happens to reuse the address of a removed one stays decoded until the next compact().
+void encodeAt(nlohmann::json& node, int level, int depth, const std::vector<const nlohmann::json*>& decoded)
+{
+    if (level == depth && level > 0)
+    {
+        if (!std::binary_search(decoded.begin(), decoded.end(), &node, std::less<const nlohmann::json*>()))
+        {
+            pack(node);
+        }
+    }
+    else if (level < depth && node.is_object())
+    {
+        for (nlohmann::json& member : node)
+        {
+            encodeAt(member, level + 1, depth, decoded);
+        }
+    }
+}
+
+// Decodes node and all of its members, node is at level below the root cache
+void decodeAt(nlohmann::json& node, int level, int depth)
+{
+    if (level <= depth)
+    {
+        unpack(node);
+        if (level < depth && node.is_object())
+        {
+            for (nlohmann::json& member : node)
+            {
+                decodeAt(member, level + 1, depth);
+            }
+        }
+    }
+}
+
+// Checks whether node and its members up to the compact depth are decoded, without changing them
+bool isDecodedAt(const nlohmann::json& node, int level, int depth)
+{
+    if (level > depth)
+    {
+        return true;
+    }
+    if (node.is_binary())
+    {
+        return false;
+    }
+    if (level < depth && node.is_object())
+    {
+        for (const nlohmann::json& member : node)
+        {
+            if (!isDecodedAt(member, level + 1, depth))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Encoded members can only be decoded while holding the exclusive lock
+constexpr const char* c_encodedMessage = "Tried to read an encoded value without the exclusive lock. "
+                                         "Lock the cache with lockShared() or call non-const getValue() first.";
+} // namespace
 
 APICache::APICache(
     std::shared_ptr<APICache> baseCache, const std::string& subEntry, std::chrono::steady_clock::duration refresh)
@@ -32,7 +266,8 @@ APICache::APICache(
       path(subEntry),
       commands(baseCache->commands),
       refreshDuration(refresh),
-      lastRefresh(baseCache->lastRefresh)
+      lastRefresh(baseCache->lastRefresh),
+      invalidations(std::make_shared<std::atomic<unsigned int>>(0))
 { }
 
 APICache::APICache(const std::string& path, const HueCommandAPI& commands, std::chrono::steady_clock::duration refresh,
@@ -41,29 +276,123 @@ APICache::APICache(const std::string& path, const HueCommandAPI& commands, std::
       commands(commands),
       refreshDuration(refresh),
       lastRefresh(initial.is_null() ? std::chrono::steady_clock::time_point() : std::chrono::steady_clock::now()),
+      invalidations(std::make_shared<std::atomic<unsigned int>>(0)),
       value(initial)
 { }
 
 void APICache::refresh()
 {
+    // Invalidations during the request need another refresh
+    const unsigned int generation = invalidations->load();
     // Only refresh part of the cache, because that is more efficient
     if (base && base->needsRefresh())
     {
         base->refresh();
+        markSeen(generation);
+        return;
     }
-    else
+    std::vector<std::string> selected;
+    JsonFilter requestFilter;
+    bool arenaParsing = false;
     {
-        nlohmann::json result = commands.GETRequest(getRequestPath(), nlohmann::json::object(), CURRENT_FILE_INFO);
-        lastRefresh = std::chrono::steady_clock::now();
-        if (base)
+        std::lock_guard<StateMutex> lock(commands.getStateMutex());
+        if (base && !base->isLoaded(path))
         {
-            base->value[path] = std::move(result);
+            throw HueException(CURRENT_FILE_INFO, "Entry " + path + " is not loaded by the base cache");
         }
-        else
+        selected = entries;
+        requestFilter = getRequestFilter();
+        arenaParsing = getRoot().arenaParsing;
+    }
+    if (!selected.empty())
+    {
+        for (const std::string& entry : selected)
         {
-            value = std::move(result);
+            refreshEntry(entry);
         }
+        markRefreshed();
+        markSeen(generation);
+        return;
+    }
+    // Other threads can read the cached value during the request
+    if (arenaParsing)
+    {
+        // The response is destroyed before the scope resets the arena
+        RefreshArena::Scope scope(getRefreshArena());
+        ArenaJson result
+            = commands.GETRequestArena(getRequestPath(), nlohmann::json::object(), requestFilter, CURRENT_FILE_INFO);
+        std::lock_guard<StateMutex> lock(commands.getStateMutex());
+        lastRefresh = std::chrono::steady_clock::now();
+        seenInvalidations = generation;
+        storeValue(result);
+        return;
+    }
+    nlohmann::json result
+        = commands.GETRequest(getRequestPath(), nlohmann::json::object(), requestFilter, CURRENT_FILE_INFO);
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    lastRefresh = std::chrono::steady_clock::now();
+    seenInvalidations = generation;
+    storeValue(std::move(result));
+}
+
+void APICache::refreshEntry(const std::string& entry)
+{
+    JsonFilter entryFilter;
+    bool arenaParsing = false;
+    {
+        std::lock_guard<StateMutex> lock(commands.getStateMutex());
+        entryFilter = getRequestFilter().getChild(entry);
+        arenaParsing = getRoot().arenaParsing;
+    }
+    if (arenaParsing)
+    {
+        RefreshArena::Scope scope(getRefreshArena());
+        ArenaJson result = commands.GETRequestArena(
+            getRequestPath() + '/' + entry, nlohmann::json::object(), entryFilter, CURRENT_FILE_INFO);
+        std::lock_guard<StateMutex> lock(commands.getStateMutex());
+        storeEntry(entry, result);
+        return;
     }
+    nlohmann::json result = commands.GETRequest(
+        getRequestPath() + '/' + entry, nlohmann::json::object(), entryFilter, CURRENT_FILE_INFO);
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    storeEntry(entry, std::move(result));
+}
+
+void APICache::markRefreshed()
+{
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    lastRefresh = std::chrono::steady_clock::now();
+}
+
+void APICache::updateValue(const nlohmann::json& newValue, std::chrono::steady_clock::time_point refreshTime)
+{
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    if (base || refreshTime <= lastRefresh)
+    {
+        return;
+    }
+    nlohmann::json decoded = newValue;
+    unpack(decoded);
+    storeValue(std::move(decoded));
+    lastRefresh = refreshTime;
+}
+
+void APICache::invalidate()
+{
+    ++*invalidations;
+}
+
+std::function<void()> APICache::getInvalidator() const
+{
+    std::weak_ptr<std::atomic<unsigned int>> weakInvalidations = invalidations;
+    return [weakInvalidations]() {
+        std::shared_ptr<std::atomic<unsigned int>> counter = weakInvalidations.lock();
+        if (counter)
+        {
+            ++*counter;
+        }
+    };
 }
 
 nlohmann::json& APICache::getValue()
@@ -72,55 +401,295 @@ nlohmann::json& APICache::getValue()
     {
         refresh();
     }
-    if (base)
+    std::shared_lock<StateMutex> lock = lockShared();
+    if (!isDecoded())
+    {
+        throw HueException(CURRENT_FILE_INFO, c_encodedMessage);
+    }
+    // Do not call getValue of base here, because that could cause another refresh
+    // if base has refresh duration 0
+    nlohmann::json* result = findStorage();
+    if (result == nullptr)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Child path not present in base cache");
+    }
+    return *result;
+}
+
+const nlohmann::json& APICache::getValue() const
+{
+    std::shared_lock<StateMutex> lock = lockShared();
+    nlohmann::json& result = getStoredValue();
+    if (!decodeStored(result, getLevel(), getRoot().compactDepth))
+    {
+        throw HueException(CURRENT_FILE_INFO, c_encodedMessage);
+    }
+    return result;
+}
+
+Error APICache::tryRefresh()
+{
+    const unsigned int generation = invalidations->load();
+    if (base && base->needsRefresh())
     {
-        // Do not call getValue here, because that could cause another refresh
-        // if base has refresh duration 0
-        nlohmann::json& baseState = base->value;
-        auto pos = baseState.find(path);
-        if (pos != baseState.end())
+        Error error = base->tryRefresh();
+        if (error.code == ErrorCode::none)
         {
-            return *pos;
+            markSeen(generation);
         }
-        else
+        return error;
+    }
+    std::vector<std::string> selected;
+    JsonFilter requestFilter;
+    bool arenaParsing = false;
+    {
+        std::lock_guard<StateMutex> lock(commands.getStateMutex());
+        if (base && !base->isLoaded(path))
         {
-            throw HueException(CURRENT_FILE_INFO, "Child path not present in base cache");
+            return Error {ErrorCode::notFound};
         }
+        selected = entries;
+        requestFilter = getRequestFilter();
+        arenaParsing = getRoot().arenaParsing;
     }
-    else
+    if (!selected.empty())
     {
-        return value;
+        for (const std::string& entry : selected)
+        {
+            const std::string entryPath = getRequestPath() + '/' + entry;
+            if (arenaParsing)
+            {
+                RefreshArena::Scope scope(getRefreshArena());
+                Result<ArenaJson> result
+                    = commands.tryGETRequestArena(entryPath, nlohmann::json::object(), requestFilter.getChild(entry));
+                if (!result)
+                {
+                    return result.error();
+                }
+                std::lock_guard<StateMutex> lock(commands.getStateMutex());
+                storeEntry(entry, *result);
+                continue;
+            }
+            Result<nlohmann::json> result
+                = commands.tryGETRequest(entryPath, nlohmann::json::object(), requestFilter.getChild(entry));
+            if (!result)
+            {
+                return result.error();
+            }
+            std::lock_guard<StateMutex> lock(commands.getStateMutex());
+            storeEntry(entry, std::move(*result));
+        }
+        markRefreshed();
+        markSeen(generation);
+        return Error {};
     }
+    if (arenaParsing)
+    {
+        RefreshArena::Scope scope(getRefreshArena());
+        Result<ArenaJson> result
+            = commands.tryGETRequestArena(getRequestPath(), nlohmann::json::object(), requestFilter);
+        if (!result)
+        {
+            return result.error();
+        }
+        std::lock_guard<StateMutex> lock(commands.getStateMutex());
+        lastRefresh = std::chrono::steady_clock::now();
+        seenInvalidations = generation;
+        storeValue(*result);
+        return Error {};
+    }
+    Result<nlohmann::json> result
+        = commands.tryGETRequest(getRequestPath(), nlohmann::json::object(), requestFilter);
+    if (!result)
+    {
+        return result.error();
+    }
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    lastRefresh = std::chrono::steady_clock::now();
+    seenInvalidations = generation;
+    storeValue(std::move(*result));
+    return Error {};
 }
 
-const nlohmann::json& APICache::getValue() const
+Result<nlohmann::json&> APICache::tryGetValue()
 {
-    if (base)
+    if (needsRefresh())
     {
-        // Make const reference to not refresh
-        const APICache& b = *base;
-        return b.getValue().at(path);
+        Error error = tryRefresh();
+        if (error.code != ErrorCode::none)
+        {
+            return error;
+        }
     }
-    else
+    std::shared_lock<StateMutex> lock = lockShared();
+    if (!isDecoded())
+    {
+        return ErrorCode::noValue;
+    }
+    nlohmann::json* result = findStorage();
+    if (result == nullptr)
+    {
+        return ErrorCode::notFound;
+    }
+    return *result;
+}
+
+Result<const nlohmann::json&> APICache::tryGetValue() const
+{
+    std::shared_lock<StateMutex> lock = lockShared();
+    Result<nlohmann::json&> result = tryGetStoredValue();
+    if (!result)
     {
-        if (lastRefresh.time_since_epoch().count() == 0)
+        return result.error();
+    }
+    if (!decodeStored(*result, getLevel(), getRoot().compactDepth))
+    {
+        return ErrorCode::noValue;
+    }
+    return *result;
+}
+
+Result<nlohmann::json&> APICache::tryGetCachedValue()
+{
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    Result<nlohmann::json&> result = tryGetStoredValue();
+    if (!result)
+    {
+        return result.error();
+    }
+    decodeAt(*result, getLevel(), getRoot().compactDepth);
+    return *result;
+}
+
+void APICache::setEntries(std::vector<std::string> entries)
+{
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    this->entries = std::move(entries);
+    nlohmann::json& storage = getStorage();
+    if (storage.is_object())
+    {
+        for (auto it = storage.begin(); it != storage.end();)
         {
-            // No value has been requested yet
-            throw HueException(CURRENT_FILE_INFO,
-                "Tried to call const getValue(), but no value was cached. "
-                "Call refresh() or non-const getValue() first.");
+            if (!isLoaded(it.key()))
+            {
+                it = storage.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
         }
-        return value;
     }
 }
 
+std::vector<std::string> APICache::getEntries() const
+{
+    std::shared_lock<StateMutex> lock(commands.getStateMutex());
+    return entries;
+}
+
+void APICache::setCompactDepth(int depth)
+{
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    APICache* root = this;
+    while (root->base)
+    {
+        root = root->base.get();
+    }
+    // Decode with the old depth first, so nothing stays encoded at another level
+    decodeAt(root->value, 0, root->compactDepth);
+    root->compactDepth = depth;
+    encodeAt(root->value, 0, depth);
+}
+
+void APICache::setArenaParsing(bool enabled)
+{
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    APICache* root = this;
+    while (root->base)
+    {
+        root = root->base.get();
+    }
+    root->arenaParsing = enabled;
+}
+
+bool APICache::getArenaParsing() const
+{
+    std::shared_lock<StateMutex> lock(commands.getStateMutex());
+    return getRoot().arenaParsing;
+}
+
+int APICache::getCompactDepth() const
+{
+    std::shared_lock<StateMutex> lock(commands.getStateMutex());
+    return getRoot().compactDepth;
+}
+
+void APICache::compact()
+{
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    nlohmann::json* node = findStorage();
+    if (node != nullptr)
+    {
+        encodeAt(*node, getLevel(), getRoot().compactDepth);
+    }
+}
+
+void APICache::setFilter(JsonFilter filter)
+{
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    this->filter = std::move(filter);
+}
+
+JsonFilter APICache::getFilter() const
+{
+    std::shared_lock<StateMutex> lock(commands.getStateMutex());
+    return filter;
+}
+
+std::unique_lock<StateMutex> APICache::lock() const
+{
+    return std::unique_lock<StateMutex>(commands.getStateMutex());
+}
+
+std::shared_lock<StateMutex> APICache::lockShared() const
+{
+    StateMutex& mutex = commands.getStateMutex();
+    std::shared_lock<StateMutex> lock(mutex);
+    // Members are decoded under the exclusive lock, so the readers holding the shared lock do not write
+    while (!isDecoded())
+    {
+        if (mutex.isLockedExclusively())
+        {
+            decodeStorage();
+            break;
+        }
+        lock.unlock();
+        if (mutex.isLocked())
+        {
+            // The shared lock of the caller cannot be upgraded, the value stays encoded
+            lock.lock();
+            break;
+        }
+        {
+            std::lock_guard<StateMutex> exclusive(mutex);
+            decodeStorage();
+        }
+        // Check again, because the value could be compacted before locking shared
+        lock.lock();
+    }
+    return lock;
+}
+
 void APICache::setRefreshDuration(std::chrono::steady_clock::duration refreshDuration)
 {
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
     this->refreshDuration = refreshDuration;
 }
 
 std::chrono::steady_clock::duration APICache::getRefreshDuration() const
 {
+    std::shared_lock<StateMutex> lock(commands.getStateMutex());
     return refreshDuration;
 }
 
@@ -137,24 +706,23 @@ const HueCommandAPI& APICache::getCommandAPI() const
 bool APICache::needsRefresh()
 {
     using clock = std::chrono::steady_clock;
-    if (base)
-    {
-        // Update lastRefresh in case base was refreshed
-        lastRefresh = std::max(lastRefresh, base->lastRefresh);
-    }
+    std::shared_lock<StateMutex> lock(commands.getStateMutex());
+    // Use the last refresh of base in case it was refreshed
+    const clock::time_point refreshed = getLastRefresh();
 
     // Explicitly check for zero in case refreshDuration is duration::max()
     // Negative duration causes overflow check to overflow itself
-    if (lastRefresh.time_since_epoch().count() == 0 || refreshDuration.count() < 0)
+    if (refreshed.time_since_epoch().count() == 0 || refreshDuration.count() < 0
+        || invalidations->load() != seenInvalidations)
     {
-        // No value set yet
+        // No value set yet or invalidated
         return true;
     }
-    // Check if nextRefresh would overflow (assumes lastRefresh is not negative, which it should not be).
+    // Check if nextRefresh would overflow (assumes the last refresh is not negative, which it should not be).
     // If addition would overflow, do not refresh
-    else if (clock::duration::max() - refreshDuration > lastRefresh.time_since_epoch())
+    else if (clock::duration::max() - refreshDuration > refreshed.time_since_epoch())
     {
-        clock::time_point nextRefresh = lastRefresh + refreshDuration;
+        clock::time_point nextRefresh = refreshed + refreshDuration;
         if (clock::now() >= nextRefresh)
         {
             return true;
@@ -163,6 +731,210 @@ bool APICache::needsRefresh()
     return false;
 }
 
+nlohmann::json& APICache::getStoredValue() const
+{
+    if (base)
+    {
+        // Do not use getValue of base, because that would decode all of its members
+        nlohmann::json& entry = base->getStoredValue().at(path);
+        if (!decodeStored(entry, 0, 0))
+        {
+            throw HueException(CURRENT_FILE_INFO, c_encodedMessage);
+        }
+        return entry;
+    }
+    if (lastRefresh.time_since_epoch().count() == 0)
+    {
+        // No value has been requested yet
+        throw HueException(CURRENT_FILE_INFO,
+            "Tried to call const getValue(), but no value was cached. "
+            "Call refresh() or non-const getValue() first.");
+    }
+    return value;
+}
+
+Result<nlohmann::json&> APICache::tryGetStoredValue() const
+{
+    if (base)
+    {
+        Result<nlohmann::json&> baseState = base->tryGetStoredValue();
+        if (!baseState)
+        {
+            return baseState;
+        }
+        auto pos = baseState->find(path);
+        if (pos == baseState->end())
+        {
+            return ErrorCode::notFound;
+        }
+        if (!decodeStored(*pos, 0, 0))
+        {
+            return ErrorCode::noValue;
+        }
+        return *pos;
+    }
+    if (lastRefresh.time_since_epoch().count() == 0)
+    {
+        return ErrorCode::noValue;
+    }
+    return value;
+}
+
+nlohmann::json* APICache::findStorage() const
+{
+    if (!base)
+    {
+        return &value;
+    }
+    nlohmann::json* baseState = base->findStorage();
+    if (baseState == nullptr || !baseState->is_object())
+    {
+        return nullptr;
+    }
+    auto pos = baseState->find(path);
+    if (pos == baseState->end() || !decodeStored(*pos, 0, 0))
+    {
+        return nullptr;
+    }
+    return &*pos;
+}
+
+const nlohmann::json* APICache::peekStorage(bool& encoded) const
+{
+    if (!base)
+    {
+        return &value;
+    }
+    const nlohmann::json* baseState = base->peekStorage(encoded);
+    if (baseState == nullptr)
+    {
+        return nullptr;
+    }
+    if (baseState->is_binary())
+    {
+        encoded = true;
+        return nullptr;
+    }
+    if (!baseState->is_object())
+    {
+        return nullptr;
+    }
+    auto pos = baseState->find(path);
+    return pos != baseState->end() ? &*pos : nullptr;
+}
+
+bool APICache::isDecoded() const
+{
+    const int depth = getRoot().compactDepth;
+    if (depth == 0)
+    {
+        return true;
+    }
+    bool encoded = false;
+    const nlohmann::json* node = peekStorage(encoded);
+    if (node == nullptr)
+    {
+        return !encoded;
+    }
+    return isDecodedAt(*node, getLevel(), depth);
+}
+
+void APICache::decodeStorage() const
+{
+    nlohmann::json* node = findStorage();
+    if (node != nullptr)
+    {
+        decodeAt(*node, getLevel(), getRoot().compactDepth);
+    }
+}
+
+bool APICache::decodeStored(nlohmann::json& node, int level, int depth) const
+{
+    if (commands.getStateMutex().isLockedExclusively())
+    {
+        decodeAt(node, level, depth);
+        return true;
+    }
+    return isDecodedAt(node, level, depth);
+}
+
+template <typename Json>
+void APICache::storeValue(Json&& result)
+{
+    nlohmann::json& storage = getStorage();
+    const int depth = getRoot().compactDepth;
+    // Members which are in use stay decoded, because they are updated in place
+    std::vector<const nlohmann::json*> decoded;
+    findDecoded(storage, getLevel(), depth, decoded);
+    std::sort(decoded.begin(), decoded.end(), std::less<const nlohmann::json*>());
+    updateInPlace(storage, std::forward<Json>(result));
+    encodeAt(storage, getLevel(), depth, decoded);
+}
+
+template <typename Json>
+void APICache::storeEntry(const std::string& entry, Json&& result)
+{
+    nlohmann::json& target = getStorage()[entry];
+    const int depth = getRoot().compactDepth;
+    std::vector<const nlohmann::json*> decoded;
+    findDecoded(target, getLevel() + 1, depth, decoded);
+    std::sort(decoded.begin(), decoded.end(), std::less<const nlohmann::json*>());
+    updateInPlace(target, std::forward<Json>(result));
+    encodeAt(target, getLevel() + 1, depth, decoded);
+}
+
+void APICache::markSeen(unsigned int generation)
+{
+    std::lock_guard<StateMutex> lock(commands.getStateMutex());
+    seenInvalidations = generation;
+}
+
+int APICache::getLevel() const
+{
+    int level = 0;
+    for (const APICache* cache = base.get(); cache != nullptr; cache = cache->base.get())
+    {
+        ++level;
+    }
+    return level;
+}
+
+const APICache& APICache::getRoot() const
+{
+    const APICache* root = this;
+    while (root->base)
+    {
+        root = root->base.get();
+    }
+    return *root;
+}
+
+bool APICache::isLoaded(const std::string& entry) const
+{
+    return entries.empty() || std::find(entries.begin(), entries.end(), entry) != entries.end();
+}
+
+nlohmann::json& APICache::getStorage()
+{
+    if (!base)
+    {
+        return value;
+    }
+    // Resources of child caches are stored in the value of the root cache
+    nlohmann::json& storage = base->getStorage()[path];
+    unpack(storage);
+    return storage;
+}
+
+JsonFilter APICache::getRequestFilter() const
+{
+    if (base && filter.keepsAll())
+    {
+        return base->getRequestFilter().getChild(path);
+    }
+    return filter;
+}
+
 std::string APICache::getRequestPath() const
 {
     std::string result;
@@ -174,4 +946,14 @@ std::string APICache::getRequestPath() const
     result.append(path);
     return result;
 }
+
+std::chrono::steady_clock::time_point APICache::getLastRefresh() const
+{
+    std::shared_lock<StateMutex> lock(commands.getStateMutex());
+    if (base)
+    {
+        return std::max(lastRefresh, base->getLastRefresh());
+    }
+    return lastRefresh;
+}
 } // namespace hueplusplus
@@ -0,0 +1,154 @@
+/**
+    \file ArenaJson.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/ArenaJson.h"
+
+#include <algorithm>
+
+namespace hueplusplus
+{
+namespace
+{
+thread_local RefreshArena* currentArena = nullptr;
+} // namespace
+
+RefreshArena::RefreshArena(std::size_t chunkSize) : chunkSize(chunkSize) { }
+
+void* RefreshArena::allocate(std::size_t size, std::size_t alignment)
+{
+    if (!chunks.empty())
+    {
+        const Chunk& chunk = chunks.back();
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(chunk.data.get());
+        const std::uintptr_t start = (base + offset + alignment - 1) & ~(alignment - 1);
+        if (start + size <= base + chunk.size)
+        {
+            offset = start + size - base;
+            used += size;
+            return reinterpret_cast<void*>(start);
+        }
+    }
+    // Chunks grow, so a large generation only needs a few of them
+    addChunk(std::max(size + alignment, chunks.empty() ? chunkSize : chunks.back().size * 2));
+    return allocate(size, alignment);
+}
+
+bool RefreshArena::owns(const void* p) const
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(p);
+    return std::any_of(chunks.begin(), chunks.end(),
+        [&](const Chunk& chunk) { return bytes >= chunk.data.get() && bytes < chunk.data.get() + chunk.size; });
+}
+
+void RefreshArena::reset()
+{
+    if (chunks.size() > 1)
+    {
+        std::size_t total = 0;
+        for (const Chunk& chunk : chunks)
+        {
+            total += chunk.size;
+        }
+        chunks.clear();
+        addChunk(total);
+    }
+    offset = 0;
+    used = 0;
+}
+
+std::size_t RefreshArena::getUsedBytes() const
+{
+    return used;
+}
+
+std::size_t RefreshArena::getChunkCount() const
+{
+    return chunks.size();
+}
+
+RefreshArena* RefreshArena::current()
+{
+    return currentArena;
+}
+
+void RefreshArena::addChunk(std::size_t size)
+{
+    chunks.push_back(Chunk {std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+    offset = 0;
+}
+
+RefreshArena::Scope::Scope(RefreshArena& arena) : arena(arena), previous(currentArena)
+{
+    currentArena = &arena;
+}
+
+RefreshArena::Scope::~Scope()
+{
+    currentArena = previous;
+    if (previous != &arena)
+    {
+        arena.reset();
+    }
+}
+
+nlohmann::json toJson(const ArenaJson& value)
+{
+    switch (value.type())
+    {
+    case nlohmann::json::value_t::object:
+    {
+        nlohmann::json result = nlohmann::json::object();
+        for (auto it = value.begin(); it != value.end(); ++it)
+        {
+            result.emplace(std::string(it.key().data(), it.key().size()), toJson(*it));
+        }
+        return result;
+    }
+    case nlohmann::json::value_t::array:
+    {
+        nlohmann::json result = nlohmann::json::array();
+        result.get_ref<nlohmann::json::array_t&>().reserve(value.size());
+        for (const ArenaJson& element : value)
+        {
+            result.push_back(toJson(element));
+        }
+        return result;
+    }
+    case nlohmann::json::value_t::string:
+    {
+        const ArenaString& str = value.get_ref<const ArenaString&>();
+        return std::string(str.data(), str.size());
+    }
+    case nlohmann::json::value_t::boolean:
+        return value.get<bool>();
+    case nlohmann::json::value_t::number_integer:
+        return value.get<std::int64_t>();
+    case nlohmann::json::value_t::number_unsigned:
+        return value.get<std::uint64_t>();
+    case nlohmann::json::value_t::number_float:
+        return value.get<double>();
+    case nlohmann::json::value_t::binary:
+        return nlohmann::json::binary(value.get_binary());
+    default:
+        return nullptr;
+    }
+}
+} // namespace hueplusplus
@@ -38,46 +38,56 @@ int BaseDevice::getId() const
 
 std::string BaseDevice::getType() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("type").get<std::string>();
 }
 
 std::string BaseDevice::getName()
 {
-    return state.getValue().at("name").get<std::string>();
+    // Refresh before locking, so the lock is not held during the request
+    state.getValue();
+    return static_cast<const BaseDevice&>(*this).getName();
 }
 
 std::string BaseDevice::getName() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("name").get<std::string>();
 }
 
 std::string BaseDevice::getModelId() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("modelid").get<std::string>();
 }
 
 std::string BaseDevice::getUId() const
 {
+    auto lock = state.lockShared();
     return state.getValue().value("uniqueid", "");
 }
 
 std::string BaseDevice::getManufacturername() const
 {
+    auto lock = state.lockShared();
     return state.getValue().value("manufacturername", "");
 }
 
 std::string BaseDevice::getProductname() const
 {
+    auto lock = state.lockShared();
     return state.getValue().value("productname", "");
 }
 
 std::string BaseDevice::getSwVersion()
 {
-    return state.getValue().at("swversion").get<std::string>();
+    state.getValue();
+    return static_cast<const BaseDevice&>(*this).getSwVersion();
 }
 
 std::string BaseDevice::getSwVersion() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("swversion").get<std::string>();
 }
 
@@ -88,7 +98,7 @@ bool BaseDevice::setName(const std::string& name)
 
     // Check whether request was successful (returned name is not necessarily the actually set name)
     // If it already exists, a number is added, if it is too long to be returned, "Updated" is returned
-    return utils::safeGetMember(reply, 0, "success", "/lights/" + std::to_string(id) + "/name").is_string();
+    return utils::safeGetMemberRef(reply, 0, "success", "/lights/" + std::to_string(id) + "/name").is_string();
 }
 
 BaseDevice::BaseDevice(int id, const std::shared_ptr<APICache>& baseCache)
@@ -125,4 +135,9 @@ void BaseDevice::setRefreshDuration(std::chrono::steady_clock::duration refreshD
     state.setRefreshDuration(refreshDuration);
 }
 
+void BaseDevice::updateState(const nlohmann::json& listState, std::chrono::steady_clock::time_point refreshTime)
+{
+    state.updateValue(listState, refreshTime);
+}
+
 } // namespace hueplusplus
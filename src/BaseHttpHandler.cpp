@@ -22,13 +22,23 @@
 
 #include "hueplusplus/BaseHttpHandler.h"
 
+#include <cstdio>
+
 #include "hueplusplus/HueExceptionMacro.h"
 
 namespace hueplusplus
 {
-std::string BaseHttpHandler::sendGetHTTPBody(const std::string& msg, const std::string& adr, int port) const
+namespace
+{
+template <std::size_t N>
+constexpr MessagePart literalPart(const char (&str)[N])
+{
+    return {str, N - 1};
+}
+
+// Returns the position of the body in response, throws if it has none
+std::size_t findBody(const std::string& msg, const std::string& response)
 {
-    std::string response = send(msg, adr, port);
     size_t start = response.find("\r\n\r\n");
     if (start == std::string::npos)
     {
@@ -39,10 +49,33 @@ std::string BaseHttpHandler::sendGetHTTPBody(const std::string& msg, const std::
         std::cerr << "\"" << response << "\"\n";
         throw HueException(CURRENT_FILE_INFO, "Failed to find body in response");
     }
-    response.erase(0, start + 4);
+    return start + 4;
+}
+
+std::string joinParts(const MessagePart* parts, std::size_t count)
+{
+    std::string result;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        result.append(parts[i].data, parts[i].size);
+    }
+    return result;
+}
+} // namespace
+
+std::string BaseHttpHandler::sendGetHTTPBody(const std::string& msg, const std::string& adr, int port) const
+{
+    std::string response = send(msg, adr, port);
+    response.erase(0, findBody(msg, response));
     return response;
 }
 
+std::string BaseHttpHandler::sendParts(
+    const MessagePart* parts, std::size_t count, const std::string& adr, int port) const
+{
+    return send(joinParts(parts, count), adr, port);
+}
+
 std::string BaseHttpHandler::sendHTTPRequest(const std::string& method, const std::string& uri,
     const std::string& contentType, const std::string& body, const std::string& adr, int port) const
 {
@@ -106,6 +139,12 @@ nlohmann::json BaseHttpHandler::GETJson(
     return nlohmann::json::parse(GETString(uri, "application/json", body.dump(), adr, port));
 }
 
+nlohmann::json BaseHttpHandler::GETJsonFiltered(const std::string& uri, const nlohmann::json& body,
+    const JsonFilter& filter, const std::string& adr, int port) const
+{
+    return filter.parse(GETString(uri, "application/json", body.dump(), adr, port));
+}
+
 nlohmann::json BaseHttpHandler::POSTJson(
     const std::string& uri, const nlohmann::json& body, const std::string& adr, int port) const
 {
@@ -123,4 +162,25 @@ nlohmann::json BaseHttpHandler::DELETEJson(
 {
     return nlohmann::json::parse(DELETEString(uri, "application/json", body.dump(), adr, port));
 }
+
+nlohmann::json BaseHttpHandler::PUTSerialized(MessagePart uriPrefix, const std::string& uri, const std::string& body,
+    const std::string& adr, int port) const
+{
+    char length[24];
+    const int lengthSize = std::snprintf(length, sizeof(length), "%zu", body.size());
+    // Same message as sendHTTPRequest, the constant parts are not copied
+    const MessagePart parts[] = {literalPart("PUT "), uriPrefix, {uri.data(), uri.size()},
+        literalPart(" HTTP/1.0\r\nContent-Type: application/json\r\nContent-Length: "),
+        {length, static_cast<std::size_t>(lengthSize)}, literalPart("\r\n\r\n"), {body.data(), body.size()},
+        literalPart("\r\n\r\n")};
+    constexpr std::size_t partCount = sizeof(parts) / sizeof(parts[0]);
+    const std::string response = sendParts(parts, partCount, adr, port);
+    const std::size_t start = response.find("\r\n\r\n");
+    if (start == std::string::npos)
+    {
+        // Only build the request string for the error message
+        findBody(joinParts(parts, partCount), response);
+    }
+    return nlohmann::json::parse(response.begin() + start + 4, response.end());
+}
 } // namespace hueplusplus
@@ -28,6 +28,7 @@
 #include <cstring>
 #include <iostream>
 #include <locale>
+#include <mutex>
 #include <stdexcept>
 #include <thread>
 
@@ -38,7 +39,15 @@
 
 namespace hueplusplus
 {
-BridgeFinder::BridgeFinder(std::shared_ptr<const IHttpHandler> handler) : http_handler(std::move(handler)) { }
+namespace
+{
+// Names of the sections in the API, indexed by Bridge::Section
+const char* const sectionNames[] = {"config", "lights", "groups", "schedules", "scenes", "sensors", "rules"};
+} // namespace
+
+BridgeFinder::BridgeFinder(std::shared_ptr<const IHttpHandler> handler)
+    : mapMutex(std::make_shared<std::mutex>()), http_handler(std::move(handler))
+{ }
 
 std::vector<BridgeFinder::BridgeIdentification> BridgeFinder::findBridges() const
 {
@@ -78,21 +87,29 @@ std::vector<BridgeFinder::BridgeIdentification> BridgeFinder::findBridges() cons
 Bridge BridgeFinder::getBridge(const BridgeIdentification& identification, bool sharedState)
 {
     std::string normalizedMac = normalizeMac(identification.mac);
-    auto pos = usernames.find(normalizedMac);
-    auto key = clientkeys.find(normalizedMac);
-    if (pos != usernames.end())
+    bool found = false;
+    std::string username;
+    std::string clientkey;
     {
-        if (key != clientkeys.end())
+        std::lock_guard<std::mutex> lock(*mapMutex);
+        auto pos = usernames.find(normalizedMac);
+        auto key = clientkeys.find(normalizedMac);
+        if (pos != usernames.end())
         {
-            return Bridge(identification.ip, identification.port, pos->second, http_handler, key->second,
-                std::chrono::seconds(10), sharedState);
-        }
-        else
-        {
-            return Bridge(identification.ip, identification.port, pos->second, http_handler, "",
-                std::chrono::seconds(10), sharedState);
+            found = true;
+            username = pos->second;
+            if (key != clientkeys.end())
+            {
+                clientkey = key->second;
+            }
         }
     }
+    if (found)
+    {
+        return Bridge(identification.ip, identification.port, username, http_handler, clientkey,
+            std::chrono::seconds(10), sharedState);
+    }
+    // Request username without holding the lock, it takes a long time
     Bridge bridge(identification.ip, identification.port, "", http_handler, "", std::chrono::seconds(10), sharedState);
     bridge.requestUsername();
     if (bridge.getUsername().empty())
@@ -108,16 +125,19 @@ Bridge BridgeFinder::getBridge(const BridgeIdentification& identification, bool
 
 void BridgeFinder::addUsername(const std::string& mac, const std::string& username)
 {
+    std::lock_guard<std::mutex> lock(*mapMutex);
     usernames[normalizeMac(mac)] = username;
 }
 
 void BridgeFinder::addClientKey(const std::string& mac, const std::string& clientkey)
 {
+    std::lock_guard<std::mutex> lock(*mapMutex);
     clientkeys[normalizeMac(mac)] = clientkey;
 }
 
-const std::map<std::string, std::string>& BridgeFinder::getAllUsernames() const
+std::map<std::string, std::string> BridgeFinder::getAllUsernames() const
 {
+    std::lock_guard<std::mutex> lock(*mapMutex);
     return usernames;
 }
 
@@ -183,6 +203,106 @@ void Bridge::refresh()
     stateCache->refresh();
 }
 
+Bridge::LoadReport Bridge::bootstrap(LoadMode mode)
+{
+    using clock = std::chrono::steady_clock;
+
+    std::vector<std::string> names = stateCache->getEntries();
+    if (names.empty())
+    {
+        names.assign(std::begin(sectionNames), std::end(sectionNames));
+    }
+    else
+    {
+        // Not all sections are part of the full state
+        mode = LoadMode::perList;
+    }
+    LoadReport report {mode, clock::duration::zero(), {}};
+    if (mode == LoadMode::fullState)
+    {
+        const clock::time_point start = clock::now();
+        stateCache->refresh();
+        report.total = clock::now() - start;
+        for (const std::string& name : names)
+        {
+            report.lists.push_back(ListTiming {name, report.total, 0});
+        }
+    }
+    else
+    {
+        for (const std::string& name : names)
+        {
+            const clock::time_point start = clock::now();
+            stateCache->refreshEntry(name);
+            report.lists.push_back(ListTiming {name, clock::now() - start, 0});
+            report.total += report.lists.back().duration;
+        }
+        stateCache->markRefreshed();
+    }
+    // Count with the const overload, which does not refresh
+    const APICache& cache = *stateCache;
+    auto lock = cache.lock();
+    for (ListTiming& timing : report.lists)
+    {
+        const nlohmann::json& list = utils::safeGetMemberRef(cache.getValue(), timing.name);
+        timing.count = (timing.name == "config") ? !list.is_null() : list.size();
+    }
+    // Counting decoded the whole state
+    stateCache->compact();
+    return report;
+}
+
+void Bridge::setSections(const std::vector<Section>& sections)
+{
+    // Keep the order of the full state, independent of the order of sections
+    std::vector<std::string> entries;
+    for (std::size_t i = 0; i < sizeof(sectionNames) / sizeof(sectionNames[0]); ++i)
+    {
+        if (std::find(sections.begin(), sections.end(), static_cast<Section>(i)) != sections.end())
+        {
+            entries.emplace_back(sectionNames[i]);
+        }
+    }
+    stateCache->setEntries(std::move(entries));
+}
+
+std::vector<Bridge::Section> Bridge::getSections() const
+{
+    std::vector<Section> sections;
+    for (const std::string& name : stateCache->getEntries())
+    {
+        sections.push_back(static_cast<Section>(
+            std::find(std::begin(sectionNames), std::end(sectionNames), name) - std::begin(sectionNames)));
+    }
+    return sections;
+}
+
+void Bridge::setFilter(const JsonFilter& filter)
+{
+    stateCache->setFilter(filter);
+}
+
+JsonFilter Bridge::getFilter() const
+{
+    return stateCache->getFilter();
+}
+
+void Bridge::setCompactState(bool compact)
+{
+    // Level 2 are the resources in the lists
+    stateCache->setCompactDepth(compact ? 2 : 0);
+}
+
+void Bridge::compactState()
+{
+    stateCache->compact();
+}
+
+void Bridge::setArenaParsing(bool enabled)
+{
+    stateCache->setArenaParsing(enabled);
+}
+
 void Bridge::setRefreshDuration(std::chrono::steady_clock::duration refreshDuration)
 {
     stateCache->setRefreshDuration(refreshDuration);
@@ -224,8 +344,8 @@ std::string Bridge::requestUsername()
     {
         std::this_thread::sleep_for(checkInterval);
         answer = http_handler->POSTJson("/api", request, ip, port);
-        nlohmann::json jsonUser = utils::safeGetMember(answer, 0, "success", "username");
-        nlohmann::json jsonKey = utils::safeGetMember(answer, 0, "success", "clientkey");
+        const nlohmann::json& jsonUser = utils::safeGetMemberRef(answer, 0, "success", "username");
+        const nlohmann::json& jsonKey = utils::safeGetMemberRef(answer, 0, "success", "clientkey");
         if (jsonUser != nullptr)
         {
             // [{"success":{"username": "<username>"}}]
@@ -274,9 +394,7 @@ bool Bridge::startStreaming(std::string group_identifier)
     answer = http_handler->PUTJson(uri, request, ip, port);
 
     std::string key = "/groups/" + group_identifier + "/stream/active";
-    nlohmann::json success = utils::safeGetMember(answer, 0, "success", key);
-
-    return success == true;
+    return utils::safeGetMemberRef(answer, 0, "success", key) == true;
 }
 
 bool Bridge::stopStreaming(std::string group_identifier)
@@ -400,7 +518,13 @@ const Bridge::RuleList& Bridge::rules() const
 void Bridge::setHttpHandler(std::shared_ptr<const IHttpHandler> handler)
 {
     http_handler = handler;
+    std::vector<std::string> entries = stateCache->getEntries();
+    JsonFilter filter = stateCache->getFilter();
+    const int compactDepth = stateCache->getCompactDepth();
     stateCache = std::make_shared<APICache>("", HueCommandAPI(ip, port, username, handler), refreshDuration, nullptr);
+    stateCache->setEntries(std::move(entries));
+    stateCache->setFilter(std::move(filter));
+    stateCache->setCompactDepth(compactDepth);
     lightList = LightList(stateCache, "lights", refreshDuration, sharedState,
         [factory = LightFactory(stateCache->getCommandAPI(), refreshDuration)](int id, const nlohmann::json& state,
             const std::shared_ptr<APICache>& baseCache) mutable { return factory.createLight(state, id, baseCache); });
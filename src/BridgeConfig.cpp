@@ -47,6 +47,7 @@ void BridgeConfig::setRefreshDuration(std::chrono::steady_clock::duration refres
 
 std::vector<WhitelistedUser> BridgeConfig::getWhitelistedUsers() const
 {
+    auto lock = cache.lockShared();
     const nlohmann::json& whitelist = cache.getValue().at("whitelist");
     std::vector<WhitelistedUser> users;
     for (auto it = whitelist.begin(); it != whitelist.end(); ++it)
@@ -63,6 +64,7 @@ void BridgeConfig::removeUser(const std::string& userKey)
 }
 bool BridgeConfig::getLinkButton() const
 {
+    auto lock = cache.lockShared();
     return cache.getValue().at("linkbutton").get<bool>();
 }
 void BridgeConfig::pressLinkButton()
@@ -75,14 +77,17 @@ void BridgeConfig::touchLink()
 }
 std::string BridgeConfig::getMACAddress() const
 {
+    auto lock = cache.lockShared();
     return cache.getValue().at("mac").get<std::string>();
 }
 time::AbsoluteTime BridgeConfig::getUTCTime() const
 {
+    auto lock = cache.lockShared();
     return time::AbsoluteTime::parseUTC(cache.getValue().at("UTC").get<std::string>());
 }
 std::string BridgeConfig::getTimezone() const
 {
+    auto lock = cache.lockShared();
     return cache.getValue().at("timezone").get<std::string>();
 }
 } // namespace hueplusplus
\ No newline at end of file
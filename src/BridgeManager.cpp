@@ -0,0 +1,225 @@
+/**
+    \file BridgeManager.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/BridgeManager.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "hueplusplus/HueExceptionMacro.h"
+
+namespace hueplusplus
+{
+namespace
+{
+// Waits for all futures, so no task uses local state after returning, then rethrows the first exception
+template <typename T>
+std::vector<T> getAll(std::vector<std::future<T>>& futures)
+{
+    std::vector<T> results;
+    results.reserve(futures.size());
+    std::exception_ptr error;
+    for (std::future<T>& f : futures)
+    {
+        try
+        {
+            results.push_back(f.get());
+        }
+        catch (...)
+        {
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    return results;
+}
+} // namespace
+
+std::string LightHandle::toString() const
+{
+    return bridge + '/' + std::to_string(id);
+}
+
+BridgeManager::BridgeManager(std::size_t threadCount) : executor(threadCount) { }
+
+Bridge& BridgeManager::addBridge(const std::string& name, Bridge bridge)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (bridges.count(name))
+    {
+        throw HueException(CURRENT_FILE_INFO, "Bridge " + name + " already exists");
+    }
+    Entry& entry = bridges[name];
+    entry.bridge = std::make_shared<Bridge>(std::move(bridge));
+    entry.strand = nextStrand++;
+    return *entry.bridge;
+}
+
+bool BridgeManager::removeBridge(const std::string& name)
+{
+    std::size_t strand;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto pos = bridges.find(name);
+        if (pos == bridges.end())
+        {
+            return false;
+        }
+        strand = pos->second.strand;
+    }
+    // Tasks of a strand run in order, so all earlier tasks are finished after this one
+    executor.submit(strand, [] {}).wait();
+    std::lock_guard<std::mutex> lock(mutex);
+    return bridges.erase(name) != 0;
+}
+
+Bridge& BridgeManager::getBridge(const std::string& name)
+{
+    return *getEntry(name).first;
+}
+
+bool BridgeManager::hasBridge(const std::string& name) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return bridges.count(name) != 0;
+}
+
+std::vector<std::string> BridgeManager::getBridgeNames() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> names;
+    names.reserve(bridges.size());
+    for (const auto& entry : bridges)
+    {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+Executor& BridgeManager::getExecutor()
+{
+    return executor;
+}
+
+void BridgeManager::refreshAll()
+{
+    std::vector<std::future<bool>> futures;
+    for (const std::string& name : getBridgeNames())
+    {
+        futures.push_back(submit(name, [](Bridge& bridge) {
+            bridge.refresh();
+            return true;
+        }));
+    }
+    getAll(futures);
+}
+
+std::map<std::string, Bridge::LoadReport> BridgeManager::bootstrapAll(Bridge::LoadMode mode)
+{
+    std::vector<std::string> names = getBridgeNames();
+    std::vector<std::future<Bridge::LoadReport>> futures;
+    futures.reserve(names.size());
+    for (const std::string& name : names)
+    {
+        futures.push_back(submit(name, [mode](Bridge& bridge) { return bridge.bootstrap(mode); }));
+    }
+    std::vector<Bridge::LoadReport> reports = getAll(futures);
+    std::map<std::string, Bridge::LoadReport> result;
+    for (std::size_t i = 0; i < names.size(); ++i)
+    {
+        result.emplace(names[i], std::move(reports[i]));
+    }
+    return result;
+}
+
+std::vector<LightHandle> BridgeManager::getAllLights()
+{
+    std::vector<std::string> names = getBridgeNames();
+    std::vector<std::future<std::vector<LightHandle>>> futures;
+    futures.reserve(names.size());
+    for (const std::string& name : names)
+    {
+        futures.push_back(submit(name, [name](Bridge& bridge) {
+            std::vector<LightHandle> handles;
+            for (const ResourceHandle<Light>& light : bridge.lights().getAll())
+            {
+                handles.push_back(LightHandle {name, light->getId()});
+            }
+            return handles;
+        }));
+    }
+    std::vector<LightHandle> result;
+    for (std::vector<LightHandle>& handles : getAll(futures))
+    {
+        std::sort(handles.begin(), handles.end());
+        result.insert(result.end(), handles.begin(), handles.end());
+    }
+    return result;
+}
+
+ResourceHandle<Light> BridgeManager::getLight(const LightHandle& handle)
+{
+    return getBridge(handle.bridge).lights().get(handle.id);
+}
+
+std::vector<std::future<bool>> BridgeManager::forEachLight(
+    const std::vector<LightHandle>& lights, LightCommand command)
+{
+    // Shared by all tasks instead of copying it for every light
+    auto sharedCommand = std::make_shared<LightCommand>(std::move(command));
+    std::vector<std::future<bool>> futures;
+    futures.reserve(lights.size());
+    for (const LightHandle& handle : lights)
+    {
+        try
+        {
+            const int id = handle.id;
+            futures.push_back(submit(handle.bridge,
+                [id, sharedCommand](Bridge& bridge) { return (*sharedCommand)(*bridge.lights().get(id)); }));
+        }
+        catch (...)
+        {
+            // Unknown bridge, report in the future like other errors
+            std::promise<bool> failed;
+            failed.set_exception(std::current_exception());
+            futures.push_back(failed.get_future());
+        }
+    }
+    return futures;
+}
+
+std::pair<std::shared_ptr<Bridge>, std::size_t> BridgeManager::getEntry(const std::string& name) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto pos = bridges.find(name);
+    if (pos == bridges.end())
+    {
+        throw HueException(CURRENT_FILE_INFO, "Bridge " + name + " does not exist");
+    }
+    return {pos->second.bridge, pos->second.strand};
+}
+} // namespace hueplusplus
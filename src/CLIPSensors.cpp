@@ -29,6 +29,7 @@ namespace sensors
 {
 bool BaseCLIP::isOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("on").get<bool>();
 }
 
@@ -38,10 +39,12 @@ void BaseCLIP::setOn(bool on)
 }
 bool BaseCLIP::hasBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("battery") != 0;
 }
 int BaseCLIP::getBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("battery").get<int>();
 }
 void BaseCLIP::setBatteryState(int percent)
@@ -50,15 +53,18 @@ void BaseCLIP::setBatteryState(int percent)
 }
 bool BaseCLIP::isReachable() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("reachable").get<bool>();
 }
 
 bool BaseCLIP::hasURL() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("url") != 0;
 }
 std::string BaseCLIP::getURL() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("url").get<std::string>();
 }
 void BaseCLIP::setURL(const std::string& url)
@@ -68,6 +74,7 @@ void BaseCLIP::setURL(const std::string& url)
 
 time::AbsoluteTime BaseCLIP::getLastUpdated() const
 {
+    auto lock = state.lockShared();
     const nlohmann::json& stateJson = state.getValue().at("state");
     auto it = stateJson.find("lastupdated");
     if (it == stateJson.end() || !it->is_string() || *it == "none")
@@ -81,6 +88,7 @@ constexpr const char* CLIPSwitch::typeStr;
 
 int CLIPSwitch::getButtonEvent() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("buttonevent").get<int>();
 }
 void CLIPSwitch::setButtonEvent(int code)
@@ -92,6 +100,7 @@ constexpr const char* CLIPOpenClose::typeStr;
 
 bool CLIPOpenClose::isOpen() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("open").get<bool>();
 }
 void CLIPOpenClose::setOpen(bool open)
@@ -109,6 +118,7 @@ constexpr const char* CLIPPresence::typeStr;
 
 bool CLIPPresence::getPresence() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("presence").get<bool>();
 }
 void CLIPPresence::setPresence(bool presence)
@@ -120,6 +130,7 @@ constexpr const char* CLIPTemperature::typeStr;
 
 int CLIPTemperature::getTemperature() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("temperature").get<int>();
 }
 void CLIPTemperature::setTemperature(int temperature)
@@ -131,6 +142,7 @@ constexpr const char* CLIPHumidity::typeStr;
 
 int CLIPHumidity::getHumidity() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("humidity").get<int>();
 }
 void CLIPHumidity::setHumidity(int humidity)
@@ -147,6 +159,7 @@ constexpr const char* CLIPLightLevel::typeStr;
 
 int CLIPLightLevel::getDarkThreshold() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("tholddark").get<int>();
 }
 
@@ -156,6 +169,7 @@ void CLIPLightLevel::setDarkThreshold(int threshold)
 }
 int CLIPLightLevel::getThresholdOffset() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("tholdoffset").get<int>();
 }
 
@@ -166,6 +180,7 @@ void CLIPLightLevel::setThresholdOffset(int offset)
 
 int CLIPLightLevel::getLightLevel() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("lightlevel").get<int>();
 }
 
@@ -176,11 +191,13 @@ void CLIPLightLevel::setLightLevel(int level)
 
 bool CLIPLightLevel::isDark() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("dark").get<bool>();
 }
 
 bool CLIPLightLevel::isDaylight() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("daylight").get<bool>();
 }
 
@@ -188,6 +205,7 @@ constexpr const char* CLIPGenericFlag::typeStr;
 
 bool CLIPGenericFlag::getFlag() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("flag").get<bool>();
 }
 void CLIPGenericFlag::setFlag(bool flag)
@@ -204,6 +222,7 @@ constexpr const char* CLIPGenericStatus::typeStr;
 
 int CLIPGenericStatus::getStatus() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("status").get<int>();
 }
 
@@ -0,0 +1,207 @@
+/**
+    \file ColorConversion.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/ColorConversion.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "hueplusplus/Simd.h"
+
+namespace hueplusplus
+{
+namespace
+{
+// Number of colors which are converted at once
+constexpr std::size_t blockSize = 4;
+
+// Converts a block of linear colors to xy coordinates, black results in nan
+void linearToXY(const float* red, const float* green, const float* blue, float* x, float* y)
+{
+#if defined(HUEPLUSPLUS_SSE2)
+    const __m128 r = _mm_loadu_ps(red);
+    const __m128 g = _mm_loadu_ps(green);
+    const __m128 b = _mm_loadu_ps(blue);
+    const __m128 X = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(0.664511f)), _mm_mul_ps(g, _mm_set1_ps(0.154324f))),
+        _mm_mul_ps(b, _mm_set1_ps(0.162028f)));
+    const __m128 Y = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(0.283881f)), _mm_mul_ps(g, _mm_set1_ps(0.668433f))),
+        _mm_mul_ps(b, _mm_set1_ps(0.047685f)));
+    const __m128 Z = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(0.000088f)), _mm_mul_ps(g, _mm_set1_ps(0.072310f))),
+        _mm_mul_ps(b, _mm_set1_ps(0.986039f)));
+    const __m128 sum = _mm_add_ps(_mm_add_ps(X, Y), Z);
+    _mm_storeu_ps(x, _mm_div_ps(X, sum));
+    _mm_storeu_ps(y, _mm_div_ps(Y, sum));
+#elif defined(HUEPLUSPLUS_NEON)
+    const float32x4_t r = vld1q_f32(red);
+    const float32x4_t g = vld1q_f32(green);
+    const float32x4_t b = vld1q_f32(blue);
+    const float32x4_t X = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(r, 0.664511f), g, 0.154324f), b, 0.162028f);
+    const float32x4_t Y = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(r, 0.283881f), g, 0.668433f), b, 0.047685f);
+    const float32x4_t Z = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(r, 0.000088f), g, 0.072310f), b, 0.986039f);
+    const float32x4_t sum = vaddq_f32(vaddq_f32(X, Y), Z);
+    vst1q_f32(x, vdivq_f32(X, sum));
+    vst1q_f32(y, vdivq_f32(Y, sum));
+#else
+    for (std::size_t i = 0; i < blockSize; ++i)
+    {
+        const float X = red[i] * 0.664511f + green[i] * 0.154324f + blue[i] * 0.162028f;
+        const float Y = red[i] * 0.283881f + green[i] * 0.668433f + blue[i] * 0.047685f;
+        const float Z = red[i] * 0.000088f + green[i] * 0.072310f + blue[i] * 0.986039f;
+        x[i] = X / (X + Y + Z);
+        y[i] = Y / (X + Y + Z);
+    }
+#endif
+}
+
+// Converts a block of xy coordinates to linear colors with luminance 0.3, like RGB::fromXY()
+void xyToLinear(const float* x, const float* y, float* red, float* green, float* blue)
+{
+#if defined(HUEPLUSPLUS_SSE2)
+    const __m128 xs = _mm_loadu_ps(x);
+    const __m128 ys = _mm_loadu_ps(y);
+    const __m128 Y = _mm_set1_ps(0.3f);
+    const __m128 scale = _mm_div_ps(Y, ys);
+    const __m128 X = _mm_mul_ps(scale, xs);
+    const __m128 Z = _mm_mul_ps(scale, _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.f), xs), ys));
+    _mm_storeu_ps(red,
+        _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(X, _mm_set1_ps(1.656492f)), _mm_mul_ps(Y, _mm_set1_ps(0.354851f))),
+            _mm_mul_ps(Z, _mm_set1_ps(0.255038f))));
+    _mm_storeu_ps(green,
+        _mm_add_ps(_mm_sub_ps(_mm_mul_ps(Y, _mm_set1_ps(1.655397f)), _mm_mul_ps(X, _mm_set1_ps(0.707196f))),
+            _mm_mul_ps(Z, _mm_set1_ps(0.036152f))));
+    _mm_storeu_ps(blue,
+        _mm_add_ps(_mm_sub_ps(_mm_mul_ps(X, _mm_set1_ps(0.051713f)), _mm_mul_ps(Y, _mm_set1_ps(0.121364f))),
+            _mm_mul_ps(Z, _mm_set1_ps(1.011530f))));
+#elif defined(HUEPLUSPLUS_NEON)
+    const float32x4_t xs = vld1q_f32(x);
+    const float32x4_t ys = vld1q_f32(y);
+    const float32x4_t Y = vdupq_n_f32(0.3f);
+    const float32x4_t scale = vdivq_f32(Y, ys);
+    const float32x4_t X = vmulq_f32(scale, xs);
+    const float32x4_t Z = vmulq_f32(scale, vsubq_f32(vsubq_f32(vdupq_n_f32(1.f), xs), ys));
+    vst1q_f32(red, vmlaq_n_f32(vmlsq_n_f32(vmulq_n_f32(X, 1.656492f), Y, 0.354851f), Z, -0.255038f));
+    vst1q_f32(green, vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(X, -0.707196f), Y, 1.655397f), Z, 0.036152f));
+    vst1q_f32(blue, vmlaq_n_f32(vmlsq_n_f32(vmulq_n_f32(X, 0.051713f), Y, 0.121364f), Z, 1.011530f));
+#else
+    for (std::size_t i = 0; i < blockSize; ++i)
+    {
+        const float Y = 0.3f;
+        const float X = (Y / y[i]) * x[i];
+        const float Z = (Y / y[i]) * (1.f - x[i] - y[i]);
+        red[i] = X * 1.656492f - Y * 0.354851f - Z * 0.255038f;
+        green[i] = -X * 0.707196f + Y * 1.655397f + Z * 0.036152f;
+        blue[i] = X * 0.051713f - Y * 0.121364f + Z * 1.011530f;
+    }
+#endif
+}
+
+uint8_t toChannel(float value)
+{
+    return static_cast<uint8_t>(std::round(std::min(std::max(0.f, value), 255.f)));
+}
+} // namespace
+
+void convertToXY(const RGB* rgb, std::size_t count, XYBrightness* result, const ColorGamut* gamuts)
+{
+    for (std::size_t start = 0; start < count; start += blockSize)
+    {
+        const std::size_t size = std::min(blockSize, count - start);
+        // Unused elements of the last block are black
+        float red[blockSize] = {};
+        float green[blockSize] = {};
+        float blue[blockSize] = {};
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            red[i] = srgb::toLinear(rgb[start + i].r);
+            green[i] = srgb::toLinear(rgb[start + i].g);
+            blue[i] = srgb::toLinear(rgb[start + i].b);
+        }
+        float x[blockSize];
+        float y[blockSize];
+        linearToXY(red, green, blue, x, y);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const RGB& color = rgb[start + i];
+            XYBrightness& xy = result[start + i];
+            if (color.r == 0 && color.g == 0 && color.b == 0)
+            {
+                // White with minimum brightness, like RGB::toXY()
+                xy = XYBrightness {XY {0.32272673f, 0.32902291f}, 0.f};
+            }
+            else
+            {
+                xy = XYBrightness {XY {x[i], y[i]}, std::max({color.r, color.g, color.b}) / 255.f};
+            }
+            if (gamuts != nullptr && !gamuts[start + i].contains(xy.xy))
+            {
+                xy.xy = gamuts[start + i].corrected(xy.xy);
+            }
+        }
+    }
+}
+
+void convertToRGB(const XYBrightness* xy, std::size_t count, RGB* result, const ColorGamut* gamuts)
+{
+    for (std::size_t start = 0; start < count; start += blockSize)
+    {
+        const std::size_t size = std::min(blockSize, count - start);
+        // Unused elements of the last block are white
+        float x[blockSize] = {1.f / 3, 1.f / 3, 1.f / 3, 1.f / 3};
+        float y[blockSize] = {1.f / 3, 1.f / 3, 1.f / 3, 1.f / 3};
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            XY color = xy[start + i].xy;
+            if (gamuts != nullptr && !gamuts[start + i].contains(color))
+            {
+                color = gamuts[start + i].corrected(color);
+            }
+            x[i] = color.x;
+            y[i] = color.y;
+        }
+        float red[blockSize];
+        float green[blockSize];
+        float blue[blockSize];
+        xyToLinear(x, y, red, green, blue);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const float brightness = xy[start + i].brightness;
+            const float gammaR = srgb::fromLinear(red[i]);
+            const float gammaG = srgb::fromLinear(green[i]);
+            const float gammaB = srgb::fromLinear(blue[i]);
+            const float maxColor = std::max({gammaR, gammaG, gammaB});
+            if (brightness < 1e-4 || maxColor < 1e-4)
+            {
+                result[start + i] = RGB {0, 0, 0};
+            }
+            else
+            {
+                // Scale color values so that the brightness matches
+                const float scale = brightness * 255.f / maxColor;
+                result[start + i]
+                    = RGB {toChannel(gammaR * scale), toChannel(gammaG * scale), toChannel(gammaB * scale)};
+            }
+        }
+    }
+}
+} // namespace hueplusplus
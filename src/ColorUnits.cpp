@@ -20,6 +20,7 @@
 **/
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 
 #include <hueplusplus/ColorUnits.h>
@@ -106,7 +107,95 @@ XY ColorGamut::corrected(const XY& xy) const
     return xy;
 }
 
-XYBrightness RGB::toXY() const
+namespace srgb
+{
+namespace
+{
+std::array<float, 256> createLinearTable()
+{
+    std::array<float, 256> table;
+    for (std::size_t i = 0; i < table.size(); ++i)
+    {
+        table[i] = toLinearExact(i / 255.f);
+    }
+    return table;
+}
+
+// Tables for pow(value, 1/2.4), split into mantissa in [0.5, 1) and exponent, see fromLinear()
+constexpr int mantissaSteps = 256;
+constexpr int minExponent = -8;
+constexpr int maxExponent = 8;
+
+struct RootTables
+{
+    std::array<float, mantissaSteps + 1> mantissa;
+    std::array<float, maxExponent - minExponent + 1> exponent;
+};
+
+RootTables createRootTables()
+{
+    RootTables tables;
+    for (int i = 0; i <= mantissaSteps; ++i)
+    {
+        tables.mantissa[i] = std::pow(0.5f + 0.5f * i / mantissaSteps, 1.0f / 2.4f);
+    }
+    for (int e = minExponent; e <= maxExponent; ++e)
+    {
+        tables.exponent[e - minExponent] = std::pow(2.0f, e / 2.4f);
+    }
+    return tables;
+}
+} // namespace
+
+float toLinearExact(float value)
+{
+    return (value > 0.04045f) ? pow((value + 0.055f) / (1.0f + 0.055f), 2.4f) : (value / 12.92f);
+}
+
+float toLinear(uint8_t value)
+{
+    static const std::array<float, 256> table = createLinearTable();
+    return table[value];
+}
+
+float fromLinearExact(float value)
+{
+    return value <= 0.0031308f ? 12.92f * value : (1.0f + 0.055f) * pow(value, (1.0f / 2.4f)) - 0.055f;
+}
+
+XY linearToXY(float red, float green, float blue)
+{
+    const float X = red * 0.664511f + green * 0.154324f + blue * 0.162028f;
+    const float Y = red * 0.283881f + green * 0.668433f + blue * 0.047685f;
+    const float Z = red * 0.000088f + green * 0.072310f + blue * 0.986039f;
+
+    const float x = X / (X + Y + Z);
+    const float y = Y / (X + Y + Z);
+    return XY {x, y};
+}
+
+float fromLinear(float value)
+{
+    if (value <= 0.0031308f)
+    {
+        return 12.92f * value;
+    }
+    int exponent;
+    const float mantissa = std::frexp(value, &exponent);
+    if (exponent < minExponent || exponent > maxExponent)
+    {
+        return fromLinearExact(value);
+    }
+    static const RootTables tables = createRootTables();
+    const float position = (mantissa - 0.5f) * (2 * mantissaSteps);
+    const int index = std::min(static_cast<int>(position), mantissaSteps - 1);
+    const float fraction = position - index;
+    const float root = tables.mantissa[index] + (tables.mantissa[index + 1] - tables.mantissa[index]) * fraction;
+    return (1.0f + 0.055f) * root * tables.exponent[exponent - minExponent] - 0.055f;
+}
+} // namespace srgb
+
+XYBrightness RGB::toXY(GammaCorrection gamma) const
 {
     if (r == 0 && g == 0 && b == 0)
     {
@@ -117,24 +206,20 @@ XYBrightness RGB::toXY() const
     const float green = g / 255.f;
     const float blue = b / 255.f;
 
-    const float redCorrected = (red > 0.04045f) ? pow((red + 0.055f) / (1.0f + 0.055f), 2.4f) : (red / 12.92f);
-    const float greenCorrected = (green > 0.04045f) ? pow((green + 0.055f) / (1.0f + 0.055f), 2.4f) : (green / 12.92f);
-    const float blueCorrected = (blue > 0.04045f) ? pow((blue + 0.055f) / (1.0f + 0.055f), 2.4f) : (blue / 12.92f);
-
-    const float X = redCorrected * 0.664511f + greenCorrected * 0.154324f + blueCorrected * 0.162028f;
-    const float Y = redCorrected * 0.283881f + greenCorrected * 0.668433f + blueCorrected * 0.047685f;
-    const float Z = redCorrected * 0.000088f + greenCorrected * 0.072310f + blueCorrected * 0.986039f;
+    const bool table = gamma == GammaCorrection::table;
+    const float redCorrected = table ? srgb::toLinear(r) : srgb::toLinearExact(red);
+    const float greenCorrected = table ? srgb::toLinear(g) : srgb::toLinearExact(green);
+    const float blueCorrected = table ? srgb::toLinear(b) : srgb::toLinearExact(blue);
 
-    const float x = X / (X + Y + Z);
-    const float y = Y / (X + Y + Z);
     // Set brightness to the brightest channel value (rather than average of them),
     // so full red/green/blue can be displayed
-    return XYBrightness {XY {x, y}, std::max({red, green, blue})};
+    return XYBrightness {
+        srgb::linearToXY(redCorrected, greenCorrected, blueCorrected), std::max({red, green, blue})};
 }
 
-XYBrightness RGB::toXY(const ColorGamut& gamut) const
+XYBrightness RGB::toXY(const ColorGamut& gamut, GammaCorrection gamma) const
 {
-    XYBrightness xy = toXY();
+    XYBrightness xy = toXY(gamma);
     if (!gamut.contains(xy.xy))
     {
         xy.xy = gamut.corrected(xy.xy);
@@ -180,7 +265,7 @@ HueSaturation RGB::toHueSaturation() const
     return {h, s};
 }
 
-RGB RGB::fromXY(const XYBrightness& xy)
+RGB RGB::fromXY(const XYBrightness& xy, GammaCorrection gamma)
 {
     if (xy.brightness < 1e-4)
     {
@@ -203,9 +288,10 @@ RGB RGB::fromXY(const XYBrightness& xy)
     const float b = X * 0.051713f - Y * 0.121364f + Z * 1.011530f;
 
     // Reverse gamma correction
-    const float gammaR = r <= 0.0031308f ? 12.92f * r : (1.0f + 0.055f) * pow(r, (1.0f / 2.4f)) - 0.055f;
-    const float gammaG = g <= 0.0031308f ? 12.92f * g : (1.0f + 0.055f) * pow(g, (1.0f / 2.4f)) - 0.055f;
-    const float gammaB = b <= 0.0031308f ? 12.92f * b : (1.0f + 0.055f) * pow(b, (1.0f / 2.4f)) - 0.055f;
+    const bool table = gamma == GammaCorrection::table;
+    const float gammaR = table ? srgb::fromLinear(r) : srgb::fromLinearExact(r);
+    const float gammaG = table ? srgb::fromLinear(g) : srgb::fromLinearExact(g);
+    const float gammaB = table ? srgb::fromLinear(b) : srgb::fromLinearExact(b);
 
     // Scale color values so that the brightness matches
     const float maxColor = std::max({gammaR, gammaG, gammaB});
@@ -223,18 +309,104 @@ RGB RGB::fromXY(const XYBrightness& xy)
         static_cast<uint8_t>(std::round(std::max(0.f, bScaled)))};
 }
 
-RGB RGB::fromXY(const XYBrightness& xy, const ColorGamut& gamut)
+RGB RGB::fromXY(const XYBrightness& xy, const ColorGamut& gamut, GammaCorrection gamma)
 {
     if (gamut.contains(xy.xy))
     {
-        return fromXY(xy);
+        return fromXY(xy, gamma);
     }
     else
     {
-        return fromXY(XYBrightness {gamut.corrected(xy.xy), xy.brightness});
+        return fromXY(XYBrightness {gamut.corrected(xy.xy), xy.brightness}, gamma);
+    }
+}
+
+constexpr int GamutTable::gridSize;
+
+GamutTable::GamutTable(const ColorGamut& gamut) : gamut(gamut)
+{
+    grid.reserve(3 * gridSize * gridSize);
+    std::vector<int> regions;
+    regions.reserve(3 * gridSize * gridSize);
+    for (int face = 0; face < 3; ++face)
+    {
+        for (int u = 0; u < gridSize; ++u)
+        {
+            for (int v = 0; v < gridSize; ++v)
+            {
+                // The channel of the face is 1, the other two channels follow in order
+                float linear[3];
+                linear[face] = 1.f;
+                linear[(face + 1) % 3] = u / static_cast<float>(gridSize - 1);
+                linear[(face + 2) % 3] = v / static_cast<float>(gridSize - 1);
+                const XY xy = srgb::linearToXY(linear[0], linear[1], linear[2]);
+                grid.push_back(corrected(xy));
+                // Sides of the gamut borders, which decide how the point is corrected
+                regions.push_back(isRightOf(xy, gamut.redCorner, gamut.greenCorner)
+                    | isRightOf(xy, gamut.greenCorner, gamut.blueCorner) << 1
+                    | isRightOf(xy, gamut.blueCorner, gamut.redCorner) << 2);
+            }
+        }
+    }
+    // The correction is not continuous between the regions, so cells with corners in different regions
+    // cannot be interpolated
+    interpolated.resize(grid.size());
+    for (std::size_t i = 0; i < grid.size(); ++i)
+    {
+        const std::size_t v = i % gridSize;
+        const std::size_t u = i / gridSize % gridSize;
+        if (u + 1 < gridSize && v + 1 < gridSize)
+        {
+            interpolated[i] = regions[i] == regions[i + 1] && regions[i] == regions[i + gridSize]
+                && regions[i] == regions[i + gridSize + 1];
+        }
     }
 }
 
+const ColorGamut& GamutTable::getGamut() const
+{
+    return gamut;
+}
+
+XYBrightness GamutTable::toXY(const RGB& rgb) const
+{
+    const uint8_t maxChannel = std::max({rgb.r, rgb.g, rgb.b});
+    if (maxChannel == 0)
+    {
+        return rgb.toXY(gamut);
+    }
+    const float linear[3] = {srgb::toLinear(rgb.r), srgb::toLinear(rgb.g), srgb::toLinear(rgb.b)};
+    const int face = rgb.r == maxChannel ? 0 : (rgb.g == maxChannel ? 1 : 2);
+    // Chromaticity only depends on the ratios of the linear channels
+    const float scale = (gridSize - 1) / linear[face];
+    const float u = linear[(face + 1) % 3] * scale;
+    const float v = linear[(face + 2) % 3] * scale;
+    const int u0 = std::min(static_cast<int>(u), gridSize - 2);
+    const int v0 = std::min(static_cast<int>(v), gridSize - 2);
+    const float tu = u - u0;
+    const float tv = v - v0;
+
+    const std::size_t index = (face * gridSize + u0) * gridSize + v0;
+    if (!interpolated[index])
+    {
+        return rgb.toXY(gamut, GammaCorrection::table);
+    }
+    // Bilinear interpolation between the corners of the cell
+    const XY* cell = &grid[index];
+    const XY& p00 = cell[0];
+    const XY& p01 = cell[1];
+    const XY& p10 = cell[gridSize];
+    const XY& p11 = cell[gridSize + 1];
+    const float x = (p00.x * (1.f - tv) + p01.x * tv) * (1.f - tu) + (p10.x * (1.f - tv) + p11.x * tv) * tu;
+    const float y = (p00.y * (1.f - tv) + p01.y * tv) * (1.f - tu) + (p10.y * (1.f - tv) + p11.y * tv) * tu;
+    return XYBrightness {XY {x, y}, maxChannel / 255.f};
+}
+
+XY GamutTable::corrected(const XY& xy) const
+{
+    return gamut.contains(xy) ? xy : gamut.corrected(xy);
+}
+
 unsigned int kelvinToMired(unsigned int kelvin)
 {
     return int(std::round(1000000.f / kelvin));
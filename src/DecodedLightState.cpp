@@ -0,0 +1,80 @@
+/**
+    \file DecodedLightState.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/DecodedLightState.h"
+
+namespace hueplusplus
+{
+namespace
+{
+template <typename T>
+T getOrZero(const nlohmann::json& state, const char* key)
+{
+    auto it = state.find(key);
+    if (it == state.end() || it->is_null())
+    {
+        return T {};
+    }
+    return it->get<T>();
+}
+
+ColorMode parseColorMode(const nlohmann::json& state)
+{
+    auto it = state.find("colormode");
+    if (it == state.end() || !it->is_string())
+    {
+        return ColorMode::NONE;
+    }
+    const std::string& mode = it->get_ref<const std::string&>();
+    if (mode == "hs")
+    {
+        return ColorMode::HUE_SATURATION;
+    }
+    else if (mode == "xy")
+    {
+        return ColorMode::XY;
+    }
+    else if (mode == "ct")
+    {
+        return ColorMode::TEMPERATURE;
+    }
+    return ColorMode::NONE;
+}
+} // namespace
+
+DecodedLightState DecodedLightState::parse(const nlohmann::json& state)
+{
+    DecodedLightState result {};
+    auto xyIt = state.find("xy");
+    if (xyIt != state.end() && xyIt->is_array() && xyIt->size() == 2)
+    {
+        result.xy = XY {(*xyIt)[0].get<float>(), (*xyIt)[1].get<float>()};
+    }
+    result.hue = getOrZero<uint16_t>(state, "hue");
+    result.ct = getOrZero<uint16_t>(state, "ct");
+    result.bri = getOrZero<uint8_t>(state, "bri");
+    result.sat = getOrZero<uint8_t>(state, "sat");
+    result.colormode = parseColorMode(state);
+    result.on = getOrZero<bool>(state, "on");
+    result.reachable = getOrZero<bool>(state, "reachable");
+    return result;
+}
+} // namespace hueplusplus
@@ -0,0 +1,251 @@
+/**
+    \file EffectTimeline.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/EffectTimeline.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "hueplusplus/HueExceptionMacro.h"
+#include "hueplusplus/HueStream.h"
+
+namespace hueplusplus
+{
+namespace
+{
+// Progress of the transition with easing applied, t is from 0 to 1
+float ease(Easing easing, float t)
+{
+    switch (easing)
+    {
+    case Easing::step:
+        return 0.f;
+    case Easing::easeIn:
+        return t * t * t;
+    case Easing::easeOut:
+    {
+        const float inverse = 1.f - t;
+        return 1.f - inverse * inverse * inverse;
+    }
+    case Easing::easeInOut:
+    {
+        if (t < 0.5f)
+        {
+            return 4.f * t * t * t;
+        }
+        const float inverse = 2.f - 2.f * t;
+        return 1.f - inverse * inverse * inverse / 2.f;
+    }
+    case Easing::linear:
+    default:
+        return t;
+    }
+}
+
+float clamp(float value)
+{
+    return std::min(std::max(value, 0.f), 1.f);
+}
+} // namespace
+
+EffectTimeline::EffectTimeline(std::size_t lightCount) : lights(lightCount), loopDuration(0) { }
+
+std::size_t EffectTimeline::getLightCount() const
+{
+    return lights.size();
+}
+
+void EffectTimeline::addKeyframe(
+    std::size_t lightIndex, std::chrono::steady_clock::duration time, const RGB& color, Easing easing)
+{
+    checkIndex(lightIndex);
+    std::vector<Keyframe>& keyframes = lights[lightIndex];
+    const Linear linear {srgb::toLinear(color.r), srgb::toLinear(color.g), srgb::toLinear(color.b)};
+    const Keyframe keyframe {time, linear, toLab(linear.red, linear.green, linear.blue), easing};
+    // Insert after keyframes at the same time, so later keyframes replace earlier ones from then on
+    auto pos = std::upper_bound(keyframes.begin(), keyframes.end(), time,
+        [](std::chrono::steady_clock::duration t, const Keyframe& k) { return t < k.time; });
+    keyframes.insert(pos, keyframe);
+}
+
+void EffectTimeline::clear(std::size_t lightIndex)
+{
+    checkIndex(lightIndex);
+    lights[lightIndex].clear();
+}
+
+void EffectTimeline::clear()
+{
+    for (std::vector<Keyframe>& keyframes : lights)
+    {
+        keyframes.clear();
+    }
+}
+
+std::size_t EffectTimeline::getKeyframeCount(std::size_t lightIndex) const
+{
+    checkIndex(lightIndex);
+    return lights[lightIndex].size();
+}
+
+void EffectTimeline::setLoopDuration(std::chrono::steady_clock::duration duration)
+{
+    loopDuration = duration;
+}
+
+std::chrono::steady_clock::duration EffectTimeline::getLoopDuration() const
+{
+    return loopDuration;
+}
+
+RGB EffectTimeline::getColor(std::size_t lightIndex, std::chrono::steady_clock::duration time) const
+{
+    checkIndex(lightIndex);
+    const std::vector<Keyframe>& keyframes = lights[lightIndex];
+    if (keyframes.empty())
+    {
+        return RGB {0, 0, 0};
+    }
+    const Linear color = interpolate(keyframes, time);
+    auto toByte = [](float value) { return static_cast<uint8_t>(std::round(srgb::fromLinearExact(value) * 255.f)); };
+    return RGB {toByte(color.red), toByte(color.green), toByte(color.blue)};
+}
+
+void EffectTimeline::evaluate(
+    std::chrono::steady_clock::duration time, std::vector<uint8_t>& message, const ColorGamut* gamuts) const
+{
+    const std::size_t count = std::min(lights.size(), huestream::getLightCount(message));
+    const bool rgb = huestream::getColorSpace(message) == huestream::ColorSpace::rgb;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const std::vector<Keyframe>& keyframes = lights[i];
+        if (keyframes.empty())
+        {
+            continue;
+        }
+        const Linear color = interpolate(keyframes, time);
+        const float red = srgb::fromLinear(color.red);
+        const float green = srgb::fromLinear(color.green);
+        const float blue = srgb::fromLinear(color.blue);
+        if (rgb)
+        {
+            huestream::setChannels(message, i, huestream::toChannel(red), huestream::toChannel(green),
+                huestream::toChannel(blue));
+        }
+        else
+        {
+            const float brightness = std::max({red, green, blue});
+            if (brightness <= 0.f)
+            {
+                // Same as RGB::toXY() for black
+                huestream::setXYBrightness(message, i, XYBrightness {XY {0.32272673f, 0.32902291f}, 0.f});
+                continue;
+            }
+            XY xy = srgb::linearToXY(color.red, color.green, color.blue);
+            if (gamuts != nullptr && !gamuts[i].contains(xy))
+            {
+                xy = gamuts[i].corrected(xy);
+            }
+            huestream::setXYBrightness(message, i, XYBrightness {xy, brightness});
+        }
+    }
+}
+
+void EffectTimeline::render(std::chrono::steady_clock::duration start, std::chrono::steady_clock::duration period,
+    std::size_t count, const std::vector<uint8_t>& message, std::vector<uint8_t>& output,
+    const ColorGamut* gamuts) const
+{
+    output.reserve(output.size() + count * message.size());
+    std::vector<uint8_t> frame = message;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        evaluate(start + period * static_cast<std::chrono::steady_clock::rep>(i), frame, gamuts);
+        output.insert(output.end(), frame.begin(), frame.end());
+    }
+}
+
+void EffectTimeline::checkIndex(std::size_t lightIndex) const
+{
+    if (lightIndex >= lights.size())
+    {
+        throw HueException(CURRENT_FILE_INFO, "Invalid light index");
+    }
+}
+
+EffectTimeline::Linear EffectTimeline::interpolate(
+    const std::vector<Keyframe>& keyframes, std::chrono::steady_clock::duration time) const
+{
+    if (loopDuration.count() > 0)
+    {
+        time %= loopDuration;
+        if (time.count() < 0)
+        {
+            time += loopDuration;
+        }
+    }
+    // First keyframe after time
+    auto next = std::upper_bound(keyframes.begin(), keyframes.end(), time,
+        [](std::chrono::steady_clock::duration t, const Keyframe& k) { return t < k.time; });
+    if (next == keyframes.begin())
+    {
+        return next->color;
+    }
+    const Keyframe& previous = *(next - 1);
+    if (next == keyframes.end())
+    {
+        return previous.color;
+    }
+    const float t = std::chrono::duration<float>(time - previous.time)
+        / std::chrono::duration<float>(next->time - previous.time);
+    const float factor = ease(previous.easing, t);
+    if (factor <= 0.f)
+    {
+        return previous.color;
+    }
+    return fromLab(Lab {previous.lab.l + (next->lab.l - previous.lab.l) * factor,
+        previous.lab.a + (next->lab.a - previous.lab.a) * factor,
+        previous.lab.b + (next->lab.b - previous.lab.b) * factor});
+}
+
+EffectTimeline::Lab EffectTimeline::toLab(float red, float green, float blue)
+{
+    // Matrices from https://bottosson.github.io/posts/oklab/
+    const float l = std::cbrt(0.4122214708f * red + 0.5363325363f * green + 0.0514459929f * blue);
+    const float m = std::cbrt(0.2119034982f * red + 0.6806995451f * green + 0.1073969566f * blue);
+    const float s = std::cbrt(0.0883024619f * red + 0.2817188376f * green + 0.6299787005f * blue);
+    return Lab {0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+        1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+        0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s};
+}
+
+EffectTimeline::Linear EffectTimeline::fromLab(const Lab& lab)
+{
+    const float l_ = lab.l + 0.3963377774f * lab.a + 0.2158037573f * lab.b;
+    const float m_ = lab.l - 0.1055613458f * lab.a - 0.0638541728f * lab.b;
+    const float s_ = lab.l - 0.0894841775f * lab.a - 1.2914855480f * lab.b;
+    const float l = l_ * l_ * l_;
+    const float m = m_ * m_ * m_;
+    const float s = s_ * s_ * s_;
+    return Linear {clamp(4.0767416621f * l - 3.3077115913f * m + 0.2309699292f * s),
+        clamp(-1.2684380046f * l + 2.6097574011f * m - 0.3413193965f * s),
+        clamp(-0.0041960863f * l - 0.7034186147f * m + 1.7076147010f * s)};
+}
+} // namespace hueplusplus
@@ -21,6 +21,11 @@
 **/
 
 #include "hueplusplus/EntertainmentMode.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
 #include "mbedtls/ctr_drbg.h"
 #include "mbedtls/debug.h"
 #include "mbedtls/entropy.h"
@@ -29,13 +34,12 @@
 #include "mbedtls/ssl.h"
 #include "mbedtls/timing.h"
 
+#include "hueplusplus/ColorConversion.h"
 #include "hueplusplus/HueExceptionMacro.h"
+#include "hueplusplus/LibConfig.h"
 
 namespace hueplusplus
 {
-constexpr uint8_t HUE_ENTERTAINMENT_HEADER_SIZE = 16;
-constexpr uint8_t HUE_ENTERTAINMENT_LIGHT_SIZE = 9;
-
 struct TLSContext
 {
     mbedtls_ssl_context ssl;
@@ -45,8 +49,98 @@ struct TLSContext
     mbedtls_ssl_config conf;
     mbedtls_x509_crt cacert;
     mbedtls_timing_delay_context timer;
+    mbedtls_ssl_session session; //!< last session, which can be resumed
+    bool has_session = false;
+    bool is_setup = false; //!< ssl is set up by connect, so it can be reset for reconnects
+    bool reconnecting = false; //!< the current handshake resumes a connection, streaming stays enabled on failure
+
+    std::mutex mutex; //!< locked while ssl is used, by the sending threads and the keep alive
+    std::atomic<ConnectionState> state {ConnectionState::disconnected};
+    std::chrono::steady_clock::time_point deadline; //!< end of the current handshake
+    std::vector<uint8_t> last_message; //!< sent again by the keep alive
+    std::atomic<std::size_t> reconnects {0};
 };
 
+namespace
+{
+// Number of colors which are converted at once by the bulk setters, without allocating
+constexpr std::size_t colorBlockSize = 16;
+
+// Maximum time to wait for data, before the DTLS retransmission timer is checked again
+constexpr uint32_t pollMilliseconds = 20;
+
+// Keeps the session after a successful handshake, so it can be resumed
+void saveSession(TLSContext& context)
+{
+    mbedtls_ssl_session_free(&context.session);
+    mbedtls_ssl_session_init(&context.session);
+    context.has_session = mbedtls_ssl_get_session(&context.ssl, &context.session) == 0;
+}
+
+// Continues the handshake without blocking
+ConnectionState handshakeStep(TLSContext& context)
+{
+    const int ret = mbedtls_ssl_handshake(&context.ssl);
+    if (ret == 0)
+    {
+        saveSession(context);
+        return ConnectionState::connected;
+    }
+    if ((ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE)
+        && std::chrono::steady_clock::now() < context.deadline)
+    {
+        return ConnectionState::handshaking;
+    }
+    return ConnectionState::disconnected;
+}
+
+// Waits until data is received, at most until the deadline
+void waitForData(TLSContext& context)
+{
+    using namespace std::chrono;
+    const milliseconds remaining = duration_cast<milliseconds>(context.deadline - steady_clock::now());
+    const milliseconds timeout = std::max(milliseconds(0), std::min(remaining, milliseconds(pollMilliseconds)));
+    mbedtls_net_poll(&context.server_fd, MBEDTLS_NET_POLL_READ, static_cast<uint32_t>(timeout.count()));
+}
+
+// Processes received records, returns false when the bridge closed the connection
+bool isOpen(TLSContext& context)
+{
+    unsigned char buffer[64];
+    int ret;
+    do
+    {
+        ret = mbedtls_ssl_read(&context.ssl, buffer, sizeof(buffer));
+    } while (ret > 0);
+    return ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE;
+}
+
+// Writes a whole message
+bool writeMessage(TLSContext& context, const std::vector<uint8_t>& msg)
+{
+    std::size_t total = 0;
+    while (total < msg.size())
+    {
+        const int ret = mbedtls_ssl_write(&context.ssl, &msg[total], msg.size() - total);
+        if (ret == MBEDTLS_ERR_SSL_WANT_WRITE || ret == MBEDTLS_ERR_SSL_WANT_READ)
+        {
+            // The socket is non blocking
+            mbedtls_net_poll(&context.server_fd, MBEDTLS_NET_POLL_WRITE, pollMilliseconds);
+        }
+        else if (ret < 0)
+        {
+            // Return if mbedtls_ssl_write errors
+            return false;
+        }
+        else
+        {
+            total += ret;
+        }
+    }
+    return true;
+}
+} // namespace
+
 std::vector<char> hexToBytes(const std::string& hex)
 {
     std::vector<char> bytes;
@@ -61,8 +155,12 @@ std::vector<char> hexToBytes(const std::string& hex)
     return bytes;
 }
 
-EntertainmentMode::EntertainmentMode(Bridge& b, Group& g)
-    : bridge(&b), group(&g), tls_context(std::make_unique<TLSContext>(TLSContext {}))
+EntertainmentMode::EntertainmentMode(Bridge& b, Group& g, huestream::ColorSpace colorSpace)
+    : bridge(&b),
+      group(&g),
+      tls_context(std::make_unique<TLSContext>()),
+      coordinator(nullptr),
+      coordinator_session(0)
 {
     /*-------------------------------------------------*\
     | Signal the bridge to start streaming              |
@@ -72,43 +170,49 @@ EntertainmentMode::EntertainmentMode(Bridge& b, Group& g)
     /*-------------------------------------------------*\
     | Get the number of lights from the group           |
     \*-------------------------------------------------*/
-    entertainment_num_lights = group->getLightIds().size();
+    entertainment_light_ids = group->getLightIds();
+    entertainment_num_lights = entertainment_light_ids.size();
 
     /*-------------------------------------------------*\
-    | Resize Entertainment Mode message buffer          |
+    | Create Entertainment Mode message with header     |
+    | and light data                                    |
     \*-------------------------------------------------*/
-    entertainment_msg.resize(HUE_ENTERTAINMENT_HEADER_SIZE + (entertainment_num_lights * HUE_ENTERTAINMENT_LIGHT_SIZE));
+    entertainment_msg = huestream::createMessage(entertainment_light_ids, colorSpace);
 
     /*-------------------------------------------------*\
-    | Fill in Entertainment Mode message header         |
+    | Get the color gamut of each light                 |
     \*-------------------------------------------------*/
-    memcpy(&entertainment_msg[0], "HueStream", 9);
-    entertainment_msg[9] = 0x01; // Version Major (1)
-    entertainment_msg[10] = 0x00; // Version Minor (0)
-    entertainment_msg[11] = 0x00; // Sequence ID
-    entertainment_msg[12] = 0x00; // Reserved
-    entertainment_msg[13] = 0x00; // Reserved
-    entertainment_msg[14] = 0x00; // Color Space (RGB)
-    entertainment_msg[15] = 0x00; // Reserved
+    entertainment_gamuts.reserve(entertainment_num_lights);
+    for (int light_id : entertainment_light_ids)
+    {
+        entertainment_gamuts.push_back(bridge->lights().get(light_id)->getColorGamut());
+    }
+
+    initTLSContext();
+}
 
+EntertainmentMode::EntertainmentMode(Bridge& b, Group& g, const std::string& configurationId,
+    const std::vector<uint8_t>& channelIds, huestream::ColorSpace colorSpace)
+    : bridge(&b),
+      group(&g),
+      entertainment_msg(huestream::createMessageV2(configurationId, channelIds, colorSpace)),
+      entertainment_light_ids(channelIds.begin(), channelIds.end()),
+      entertainment_num_lights(channelIds.size()),
+      entertainment_gamuts(channelIds.size(), gamut::gamutC),
+      tls_context(std::make_unique<TLSContext>()),
+      coordinator(nullptr),
+      coordinator_session(0)
+{
     /*-------------------------------------------------*\
-    | Fill in Entertainment Mode light data             |
+    | Signal the bridge to start streaming              |
     \*-------------------------------------------------*/
-    for (unsigned int light_idx = 0; light_idx < entertainment_num_lights; light_idx++)
-    {
-        unsigned int msg_idx = HUE_ENTERTAINMENT_HEADER_SIZE + (light_idx * HUE_ENTERTAINMENT_LIGHT_SIZE);
+    bridge->startStreaming(std::to_string(group->getId()));
 
-        entertainment_msg[msg_idx + 0] = 0x00; // Type (Light)
-        entertainment_msg[msg_idx + 1] = group->getLightIds()[light_idx] >> 8; // ID MSB
-        entertainment_msg[msg_idx + 2] = group->getLightIds()[light_idx] & 0xFF; // ID LSB
-        entertainment_msg[msg_idx + 3] = 0x00; // Red MSB
-        entertainment_msg[msg_idx + 4] = 0x00; // Red LSB;
-        entertainment_msg[msg_idx + 5] = 0x00; // Green MSB;
-        entertainment_msg[msg_idx + 6] = 0x00; // Green LSB;
-        entertainment_msg[msg_idx + 7] = 0x00; // Blue MSB;
-        entertainment_msg[msg_idx + 8] = 0x00; // Blue LSB;
-    }
+    initTLSContext();
+}
 
+void EntertainmentMode::initTLSContext()
+{
     /*-------------------------------------------------*\
     | Initialize mbedtls contexts                       |
     \*-------------------------------------------------*/
@@ -118,6 +222,7 @@ EntertainmentMode::EntertainmentMode(Bridge& b, Group& g)
     mbedtls_x509_crt_init(&tls_context->cacert);
     mbedtls_ctr_drbg_init(&tls_context->ctr_drbg);
     mbedtls_entropy_init(&tls_context->entropy);
+    mbedtls_ssl_session_init(&tls_context->session);
 
     /*-------------------------------------------------*\
     | Seed the Deterministic Random Bit Generator (RNG) |
@@ -130,12 +235,16 @@ EntertainmentMode::EntertainmentMode(Bridge& b, Group& g)
         mbedtls_ssl_config_free(&tls_context->conf);
         mbedtls_ssl_free(&tls_context->ssl);
         mbedtls_net_free(&tls_context->server_fd);
+        mbedtls_ssl_session_free(&tls_context->session);
         throw HueException(CURRENT_FILE_INFO, "Failed to seed mbedtls RNG");
     }
 }
 
 EntertainmentMode::~EntertainmentMode()
 {
+    stopSending();
+    keep_alive.reset();
+    mbedtls_ssl_session_free(&tls_context->session);
     mbedtls_entropy_free(&tls_context->entropy);
     mbedtls_ctr_drbg_free(&tls_context->ctr_drbg);
     mbedtls_x509_crt_free(&tls_context->cacert);
@@ -146,12 +255,51 @@ EntertainmentMode::~EntertainmentMode()
 
 bool EntertainmentMode::connect()
 {
+    if (!startConnect())
+    {
+        return false;
+    }
+    ConnectionState state;
+    while ((state = pollConnect()) == ConnectionState::handshaking)
+    {
+        waitForData(*tls_context);
+    }
+    return state == ConnectionState::connected;
+}
+
+bool EntertainmentMode::startConnect()
+{
+    if (tls_context->state != ConnectionState::disconnected)
+    {
+        return false;
+    }
+    // The timer of a previous connection is stopped before locking, because its callback locks the tls mutex
+    keep_alive.reset();
+    std::lock_guard<std::mutex> lock(tls_context->mutex);
+    if (tls_context->state != ConnectionState::disconnected)
+    {
+        return false;
+    }
     /*-------------------------------------------------*\
     | Signal the bridge to start streaming              |
     | If successful, connect to the UDP port            |
     \*-------------------------------------------------*/
     if (bridge->startStreaming(std::to_string(group->getId())))
     {
+        /*-------------------------------------------------*\
+        | Reset contexts of a previous connection           |
+        \*-------------------------------------------------*/
+        if (tls_context->is_setup)
+        {
+            mbedtls_ssl_free(&tls_context->ssl);
+            mbedtls_ssl_config_free(&tls_context->conf);
+            mbedtls_net_free(&tls_context->server_fd);
+            mbedtls_ssl_init(&tls_context->ssl);
+            mbedtls_ssl_config_init(&tls_context->conf);
+            mbedtls_net_init(&tls_context->server_fd);
+            tls_context->is_setup = false;
+        }
+
         /*-------------------------------------------------*\
         | Connect to the Hue bridge UDP server              |
         \*-------------------------------------------------*/
@@ -238,29 +386,24 @@ bool EntertainmentMode::connect()
             return false;
         }
 
-        mbedtls_ssl_set_bio(
-            &tls_context->ssl, &tls_context->server_fd, mbedtls_net_send, mbedtls_net_recv, mbedtls_net_recv_timeout);
-        mbedtls_ssl_set_timer_cb(
-            &tls_context->ssl, &tls_context->timer, mbedtls_timing_set_delay, mbedtls_timing_get_delay);
+        tls_context->is_setup = true;
 
         /*-------------------------------------------------*\
-        | Handshake                                         |
+        | Use a non blocking socket, the handshake is       |
+        | continued by pollConnect                          |
         \*-------------------------------------------------*/
-        do
-        {
-            ret = mbedtls_ssl_handshake(&tls_context->ssl);
-        } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+        mbedtls_net_set_nonblock(&tls_context->server_fd);
+        mbedtls_ssl_set_bio(&tls_context->ssl, &tls_context->server_fd, mbedtls_net_send, mbedtls_net_recv, NULL);
+        mbedtls_ssl_set_timer_cb(
+            &tls_context->ssl, &tls_context->timer, mbedtls_timing_set_delay, mbedtls_timing_get_delay);
 
         /*-------------------------------------------------*\
-        | If set hostname failed, close and return false    |
+        | Start the handshake                               |
         \*-------------------------------------------------*/
-        if (ret != 0)
-        {
-            mbedtls_ssl_close_notify(&tls_context->ssl);
-            bridge->stopStreaming(std::to_string(group->getId()));
-            return false;
-        }
-
+        tls_context->deadline
+            = std::chrono::steady_clock::now() + Config::instance().getEntertainmentHandshakeTimeout();
+        tls_context->reconnecting = false;
+        tls_context->state = ConnectionState::handshaking;
         return true;
     }
     else
@@ -269,25 +412,109 @@ bool EntertainmentMode::connect()
     }
 }
 
+ConnectionState EntertainmentMode::pollConnect()
+{
+    std::lock_guard<std::mutex> lock(tls_context->mutex);
+    return pollConnectLocked();
+}
+
+ConnectionState EntertainmentMode::getConnectionState() const
+{
+    return tls_context->state;
+}
+
+bool EntertainmentMode::reconnect()
+{
+    {
+        std::lock_guard<std::mutex> lock(tls_context->mutex);
+        // Wait for a reconnect which was already started by sending
+        if (tls_context->state != ConnectionState::handshaking && !startReconnectLocked())
+        {
+            return false;
+        }
+    }
+    ConnectionState state;
+    while ((state = pollConnect()) == ConnectionState::handshaking)
+    {
+        waitForData(*tls_context);
+    }
+    return state == ConnectionState::connected;
+}
+
+std::size_t EntertainmentMode::getReconnectCount() const
+{
+    return tls_context->reconnects;
+}
+
 bool EntertainmentMode::disconnect()
 {
-    mbedtls_ssl_close_notify(&tls_context->ssl);
+    stopSending();
+    // Stopped first, because it locks the tls mutex
+    keep_alive.reset();
+    {
+        std::lock_guard<std::mutex> lock(tls_context->mutex);
+        mbedtls_ssl_close_notify(&tls_context->ssl);
+        tls_context->state = ConnectionState::disconnected;
+    }
     return bridge->stopStreaming(std::to_string(group->getId()));
 }
 
-bool EntertainmentMode::setColorRGB(uint8_t light_index, uint8_t red, uint8_t green, uint8_t blue)
+bool EntertainmentMode::setColorRGB(std::size_t light_index, uint8_t red, uint8_t green, uint8_t blue)
 {
     if (light_index < entertainment_num_lights)
     {
-        unsigned int msg_idx = HUE_ENTERTAINMENT_HEADER_SIZE + (light_index * HUE_ENTERTAINMENT_LIGHT_SIZE);
+        std::vector<uint8_t>& entertainment_msg = getMessage();
+        if (huestream::getColorSpace(entertainment_msg) == huestream::ColorSpace::xyBrightness)
+        {
+            huestream::setXYBrightness(
+                entertainment_msg, light_index, RGB {red, green, blue}.toXY(entertainment_gamuts[light_index]));
+        }
+        else
+        {
+            huestream::setChannels(entertainment_msg, light_index, huestream::to16Bit(red), huestream::to16Bit(green),
+                huestream::to16Bit(blue));
+        }
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
 
-        entertainment_msg[msg_idx + 3] = red; // Red MSB
-        entertainment_msg[msg_idx + 4] = red; // Red LSB;
-        entertainment_msg[msg_idx + 5] = green; // Green MSB;
-        entertainment_msg[msg_idx + 6] = green; // Green LSB;
-        entertainment_msg[msg_idx + 7] = blue; // Blue MSB;
-        entertainment_msg[msg_idx + 8] = blue; // Blue LSB;
+bool EntertainmentMode::setColorRGB16(std::size_t light_index, uint16_t red, uint16_t green, uint16_t blue)
+{
+    if (getColorSpace() != huestream::ColorSpace::rgb)
+    {
+        throw HueException(CURRENT_FILE_INFO, "RGB colors with 16 bit precision require the RGB color space");
+    }
+    if (light_index < entertainment_num_lights)
+    {
+        huestream::setChannels(getMessage(), light_index, red, green, blue);
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
 
+bool EntertainmentMode::setColorXY(std::size_t light_index, const XYBrightness& xy)
+{
+    if (light_index < entertainment_num_lights)
+    {
+        std::vector<uint8_t>& entertainment_msg = getMessage();
+        const ColorGamut& gamut = entertainment_gamuts[light_index];
+        if (huestream::getColorSpace(entertainment_msg) == huestream::ColorSpace::xyBrightness)
+        {
+            huestream::setXYBrightness(entertainment_msg, light_index, {gamut.corrected(xy.xy), xy.brightness});
+        }
+        else
+        {
+            const RGB rgb = RGB::fromXY(xy, gamut);
+            huestream::setChannels(entertainment_msg, light_index, huestream::to16Bit(rgb.r),
+                huestream::to16Bit(rgb.g), huestream::to16Bit(rgb.b));
+        }
         return true;
     }
     else
@@ -296,26 +523,332 @@ bool EntertainmentMode::setColorRGB(uint8_t light_index, uint8_t red, uint8_t gr
     }
 }
 
+bool EntertainmentMode::setColorsRGB(const RGB* colors, std::size_t count, std::size_t first)
+{
+    if (first > entertainment_num_lights || count > entertainment_num_lights - first)
+    {
+        return false;
+    }
+    std::vector<uint8_t>& entertainment_msg = getMessage();
+    const bool xyBrightness = huestream::getColorSpace(entertainment_msg) == huestream::ColorSpace::xyBrightness;
+    for (std::size_t start = 0; start < count; start += colorBlockSize)
+    {
+        const std::size_t size = std::min(colorBlockSize, count - start);
+        uint16_t channels[colorBlockSize * 3];
+        if (xyBrightness)
+        {
+            XYBrightness xy[colorBlockSize];
+            convertToXY(colors + start, size, xy, entertainment_gamuts.data() + first + start);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                channels[i * 3] = huestream::toChannel(xy[i].xy.x);
+                channels[i * 3 + 1] = huestream::toChannel(xy[i].xy.y);
+                channels[i * 3 + 2] = huestream::toChannel(xy[i].brightness);
+            }
+        }
+        else
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                channels[i * 3] = huestream::to16Bit(colors[start + i].r);
+                channels[i * 3 + 1] = huestream::to16Bit(colors[start + i].g);
+                channels[i * 3 + 2] = huestream::to16Bit(colors[start + i].b);
+            }
+        }
+        huestream::setChannels(entertainment_msg, first + start, channels, size);
+    }
+    return true;
+}
+
+bool EntertainmentMode::setColorsXY(const XYBrightness* colors, std::size_t count, std::size_t first)
+{
+    if (first > entertainment_num_lights || count > entertainment_num_lights - first)
+    {
+        return false;
+    }
+    std::vector<uint8_t>& entertainment_msg = getMessage();
+    const bool xyBrightness = huestream::getColorSpace(entertainment_msg) == huestream::ColorSpace::xyBrightness;
+    for (std::size_t start = 0; start < count; start += colorBlockSize)
+    {
+        const std::size_t size = std::min(colorBlockSize, count - start);
+        const ColorGamut* gamuts = entertainment_gamuts.data() + first + start;
+        uint16_t channels[colorBlockSize * 3];
+        if (xyBrightness)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const XY xy = gamuts[i].corrected(colors[start + i].xy);
+                channels[i * 3] = huestream::toChannel(xy.x);
+                channels[i * 3 + 1] = huestream::toChannel(xy.y);
+                channels[i * 3 + 2] = huestream::toChannel(colors[start + i].brightness);
+            }
+        }
+        else
+        {
+            RGB rgb[colorBlockSize];
+            convertToRGB(colors + start, size, rgb, gamuts);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                channels[i * 3] = huestream::to16Bit(rgb[i].r);
+                channels[i * 3 + 1] = huestream::to16Bit(rgb[i].g);
+                channels[i * 3 + 2] = huestream::to16Bit(rgb[i].b);
+            }
+        }
+        huestream::setChannels(entertainment_msg, first + start, channels, size);
+    }
+    return true;
+}
+
+bool EntertainmentMode::setChannels(const uint16_t* channels, std::size_t count, std::size_t first)
+{
+    if (first > entertainment_num_lights || count > entertainment_num_lights - first)
+    {
+        return false;
+    }
+    huestream::setChannels(getMessage(), first, channels, count);
+    return true;
+}
+
+std::size_t EntertainmentMode::getLightCount() const
+{
+    return entertainment_num_lights;
+}
+
+const std::vector<int>& EntertainmentMode::getLightIds() const
+{
+    return entertainment_light_ids;
+}
+
+huestream::ColorSpace EntertainmentMode::getColorSpace() const
+{
+    return huestream::getColorSpace(entertainment_msg);
+}
+
+ColorGamut EntertainmentMode::getColorGamut(std::size_t light_index) const
+{
+    if (light_index >= entertainment_num_lights)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Invalid light index");
+    }
+    return entertainment_gamuts[light_index];
+}
+
+void EntertainmentMode::setColorGamut(std::size_t light_index, const ColorGamut& gamut)
+{
+    if (light_index >= entertainment_num_lights)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Invalid light index");
+    }
+    entertainment_gamuts[light_index] = gamut;
+}
+
 bool EntertainmentMode::update()
 {
-    int ret;
-    unsigned int total = 0;
+    if (streaming_engine)
+    {
+        streaming_engine->publish();
+        return true;
+    }
+    if (coordinator)
+    {
+        coordinator->publish(coordinator_session);
+        return true;
+    }
+    return send(entertainment_msg);
+}
 
-    while (total < entertainment_msg.size())
+bool EntertainmentMode::update(const EffectTimeline& timeline, std::chrono::steady_clock::duration time)
+{
+    timeline.evaluate(time, getMessage(), entertainment_gamuts.data());
+    return update();
+}
+
+bool EntertainmentMode::update(const SpatialMapping& mapping, const ColorGrid& grid)
+{
+    if (mapping.getLightCount() != entertainment_num_lights)
     {
-        ret = mbedtls_ssl_write(
-            &tls_context->ssl, (const unsigned char*)&entertainment_msg[total], entertainment_msg.size());
+        throw HueException(CURRENT_FILE_INFO, "Mapping does not match the lights of the group");
+    }
+    const bool xyBrightness = getColorSpace() == huestream::ColorSpace::xyBrightness;
+    for (std::size_t start = 0; start < entertainment_num_lights; start += colorBlockSize)
+    {
+        const std::size_t size = std::min(colorBlockSize, entertainment_num_lights - start);
+        if (xyBrightness)
+        {
+            RGB colors[colorBlockSize];
+            mapping.sample(grid, start, size, colors);
+            setColorsRGB(colors, size, start);
+        }
+        else
+        {
+            uint16_t channels[colorBlockSize * 3];
+            mapping.sample(grid, start, size, channels);
+            setChannels(channels, size, start);
+        }
+    }
+    return update();
+}
 
-        if (ret < 0)
+void EntertainmentMode::startSending(int rate)
+{
+    if (isSending())
+    {
+        throw HueException(CURRENT_FILE_INFO, "Entertainment mode is already sending");
+    }
+    std::unique_ptr<StreamingEngine> engine = std::make_unique<StreamingEngine>(
+        entertainment_msg, [this](const std::vector<uint8_t>& msg) { return send(msg); });
+    engine->start(rate);
+    streaming_engine = std::move(engine);
+}
+
+void EntertainmentMode::startSending(StreamCoordinator& coordinator)
+{
+    if (isSending())
+    {
+        throw HueException(CURRENT_FILE_INFO, "Entertainment mode is already sending");
+    }
+    coordinator_session
+        = coordinator.addSession(entertainment_msg, [this](const std::vector<uint8_t>& msg) { return send(msg); });
+    this->coordinator = &coordinator;
+}
+
+void EntertainmentMode::stopSending()
+{
+    if (streaming_engine)
+    {
+        streaming_engine->stop();
+        // Keep colors which were set, but not published yet
+        entertainment_msg = streaming_engine->getFrame();
+        streaming_engine.reset();
+    }
+    if (coordinator)
+    {
+        entertainment_msg = coordinator->getFrame(coordinator_session);
+        // Waits until the coordinator does not send this session anymore
+        coordinator->removeSession(coordinator_session);
+        coordinator = nullptr;
+    }
+}
+
+bool EntertainmentMode::isSending() const
+{
+    return streaming_engine != nullptr || coordinator != nullptr;
+}
+
+StreamStatistics EntertainmentMode::getStreamStatistics() const
+{
+    if (coordinator)
+    {
+        return coordinator->getStatistics(coordinator_session);
+    }
+    return streaming_engine ? streaming_engine->getStatistics() : StreamStatistics();
+}
+
+std::vector<uint8_t>& EntertainmentMode::getMessage()
+{
+    if (coordinator)
+    {
+        return coordinator->getFrame(coordinator_session);
+    }
+    return streaming_engine ? streaming_engine->getFrame() : entertainment_msg;
+}
+
+bool EntertainmentMode::send(const std::vector<uint8_t>& msg)
+{
+    std::lock_guard<std::mutex> lock(tls_context->mutex);
+    if (!sendLocked(msg))
+    {
+        return false;
+    }
+    // Same size as before, so this does not allocate
+    tls_context->last_message = msg;
+    return true;
+}
+
+bool EntertainmentMode::sendLocked(const std::vector<uint8_t>& msg)
+{
+    // Every send continues a reconnect without blocking, the frames are dropped until it is finished
+    if (pollConnectLocked() != ConnectionState::connected)
+    {
+        return false;
+    }
+    // The bridge closes the connection after some time without messages, or when it restarts
+    if (!isOpen(*tls_context) || !writeMessage(*tls_context, msg))
+    {
+        if (!startReconnectLocked() || pollConnectLocked() != ConnectionState::connected
+            || !writeMessage(*tls_context, msg))
         {
-            // Return if mbedtls_ssl_write errors
             return false;
         }
-        else
+    }
+    if (keep_alive)
+    {
+        keep_alive->touch();
+    }
+    return true;
+}
+
+ConnectionState EntertainmentMode::pollConnectLocked()
+{
+    if (tls_context->state != ConnectionState::handshaking)
+    {
+        return tls_context->state;
+    }
+    const ConnectionState state = handshakeStep(*tls_context);
+    if (state == ConnectionState::connected)
+    {
+        tls_context->last_message = entertainment_msg;
+        const std::chrono::steady_clock::duration interval = Config::instance().getEntertainmentKeepAliveInterval();
+        // A reconnect keeps the timer of the connection
+        if (!keep_alive && interval > std::chrono::steady_clock::duration::zero())
         {
-            total += ret;
+            keep_alive = std::make_unique<IdleTimer>(interval, [this]() { keepAlive(); });
+            keep_alive->start();
         }
     }
+    else if (state == ConnectionState::disconnected && !tls_context->reconnecting)
+    {
+        /*-------------------------------------------------*\
+        | If the handshake failed or timed out, close and   |
+        | stop streaming                                    |
+        \*-------------------------------------------------*/
+        mbedtls_ssl_close_notify(&tls_context->ssl);
+        bridge->stopStreaming(std::to_string(group->getId()));
+    }
+    tls_context->state = state;
+    return state;
+}
+
+bool EntertainmentMode::startReconnectLocked()
+{
+    if (!tls_context->is_setup || tls_context->state == ConnectionState::handshaking)
+    {
+        return false;
+    }
+    ++tls_context->reconnects;
+    /*-------------------------------------------------*\
+    | Start a new handshake on the same socket, which   |
+    | resumes the last session if the bridge allows it  |
+    \*-------------------------------------------------*/
+    if (mbedtls_ssl_session_reset(&tls_context->ssl) != 0)
+    {
+        tls_context->state = ConnectionState::disconnected;
+        return false;
+    }
+    if (tls_context->has_session)
+    {
+        // A full handshake is done when this fails
+        mbedtls_ssl_set_session(&tls_context->ssl, &tls_context->session);
+    }
+    tls_context->deadline = std::chrono::steady_clock::now() + Config::instance().getEntertainmentHandshakeTimeout();
+    tls_context->reconnecting = true;
+    tls_context->state = ConnectionState::handshaking;
     return true;
 }
+
+void EntertainmentMode::keepAlive()
+{
+    std::lock_guard<std::mutex> lock(tls_context->mutex);
+    sendLocked(tls_context->last_message);
+}
 } // namespace hueplusplus
@@ -0,0 +1,139 @@
+/**
+    \file Executor.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/Executor.h"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+namespace hueplusplus
+{
+Executor::Executor(std::size_t threadCount)
+{
+    threadCount = std::max<std::size_t>(threadCount, 1);
+    threads.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back(&Executor::run, this);
+    }
+}
+
+Executor::~Executor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    changed.notify_all();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void Executor::post(std::size_t strand, Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Strand& s = strands[strand];
+        s.tasks.push_back(std::move(task));
+        ++pending;
+        if (!s.running && s.tasks.size() == 1)
+        {
+            ready.push_back(strand);
+        }
+    }
+    changed.notify_all();
+}
+
+std::size_t Executor::getThreadCount() const
+{
+    return threads.size();
+}
+
+std::size_t Executor::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending;
+}
+
+void Executor::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return pending == 0; });
+}
+
+std::size_t Executor::defaultThreadCount()
+{
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 4);
+}
+
+void Executor::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        // Remaining tasks are still run when stopped
+        if (ready.empty())
+        {
+            if (stopped)
+            {
+                break;
+            }
+            changed.wait(lock);
+            continue;
+        }
+        const std::size_t strand = ready.front();
+        ready.pop_front();
+        Strand& s = strands[strand];
+        Task task = std::move(s.tasks.front());
+        s.tasks.pop_front();
+        s.running = true;
+        lock.unlock();
+        try
+        {
+            task();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Executor: Task failed: " << e.what() << "\n";
+        }
+        catch (...)
+        {
+            std::cerr << "Executor: Task failed with unknown exception\n";
+        }
+        lock.lock();
+        s.running = false;
+        --pending;
+        if (!s.tasks.empty())
+        {
+            // Go to the back, so other strands get their turn
+            ready.push_back(strand);
+        }
+        else
+        {
+            strands.erase(strand);
+        }
+        changed.notify_all();
+    }
+}
+} // namespace hueplusplus
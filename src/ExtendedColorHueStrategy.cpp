@@ -32,37 +32,53 @@ namespace hueplusplus
 {
 bool ExtendedColorHueStrategy::alertHueSaturation(const HueSaturation& hueSat, Light& light) const
 {
-    // Careful, only use state until any light function might refresh the value and invalidate the reference
-    const nlohmann::json& state = light.state.getValue()["state"];
-    std::string cType = state["colormode"].get<std::string>();
-    bool on = state["on"].get<bool>();
+    std::string cType;
+    bool on = false;
+    uint16_t oldCT = 0;
+    {
+        // Refresh before locking and only hold the lock while reading, the light functions below send requests
+        light.state.getValue();
+        auto lock = light.state.lockShared();
+        const nlohmann::json& state = static_cast<const APICache&>(light.state).getValue().at("state");
+        cType = state["colormode"].get<std::string>();
+        on = state["on"].get<bool>();
+        if (cType == "ct")
+        {
+            oldCT = state["ct"].get<uint16_t>();
+        }
+    }
     if (cType != "ct")
     {
         return SimpleColorHueStrategy::alertHueSaturation(hueSat, light);
     }
     else
     {
-        uint16_t oldCT = state["ct"].get<uint16_t>();
         if (!light.setColorHueSaturation(hueSat, 1))
         {
             return false;
         }
-        std::this_thread::sleep_for(Config::instance().getPreAlertDelay());
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(Config::instance().getPostAlertDelay());
-        return light.transaction().setColorTemperature(oldCT).setOn(on).setTransition(1).commit();
+        return light.alertAndRestore(
+            [=](StateTransaction& t) { t.setColorTemperature(oldCT).setOn(on).setTransition(1); });
     }
 }
 
 bool ExtendedColorHueStrategy::alertXY(const XYBrightness& xy, Light& light) const
 {
-    // Careful, only use state until any light function might refresh the value and invalidate the reference
-    const nlohmann::json& state = light.state.getValue()["state"];
-    std::string cType = state["colormode"].get<std::string>();
-    bool on = state["on"].get<bool>();
+    std::string cType;
+    bool on = false;
+    uint16_t oldCT = 0;
+    {
+        // Refresh before locking and only hold the lock while reading, the light functions below send requests
+        light.state.getValue();
+        auto lock = light.state.lockShared();
+        const nlohmann::json& state = static_cast<const APICache&>(light.state).getValue().at("state");
+        cType = state["colormode"].get<std::string>();
+        on = state["on"].get<bool>();
+        if (cType == "ct")
+        {
+            oldCT = state["ct"].get<uint16_t>();
+        }
+    }
     // const reference to prevent refreshes
     const Light& cLight = light;
     if (cType != "ct")
@@ -71,24 +87,14 @@ bool ExtendedColorHueStrategy::alertXY(const XYBrightness& xy, Light& light) con
     }
     else
     {
-        uint16_t oldCT = state["ct"].get<uint16_t>();
         uint8_t oldBrightness = cLight.getBrightness();
         if (!light.setColorXY(xy, 1))
         {
             return false;
         }
-        std::this_thread::sleep_for(Config::instance().getPreAlertDelay());
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(Config::instance().getPostAlertDelay());
-        return light.transaction()
-            .setColorTemperature(oldCT)
-            .setBrightness(oldBrightness)
-            .setOn(on)
-            .setTransition(1)
-            .commit();
+        return light.alertAndRestore([=](StateTransaction& t) {
+            t.setColorTemperature(oldCT).setBrightness(oldBrightness).setOn(on).setTransition(1);
+        });
     }
 }
 } // namespace hueplusplus
@@ -34,10 +34,16 @@ namespace hueplusplus
 {
 bool ExtendedColorTemperatureStrategy::alertTemperature(unsigned int mired, Light& light) const
 {
-    // Careful, only use state until any light function might refresh the value and invalidate the reference
-    const nlohmann::json& state = light.state.getValue()["state"];
-    std::string cType = state["colormode"].get<std::string>();
-    bool on = state["on"].get<bool>();
+    std::string cType;
+    bool on = false;
+    {
+        // Refresh before locking and only hold the lock while reading, the light functions below send requests
+        light.state.getValue();
+        auto lock = light.state.lockShared();
+        const nlohmann::json& state = static_cast<const APICache&>(light.state).getValue().at("state");
+        cType = state["colormode"].get<std::string>();
+        on = state["on"].get<bool>();
+    }
     const Light& cLight = light;
     if (cType == "ct")
     {
@@ -50,13 +56,7 @@ bool ExtendedColorTemperatureStrategy::alertTemperature(unsigned int mired, Ligh
         {
             return false;
         }
-        std::this_thread::sleep_for(Config::instance().getPreAlertDelay());
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(Config::instance().getPostAlertDelay());
-        return light.transaction().setColor(oldHueSat).setOn(on).setTransition(1).commit();
+        return light.alertAndRestore([=](StateTransaction& t) { t.setColor(oldHueSat).setOn(on).setTransition(1); });
     }
     else if (cType == "xy")
     {
@@ -65,13 +65,7 @@ bool ExtendedColorTemperatureStrategy::alertTemperature(unsigned int mired, Ligh
         {
             return false;
         }
-        std::this_thread::sleep_for(Config::instance().getPreAlertDelay());
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(Config::instance().getPostAlertDelay());
-        return light.transaction().setColor(oldXy).setOn(on).setTransition(1).commit();
+        return light.alertAndRestore([=](StateTransaction& t) { t.setColor(oldXy).setOn(on).setTransition(1); });
     }
     else
     {
@@ -32,6 +32,11 @@ void Group::setRefreshDuration(std::chrono::steady_clock::duration refreshDurati
     state.setRefreshDuration(refreshDuration);
 }
 
+void Group::updateState(const nlohmann::json& listState, std::chrono::steady_clock::time_point refreshTime)
+{
+    state.updateValue(listState, refreshTime);
+}
+
 
 int Group::getId() const
 {
@@ -40,16 +45,19 @@ int Group::getId() const
 
 std::string Group::getName() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("name").get<std::string>();
 }
 
 std::string Group::getType() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("type").get<std::string>();
 }
 
 std::vector<int> Group::getLightIds() const
 {
+    auto lock = state.lockShared();
     const nlohmann::json& lights = state.getValue().at("lights");
     std::vector<int> ids;
     ids.reserve(lights.size());
@@ -64,6 +72,34 @@ std::vector<int> Group::getLightIds() const
     return ids;
 }
 
+std::vector<LightLocation> Group::getLightLocations() const
+{
+    auto lock = state.lockShared();
+    const nlohmann::json& value = state.getValue();
+    const auto locations = value.find("locations");
+    std::vector<LightLocation> result;
+    for (const nlohmann::json& id : value.at("lights"))
+    {
+        if (id.is_null())
+        {
+            continue;
+        }
+        LightLocation location {0.f, 0.f, 0.f};
+        if (locations != value.end())
+        {
+            const auto pos = locations->find(id.get<std::string>());
+            if (pos != locations->end() && pos->is_array() && pos->size() >= 2)
+            {
+                location.x = pos->at(0).get<float>();
+                location.y = pos->at(1).get<float>();
+                location.z = pos->size() > 2 ? pos->at(2).get<float>() : 0.f;
+            }
+        }
+        result.push_back(location);
+    }
+    return result;
+}
+
 void Group::setName(const std::string& name)
 {
     nlohmann::json request = {{"name", name}};
@@ -84,39 +120,46 @@ void Group::setLights(const std::vector<int>& ids)
 
 bool Group::getAllOn()
 {
-    return state.getValue().at("state").at("all_on").get<bool>();
+    // Refresh before locking, so the lock is not held during the request
+    state.getValue();
+    return static_cast<const Group&>(*this).getAllOn();
 }
 bool Group::getAllOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("all_on").get<bool>();
 }
 
 bool Group::getAnyOn()
 {
-    return state.getValue().at("state").at("any_on").get<bool>();
+    state.getValue();
+    return static_cast<const Group&>(*this).getAnyOn();
 }
 bool Group::getAnyOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("any_on").get<bool>();
 }
 
 bool Group::getActionOn()
 {
-    return state.getValue().at("action").at("on").get<bool>();
+    state.getValue();
+    return static_cast<const Group&>(*this).getActionOn();
 }
 bool Group::getActionOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("action").at("on").get<bool>();
 }
 
 std::pair<uint16_t, uint8_t> Group::getActionHueSaturation()
 {
-    const nlohmann::json& action = state.getValue().at("action");
-
-    return std::make_pair(action.at("hue").get<int>(), action.at("sat").get<int>());
+    state.getValue();
+    return static_cast<const Group&>(*this).getActionHueSaturation();
 }
 std::pair<uint16_t, uint8_t> Group::getActionHueSaturation() const
 {
+    auto lock = state.lockShared();
     const nlohmann::json& action = state.getValue().at("action");
 
     return std::make_pair(action.at("hue").get<int>(), action.at("sat").get<int>());
@@ -124,39 +167,46 @@ std::pair<uint16_t, uint8_t> Group::getActionHueSaturation() const
 
 unsigned int Group::getActionBrightness()
 {
-    return state.getValue().at("action").at("bri").get<int>();
+    state.getValue();
+    return static_cast<const Group&>(*this).getActionBrightness();
 }
 unsigned int Group::getActionBrightness() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("action").at("bri").get<int>();
 }
 
 unsigned int Group::getActionColorTemperature()
 {
-    return state.getValue().at("action").at("ct").get<int>();
+    state.getValue();
+    return static_cast<const Group&>(*this).getActionColorTemperature();
 }
 unsigned int Group::getActionColorTemperature() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("action").at("ct").get<int>();
 }
 
 std::pair<float, float> Group::getActionColorXY()
 {
-    const nlohmann::json& xy = state.getValue().at("action").at("xy");
-    return std::pair<float, float>(xy[0].get<float>(), xy[1].get<float>());
+    state.getValue();
+    return static_cast<const Group&>(*this).getActionColorXY();
 }
 std::pair<float, float> Group::getActionColorXY() const
 {
+    auto lock = state.lockShared();
     const nlohmann::json& xy = state.getValue().at("action").at("xy");
     return std::pair<float, float>(xy[0].get<float>(), xy[1].get<float>());
 }
 
 std::string Group::getActionColorMode()
 {
-    return state.getValue().at("action").at("colormode").get<std::string>();
+    state.getValue();
+    return static_cast<const Group&>(*this).getActionColorMode();
 }
 std::string Group::getActionColorMode() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("action").at("colormode").get<std::string>();
 }
 
@@ -216,6 +266,7 @@ nlohmann::json Group::sendPutRequest(const std::string& subPath, const nlohmann:
 
 std::string Group::getRoomType() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("class").get<std::string>();
 }
 
@@ -227,11 +278,13 @@ void Group::setRoomType(const std::string& type)
 
 std::string Group::getModelId() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("modelid").get<std::string>();
 }
 
 std::string Group::getUniqueId() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("uniqueid").get<std::string>();
 }
 
@@ -22,6 +22,8 @@
 
 #include "hueplusplus/HueCommandAPI.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <thread>
 
 #include "hueplusplus/LibConfig.h"
@@ -33,7 +35,8 @@ namespace
 {
 // Runs functor with appropriate timeout and retries when timed out or connection reset
 template <typename Timeout, typename Fun>
-nlohmann::json RunWithTimeout(std::shared_ptr<Timeout> timeout, std::chrono::steady_clock::duration minDelay, Fun fun)
+auto RunWithTimeout(std::shared_ptr<Timeout> timeout, std::chrono::steady_clock::duration minDelay, Fun fun)
+    -> decltype(fun())
 {
     auto now = std::chrono::steady_clock::now();
     std::lock_guard<std::mutex> lock(timeout->mutex);
@@ -43,7 +46,7 @@ nlohmann::json RunWithTimeout(std::shared_ptr<Timeout> timeout, std::chrono::ste
     }
     try
     {
-        nlohmann::json response = fun();
+        auto response = fun();
         timeout->timeout = now + minDelay;
         return response;
     }
@@ -53,7 +56,7 @@ nlohmann::json RunWithTimeout(std::shared_ptr<Timeout> timeout, std::chrono::ste
         {
             // Happens when hue is too busy, wait and try again (once)
             std::this_thread::sleep_for(minDelay);
-            nlohmann::json v = fun();
+            auto v = fun();
             timeout->timeout = std::chrono::steady_clock::now() + minDelay;
             return v;
         }
@@ -61,6 +64,76 @@ nlohmann::json RunWithTimeout(std::shared_ptr<Timeout> timeout, std::chrono::ste
         throw;
     }
 }
+
+// Returns the entry of response which contains an error, or nullptr
+template <typename Json>
+const Json* findError(const Json& response)
+{
+    if (response.count("error"))
+    {
+        return &response;
+    }
+    else if (response.is_array())
+    {
+        // Check if array contains error response
+        auto it
+            = std::find_if(response.begin(), response.end(), [](const Json& v) { return v.count("error"); });
+        if (it != response.end())
+        {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+// Same error number as HueAPIResponseException::Create, without throwing on invalid values
+template <typename Json>
+int getErrorNumber(const Json& errorEntry)
+{
+    const Json& error = errorEntry["error"];
+    auto type = error.find("type");
+    if (type != error.end())
+    {
+        if (type->is_number_integer())
+        {
+            return type->template get<int>();
+        }
+        else if (type->is_string())
+        {
+            return static_cast<int>(std::strtol(type->template get_ref<const typename Json::string_t&>().c_str(), nullptr, 10));
+        }
+    }
+    return -1;
+}
+
+// Runs request without throwing, converts exceptions and error responses to Error
+template <typename Timeout, typename Fun, typename Json = decltype(std::declval<Fun>()())>
+Result<Json> TryRunWithTimeout(std::shared_ptr<Timeout> timeout, std::chrono::steady_clock::duration minDelay, Fun fun)
+{
+    try
+    {
+        Json response = RunWithTimeout(std::move(timeout), minDelay, fun);
+        const Json* error = findError(response);
+        if (error != nullptr)
+        {
+            return Error {ErrorCode::apiError, getErrorNumber(*error), {}};
+        }
+        return Result<Json>(std::move(response));
+    }
+    catch (const std::system_error& e)
+    {
+        const bool busy = e.code() == std::errc::connection_reset || e.code() == std::errc::timed_out;
+        return Error {busy ? ErrorCode::busy : ErrorCode::connectionFailed, 0, e.code()};
+    }
+    catch (const HueException&)
+    {
+        return ErrorCode::invalidResponse;
+    }
+    catch (const nlohmann::json::exception&)
+    {
+        return ErrorCode::invalidResponse;
+    }
+}
 } // namespace
 
 HueCommandAPI::HueCommandAPI(
@@ -68,8 +141,10 @@ HueCommandAPI::HueCommandAPI(
     : ip(ip),
       port(port),
       username(username),
+      apiPrefix("/api/" + username + "/"),
       httpHandler(std::move(httpHandler)),
-      timeout(new TimeoutData {std::chrono::steady_clock::now(), {}})
+      timeout(new TimeoutData {std::chrono::steady_clock::now(), {}}),
+      stateMutex(std::make_shared<StateMutex>())
 {}
 
 nlohmann::json HueCommandAPI::PUTRequest(const std::string& path, const nlohmann::json& request) const
@@ -85,6 +160,19 @@ nlohmann::json HueCommandAPI::PUTRequest(
     }));
 }
 
+nlohmann::json HueCommandAPI::PUTSerializedRequest(const std::string& path, const std::string& body) const
+{
+    return PUTSerializedRequest(path, body, CURRENT_FILE_INFO);
+}
+
+nlohmann::json HueCommandAPI::PUTSerializedRequest(
+    const std::string& path, const std::string& body, FileInfo fileInfo) const
+{
+    return HandleError(std::move(fileInfo), RunWithTimeout(timeout, Config::instance().getBridgeRequestDelay(), [&]() {
+        return httpHandler->PUTSerialized(getPathPrefix(path), path, body, ip, port);
+    }));
+}
+
 nlohmann::json HueCommandAPI::GETRequest(const std::string& path, const nlohmann::json& request) const
 {
     return GETRequest(path, request, CURRENT_FILE_INFO);
@@ -98,6 +186,33 @@ nlohmann::json HueCommandAPI::GETRequest(
     }));
 }
 
+nlohmann::json HueCommandAPI::GETRequest(
+    const std::string& path, const nlohmann::json& request, const JsonFilter& filter, FileInfo fileInfo) const
+{
+    if (filter.keepsAll())
+    {
+        return GETRequest(path, request, std::move(fileInfo));
+    }
+    return HandleError(std::move(fileInfo), RunWithTimeout(timeout, Config::instance().getBridgeRequestDelay(), [&]() {
+        return httpHandler->GETJsonFiltered(combinedPath(path), request, filter, ip, port);
+    }));
+}
+
+ArenaJson HueCommandAPI::GETRequestArena(
+    const std::string& path, const nlohmann::json& request, const JsonFilter& filter, FileInfo fileInfo) const
+{
+    ArenaJson response = RunWithTimeout(timeout, Config::instance().getBridgeRequestDelay(), [&]() {
+        return filter.parseArena(
+            httpHandler->GETString(combinedPath(path), "application/json", request.dump(), ip, port));
+    });
+    const ArenaJson* error = findError(response);
+    if (error != nullptr)
+    {
+        throw HueAPIResponseException::Create(std::move(fileInfo), toJson(*error));
+    }
+    return response;
+}
+
 nlohmann::json HueCommandAPI::DELETERequest(const std::string& path, const nlohmann::json& request) const
 {
     return DELETERequest(path, request, CURRENT_FILE_INFO);
@@ -124,35 +239,77 @@ nlohmann::json HueCommandAPI::POSTRequest(
     }));
 }
 
-nlohmann::json HueCommandAPI::HandleError(FileInfo fileInfo, const nlohmann::json& response) const
+Result<nlohmann::json> HueCommandAPI::tryPUTRequest(const std::string& path, const nlohmann::json& request) const
 {
-    if (response.count("error"))
+    return TryRunWithTimeout(timeout, Config::instance().getBridgeRequestDelay(),
+        [&]() { return httpHandler->PUTJson(combinedPath(path), request, ip, port); });
+}
+
+Result<nlohmann::json> HueCommandAPI::tryGETRequest(const std::string& path, const nlohmann::json& request) const
+{
+    return TryRunWithTimeout(timeout, Config::instance().getBridgeRequestDelay(),
+        [&]() { return httpHandler->GETJson(combinedPath(path), request, ip, port); });
+}
+
+Result<nlohmann::json> HueCommandAPI::tryGETRequest(
+    const std::string& path, const nlohmann::json& request, const JsonFilter& filter) const
+{
+    if (filter.keepsAll())
     {
-        throw HueAPIResponseException::Create(std::move(fileInfo), response);
+        return tryGETRequest(path, request);
     }
-    else if (response.is_array())
+    return TryRunWithTimeout(timeout, Config::instance().getBridgeRequestDelay(),
+        [&]() { return httpHandler->GETJsonFiltered(combinedPath(path), request, filter, ip, port); });
+}
+
+Result<ArenaJson> HueCommandAPI::tryGETRequestArena(
+    const std::string& path, const nlohmann::json& request, const JsonFilter& filter) const
+{
+    return TryRunWithTimeout(timeout, Config::instance().getBridgeRequestDelay(), [&]() {
+        return filter.parseArena(
+            httpHandler->GETString(combinedPath(path), "application/json", request.dump(), ip, port));
+    });
+}
+
+Result<nlohmann::json> HueCommandAPI::tryDELETERequest(const std::string& path, const nlohmann::json& request) const
+{
+    return TryRunWithTimeout(timeout, Config::instance().getBridgeRequestDelay(),
+        [&]() { return httpHandler->DELETEJson(combinedPath(path), request, ip, port); });
+}
+
+Result<nlohmann::json> HueCommandAPI::tryPOSTRequest(const std::string& path, const nlohmann::json& request) const
+{
+    return TryRunWithTimeout(timeout, Config::instance().getBridgeRequestDelay(),
+        [&]() { return httpHandler->POSTJson(combinedPath(path), request, ip, port); });
+}
+
+nlohmann::json HueCommandAPI::HandleError(FileInfo fileInfo, const nlohmann::json& response) const
+{
+    const nlohmann::json* error = findError(response);
+    if (error != nullptr)
     {
-        // Check if array contains error response
-        auto it
-            = std::find_if(response.begin(), response.end(), [](const nlohmann::json& v) { return v.count("error"); });
-        if (it != response.end())
-        {
-            throw HueAPIResponseException::Create(std::move(fileInfo), it.value());
-        }
+        throw HueAPIResponseException::Create(std::move(fileInfo), *error);
     }
     return response;
 }
 
 std::string HueCommandAPI::combinedPath(const std::string& path) const
 {
-    std::string result = "/api/";
-    result.append(username);
-    // If path does not begin with '/', insert it unless it is empty
-    if (!path.empty() && path.front() != '/')
-    {
-        result.append("/");
-    }
+    MessagePart prefix = getPathPrefix(path);
+    std::string result(prefix.data, prefix.size);
     result.append(path);
     return result;
 }
+
+StateMutex& HueCommandAPI::getStateMutex() const
+{
+    return *stateMutex;
+}
+
+MessagePart HueCommandAPI::getPathPrefix(const std::string& path) const
+{
+    // If path does not begin with '/', keep the one at the end of the prefix unless path is empty
+    const bool keepSlash = !path.empty() && path.front() != '/';
+    return {apiPrefix.data(), apiPrefix.size() - (keepSlash ? 0 : 1)};
+}
 } // namespace hueplusplus
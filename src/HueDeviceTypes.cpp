@@ -22,12 +22,12 @@
 
 #include "hueplusplus/HueDeviceTypes.h"
 
-#include <set>
+#include <cctype>
 
 #include "hueplusplus/ExtendedColorHueStrategy.h"
 #include "hueplusplus/ExtendedColorTemperatureStrategy.h"
-#include "hueplusplus/HueDeviceTypes.h"
 #include "hueplusplus/HueExceptionMacro.h"
+#include "hueplusplus/ModelDatabase.h"
 #include "hueplusplus/SimpleBrightnessStrategy.h"
 #include "hueplusplus/SimpleColorHueStrategy.h"
 #include "hueplusplus/SimpleColorTemperatureStrategy.h"
@@ -37,25 +37,51 @@ namespace hueplusplus
 {
 namespace
 {
-const std::set<std::string>& getGamutBTypes()
+enum class LightKind
+{
+    onOff,
+    dimmable,
+    colorTemperature,
+    color,
+    extendedColor
+};
+
+struct LightTypeEntry
 {
-    static const std::set<std::string> c_EXTENDEDCOLORLIGHT_GAMUTB_TYPES
-        = {"LCT001", "LCT002", "LCT003", "LCT007", "LLM001"};
-    return c_EXTENDEDCOLORLIGHT_GAMUTB_TYPES;
+    const char* type;
+    LightKind kind;
 };
 
-const std::set<std::string>& getGamutCTypes()
+// Light types in lower case
+constexpr LightTypeEntry c_lightTypes[] = {{"on/off light", LightKind::onOff},
+    {"on/off plug-in unit", LightKind::onOff}, {"dimmable light", LightKind::dimmable},
+    {"dimmable plug-in unit", LightKind::dimmable}, {"color temperature light", LightKind::colorTemperature},
+    {"color light", LightKind::color}, {"extended color light", LightKind::extendedColor}};
+
+// Compares type ignoring case without copying it
+bool equalsLowerCase(const std::string& type, const char* lower)
 {
-    static const std::set<std::string> c_EXTENDEDCOLORLIGHT_GAMUTC_TYPES
-        = {"LCT010", "LCT011", "LCT012", "LCT014", "LCT015", "LCT016", "LLC020", "LST002", "LCA003", "LCB001" };
-    return c_EXTENDEDCOLORLIGHT_GAMUTC_TYPES;
+    std::size_t i = 0;
+    for (; i < type.size() && lower[i] != '\0'; ++i)
+    {
+        if (std::tolower(static_cast<unsigned char>(type[i])) != lower[i])
+        {
+            return false;
+        }
+    }
+    return i == type.size() && lower[i] == '\0';
 }
 
-const std::set<std::string>& getGamutATypes()
+const LightTypeEntry* findLightType(const std::string& type)
 {
-    static const std::set<std::string> c_EXTENDEDCOLORLIGHT_GAMUTA_TYPES
-        = {"LST001", "LLC005", "LLC006", "LLC007", "LLC010", "LLC011", "LLC012", "LLC013", "LLC014"};
-    return c_EXTENDEDCOLORLIGHT_GAMUTA_TYPES;
+    for (const LightTypeEntry& entry : c_lightTypes)
+    {
+        if (equalsLowerCase(type, entry.type))
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
 }
 } // namespace
 
@@ -71,56 +97,55 @@ LightFactory::LightFactory(const HueCommandAPI& commands, std::chrono::steady_cl
 
 Light LightFactory::createLight(const nlohmann::json& lightState, int id, const std::shared_ptr<APICache>& baseCache)
 {
-    std::string type = lightState.value("type", "");
-    // Ignore case
-    std::transform(type.begin(), type.end(), type.begin(), [](char c) { return std::tolower(c); });
+    auto typeJson = lightState.find("type");
+    const LightTypeEntry* type = typeJson != lightState.end() && typeJson->is_string()
+        ? findLightType(typeJson->get_ref<const std::string&>())
+        : nullptr;
+    if (!type)
+    {
+        std::cerr << "Could not determine Light type:" << lightState.value("type", "") << "!\n";
+        throw HueException(CURRENT_FILE_INFO, "Could not determine Light type!");
+    }
 
     Light light = baseCache ? Light(id, baseCache) : Light(id, commands, nullptr, nullptr, nullptr, refreshDuration, lightState);
 
-    if (type == "on/off light" || type == "on/off plug-in unit")
+    switch (type->kind)
     {
+    case LightKind::onOff:
         light.colorType = ColorType::NONE;
-        return light;
-    }
-    else if (type == "dimmable light" || type == "dimmable plug-in unit")
-    {
+        break;
+    case LightKind::dimmable:
         light.setBrightnessStrategy(simpleBrightness);
         light.colorType = ColorType::NONE;
-        return light;
-    }
-    else if (type == "color temperature light")
-    {
+        break;
+    case LightKind::colorTemperature:
         light.setBrightnessStrategy(simpleBrightness);
         light.setColorTemperatureStrategy(simpleColorTemperature);
         light.colorType = ColorType::TEMPERATURE;
-        return light;
-    }
-    else if (type == "color light")
-    {
+        break;
+    case LightKind::color:
         light.setBrightnessStrategy(simpleBrightness);
         light.setColorHueStrategy(simpleColorHue);
         light.colorType = getColorType(lightState, false);
-        return light;
-    }
-    else if (type == "extended color light")
-    {
+        break;
+    case LightKind::extendedColor:
         light.setBrightnessStrategy(simpleBrightness);
         light.setColorTemperatureStrategy(extendedColorTemperature);
         light.setColorHueStrategy(extendedColorHue);
         light.colorType = getColorType(lightState, true);
-        return light;
+        break;
     }
-    std::cerr << "Could not determine Light type:" << type << "!\n";
-    throw HueException(CURRENT_FILE_INFO, "Could not determine Light type!");
+    return light;
 }
 
 ColorType LightFactory::getColorType(const nlohmann::json& lightState, bool hasCt) const
 {
     // Try to get color type via capabilities
-    const nlohmann::json& gamuttype = utils::safeGetMember(lightState, "capabilities", "control", "colorgamuttype");
+    static const utils::MemberPath gamutTypePath {"capabilities", "control", "colorgamuttype"};
+    const nlohmann::json& gamuttype = gamutTypePath.get(lightState);
     if (gamuttype.is_string())
     {
-        const std::string gamut = gamuttype.get<std::string>();
+        const std::string& gamut = gamuttype.get_ref<const std::string&>();
         if (gamut == "A")
         {
             return hasCt ? ColorType::GAMUT_A_TEMPERATURE : ColorType::GAMUT_A;
@@ -142,16 +167,17 @@ ColorType LightFactory::getColorType(const nlohmann::json& lightState, bool hasC
     else
     {
         // Old version without capabilities, fall back to hardcoded types
-        std::string modelid = lightState.at("modelid").get<std::string>();
-        if (getGamutATypes().count(modelid))
+        const std::string& modelid = lightState.at("modelid").get_ref<const std::string&>();
+        const ModelInfo* info = ModelDatabase::instance().find(modelid);
+        if (info && info->gamut == ModelGamut::A)
         {
             return hasCt ? ColorType::GAMUT_A_TEMPERATURE : ColorType::GAMUT_A;
         }
-        else if (getGamutBTypes().count(modelid))
+        else if (info && info->gamut == ModelGamut::B)
         {
             return hasCt ? ColorType::GAMUT_B_TEMPERATURE : ColorType::GAMUT_B;
         }
-        else if (getGamutCTypes().count(modelid))
+        else if (info && info->gamut == ModelGamut::C)
         {
             return hasCt ? ColorType::GAMUT_C_TEMPERATURE : ColorType::GAMUT_C;
         }
@@ -0,0 +1,170 @@
+/**
+    \file HueStream.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/HueStream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "hueplusplus/HueExceptionMacro.h"
+
+namespace hueplusplus
+{
+namespace huestream
+{
+namespace
+{
+constexpr std::size_t versionOffset = 9;
+constexpr std::size_t colorSpaceOffset = 14;
+
+// Position of the entries and their channels, which depends on the version
+struct Layout
+{
+    std::size_t header;
+    std::size_t entry;
+    std::size_t channels; //!< offset of the channels in an entry
+};
+
+Layout getLayout(const std::vector<uint8_t>& message)
+{
+    if (message[versionOffset] == static_cast<uint8_t>(Version::v2))
+    {
+        return Layout {headerSizeV2, channelSize, 1};
+    }
+    return Layout {headerSize, lightSize, 3};
+}
+
+// Writes the header up to the color space, with sequence id and reserved bytes set to zero
+void writeHeader(std::vector<uint8_t>& message, Version version, ColorSpace colorSpace)
+{
+    std::memcpy(&message[0], "HueStream", 9);
+    message[versionOffset] = static_cast<uint8_t>(version); // Version Major
+    message[10] = 0x00; // Version Minor (0)
+    message[11] = 0x00; // Sequence ID
+    message[12] = 0x00; // Reserved
+    message[13] = 0x00; // Reserved
+    message[colorSpaceOffset] = static_cast<uint8_t>(colorSpace);
+    message[15] = 0x00; // Reserved
+}
+} // namespace
+
+std::vector<uint8_t> createMessage(const std::vector<int>& lightIds, ColorSpace colorSpace)
+{
+    std::vector<uint8_t> message(headerSize + lightIds.size() * lightSize);
+    writeHeader(message, Version::v1, colorSpace);
+
+    for (std::size_t i = 0; i < lightIds.size(); ++i)
+    {
+        const std::size_t offset = headerSize + i * lightSize;
+        message[offset + 0] = 0x00; // Type (Light)
+        message[offset + 1] = static_cast<uint8_t>(lightIds[i] >> 8); // ID MSB
+        message[offset + 2] = static_cast<uint8_t>(lightIds[i] & 0xFF); // ID LSB
+        // Channels are already zero
+    }
+    return message;
+}
+
+std::vector<uint8_t> createMessageV2(
+    const std::string& configurationId, const std::vector<uint8_t>& channelIds, ColorSpace colorSpace)
+{
+    if (configurationId.size() != configurationIdSize)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Entertainment configuration id must have 36 characters");
+    }
+    std::vector<uint8_t> message(headerSizeV2 + channelIds.size() * channelSize);
+    writeHeader(message, Version::v2, colorSpace);
+    std::memcpy(&message[headerSize], configurationId.data(), configurationIdSize);
+
+    for (std::size_t i = 0; i < channelIds.size(); ++i)
+    {
+        message[headerSizeV2 + i * channelSize] = channelIds[i]; // Channel ID
+        // Channels are already zero
+    }
+    return message;
+}
+
+Version getVersion(const std::vector<uint8_t>& message)
+{
+    return static_cast<Version>(message[versionOffset]);
+}
+
+std::size_t getLightCount(const std::vector<uint8_t>& message)
+{
+    const Layout layout = getLayout(message);
+    return (message.size() - layout.header) / layout.entry;
+}
+
+ColorSpace getColorSpace(const std::vector<uint8_t>& message)
+{
+    return static_cast<ColorSpace>(message[colorSpaceOffset]);
+}
+
+void setColorSpace(std::vector<uint8_t>& message, ColorSpace colorSpace)
+{
+    message[colorSpaceOffset] = static_cast<uint8_t>(colorSpace);
+}
+
+void setChannels(std::vector<uint8_t>& message, std::size_t index, uint16_t first, uint16_t second, uint16_t third)
+{
+    const Layout layout = getLayout(message);
+    uint8_t* channels = &message[layout.header + index * layout.entry + layout.channels];
+    channels[0] = static_cast<uint8_t>(first >> 8);
+    channels[1] = static_cast<uint8_t>(first & 0xFF);
+    channels[2] = static_cast<uint8_t>(second >> 8);
+    channels[3] = static_cast<uint8_t>(second & 0xFF);
+    channels[4] = static_cast<uint8_t>(third >> 8);
+    channels[5] = static_cast<uint8_t>(third & 0xFF);
+}
+
+void setChannels(std::vector<uint8_t>& message, std::size_t first, const uint16_t* channels, std::size_t count)
+{
+    const Layout layout = getLayout(message);
+    uint8_t* entry = message.data() + layout.header + first * layout.entry + layout.channels;
+    for (std::size_t i = 0; i < count; ++i, entry += layout.entry, channels += 3)
+    {
+        entry[0] = static_cast<uint8_t>(channels[0] >> 8);
+        entry[1] = static_cast<uint8_t>(channels[0] & 0xFF);
+        entry[2] = static_cast<uint8_t>(channels[1] >> 8);
+        entry[3] = static_cast<uint8_t>(channels[1] & 0xFF);
+        entry[4] = static_cast<uint8_t>(channels[2] >> 8);
+        entry[5] = static_cast<uint8_t>(channels[2] & 0xFF);
+    }
+}
+
+uint16_t getChannel(const std::vector<uint8_t>& message, std::size_t index, std::size_t channel)
+{
+    const Layout layout = getLayout(message);
+    const uint8_t* value = &message[layout.header + index * layout.entry + layout.channels + channel * 2];
+    return static_cast<uint16_t>((value[0] << 8) | value[1]);
+}
+
+uint16_t toChannel(float value)
+{
+    return static_cast<uint16_t>(std::lround(std::min(std::max(value, 0.f), 1.f) * 65535.f));
+}
+
+void setXYBrightness(std::vector<uint8_t>& message, std::size_t index, const XYBrightness& xy)
+{
+    setChannels(message, index, toChannel(xy.xy.x), toChannel(xy.xy.y), toChannel(xy.brightness));
+}
+} // namespace huestream
+} // namespace hueplusplus
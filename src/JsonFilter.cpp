@@ -0,0 +1,180 @@
+/**
+    \file JsonFilter.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/JsonFilter.h"
+
+#include <algorithm>
+
+namespace hueplusplus
+{
+JsonFilter::JsonFilter(const std::vector<std::string>& paths) : all(false)
+{
+    for (const std::string& path : paths)
+    {
+        std::vector<std::string> keys;
+        std::size_t start = 0;
+        while (start < path.size())
+        {
+            std::size_t end = path.find('/', start);
+            if (end == std::string::npos)
+            {
+                end = path.size();
+            }
+            keys.push_back(path.substr(start, end - start));
+            start = end + 1;
+        }
+        if (keys.empty())
+        {
+            all = true;
+        }
+        this->paths.push_back(std::move(keys));
+    }
+}
+
+bool JsonFilter::keepsAll() const
+{
+    return all;
+}
+
+bool JsonFilter::keeps(const std::vector<std::string>& path) const
+{
+    if (all)
+    {
+        return true;
+    }
+    for (const std::vector<std::string>& keys : paths)
+    {
+        // Either the member is below the path, or the path is below the member
+        const std::size_t length = std::min(keys.size(), path.size());
+        if (std::equal(keys.begin(), keys.begin() + length, path.begin(),
+                [](const std::string& key, const std::string& member) { return key == "*" || key == member; }))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+JsonFilter JsonFilter::getChild(const std::string& key) const
+{
+    JsonFilter child;
+    if (all)
+    {
+        return child;
+    }
+    child.all = false;
+    for (const std::vector<std::string>& keys : paths)
+    {
+        if (keys.front() == "*" || keys.front() == key)
+        {
+            if (keys.size() == 1)
+            {
+                // Whole member is kept
+                return JsonFilter();
+            }
+            child.paths.emplace_back(keys.begin() + 1, keys.end());
+        }
+    }
+    return child;
+}
+
+nlohmann::json JsonFilter::parse(const std::string& text) const
+{
+    return parseAs<nlohmann::json>(text);
+}
+
+ArenaJson JsonFilter::parseArena(const std::string& text) const
+{
+    return parseAs<ArenaJson>(text);
+}
+
+nlohmann::json JsonFilter::apply(nlohmann::json json) const
+{
+    if (!all && json.is_object())
+    {
+        std::vector<std::string> path;
+        applyMembers(json, path);
+    }
+    return json;
+}
+
+template <typename Json>
+Json JsonFilter::parseAs(const std::string& text) const
+{
+    if (all)
+    {
+        return Json::parse(text);
+    }
+    // The callback is not called at the end of dropped objects, so the path is truncated using the depth
+    std::vector<std::string> path;
+    bool topLevelArray = false;
+    return Json::parse(text, [&](int depth, typename Json::parse_event_t event, Json& parsed) {
+        switch (event)
+        {
+        case Json::parse_event_t::array_start:
+            topLevelArray = topLevelArray || depth == 0;
+            path.resize(depth);
+            // Array elements have no key
+            path.emplace_back();
+            return true;
+        case Json::parse_event_t::key:
+        {
+            const typename Json::string_t& key = parsed.template get_ref<const typename Json::string_t&>();
+            path.resize(depth - 1);
+            path.emplace_back(key.data(), key.size());
+            return topLevelArray || keeps(path);
+        }
+        default:
+            return true;
+        }
+    });
+}
+
+void JsonFilter::applyMembers(nlohmann::json& json, std::vector<std::string>& path) const
+{
+    if (json.is_object())
+    {
+        for (auto it = json.begin(); it != json.end();)
+        {
+            path.push_back(it.key());
+            if (keeps(path))
+            {
+                applyMembers(*it, path);
+                ++it;
+            }
+            else
+            {
+                it = json.erase(it);
+            }
+            path.pop_back();
+        }
+    }
+    else if (json.is_array())
+    {
+        path.emplace_back();
+        for (nlohmann::json& element : json)
+        {
+            applyMembers(element, path);
+        }
+        path.pop_back();
+    }
+}
+} // namespace hueplusplus
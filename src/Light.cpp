@@ -25,7 +25,9 @@
 #include <thread>
 
 #include "hueplusplus/HueExceptionMacro.h"
+#include "hueplusplus/LibConfig.h"
 #include "hueplusplus/Light.h"
+#include "hueplusplus/TimerScheduler.h"
 #include "hueplusplus/Utils.h"
 #include <nlohmann/json.hpp>
 
@@ -43,16 +45,89 @@ bool Light::off(uint8_t transition)
 
 bool Light::isOn()
 {
-    return state.getValue().at("state").at("on").get<bool>();
+    refreshDecodedState();
+    return static_cast<const Light&>(*this).isOn();
 }
 
 bool Light::isOn() const
 {
+    auto lock = state.lockShared();
+    if (stateDecoding)
+    {
+        return getDecodedState().on;
+    }
     return state.getValue().at("state").at("on").get<bool>();
 }
 
+DecodedLightState Light::getDecodedState()
+{
+    // Refresh if necessary, then decode from the current value
+    refreshDecodedState();
+    return static_cast<const Light&>(*this).getDecodedState();
+}
+
+DecodedLightState Light::getDecodedState() const
+{
+    auto lock = state.lockShared();
+    if (isDecodedStateCurrent())
+    {
+        return decodedState;
+    }
+    // Readers only hold the shared lock, so the cached state is not updated here
+    return DecodedLightState::parse(state.getValue().at("state"));
+}
+
+void Light::setStateDecoding(bool enabled)
+{
+    auto lock = state.lock();
+    stateDecoding = enabled;
+    // Force decoding on next access
+    decodedRefresh = std::chrono::steady_clock::time_point();
+}
+
+void Light::refreshDecodedState()
+{
+    state.getValue();
+    {
+        auto lock = state.lockShared();
+        if (!stateDecoding || isDecodedStateCurrent())
+        {
+            return;
+        }
+    }
+    auto lock = state.lock();
+    // Check again, another thread could have decoded it before locking
+    if (stateDecoding && !isDecodedStateCurrent())
+    {
+        decodedState = DecodedLightState::parse(state.getValue().at("state"));
+        decodedRefresh = state.getLastRefresh();
+    }
+}
+
+bool Light::isDecodedStateCurrent() const
+{
+    std::chrono::steady_clock::time_point lastRefresh = state.getLastRefresh();
+    return stateDecoding && lastRefresh == decodedRefresh && lastRefresh.time_since_epoch().count() != 0;
+}
+
+bool Light::isStateDecodingEnabled() const
+{
+    return stateDecoding;
+}
+
+void Light::setAsyncAlerts(bool enabled)
+{
+    asyncAlerts = enabled;
+}
+
+bool Light::isAsyncAlertsEnabled() const
+{
+    return asyncAlerts;
+}
+
 std::string Light::getLuminaireUId() const
 {
+    auto lock = state.lockShared();
     return state.getValue().value("luminaireuniqueid", std::string());
 }
 
@@ -63,6 +138,7 @@ ColorType Light::getColorType() const
 
 ColorGamut Light::getColorGamut() const
 {
+    auto lock = state.lockShared();
     switch (colorType)
     {
     case ColorType::GAMUT_A:
@@ -77,8 +153,8 @@ ColorGamut Light::getColorGamut() const
     case ColorType::UNDEFINED:
         return gamut::maxGamut;
     default: { // GAMUT_OTHER, GAMUT_OTHER_TEMPERATURE
-        const nlohmann::json& capabilitiesGamut
-            = utils::safeGetMember(state.getValue(), "capabilities", "control", "colorgamut");
+        static const utils::MemberPath gamutPath {"capabilities", "control", "colorgamut"};
+        const nlohmann::json& capabilitiesGamut = gamutPath.get(state.getValue());
         if (capabilitiesGamut.is_array() && capabilitiesGamut.size() == 3)
         {
             // Other gamut
@@ -97,17 +173,56 @@ bool Light::alert()
     return transaction().alert().commit();
 }
 
+bool Light::alertAndRestore(const std::function<void(StateTransaction&)>& restore)
+{
+    if (!asyncAlerts)
+    {
+        std::this_thread::sleep_for(Config::instance().getPreAlertDelay());
+        if (!alert())
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(Config::instance().getPostAlertDelay());
+        StateTransaction t = transaction();
+        restore(t);
+        return t.commit();
+    }
+    // Scheduled steps do not use the cached state, because the light could be used or destroyed in the meantime.
+    // Instead, the cached state which still contains the alert color is invalidated after restoring.
+    const HueCommandAPI commands = state.getCommandAPI();
+    const std::string path = "/lights/" + std::to_string(id) + "/state";
+    std::function<void(StateTransaction&)> restoreState = restore;
+    std::function<void()> invalidateState = state.getInvalidator();
+    TimerScheduler::instance().schedule(
+        Config::instance().getPreAlertDelay(), [commands, path, restoreState, invalidateState]() {
+            if (!StateTransaction(commands, path, nullptr).alert().commit(false))
+            {
+                return;
+            }
+            TimerScheduler::instance().schedule(
+                Config::instance().getPostAlertDelay(), [commands, path, restoreState, invalidateState]() {
+                    StateTransaction t(commands, path, nullptr);
+                    restoreState(t);
+                    t.commit(false);
+                    invalidateState();
+                });
+        });
+    return true;
+}
+
 StateTransaction Light::transaction()
 {
-    return StateTransaction(
-        state.getCommandAPI(), "/lights/" + std::to_string(id) + "/state", &state.getValue().at("state"));
+    // Refresh if necessary, the transaction looks up the state again when it is committed
+    state.getValue();
+    return StateTransaction(state, "/lights/" + std::to_string(id) + "/state", stateDecoding ? &decodedState : nullptr);
 }
 
 Light::Light(int id, const HueCommandAPI& commands)
     : Light(id, commands, nullptr, nullptr, nullptr, std::chrono::seconds(10), nullptr)
 { }
 
-Light::Light(int id, const std::shared_ptr<APICache>& baseCache) : BaseDevice(id, baseCache), colorType(ColorType::NONE)
+Light::Light(int id, const std::shared_ptr<APICache>& baseCache)
+    : BaseDevice(id, baseCache), colorType(ColorType::NONE), stateDecoding(false), decodedState(), asyncAlerts(false)
 { }
 
 Light::Light(int id, const HueCommandAPI& commands, std::shared_ptr<const BrightnessStrategy> brightnessStrategy,
@@ -116,6 +231,9 @@ Light::Light(int id, const HueCommandAPI& commands, std::shared_ptr<const Bright
     const nlohmann::json& currentState)
     : BaseDevice(id, commands, "/lights/", refreshDuration, currentState),
       colorType(ColorType::NONE),
+      stateDecoding(false),
+      decodedState(),
+      asyncAlerts(false),
       brightnessStrategy(std::move(brightnessStrategy)),
       colorTemperatureStrategy(std::move(colorTempStrategy)),
       colorHueStrategy(std::move(colorHueStrategy))
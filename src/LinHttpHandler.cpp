@@ -22,6 +22,7 @@
 
 #include "hueplusplus/LinHttpHandler.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <iostream>
@@ -36,6 +37,7 @@
 #include <stdlib.h> // exit
 #include <string.h> // functions for C style null-terminated strings
 #include <sys/socket.h> // socket, connect
+#include <sys/uio.h> // writev
 #include <unistd.h> // read, write, close
 
 namespace hueplusplus
@@ -50,7 +52,62 @@ private:
     int s;
 };
 
+namespace
+{
+// Writes all parts, multiple parts are written with a single system call
+void writeParts(int socketFD, const MessagePart* parts, std::size_t count)
+{
+    constexpr std::size_t maxBuffers = 16;
+    for (std::size_t batch = 0; batch < count; batch += maxBuffers)
+    {
+        iovec buffers[maxBuffers];
+        std::size_t remaining = std::min(maxBuffers, count - batch);
+        for (std::size_t i = 0; i < remaining; ++i)
+        {
+            buffers[i].iov_base = const_cast<char*>(parts[batch + i].data);
+            buffers[i].iov_len = parts[batch + i].size;
+        }
+        iovec* current = buffers;
+        while (remaining > 0)
+        {
+            ssize_t bytes = writev(socketFD, current, static_cast<int>(remaining));
+            if (bytes < 0)
+            {
+                int errCode = errno;
+                std::cerr << "LinHttpHandler: Failed to write message to socket: " << std::strerror(errCode) << "\n";
+                throw(std::system_error(
+                    errCode, std::generic_category(), "LinHttpHandler: Failed to write message to socket"));
+            }
+            else if (bytes == 0)
+            {
+                return;
+            }
+            // Skip written buffers and continue in the partially written one
+            std::size_t written = static_cast<std::size_t>(bytes);
+            while (remaining > 0 && written >= current->iov_len)
+            {
+                written -= current->iov_len;
+                ++current;
+                --remaining;
+            }
+            if (remaining > 0)
+            {
+                current->iov_base = static_cast<char*>(current->iov_base) + written;
+                current->iov_len -= written;
+            }
+        }
+    }
+}
+} // namespace
+
 std::string LinHttpHandler::send(const std::string& msg, const std::string& adr, int port) const
+{
+    const MessagePart part {msg.data(), msg.size()};
+    return sendParts(&part, 1, adr, port);
+}
+
+std::string LinHttpHandler::sendParts(
+    const MessagePart* parts, std::size_t count, const std::string& adr, int port) const
 {
     // create socket
     int socketFD = socket(AF_INET, SOCK_STREAM, 0);
@@ -90,27 +147,7 @@ std::string LinHttpHandler::send(const std::string& msg, const std::string& adr,
     }
 
     // send the request
-    size_t total = msg.length();
-    size_t sent = 0;
-    do
-    {
-        ssize_t bytes = write(socketFD, msg.c_str() + sent, total - sent);
-        if (bytes < 0)
-        {
-            int errCode = errno;
-            std::cerr << "LinHttpHandler: Failed to write message to socket: " << std::strerror(errCode) << "\n";
-            throw(std::system_error(
-                errCode, std::generic_category(), "LinHttpHandler: Failed to write message to socket"));
-        }
-        else if (bytes == 0)
-        {
-            break;
-        }
-        else
-        {
-            sent += bytes;
-        }
-    } while (sent < total);
+    writeParts(socketFD, parts, count);
 
     // receive the response
     std::string response;
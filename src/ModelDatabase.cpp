@@ -0,0 +1,203 @@
+/**
+    \file ModelDatabase.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/ModelDatabase.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "hueplusplus/Light.h"
+
+namespace hueplusplus
+{
+namespace
+{
+constexpr uint8_t c_colorFeatures = modelfeature::brightness | modelfeature::color;
+constexpr uint8_t c_ambianceFeatures = modelfeature::brightness | modelfeature::colorTemperature;
+constexpr uint8_t c_extendedColorFeatures
+    = modelfeature::brightness | modelfeature::colorTemperature | modelfeature::color;
+
+// Must be sorted by model id, checked below
+constexpr ModelInfo c_builtinModels[] = {
+    {"BSB001", "bridge_v1", ModelGamut::UNKNOWN, 0},
+    {"BSB002", "bridge_v2", ModelGamut::UNKNOWN, 0},
+    {"HBL001", "beyond_ceiling_pendant_table", ModelGamut::UNKNOWN, 0},
+    {"HBL002", "beyond_ceiling_pendant_table", ModelGamut::UNKNOWN, 0},
+    {"HBL003", "beyond_ceiling_pendant_table", ModelGamut::UNKNOWN, 0},
+    {"HEL001", "entity", ModelGamut::UNKNOWN, 0},
+    {"HEL002", "entity", ModelGamut::UNKNOWN, 0},
+    {"HIL001", "impulse", ModelGamut::UNKNOWN, 0},
+    {"HIL002", "impulse", ModelGamut::UNKNOWN, 0},
+    {"HML001", "phoenix_ceiling_pendant_table_wall", ModelGamut::UNKNOWN, 0},
+    {"HML002", "phoenix_ceiling_pendant_table_wall", ModelGamut::UNKNOWN, 0},
+    {"HML003", "phoenix_ceiling_pendant_table_wall", ModelGamut::UNKNOWN, 0},
+    {"HML004", "phoenix_ceiling_pendant_table_wall", ModelGamut::UNKNOWN, 0},
+    {"HML005", "phoenix_ceiling_pendant_table_wall", ModelGamut::UNKNOWN, 0},
+    {"HML006", "phoenix_down", ModelGamut::UNKNOWN, 0},
+    {"LCA003", "", ModelGamut::C, c_extendedColorFeatures},
+    {"LCB001", "", ModelGamut::C, c_extendedColorFeatures},
+    {"LCT001", "e27_waca", ModelGamut::B, c_extendedColorFeatures},
+    {"LCT002", "br30", ModelGamut::B, c_extendedColorFeatures},
+    {"LCT003", "gu10", ModelGamut::B, c_extendedColorFeatures},
+    {"LCT007", "e27_waca", ModelGamut::B, c_extendedColorFeatures},
+    {"LCT010", "e27_waca", ModelGamut::C, c_extendedColorFeatures},
+    {"LCT011", "br30_slim", ModelGamut::C, c_extendedColorFeatures},
+    {"LCT012", "e14", ModelGamut::C, c_extendedColorFeatures},
+    {"LCT014", "e27_waca", ModelGamut::C, c_extendedColorFeatures},
+    {"LCT015", "", ModelGamut::C, c_extendedColorFeatures},
+    {"LCT016", "", ModelGamut::C, c_extendedColorFeatures},
+    {"LDD001", "table", ModelGamut::UNKNOWN, 0},
+    {"LDD002", "floor", ModelGamut::UNKNOWN, 0},
+    {"LDF001", "ceiling", ModelGamut::UNKNOWN, 0},
+    {"LDF002", "ceiling", ModelGamut::UNKNOWN, 0},
+    {"LDT001", "recessed", ModelGamut::UNKNOWN, 0},
+    {"LFF001", "floor", ModelGamut::UNKNOWN, 0},
+    {"LLC005", "bloom", ModelGamut::A, c_colorFeatures},
+    {"LLC006", "iris", ModelGamut::A, c_colorFeatures},
+    {"LLC007", "bloom", ModelGamut::A, c_colorFeatures},
+    {"LLC010", "iris", ModelGamut::A, c_colorFeatures},
+    {"LLC011", "bloom", ModelGamut::A, c_colorFeatures},
+    {"LLC012", "bloom", ModelGamut::A, c_colorFeatures},
+    {"LLC013", "storylight", ModelGamut::A, c_colorFeatures},
+    {"LLC014", "aura", ModelGamut::A, c_colorFeatures},
+    {"LLC020", "go", ModelGamut::C, c_extendedColorFeatures},
+    {"LLM001", "", ModelGamut::B, c_extendedColorFeatures},
+    {"LST001", "lightstrip", ModelGamut::A, c_colorFeatures},
+    {"LST002", "lightstrip", ModelGamut::C, c_extendedColorFeatures},
+    {"LTC001", "ceiling", ModelGamut::UNKNOWN, 0},
+    {"LTC002", "ceiling", ModelGamut::UNKNOWN, 0},
+    {"LTC003", "ceiling", ModelGamut::UNKNOWN, 0},
+    {"LTC004", "ceiling", ModelGamut::UNKNOWN, 0},
+    {"LTD001", "ceiling", ModelGamut::UNKNOWN, 0},
+    {"LTD002", "ceiling", ModelGamut::UNKNOWN, 0},
+    {"LTD003", "pendant", ModelGamut::UNKNOWN, 0},
+    {"LTF001", "ceiling", ModelGamut::UNKNOWN, 0},
+    {"LTF002", "ceiling", ModelGamut::UNKNOWN, 0},
+    {"LTP001", "pendant", ModelGamut::UNKNOWN, 0},
+    {"LTP002", "pendant", ModelGamut::UNKNOWN, 0},
+    {"LTP003", "pendant", ModelGamut::UNKNOWN, 0},
+    {"LTP004", "pendant", ModelGamut::UNKNOWN, 0},
+    {"LTP005", "pendant", ModelGamut::UNKNOWN, 0},
+    {"LTT001", "table", ModelGamut::UNKNOWN, 0},
+    {"LTW001", "e27_waca", ModelGamut::UNKNOWN, c_ambianceFeatures},
+    {"LTW004", "e27_waca", ModelGamut::UNKNOWN, c_ambianceFeatures},
+    {"LTW010", "e27_waca", ModelGamut::UNKNOWN, c_ambianceFeatures},
+    {"LTW011", "br30_slim", ModelGamut::UNKNOWN, c_ambianceFeatures},
+    {"LTW012", "e14", ModelGamut::UNKNOWN, c_ambianceFeatures},
+    {"LTW013", "gu10_perfectfit", ModelGamut::UNKNOWN, c_ambianceFeatures},
+    {"LTW015", "e27_waca", ModelGamut::UNKNOWN, c_ambianceFeatures},
+    {"LWB004", "e27_waca", ModelGamut::UNKNOWN, modelfeature::brightness},
+    {"LWB006", "e27_waca", ModelGamut::UNKNOWN, modelfeature::brightness},
+    {"LWB010", "e27_white", ModelGamut::UNKNOWN, modelfeature::brightness},
+    {"LWB014", "e27_white", ModelGamut::UNKNOWN, modelfeature::brightness},
+    {"MWM001", "recessed", ModelGamut::UNKNOWN, 0},
+    {"RWL021", "hds", ModelGamut::UNKNOWN, 0},
+    {"SML001", "motion_sensor", ModelGamut::UNKNOWN, 0},
+    {"SWT001", "tap", ModelGamut::UNKNOWN, 0}};
+
+constexpr int compare(const char* lhs, const char* rhs)
+{
+    while (*lhs != '\0' && *lhs == *rhs)
+    {
+        ++lhs;
+        ++rhs;
+    }
+    return static_cast<unsigned char>(*lhs) - static_cast<unsigned char>(*rhs);
+}
+
+template <std::size_t N>
+constexpr bool isSorted(const ModelInfo (&models)[N])
+{
+    for (std::size_t i = 1; i < N; ++i)
+    {
+        if (compare(models[i - 1].modelId, models[i].modelId) >= 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(isSorted(c_builtinModels), "Built in models must be sorted by unique model id");
+} // namespace
+
+ColorType ModelInfo::getColorType() const
+{
+    const bool hasCt = hasFeatures(modelfeature::colorTemperature);
+    switch (gamut)
+    {
+    case ModelGamut::A:
+        return hasCt ? ColorType::GAMUT_A_TEMPERATURE : ColorType::GAMUT_A;
+    case ModelGamut::B:
+        return hasCt ? ColorType::GAMUT_B_TEMPERATURE : ColorType::GAMUT_B;
+    case ModelGamut::C:
+        return hasCt ? ColorType::GAMUT_C_TEMPERATURE : ColorType::GAMUT_C;
+    default:
+        return ColorType::UNDEFINED;
+    }
+}
+
+const ModelInfo* ModelDatabase::find(const std::string& modelId) const
+{
+    for (const AddedModel& model : added)
+    {
+        if (model.modelId == modelId)
+        {
+            return &model.info;
+        }
+    }
+    auto pos = std::lower_bound(std::begin(c_builtinModels), std::end(c_builtinModels), modelId.c_str(),
+        [](const ModelInfo& info, const char* id) { return std::strcmp(info.modelId, id) < 0; });
+    if (pos != std::end(c_builtinModels) && modelId == pos->modelId)
+    {
+        return pos;
+    }
+    return nullptr;
+}
+
+void ModelDatabase::add(const std::string& modelId, const std::string& picture, ModelGamut gamut, uint8_t features)
+{
+    auto pos = std::find_if(
+        added.begin(), added.end(), [&](const AddedModel& model) { return model.modelId == modelId; });
+    if (pos == added.end())
+    {
+        added.push_back(AddedModel {modelId, picture, {}});
+        pos = std::prev(added.end());
+    }
+    else
+    {
+        pos->picture = picture;
+    }
+    pos->info = ModelInfo {pos->modelId.c_str(), pos->picture.c_str(), gamut, features};
+}
+
+void ModelDatabase::clearAdded()
+{
+    added.clear();
+}
+
+ModelDatabase& ModelDatabase::instance()
+{
+    static ModelDatabase database;
+    return database;
+}
+} // namespace hueplusplus
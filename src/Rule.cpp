@@ -157,6 +157,11 @@ void Rule::setRefreshDuration(std::chrono::steady_clock::duration refreshDuratio
     state.setRefreshDuration(refreshDuration);
 }
 
+void Rule::updateState(const nlohmann::json& listState, std::chrono::steady_clock::time_point refreshTime)
+{
+    state.updateValue(listState, refreshTime);
+}
+
 int Rule::getId() const
 {
     return id;
@@ -164,6 +169,7 @@ int Rule::getId() const
 
 std::string Rule::getName() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("name").get<std::string>();
 }
 
@@ -176,11 +182,13 @@ void Rule::setName(const std::string& name)
 
 time::AbsoluteTime Rule::getCreated() const
 {
+    auto lock = state.lockShared();
     return time::AbsoluteTime::parseUTC(state.getValue().at("created").get<std::string>());
 }
 
 time::AbsoluteTime Rule::getLastTriggered() const
 {
+    auto lock = state.lockShared();
     const std::string lasttriggered = state.getValue().value("lasttriggered", "none");
     if (lasttriggered.empty() || lasttriggered == "none")
     {
@@ -191,11 +199,13 @@ time::AbsoluteTime Rule::getLastTriggered() const
 
 int Rule::getTimesTriggered() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("timestriggered").get<int>();
 }
 
 bool Rule::isEnabled() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("status").get<std::string>() == "enabled";
 }
 
@@ -207,11 +217,13 @@ void Rule::setEnabled(bool enabled)
 
 std::string Rule::getOwner() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("owner").get<std::string>();
 }
 
 std::vector<Condition> Rule::getConditions() const
 {
+    auto lock = state.lockShared();
     std::vector<Condition> result;
     const nlohmann::json& conditions = state.getValue().at("conditions");
     for (const nlohmann::json& c : conditions)
@@ -223,6 +235,7 @@ std::vector<Condition> Rule::getConditions() const
 
 std::vector<Action> Rule::getActions() const
 {
+    auto lock = state.lockShared();
     std::vector<Action> result;
     const nlohmann::json& actions = state.getValue().at("actions");
     for (const nlohmann::json& a : actions)
@@ -178,6 +178,11 @@ void Scene::setRefreshDuration(std::chrono::steady_clock::duration refreshDurati
     state.setRefreshDuration(refreshDuration);
 }
 
+void Scene::updateState(const nlohmann::json& listState, std::chrono::steady_clock::time_point refreshTime)
+{
+    state.updateValue(listState, refreshTime);
+}
+
 std::string Scene::getId() const
 {
     return id;
@@ -185,6 +190,7 @@ std::string Scene::getId() const
 
 std::string Scene::getName() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("name").get<std::string>();
 }
 
@@ -196,6 +202,7 @@ void Scene::setName(const std::string& name)
 
 Scene::Type Scene::getType() const
 {
+    auto lock = state.lockShared();
     std::string type = state.getValue().value("type", "LightScene");
     if (type == "LightScene")
     {
@@ -210,11 +217,13 @@ Scene::Type Scene::getType() const
 
 int Scene::getGroupId() const
 {
+    auto lock = state.lockShared();
     return std::stoi(state.getValue().value("group", "0"));
 }
 
 std::vector<int> Scene::getLightIds() const
 {
+    auto lock = state.lockShared();
     std::vector<int> result;
     for (const nlohmann::json& id : state.getValue().at("lights"))
     {
@@ -236,26 +245,31 @@ void Scene::setLightIds(const std::vector<int>& ids)
 
 std::string Scene::getOwner() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("owner").get<std::string>();
 }
 
 bool Scene::getRecycle() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("recycle").get<bool>();
 }
 
 bool Scene::isLocked() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("locked").get<bool>();
 }
 
 std::string Scene::getAppdata() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("appdata").at("data").get<std::string>();
 }
 
 int Scene::getAppdataVersion() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("appdata").at("version").get<int>();
 }
 
@@ -267,21 +281,25 @@ void Scene::setAppdata(const std::string& data, int version)
 
 std::string Scene::getPicture() const
 {
+    auto lock = state.lockShared();
     return state.getValue().value("picture", "");
 }
 
 time::AbsoluteTime Scene::getLastUpdated() const
 {
+    auto lock = state.lockShared();
     return time::AbsoluteTime::parseUTC(state.getValue().at("lastupdated").get<std::string>());
 }
 
 int Scene::getVersion() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("version").get<int>();
 }
 
 std::map<int, LightState> Scene::getLightStates() const
 {
+    auto lock = state.lockShared();
     if (state.getValue().count("lightstates") == 0)
     {
         return {};
@@ -44,6 +44,11 @@ void Schedule::setRefreshDuration(std::chrono::steady_clock::duration refreshDur
     state.setRefreshDuration(refreshDuration);
 }
 
+void Schedule::updateState(const nlohmann::json& listState, std::chrono::steady_clock::time_point refreshTime)
+{
+    state.updateValue(listState, refreshTime);
+}
+
 int Schedule::getId() const
 {
     return id;
@@ -51,21 +56,25 @@ int Schedule::getId() const
 
 std::string Schedule::getName() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("name").get<std::string>();
 }
 
 std::string Schedule::getDescription() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("description").get<std::string>();
 }
 
 Action Schedule::getCommand() const
 {
+    auto lock = state.lockShared();
     return Action(state.getValue().at("command"));
 }
 
 time::TimePattern Schedule::getTime() const
 {
+    auto lock = state.lockShared();
     return time::TimePattern::parse(state.getValue().at("localtime").get<std::string>());
     // time requires UTC parsing, which is not yet supported
     // return time::TimePattern::parse(state.getValue().at("time").get<std::string>());
@@ -73,6 +82,7 @@ time::TimePattern Schedule::getTime() const
 
 bool Schedule::isEnabled() const
 {
+    auto lock = state.lockShared();
     if (state.getValue().at("status").get<std::string>() == "enabled")
     {
         return true;
@@ -82,16 +92,19 @@ bool Schedule::isEnabled() const
 
 bool Schedule::getAutodelete() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("autodelete").get<bool>();
 }
 
 time::AbsoluteTime Schedule::getCreated() const
 {
+    auto lock = state.lockShared();
     return time::AbsoluteTime::parse(state.getValue().at("created").get<std::string>());
 }
 
 time::AbsoluteTime Schedule::getStartTime() const
 {
+    auto lock = state.lockShared();
     return time::AbsoluteTime::parse(state.getValue().at("starttime").get<std::string>());
 }
 
@@ -59,11 +59,13 @@ Alert alertFromString(const std::string& s)
 
 bool Sensor::hasOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("on") != 0;
 }
 
 bool Sensor::isOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("on").get<bool>();
 }
 
@@ -74,10 +76,12 @@ void Sensor::setOn(bool on)
 
 bool Sensor::hasBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("battery") != 0;
 }
 int Sensor::getBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("battery").get<int>();
 }
 void Sensor::setBatteryState(int percent)
@@ -86,10 +90,12 @@ void Sensor::setBatteryState(int percent)
 }
 bool Sensor::hasAlert() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("alert") != 0;
 }
 Alert Sensor::getLastAlert() const
 {
+    auto lock = state.lockShared();
     std::string alert = state.getValue().at("config").at("alert").get<std::string>();
     if (alert == "select")
     {
@@ -123,16 +129,19 @@ void Sensor::sendAlert(Alert type)
 }
 bool Sensor::hasReachable() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("reachable") != 0;
 }
 bool Sensor::isReachable() const
 {
+    auto lock = state.lockShared();
     // If not present, always assume it is reachable (for daylight sensor)
     return state.getValue().at("config").value("reachable", true);
 }
 
 time::AbsoluteTime Sensor::getLastUpdated() const
 {
+    auto lock = state.lockShared();
     const nlohmann::json& stateJson = state.getValue().at("state");
     auto it = stateJson.find("lastupdated");
     if (it == stateJson.end() || !it->is_string() || *it == "none")
@@ -144,6 +153,7 @@ time::AbsoluteTime Sensor::getLastUpdated() const
 
 bool Sensor::hasUserTest() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("usertest") != 0;
 }
 void Sensor::setUserTest(bool enabled)
@@ -153,10 +163,12 @@ void Sensor::setUserTest(bool enabled)
 
 bool Sensor::hasURL() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("url") != 0;
 }
 std::string Sensor::getURL() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("url").get<std::string>();
 }
 void Sensor::setURL(const std::string& url)
@@ -166,6 +178,7 @@ void Sensor::setURL(const std::string& url)
 
 std::vector<std::string> Sensor::getPendingConfig() const
 {
+    auto lock = state.lockShared();
     const nlohmann::json& config = state.getValue().at("config");
     const auto pendingIt = config.find("pending");
     if (pendingIt == config.end() || !pendingIt->is_array())
@@ -183,10 +196,12 @@ std::vector<std::string> Sensor::getPendingConfig() const
 
 bool Sensor::hasLEDIndication() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("ledindication") != 0;
 }
 bool Sensor::getLEDIndication() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("ledindication").get<bool>();
 }
 void Sensor::setLEDIndication(bool on)
@@ -196,6 +211,7 @@ void Sensor::setLEDIndication(bool on)
 
 nlohmann::json Sensor::getState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state");
 }
 void Sensor::setStateAttribute(const std::string& key, const nlohmann::json& value)
@@ -210,6 +226,7 @@ std::string Sensor::getStateAddress(const std::string& key) const
 
 nlohmann::json Sensor::getConfig() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config");
 }
 
@@ -220,13 +237,15 @@ void Sensor::setConfigAttribute(const std::string& key, const nlohmann::json& va
 
 bool Sensor::isCertified() const
 {
-    nlohmann::json certified = utils::safeGetMember(state.getValue(), "capabilities", "certified");
+    auto lock = state.lockShared();
+    const nlohmann::json& certified = utils::safeGetMemberRef(state.getValue(), "capabilities", "certified");
     return certified.is_boolean() && certified.get<bool>();
 }
 
 bool Sensor::isPrimary() const
 {
-    nlohmann::json primary = utils::safeGetMember(state.getValue(), "capabilities", "primary");
+    auto lock = state.lockShared();
+    const nlohmann::json& primary = utils::safeGetMemberRef(state.getValue(), "capabilities", "primary");
     return primary.is_boolean() && primary.get<bool>();
 }
 
@@ -275,6 +294,7 @@ constexpr const char* DaylightSensor::typeStr;
 
 bool DaylightSensor::isOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("on").get<bool>();
 }
 
@@ -285,10 +305,12 @@ void DaylightSensor::setOn(bool on)
 
 bool DaylightSensor::hasBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("battery") != 0;
 }
 int DaylightSensor::getBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("battery").get<int>();
 }
 void DaylightSensor::setBatteryState(int percent)
@@ -312,10 +334,12 @@ void DaylightSensor::setCoordinates(const std::string& latitude, const std::stri
 }
 bool DaylightSensor::isConfigured() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("configured").get<bool>();
 }
 int DaylightSensor::getSunriseOffset() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("sunriseoffset").get<int>();
 }
 void DaylightSensor::setSunriseOffset(int minutes)
@@ -325,6 +349,7 @@ void DaylightSensor::setSunriseOffset(int minutes)
 
 int DaylightSensor::getSunsetOffset() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("sunsetoffset").get<int>();
 }
 void DaylightSensor::setSunsetOffset(int minutes)
@@ -334,11 +359,13 @@ void DaylightSensor::setSunsetOffset(int minutes)
 
 bool DaylightSensor::isDaylight() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("daylight").get<bool>();
 }
 
 time::AbsoluteTime DaylightSensor::getLastUpdated() const
 {
+    auto lock = state.lockShared();
     const nlohmann::json& stateJson = state.getValue().at("state");
     auto it = stateJson.find("lastupdated");
     if (it == stateJson.end() || !it->is_string() || *it == "none")
@@ -39,11 +39,17 @@ bool SimpleBrightnessStrategy::setBrightness(unsigned int bri, uint8_t transitio
 
 unsigned int SimpleBrightnessStrategy::getBrightness(Light& light) const
 {
-    return light.state.getValue()["state"]["bri"].get<unsigned int>();
+    light.refreshDecodedState();
+    return getBrightness(static_cast<const Light&>(light));
 }
 
 unsigned int SimpleBrightnessStrategy::getBrightness(const Light& light) const
 {
+    auto lock = light.state.lockShared();
+    if (light.isStateDecodingEnabled())
+    {
+        return light.getDecodedState().bri;
+    }
     return light.state.getValue()["state"]["bri"].get<unsigned int>();
 }
 } // namespace hueplusplus
@@ -60,10 +60,16 @@ bool SimpleColorHueStrategy::setColorLoop(bool on, Light& light) const
 
 bool SimpleColorHueStrategy::alertHueSaturation(const HueSaturation& hueSat, Light& light) const
 {
-    // Careful, only use state until any light function might refresh the value and invalidate the reference
-    const nlohmann::json& state = light.state.getValue()["state"];
-    std::string cType = state["colormode"].get<std::string>();
-    bool on = state["on"].get<bool>();
+    std::string cType;
+    bool on = false;
+    {
+        // Refresh before locking and only hold the lock while reading, the light functions below send requests
+        light.state.getValue();
+        auto lock = light.state.lockShared();
+        const nlohmann::json& state = static_cast<const APICache&>(light.state).getValue().at("state");
+        cType = state["colormode"].get<std::string>();
+        on = state["on"].get<bool>();
+    }
     const Light& cLight = light;
     if (cType == "hs")
     {
@@ -72,13 +78,7 @@ bool SimpleColorHueStrategy::alertHueSaturation(const HueSaturation& hueSat, Lig
         {
             return false;
         }
-        std::this_thread::sleep_for(Config::instance().getPreAlertDelay());
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(Config::instance().getPostAlertDelay());
-        return light.transaction().setColor(oldHueSat).setOn(on).setTransition(1).commit();
+        return light.alertAndRestore([=](StateTransaction& t) { t.setColor(oldHueSat).setOn(on).setTransition(1); });
     }
     else if (cType == "xy")
     {
@@ -87,13 +87,7 @@ bool SimpleColorHueStrategy::alertHueSaturation(const HueSaturation& hueSat, Lig
         {
             return false;
         }
-        std::this_thread::sleep_for(Config::instance().getPreAlertDelay());
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(Config::instance().getPostAlertDelay());
-        return light.transaction().setColor(oldXY).setOn(on).setTransition(1).commit();
+        return light.alertAndRestore([=](StateTransaction& t) { t.setColor(oldXY).setOn(on).setTransition(1); });
     }
     else
     {
@@ -103,10 +97,16 @@ bool SimpleColorHueStrategy::alertHueSaturation(const HueSaturation& hueSat, Lig
 
 bool SimpleColorHueStrategy::alertXY(const XYBrightness& xy, Light& light) const
 {
-    // Careful, only use state until any light function might refresh the value and invalidate the reference
-    const nlohmann::json& state = light.state.getValue()["state"];
-    std::string cType = state["colormode"].get<std::string>();
-    bool on = state["on"].get<bool>();
+    std::string cType;
+    bool on = false;
+    {
+        // Refresh before locking and only hold the lock while reading, the light functions below send requests
+        light.state.getValue();
+        auto lock = light.state.lockShared();
+        const nlohmann::json& state = static_cast<const APICache&>(light.state).getValue().at("state");
+        cType = state["colormode"].get<std::string>();
+        on = state["on"].get<bool>();
+    }
     // const reference to prevent refreshes
     const Light& cLight = light;
     if (cType == "hs")
@@ -117,13 +117,9 @@ bool SimpleColorHueStrategy::alertXY(const XYBrightness& xy, Light& light) const
         {
             return false;
         }
-        std::this_thread::sleep_for(Config::instance().getPreAlertDelay());
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(Config::instance().getPostAlertDelay());
-        return light.transaction().setColor(oldHueSat).setBrightness(oldBrightness).setOn(on).setTransition(1).commit();
+        return light.alertAndRestore([=](StateTransaction& t) {
+            t.setColor(oldHueSat).setBrightness(oldBrightness).setOn(on).setTransition(1);
+        });
     }
     else if (cType == "xy")
     {
@@ -132,13 +128,7 @@ bool SimpleColorHueStrategy::alertXY(const XYBrightness& xy, Light& light) const
         {
             return false;
         }
-        std::this_thread::sleep_for(Config::instance().getPreAlertDelay());
-        if (!light.alert())
-        {
-            return false;
-        }
-        std::this_thread::sleep_for(Config::instance().getPostAlertDelay());
-        return light.transaction().setColor(oldXY).setOn(on).setTransition(1).commit();
+        return light.alertAndRestore([=](StateTransaction& t) { t.setColor(oldXY).setOn(on).setTransition(1); });
     }
     else
     {
@@ -148,26 +138,36 @@ bool SimpleColorHueStrategy::alertXY(const XYBrightness& xy, Light& light) const
 
 HueSaturation SimpleColorHueStrategy::getColorHueSaturation(Light& light) const
 {
-    // Save value, so there are no inconsistent results if it is refreshed between two calls
-    const nlohmann::json& state = light.state.getValue()["state"];
-    return HueSaturation {state["hue"].get<int>(), state["sat"].get<int>()};
+    light.refreshDecodedState();
+    return getColorHueSaturation(static_cast<const Light&>(light));
 }
 
 HueSaturation SimpleColorHueStrategy::getColorHueSaturation(const Light& light) const
 {
+    auto lock = light.state.lockShared();
+    if (light.isStateDecodingEnabled())
+    {
+        const DecodedLightState& decoded = light.getDecodedState();
+        return HueSaturation {decoded.hue, decoded.sat};
+    }
     return HueSaturation {
         light.state.getValue()["state"]["hue"].get<int>(), light.state.getValue()["state"]["sat"].get<int>()};
 }
 
 XYBrightness SimpleColorHueStrategy::getColorXY(Light& light) const
 {
-    // Save value, so there are no inconsistent results if it is refreshed between two calls
-    const nlohmann::json& state = light.state.getValue()["state"];
-    return XYBrightness {{state["xy"][0].get<float>(), state["xy"][1].get<float>()}, state["bri"].get<int>() / 254.f};
+    light.refreshDecodedState();
+    return getColorXY(static_cast<const Light&>(light));
 }
 
 XYBrightness SimpleColorHueStrategy::getColorXY(const Light& light) const
 {
+    auto lock = light.state.lockShared();
+    if (light.isStateDecodingEnabled())
+    {
+        const DecodedLightState& decoded = light.getDecodedState();
+        return XYBrightness {decoded.xy, decoded.bri / 254.f};
+    }
     const nlohmann::json& state = light.state.getValue()["state"];
     return XYBrightness {{state["xy"][0].get<float>(), state["xy"][1].get<float>()}, state["bri"].get<int>() / 254.f};
 }
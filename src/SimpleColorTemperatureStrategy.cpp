@@ -39,24 +39,29 @@ bool SimpleColorTemperatureStrategy::setColorTemperature(unsigned int mired, uin
 
 bool SimpleColorTemperatureStrategy::alertTemperature(unsigned int mired, Light& light) const
 {
-    // Careful, only use state until any light function might refresh the value and invalidate the reference
-    const nlohmann::json& state = light.state.getValue()["state"];
-    std::string cType = state["colormode"].get<std::string>();
-    bool on = state["on"].get<bool>();
-    if (cType == "ct")
+    std::string cType;
+    bool on = false;
+    uint16_t oldCT = 0;
     {
-        uint16_t oldCT = state["ct"].get<uint16_t>();
-        if (!light.setColorTemperature(mired, 1))
+        // Refresh before locking and only hold the lock while reading, the light functions below send requests
+        light.state.getValue();
+        auto lock = light.state.lockShared();
+        const nlohmann::json& state = static_cast<const APICache&>(light.state).getValue().at("state");
+        cType = state["colormode"].get<std::string>();
+        on = state["on"].get<bool>();
+        if (cType == "ct")
         {
-            return false;
+            oldCT = state["ct"].get<uint16_t>();
         }
-        std::this_thread::sleep_for(Config::instance().getPreAlertDelay());
-        if (!light.alert())
+    }
+    if (cType == "ct")
+    {
+        if (!light.setColorTemperature(mired, 1))
         {
             return false;
         }
-        std::this_thread::sleep_for(Config::instance().getPostAlertDelay());
-        return light.transaction().setColorTemperature(oldCT).setOn(on).setTransition(1).commit();
+        return light.alertAndRestore(
+            [=](StateTransaction& t) { t.setColorTemperature(oldCT).setOn(on).setTransition(1); });
     }
     else
     {
@@ -66,11 +71,17 @@ bool SimpleColorTemperatureStrategy::alertTemperature(unsigned int mired, Light&
 
 unsigned int SimpleColorTemperatureStrategy::getColorTemperature(Light& light) const
 {
-    return light.state.getValue()["state"]["ct"].get<unsigned int>();
+    light.refreshDecodedState();
+    return getColorTemperature(static_cast<const Light&>(light));
 }
 
 unsigned int SimpleColorTemperatureStrategy::getColorTemperature(const Light& light) const
 {
+    auto lock = light.state.lockShared();
+    if (light.isStateDecodingEnabled())
+    {
+        return light.getDecodedState().ct;
+    }
     return light.state.getValue()["state"]["ct"].get<unsigned int>();
 }
 } // namespace hueplusplus
@@ -0,0 +1,268 @@
+/**
+    \file SpatialMapping.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/SpatialMapping.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "hueplusplus/HueExceptionMacro.h"
+#include "hueplusplus/HueStream.h"
+#include "hueplusplus/Simd.h"
+
+namespace hueplusplus
+{
+namespace
+{
+// Number of lights which are interpolated at once
+constexpr std::size_t blockSize = 4;
+
+// Neighboring cells of a coordinate along one axis and the weight of the upper one
+struct AxisSample
+{
+    std::size_t low;
+    std::size_t high;
+    float fraction;
+};
+
+AxisSample sampleAxis(float coordinate, std::size_t size)
+{
+    // Cell centers are at (i + 0.5) / size * 2 - 1
+    const float clamped = std::min(std::max(coordinate, -1.f), 1.f);
+    const float position = std::min(std::max((clamped + 1.f) * 0.5f * size - 0.5f, 0.f), static_cast<float>(size - 1));
+    const std::size_t low = static_cast<std::size_t>(position);
+    return AxisSample {low, std::min(low + 1, size - 1), position - low};
+}
+
+uint8_t to8Bit(float value)
+{
+    return static_cast<uint8_t>(std::lround(std::min(std::max(value, 0.f), 1.f) * 255.f));
+}
+} // namespace
+
+ColorGrid::ColorGrid(std::size_t width, std::size_t height, std::size_t depth)
+    : width(width), height(height), depth(depth), channels(3 * width * height * depth, 0.f)
+{
+    if (width == 0 || height == 0 || depth == 0)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Grid size must not be zero");
+    }
+}
+
+std::size_t ColorGrid::getWidth() const
+{
+    return width;
+}
+
+std::size_t ColorGrid::getHeight() const
+{
+    return height;
+}
+
+std::size_t ColorGrid::getDepth() const
+{
+    return depth;
+}
+
+void ColorGrid::setColor(std::size_t x, std::size_t y, std::size_t z, float red, float green, float blue)
+{
+    const std::size_t index = getIndex(x, y, z);
+    getChannel(0)[index] = red;
+    getChannel(1)[index] = green;
+    getChannel(2)[index] = blue;
+}
+
+void ColorGrid::setColor(std::size_t x, std::size_t y, std::size_t z, const RGB& color)
+{
+    setColor(x, y, z, color.r / 255.f, color.g / 255.f, color.b / 255.f);
+}
+
+void ColorGrid::fill(const RGB& color)
+{
+    std::fill(getChannel(0), getChannel(1), color.r / 255.f);
+    std::fill(getChannel(1), getChannel(2), color.g / 255.f);
+    std::fill(getChannel(2), getChannel(2) + width * height * depth, color.b / 255.f);
+}
+
+float* ColorGrid::getChannel(std::size_t channel)
+{
+    return channels.data() + channel * width * height * depth;
+}
+
+const float* ColorGrid::getChannel(std::size_t channel) const
+{
+    return channels.data() + channel * width * height * depth;
+}
+
+SpatialMapping::SpatialMapping(
+    const std::vector<LightLocation>& locations, std::size_t width, std::size_t height, std::size_t depth)
+    : width(width),
+      height(height),
+      depth(depth),
+      lightCount(locations.size()),
+      corners(depth > 1 ? 8 : (height > 1 ? 4 : 2)),
+      stride(locations.size() + blockSize - 1),
+      // Unused lights read the first cell with weight zero
+      indices(corners * stride, 0),
+      weights(corners * stride, 0.f)
+{
+    if (width == 0 || height == 0 || depth == 0)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Grid size must not be zero");
+    }
+    for (std::size_t light = 0; light < lightCount; ++light)
+    {
+        const AxisSample x = sampleAxis(locations[light].x, width);
+        const AxisSample y = sampleAxis(locations[light].y, height);
+        const AxisSample z = sampleAxis(locations[light].z, depth);
+        for (std::size_t corner = 0; corner < corners; ++corner)
+        {
+            const bool upperX = (corner & 1) != 0;
+            const bool upperY = (corner & 2) != 0;
+            const bool upperZ = (corner & 4) != 0;
+            indices[corner * stride + light] = static_cast<uint32_t>(
+                ((upperZ ? z.high : z.low) * height + (upperY ? y.high : y.low)) * width + (upperX ? x.high : x.low));
+            weights[corner * stride + light] = (upperX ? x.fraction : 1.f - x.fraction)
+                * (upperY ? y.fraction : 1.f - y.fraction) * (upperZ ? z.fraction : 1.f - z.fraction);
+        }
+    }
+}
+
+std::size_t SpatialMapping::getLightCount() const
+{
+    return lightCount;
+}
+
+void SpatialMapping::sample(const ColorGrid& grid, std::size_t first, std::size_t count, uint16_t* channels) const
+{
+    checkArguments(grid, first, count);
+    for (std::size_t start = 0; start < count; start += blockSize)
+    {
+        const std::size_t size = std::min(blockSize, count - start);
+        float red[blockSize];
+        float green[blockSize];
+        float blue[blockSize];
+        interpolate(grid, first + start, red, green, blue);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            uint16_t* light = channels + (start + i) * 3;
+            light[0] = huestream::toChannel(red[i]);
+            light[1] = huestream::toChannel(green[i]);
+            light[2] = huestream::toChannel(blue[i]);
+        }
+    }
+}
+
+void SpatialMapping::sample(const ColorGrid& grid, std::size_t first, std::size_t count, RGB* colors) const
+{
+    checkArguments(grid, first, count);
+    for (std::size_t start = 0; start < count; start += blockSize)
+    {
+        const std::size_t size = std::min(blockSize, count - start);
+        float red[blockSize];
+        float green[blockSize];
+        float blue[blockSize];
+        interpolate(grid, first + start, red, green, blue);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            colors[start + i] = RGB {to8Bit(red[i]), to8Bit(green[i]), to8Bit(blue[i])};
+        }
+    }
+}
+
+void SpatialMapping::checkArguments(const ColorGrid& grid, std::size_t first, std::size_t count) const
+{
+    if (grid.getWidth() != width || grid.getHeight() != height || grid.getDepth() != depth)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Grid size does not match the mapping");
+    }
+    if (first > lightCount || count > lightCount - first)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Light range is out of bounds");
+    }
+}
+
+void SpatialMapping::interpolate(const ColorGrid& grid, std::size_t light, float* red, float* green, float* blue) const
+{
+    const float* gridRed = grid.getChannel(0);
+    const float* gridGreen = grid.getChannel(1);
+    const float* gridBlue = grid.getChannel(2);
+#if defined(HUEPLUSPLUS_SSE2)
+    __m128 r = _mm_setzero_ps();
+    __m128 g = _mm_setzero_ps();
+    __m128 b = _mm_setzero_ps();
+    for (std::size_t corner = 0; corner < corners; ++corner)
+    {
+        const uint32_t* index = &indices[corner * stride + light];
+        const __m128 weight = _mm_loadu_ps(&weights[corner * stride + light]);
+        r = _mm_add_ps(r,
+            _mm_mul_ps(
+                weight, _mm_setr_ps(gridRed[index[0]], gridRed[index[1]], gridRed[index[2]], gridRed[index[3]])));
+        g = _mm_add_ps(g,
+            _mm_mul_ps(weight,
+                _mm_setr_ps(gridGreen[index[0]], gridGreen[index[1]], gridGreen[index[2]], gridGreen[index[3]])));
+        b = _mm_add_ps(b,
+            _mm_mul_ps(weight,
+                _mm_setr_ps(gridBlue[index[0]], gridBlue[index[1]], gridBlue[index[2]], gridBlue[index[3]])));
+    }
+    _mm_storeu_ps(red, r);
+    _mm_storeu_ps(green, g);
+    _mm_storeu_ps(blue, b);
+#elif defined(HUEPLUSPLUS_NEON)
+    float32x4_t r = vdupq_n_f32(0.f);
+    float32x4_t g = vdupq_n_f32(0.f);
+    float32x4_t b = vdupq_n_f32(0.f);
+    for (std::size_t corner = 0; corner < corners; ++corner)
+    {
+        const uint32_t* index = &indices[corner * stride + light];
+        const float32x4_t weight = vld1q_f32(&weights[corner * stride + light]);
+        const float valuesRed[blockSize]
+            = {gridRed[index[0]], gridRed[index[1]], gridRed[index[2]], gridRed[index[3]]};
+        const float valuesGreen[blockSize]
+            = {gridGreen[index[0]], gridGreen[index[1]], gridGreen[index[2]], gridGreen[index[3]]};
+        const float valuesBlue[blockSize]
+            = {gridBlue[index[0]], gridBlue[index[1]], gridBlue[index[2]], gridBlue[index[3]]};
+        r = vmlaq_f32(r, weight, vld1q_f32(valuesRed));
+        g = vmlaq_f32(g, weight, vld1q_f32(valuesGreen));
+        b = vmlaq_f32(b, weight, vld1q_f32(valuesBlue));
+    }
+    vst1q_f32(red, r);
+    vst1q_f32(green, g);
+    vst1q_f32(blue, b);
+#else
+    for (std::size_t i = 0; i < blockSize; ++i)
+    {
+        red[i] = green[i] = blue[i] = 0.f;
+    }
+    for (std::size_t corner = 0; corner < corners; ++corner)
+    {
+        const uint32_t* index = &indices[corner * stride + light];
+        const float* weight = &weights[corner * stride + light];
+        for (std::size_t i = 0; i < blockSize; ++i)
+        {
+            red[i] += weight[i] * gridRed[index[i]];
+            green[i] += weight[i] * gridGreen[index[i]];
+            blue[i] += weight[i] * gridBlue[index[i]];
+        }
+    }
+#endif
+}
+} // namespace hueplusplus
@@ -0,0 +1,149 @@
+/**
+    \file StateMutex.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/StateMutex.h"
+
+#include <algorithm>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace hueplusplus
+{
+namespace
+{
+// Shared locks of the current thread and how often they were locked
+thread_local std::vector<std::pair<const StateMutex*, unsigned int>> sharedLocks;
+
+std::vector<std::pair<const StateMutex*, unsigned int>>::iterator findSharedLock(const StateMutex* mutex)
+{
+    return std::find_if(sharedLocks.begin(), sharedLocks.end(),
+        [mutex](const std::pair<const StateMutex*, unsigned int>& entry) { return entry.first == mutex; });
+}
+} // namespace
+
+void StateMutex::lock()
+{
+    const std::thread::id self = std::this_thread::get_id();
+    if (owner.load(std::memory_order_relaxed) == self)
+    {
+        ++exclusiveCount;
+        return;
+    }
+    if (findSharedLock(this) != sharedLocks.end())
+    {
+        // Would wait for itself to release the shared lock
+        throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur));
+    }
+    mutex.lock();
+    owner.store(self, std::memory_order_relaxed);
+    exclusiveCount = 1;
+}
+
+bool StateMutex::try_lock()
+{
+    const std::thread::id self = std::this_thread::get_id();
+    if (owner.load(std::memory_order_relaxed) == self)
+    {
+        ++exclusiveCount;
+        return true;
+    }
+    if (findSharedLock(this) != sharedLocks.end() || !mutex.try_lock())
+    {
+        return false;
+    }
+    owner.store(self, std::memory_order_relaxed);
+    exclusiveCount = 1;
+    return true;
+}
+
+void StateMutex::unlock()
+{
+    if (--exclusiveCount == 0)
+    {
+        owner.store(std::thread::id(), std::memory_order_relaxed);
+        mutex.unlock();
+    }
+}
+
+void StateMutex::lock_shared()
+{
+    if (isLockedExclusively())
+    {
+        ++exclusiveCount;
+        return;
+    }
+    auto pos = findSharedLock(this);
+    if (pos != sharedLocks.end())
+    {
+        ++pos->second;
+        return;
+    }
+    mutex.lock_shared();
+    sharedLocks.emplace_back(this, 1);
+}
+
+bool StateMutex::try_lock_shared()
+{
+    if (isLockedExclusively())
+    {
+        ++exclusiveCount;
+        return true;
+    }
+    auto pos = findSharedLock(this);
+    if (pos != sharedLocks.end())
+    {
+        ++pos->second;
+        return true;
+    }
+    if (!mutex.try_lock_shared())
+    {
+        return false;
+    }
+    sharedLocks.emplace_back(this, 1);
+    return true;
+}
+
+void StateMutex::unlock_shared()
+{
+    if (isLockedExclusively())
+    {
+        unlock();
+        return;
+    }
+    auto pos = findSharedLock(this);
+    if (--pos->second == 0)
+    {
+        sharedLocks.erase(pos);
+        mutex.unlock_shared();
+    }
+}
+
+bool StateMutex::isLockedExclusively() const
+{
+    return owner.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
+bool StateMutex::isLocked() const
+{
+    return isLockedExclusively() || findSharedLock(this) != sharedLocks.end();
+}
+} // namespace hueplusplus
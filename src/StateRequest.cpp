@@ -0,0 +1,517 @@
+/**
+    \file StateRequest.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/StateRequest.h"
+
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "hueplusplus/Utils.h"
+
+namespace hueplusplus
+{
+namespace
+{
+const char* getAlertName(StateRequest::Alert alert)
+{
+    switch (alert)
+    {
+    case StateRequest::Alert::select:
+        return "select";
+    case StateRequest::Alert::lselect:
+        return "lselect";
+    default:
+        return "none";
+    }
+}
+
+const char* getEffectName(StateRequest::Effect effect)
+{
+    return effect == StateRequest::Effect::colorloop ? "colorloop" : "none";
+}
+
+void appendInt(std::string& buffer, int32_t value)
+{
+    char digits[12];
+    char* end = digits + sizeof(digits);
+    char* p = end;
+    // Use unsigned to handle the minimum value
+    uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+    do
+    {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0)
+    {
+        *--p = '-';
+    }
+    buffer.append(p, end);
+}
+
+void appendFloat(std::string& buffer, float value)
+{
+    // Parses to the same value as nlohmann::json::dump, values are stored as double in json
+    const double number = static_cast<double>(value);
+    if (!std::isfinite(number))
+    {
+        buffer.append("null");
+        return;
+    }
+    // 17 significant digits always parse to the same double, %g drops trailing zeros of short values
+    char digits[32];
+    char* end = digits + std::snprintf(digits, sizeof(digits), "%.17g", number);
+    // snprintf uses the decimal point of the current locale
+    const char decimalPoint = *std::localeconv()->decimal_point;
+    std::replace(digits, end, decimalPoint, '.');
+    buffer.append(digits, end);
+    if (std::find_if(digits, end, [](char c) { return c == '.' || c == 'e'; }) == end)
+    {
+        // Keep integral values as floating point numbers
+        buffer.append(".0");
+    }
+}
+
+void appendString(std::string& buffer, const char* value)
+{
+    buffer.push_back('"');
+    buffer.append(value);
+    buffer.push_back('"');
+}
+
+bool stringEquals(const nlohmann::json& json, const char* value)
+{
+    return json.is_string() && json.get_ref<const std::string&>() == value;
+}
+
+bool xyEquals(const nlohmann::json& json, const float (&xy)[2])
+{
+    return json.is_array() && json.size() == 2 && utils::floatEquals(json[0].get<float>(), xy[0])
+        && utils::floatEquals(json[1].get<float>(), xy[1]);
+}
+} // namespace
+
+constexpr int StateRequest::fieldCount;
+
+const char* StateRequest::getKey(Field field)
+{
+    switch (field)
+    {
+    case alert:
+        return "alert";
+    case bri:
+        return "bri";
+    case briInc:
+        return "bri_inc";
+    case ct:
+        return "ct";
+    case ctInc:
+        return "ct_inc";
+    case effect:
+        return "effect";
+    case hue:
+        return "hue";
+    case hueInc:
+        return "hue_inc";
+    case on:
+        return "on";
+    case sat:
+        return "sat";
+    case satInc:
+        return "sat_inc";
+    case transitiontime:
+        return "transitiontime";
+    case xy:
+        return "xy";
+    case xyInc:
+        return "xy_inc";
+    default:
+        return "";
+    }
+}
+
+int StateRequest::size() const
+{
+    int count = 0;
+    for (uint16_t f = fields; f != 0; f &= static_cast<uint16_t>(f - 1))
+    {
+        ++count;
+    }
+    return count;
+}
+
+void StateRequest::setOn(bool value)
+{
+    fields |= on;
+    onValue = value;
+}
+
+void StateRequest::setBrightness(int value)
+{
+    fields |= bri;
+    briValue = static_cast<int16_t>(value);
+}
+
+void StateRequest::setHue(int value)
+{
+    fields |= hue;
+    hueValue = value;
+}
+
+void StateRequest::setSaturation(int value)
+{
+    fields |= sat;
+    satValue = static_cast<int16_t>(value);
+}
+
+void StateRequest::setXY(float x, float y)
+{
+    fields |= xy;
+    xyValue[0] = x;
+    xyValue[1] = y;
+}
+
+void StateRequest::setColorTemperature(int value)
+{
+    fields |= ct;
+    ctValue = static_cast<int16_t>(value);
+}
+
+void StateRequest::setEffect(Effect value)
+{
+    fields |= effect;
+    effectValue = value;
+}
+
+void StateRequest::setAlert(Alert value)
+{
+    fields |= alert;
+    alertValue = value;
+}
+
+void StateRequest::setTransition(int value)
+{
+    fields |= transitiontime;
+    transitionValue = static_cast<uint16_t>(value);
+}
+
+void StateRequest::setBrightnessIncrement(int value)
+{
+    fields |= briInc;
+    briIncValue = static_cast<int16_t>(value);
+}
+
+void StateRequest::setSaturationIncrement(int value)
+{
+    fields |= satInc;
+    satIncValue = static_cast<int16_t>(value);
+}
+
+void StateRequest::setHueIncrement(int value)
+{
+    fields |= hueInc;
+    hueIncValue = value;
+}
+
+void StateRequest::setColorTemperatureIncrement(int value)
+{
+    fields |= ctInc;
+    ctIncValue = value;
+}
+
+void StateRequest::setXYIncrement(float x, float y)
+{
+    fields |= xyInc;
+    xyIncValue[0] = x;
+    xyIncValue[1] = y;
+}
+
+void StateRequest::trim(const nlohmann::json& state)
+{
+    auto colormodeIt = state.find("colormode");
+    const auto colormodeIs = [&](const char* mode) {
+        return colormodeIt != state.end() && stringEquals(*colormodeIt, mode);
+    };
+    const auto stateHas = [&](const char* key, const auto& matches) {
+        auto it = state.find(key);
+        return it != state.end() && matches(*it);
+    };
+    // Color fields are only removed if colormode and value match
+    if (has(hue) && colormodeIs("hs") && stateHas("hue", [&](const nlohmann::json& v) { return v == hueValue; }))
+    {
+        remove(hue);
+    }
+    if (has(sat) && colormodeIs("hs") && stateHas("sat", [&](const nlohmann::json& v) { return v == satValue; }))
+    {
+        remove(sat);
+    }
+    if (has(xy) && colormodeIs("xy")
+        && stateHas("xy", [&](const nlohmann::json& v) { return xyEquals(v, xyValue); }))
+    {
+        remove(xy);
+    }
+    if (has(ct) && colormodeIs("ct") && stateHas("ct", [&](const nlohmann::json& v) { return v == ctValue; }))
+    {
+        remove(ct);
+    }
+    if (has(on) && stateHas("on", [&](const nlohmann::json& v) { return v == onValue; }))
+    {
+        remove(on);
+    }
+    if (has(bri) && stateHas("bri", [&](const nlohmann::json& v) { return v == briValue; }))
+    {
+        remove(bri);
+    }
+    if (has(effect)
+        && stateHas("effect", [&](const nlohmann::json& v) { return stringEquals(v, getEffectName(effectValue)); }))
+    {
+        remove(effect);
+    }
+}
+
+void StateRequest::serialize(std::string& buffer) const
+{
+    buffer.clear();
+    buffer.push_back('{');
+    bool first = true;
+    for (int i = 0; i < fieldCount; ++i)
+    {
+        const Field field = static_cast<Field>(1 << i);
+        if (!has(field))
+        {
+            continue;
+        }
+        if (!first)
+        {
+            buffer.push_back(',');
+        }
+        first = false;
+        appendString(buffer, getKey(field));
+        buffer.push_back(':');
+        switch (field)
+        {
+        case alert:
+            appendString(buffer, getAlertName(alertValue));
+            break;
+        case bri:
+            appendInt(buffer, briValue);
+            break;
+        case briInc:
+            appendInt(buffer, briIncValue);
+            break;
+        case ct:
+            appendInt(buffer, ctValue);
+            break;
+        case ctInc:
+            appendInt(buffer, ctIncValue);
+            break;
+        case effect:
+            appendString(buffer, getEffectName(effectValue));
+            break;
+        case hue:
+            appendInt(buffer, hueValue);
+            break;
+        case hueInc:
+            appendInt(buffer, hueIncValue);
+            break;
+        case on:
+            buffer.append(onValue ? "true" : "false");
+            break;
+        case sat:
+            appendInt(buffer, satValue);
+            break;
+        case satInc:
+            appendInt(buffer, satIncValue);
+            break;
+        case transitiontime:
+            appendInt(buffer, transitionValue);
+            break;
+        case xy:
+        case xyInc:
+        {
+            const float* values = field == xy ? xyValue : xyIncValue;
+            buffer.push_back('[');
+            appendFloat(buffer, values[0]);
+            buffer.push_back(',');
+            appendFloat(buffer, values[1]);
+            buffer.push_back(']');
+            break;
+        }
+        }
+    }
+    buffer.push_back('}');
+}
+
+nlohmann::json StateRequest::toJson() const
+{
+    nlohmann::json result = nlohmann::json::object();
+    applyTo(result);
+    if (has(transitiontime))
+    {
+        result["transitiontime"] = transitionValue;
+    }
+    return result;
+}
+
+bool StateRequest::validateReply(const std::string& path, const nlohmann::json& reply) const
+{
+    const std::size_t prefixLength = path.size() + (path.back() != '/' ? 1 : 0);
+    bool success = false;
+    for (auto it = reply.begin(); it != reply.end(); ++it)
+    {
+        auto successIt = it->find("success");
+        success = successIt != it->end();
+        if (success)
+        {
+            for (auto valueIt = successIt->begin(); valueIt != successIt->end(); ++valueIt)
+            {
+                const std::string& successPath = valueIt.key();
+                if (successPath.size() < prefixLength || successPath.compare(0, path.size(), path) != 0
+                    || (prefixLength != path.size() && successPath[path.size()] != '/'))
+                {
+                    success = false;
+                    break;
+                }
+                const char* valueKey = successPath.c_str() + prefixLength;
+                Field field = static_cast<Field>(0);
+                for (int i = 0; i < fieldCount; ++i)
+                {
+                    if (std::strcmp(getKey(static_cast<Field>(1 << i)), valueKey) == 0)
+                    {
+                        field = static_cast<Field>(1 << i);
+                        break;
+                    }
+                }
+                success = has(field) && (valueMatches(field, *valueIt) || stringEquals(*valueIt, "Updated."));
+                if (!success)
+                {
+                    std::cout << "Value for " << valueKey << " does not match reply " << *valueIt << std::endl;
+                    break;
+                }
+            }
+        }
+        if (!success) // Fail fast
+        {
+            break;
+        }
+    }
+    return success;
+}
+
+void StateRequest::applyTo(nlohmann::json& state) const
+{
+    if (has(alert))
+    {
+        state["alert"] = getAlertName(alertValue);
+    }
+    if (has(bri))
+    {
+        state["bri"] = briValue;
+    }
+    if (has(briInc))
+    {
+        state["bri_inc"] = briIncValue;
+    }
+    if (has(ct))
+    {
+        state["ct"] = ctValue;
+    }
+    if (has(ctInc))
+    {
+        state["ct_inc"] = ctIncValue;
+    }
+    if (has(effect))
+    {
+        state["effect"] = getEffectName(effectValue);
+    }
+    if (has(hue))
+    {
+        state["hue"] = hueValue;
+    }
+    if (has(hueInc))
+    {
+        state["hue_inc"] = hueIncValue;
+    }
+    if (has(on))
+    {
+        state["on"] = onValue;
+    }
+    if (has(sat))
+    {
+        state["sat"] = satValue;
+    }
+    if (has(satInc))
+    {
+        state["sat_inc"] = satIncValue;
+    }
+    if (has(xy))
+    {
+        state["xy"] = {xyValue[0], xyValue[1]};
+    }
+    if (has(xyInc))
+    {
+        state["xy_inc"] = {xyIncValue[0], xyIncValue[1]};
+    }
+}
+
+bool StateRequest::valueMatches(Field field, const nlohmann::json& value) const
+{
+    switch (field)
+    {
+    case alert:
+        return stringEquals(value, getAlertName(alertValue));
+    case bri:
+        return value == briValue;
+    case briInc:
+        return value == briIncValue;
+    case ct:
+        return value == ctValue;
+    case ctInc:
+        return value == ctIncValue;
+    case effect:
+        return stringEquals(value, getEffectName(effectValue));
+    case hue:
+        return value == hueValue;
+    case hueInc:
+        return value == hueIncValue;
+    case on:
+        return value == onValue;
+    case sat:
+        return value == satValue;
+    case satInc:
+        return value == satIncValue;
+    case transitiontime:
+        return value == transitionValue;
+    case xy:
+        return xyEquals(value, xyValue);
+    case xyInc:
+        return value.is_array() && value.size() == 2 && value[0] == static_cast<double>(xyIncValue[0])
+            && value[1] == static_cast<double>(xyIncValue[1]);
+    default:
+        return false;
+    }
+}
+} // namespace hueplusplus
@@ -22,34 +22,47 @@
 
 #include "hueplusplus/StateTransaction.h"
 
-#include <set>
+#include <mutex>
 
 #include "hueplusplus/HueExceptionMacro.h"
 #include "hueplusplus/Utils.h"
 
 namespace hueplusplus
 {
-StateTransaction::StateTransaction(const HueCommandAPI& commands, const std::string& path, nlohmann::json* currentState)
-    : commands(commands), path(path), state(currentState), request(nlohmann::json::object())
+StateTransaction::StateTransaction(const HueCommandAPI& commands, const std::string& path,
+    nlohmann::json* currentState, DecodedLightState* decodedState)
+    : commands(commands), path(path), state(currentState), stateCache(nullptr), decodedState(decodedState)
+{ }
+
+StateTransaction::StateTransaction(APICache& stateCache, const std::string& path, DecodedLightState* decodedState)
+    : commands(stateCache.getCommandAPI()),
+      path(path),
+      state(nullptr),
+      stateCache(&stateCache),
+      decodedState(decodedState)
 { }
 
 bool StateTransaction::commit(bool trimRequest)
 {
-    const nlohmann::json& stateJson = (state != nullptr) ? *state : nlohmann::json::object();
+    std::unique_lock<StateMutex> lock(commands.getStateMutex());
+    const nlohmann::json* current = getState();
     // Check this before request is trimmed
-    if (!request.count("on"))
+    if (!request.has(StateRequest::on))
     {
-        if (!stateJson.value("on", false) && request.value("bri", 254) != 0
-            && (request.count("bri") || request.count("effect") || request.count("hue") || request.count("sat")
-                || request.count("xy") || request.count("ct")))
+        const bool stateOn = current != nullptr && current->value("on", false);
+        const bool briZero = request.has(StateRequest::bri) && request.getBrightness() == 0;
+        if (!stateOn && !briZero
+            && (request.getFields()
+                & (StateRequest::bri | StateRequest::effect | StateRequest::hue | StateRequest::sat | StateRequest::xy
+                    | StateRequest::ct)))
         {
             // Turn on if it was turned off
-            request["on"] = true;
+            request.setOn(true);
         }
-        else if (request.value("bri", 254) == 0 && stateJson.value("on", true))
+        else if (briZero && (current == nullptr || current->value("on", true)))
         {
             // Turn off if brightness is 0
-            request["on"] = false;
+            request.setOn(false);
         }
     }
 
@@ -58,21 +71,26 @@ bool StateTransaction::commit(bool trimRequest)
         this->trimRequest();
     }
     // Empty request or request with only transition makes no sense
-    if (!request.empty() && !(request.size() == 1 && request.count("transitiontime")))
+    if (!request.empty() && request.getFields() != StateRequest::transitiontime)
     {
-        nlohmann::json reply = commands.PUTRequest(path, request, CURRENT_FILE_INFO);
-        if (utils::validatePUTReply(path, request, reply))
+        // Reused, so serializing does not allocate once the buffer is large enough
+        thread_local std::string body;
+        request.serialize(body);
+        // Other threads can use the state during the request
+        lock.unlock();
+        nlohmann::json reply = commands.PUTSerializedRequest(path, body, CURRENT_FILE_INFO);
+        if (request.validateReply(path, reply))
         {
-            if (state != nullptr)
+            lock.lock();
+            // Look up the state again, it could have been refreshed or removed during the request
+            nlohmann::json* updated = getState();
+            if (updated != nullptr)
             {
                 // Apply changes to state
-                for (auto it = request.begin(); it != request.end(); ++it)
+                request.applyTo(*updated);
+                if (decodedState != nullptr)
                 {
-                    if (it.key() == "transitiontime")
-                    {
-                        continue;
-                    }
-                    (*state)[it.key()] = it.value();
+                    *decodedState = DecodedLightState::parse(*updated);
                 }
             }
             return true;
@@ -84,40 +102,40 @@ bool StateTransaction::commit(bool trimRequest)
 
 Action StateTransaction::toAction()
 {
-    nlohmann::json command {{"method", "PUT"}, {"address", commands.combinedPath(path)}, {"body", request}};
+    nlohmann::json command {{"method", "PUT"}, {"address", commands.combinedPath(path)}, {"body", request.toJson()}};
     return Action(command);
 }
 
 StateTransaction& StateTransaction::setOn(bool on)
 {
-    request["on"] = on;
+    request.setOn(on);
     return *this;
 }
 
 StateTransaction& StateTransaction::setBrightness(uint8_t brightness)
 {
     uint8_t clamped = std::min<uint8_t>(brightness, 254);
-    request["bri"] = clamped;
+    request.setBrightness(clamped);
     return *this;
 }
 
 StateTransaction& StateTransaction::setColorSaturation(uint8_t saturation)
 {
     uint8_t clamped = std::min<uint8_t>(saturation, 254);
-    request["sat"] = clamped;
+    request.setSaturation(clamped);
     return *this;
 }
 
 StateTransaction& StateTransaction::setColorHue(uint16_t hue)
 {
-    request["hue"] = hue;
+    request.setHue(hue);
     return *this;
 }
 
 StateTransaction& StateTransaction::setColor(const HueSaturation& hueSat)
 {
-    request["hue"] = std::max(0, std::min(hueSat.hue, (1 << 16) - 1));
-    request["sat"] = std::max(0, std::min(hueSat.saturation, 254));
+    request.setHue(std::max(0, std::min(hueSat.hue, (1 << 16) - 1)));
+    request.setSaturation(std::max(0, std::min(hueSat.saturation, 254)));
     return *this;
 }
 
@@ -125,14 +143,14 @@ StateTransaction& StateTransaction::setColor(const XY& xy)
 {
     float clampedX = std::max(0.f, std::min(xy.x, 1.f));
     float clampedY = std::max(0.f, std::min(xy.y, 1.f));
-    request["xy"] = {clampedX, clampedY};
+    request.setXY(clampedX, clampedY);
     return *this;
 }
 
 StateTransaction& StateTransaction::setColor(const XYBrightness& xy)
 {
     int clamped = std::max(0, std::min(static_cast<int>(std::round(xy.brightness * 254.f)), 254));
-    request["bri"] = clamped;
+    request.setBrightness(clamped);
 
     return this->setColor(xy.xy);
 }
@@ -140,43 +158,43 @@ StateTransaction& StateTransaction::setColor(const XYBrightness& xy)
 StateTransaction& StateTransaction::setColorTemperature(unsigned int mired)
 {
     unsigned int clamped = std::max(153u, std::min(mired, 500u));
-    request["ct"] = clamped;
+    request.setColorTemperature(clamped);
     return *this;
 }
 
 StateTransaction& StateTransaction::setColorLoop(bool on)
 {
-    request["effect"] = on ? "colorloop" : "none";
+    request.setEffect(on ? StateRequest::Effect::colorloop : StateRequest::Effect::none);
     return *this;
 }
 
 StateTransaction& StateTransaction::incrementBrightness(int increment)
 {
-    request["bri_inc"] = std::max(-254, std::min(increment, 254));
+    request.setBrightnessIncrement(std::max(-254, std::min(increment, 254)));
     return *this;
 }
 
 StateTransaction& StateTransaction::incrementSaturation(int increment)
 {
-    request["sat_inc"] = std::max(-254, std::min(increment, 254));
+    request.setSaturationIncrement(std::max(-254, std::min(increment, 254)));
     return *this;
 }
 
 StateTransaction& StateTransaction::incrementHue(int increment)
 {
-    request["hue_inc"] = std::max(-65534, std::min(increment, 65534));
+    request.setHueIncrement(std::max(-65534, std::min(increment, 65534)));
     return *this;
 }
 
 StateTransaction& StateTransaction::incrementColorTemperature(int increment)
 {
-    request["ct_inc"] = std::max(-65534, std::min(increment, 65534));
+    request.setColorTemperatureIncrement(std::max(-65534, std::min(increment, 65534)));
     return *this;
 }
 
 StateTransaction& StateTransaction::incrementColorXY(float xInc, float yInc)
 {
-    request["xy_inc"] = {std::max(-0.5f, std::min(xInc, 0.5f)), std::max(-0.5f, std::min(yInc, 0.5f))};
+    request.setXYIncrement(std::max(-0.5f, std::min(xInc, 0.5f)), std::max(-0.5f, std::min(yInc, 0.5f)));
     return *this;
 }
 
@@ -184,65 +202,49 @@ StateTransaction& StateTransaction::setTransition(uint16_t transition)
 {
     if (transition != 4)
     {
-        request["transitiontime"] = transition;
+        request.setTransition(transition);
     }
     return *this;
 }
 StateTransaction& StateTransaction::alert()
 {
-    request["alert"] = "select";
+    request.setAlert(StateRequest::Alert::select);
     return *this;
 }
 StateTransaction& StateTransaction::longAlert()
 {
-    request["alert"] = "lselect";
+    request.setAlert(StateRequest::Alert::lselect);
     return *this;
 }
 StateTransaction& StateTransaction::stopAlert()
 {
-    request["alert"] = "none";
+    request.setAlert(StateRequest::Alert::none);
     return *this;
 }
 
 void StateTransaction::trimRequest()
 {
-    static const std::map<std::string, std::string> colormodes
-        = {{"sat", "hs"}, {"hue", "hs"}, {"xy", "xy"}, {"ct", "ct"}};
-    static const std::set<std::string> otherRemove = {"on", "bri", "effect"};
+    const nlohmann::json* current = getState();
     // Skip when there is no state provided (e.g. for groups)
-    if (!state)
+    if (current)
     {
-        return;
+        request.trim(*current);
     }
-    for (auto it = request.begin(); it != request.end();)
+}
+
+nlohmann::json* StateTransaction::getState()
+{
+    if (stateCache == nullptr)
     {
-        auto colormodeIt = colormodes.find(it.key());
-        if (colormodeIt != colormodes.end())
-        {
-            // Only erase color commands if colormode and value matches
-            auto stateIt = state->find(it.key());
-            if (stateIt != state->end() && state->value("colormode", "") == colormodeIt->second)
-            {
-                // Compare xy using float comparison
-                if ((!it->is_array() && *stateIt == *it)
-                    || (stateIt->is_array() && utils::floatEquals((*stateIt)[0].get<float>(), (*it)[0].get<float>())
-                        && utils::floatEquals((*stateIt)[1].get<float>(), (*it)[1].get<float>())))
-                {
-                    it = request.erase(it);
-                    continue;
-                }
-            }
-        }
-        else if (otherRemove.count(it.key()))
-        {
-            if (state->count(it.key()) && (*state)[it.key()] == *it)
-            {
-                it = request.erase(it);
-                continue;
-            }
-        }
-        ++it;
+        return state;
+    }
+    Result<nlohmann::json&> value = stateCache->tryGetCachedValue();
+    if (!value || !value->is_object())
+    {
+        return nullptr;
     }
+    auto it = value->find("state");
+    return it != value->end() ? &*it : nullptr;
 }
 
 } // namespace hueplusplus
\ No newline at end of file
@@ -0,0 +1,243 @@
+/**
+    \file StreamCoordinator.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/StreamCoordinator.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "hueplusplus/HueExceptionMacro.h"
+
+namespace hueplusplus
+{
+StreamCoordinator::Session::Session(const std::vector<uint8_t>& initial, SendFunction send)
+    : frames(initial), send(std::move(send))
+{ }
+
+StreamCoordinator::~StreamCoordinator()
+{
+    stop();
+}
+
+std::size_t StreamCoordinator::addSession(const std::vector<uint8_t>& initial, SendFunction send)
+{
+    std::unique_ptr<Session> session = std::make_unique<Session>(initial, std::move(send));
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    // Reuse the slot of a removed session, so starting and stopping sessions does not grow the list
+    auto slot = std::find(sessions.begin(), sessions.end(), nullptr);
+    if (slot != sessions.end())
+    {
+        *slot = std::move(session);
+        return static_cast<std::size_t>(slot - sessions.begin());
+    }
+    sessions.push_back(std::move(session));
+    return sessions.size() - 1;
+}
+
+void StreamCoordinator::removeSession(std::size_t session)
+{
+    // Wait for the current send time, so the send function is not called afterwards
+    std::lock_guard<std::mutex> sendLock(sendMutex);
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    getSessionLocked(session);
+    sessions[session].reset();
+}
+
+std::size_t StreamCoordinator::getSessionCount() const
+{
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    return std::count_if(
+        sessions.begin(), sessions.end(), [](const std::unique_ptr<Session>& s) { return s != nullptr; });
+}
+
+void StreamCoordinator::start(int rate)
+{
+    if (rate <= 0)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Streaming rate must be positive");
+    }
+    if (sender.joinable())
+    {
+        throw HueException(CURRENT_FILE_INFO, "Stream coordinator is already running");
+    }
+    this->rate = rate;
+    resetStatistics();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = false;
+    }
+    const std::chrono::steady_clock::duration period
+        = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(1)) / rate;
+    sender = std::thread(&StreamCoordinator::run, this, period);
+}
+
+void StreamCoordinator::stop()
+{
+    if (!sender.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+    }
+    stopped.notify_all();
+    sender.join();
+}
+
+bool StreamCoordinator::isRunning() const
+{
+    return sender.joinable();
+}
+
+int StreamCoordinator::getRate() const
+{
+    return rate;
+}
+
+std::vector<uint8_t>& StreamCoordinator::getFrame(std::size_t session)
+{
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    return getSessionLocked(session).frames.back();
+}
+
+void StreamCoordinator::publish(std::size_t session)
+{
+    // Keep the session locked, so it cannot be removed while publishing
+    std::lock_guard<std::mutex> sessionLock(sessionMutex);
+    Session& s = getSessionLocked(session);
+    std::lock_guard<std::mutex> lock(publishMutex);
+    s.frames.publish();
+}
+
+void StreamCoordinator::publish()
+{
+    std::lock_guard<std::mutex> sessionLock(sessionMutex);
+    std::lock_guard<std::mutex> lock(publishMutex);
+    for (const std::unique_ptr<Session>& s : sessions)
+    {
+        if (s)
+        {
+            s->frames.publish();
+        }
+    }
+}
+
+StreamStatistics StreamCoordinator::getStatistics(std::size_t session) const
+{
+    std::lock_guard<std::mutex> sessionLock(sessionMutex);
+    const Session& s = getSessionLocked(session);
+    std::lock_guard<std::mutex> lock(mutex);
+    return s.statistics.get(s.frames);
+}
+
+SkewStatistics StreamCoordinator::getSkewStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    SkewStatistics result = skew;
+    if (result.ticks > 0)
+    {
+        result.meanSkew = totalSkew / result.ticks;
+    }
+    return result;
+}
+
+void StreamCoordinator::resetStatistics()
+{
+    std::lock_guard<std::mutex> sessionLock(sessionMutex);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const std::unique_ptr<Session>& s : sessions)
+    {
+        if (s)
+        {
+            s->statistics.reset(s->frames);
+        }
+    }
+    skew = SkewStatistics();
+    totalSkew = std::chrono::nanoseconds(0);
+}
+
+StreamCoordinator::Session& StreamCoordinator::getSessionLocked(std::size_t session) const
+{
+    if (session >= sessions.size() || !sessions[session])
+    {
+        throw HueException(CURRENT_FILE_INFO, "Invalid session id");
+    }
+    return *sessions[session];
+}
+
+void StreamCoordinator::run(std::chrono::steady_clock::duration period)
+{
+    using namespace std::chrono;
+    SendSchedule schedule(steady_clock::now(), period);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopped.wait_until(lock, schedule.getNext(), [this]() { return stopRequested; }))
+    {
+        const std::size_t skipped = schedule.skipPassed(steady_clock::now());
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> sendLock(sendMutex);
+            {
+                std::lock_guard<std::mutex> sessionLock(sessionMutex);
+                sending.clear();
+                for (const std::unique_ptr<Session>& s : sessions)
+                {
+                    if (s)
+                    {
+                        sending.push_back(s.get());
+                    }
+                }
+            }
+            {
+                // Take the frames of all sessions at once, so frames published together stay together
+                std::lock_guard<std::mutex> publishLock(publishMutex);
+                for (Session* s : sending)
+                {
+                    s->fresh = s->frames.consume();
+                }
+            }
+            steady_clock::time_point firstSend;
+            steady_clock::time_point lastSend;
+            for (Session* s : sending)
+            {
+                lastSend = steady_clock::now();
+                if (s == sending.front())
+                {
+                    firstSend = lastSend;
+                }
+                const bool success = StreamingEngine::sendFrame(s->send, s->frames.front());
+
+                std::lock_guard<std::mutex> statisticsLock(mutex);
+                s->statistics.countFrame(s->fresh, success, skipped, schedule.getJitter(lastSend));
+            }
+            lock.lock();
+            if (!sending.empty())
+            {
+                const nanoseconds tickSkew = duration_cast<nanoseconds>(lastSend - firstSend);
+                ++skew.ticks;
+                totalSkew += tickSkew;
+                skew.maxSkew = std::max(skew.maxSkew, tickSkew);
+            }
+        }
+        schedule.advance();
+    }
+}
+} // namespace hueplusplus
@@ -0,0 +1,331 @@
+/**
+    \file StreamingEngine.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/StreamingEngine.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "hueplusplus/HueExceptionMacro.h"
+
+namespace hueplusplus
+{
+constexpr unsigned int FrameBuffer::freshBit;
+
+FrameBuffer::FrameBuffer(const std::vector<uint8_t>& initial) : buffers {initial, initial, initial} { }
+
+std::vector<uint8_t>& FrameBuffer::back()
+{
+    return buffers[backIndex];
+}
+
+void FrameBuffer::publish()
+{
+    const unsigned int published = backIndex;
+    const unsigned int old = middle.exchange(published | freshBit, std::memory_order_acq_rel);
+    if (old & freshBit)
+    {
+        overwritten.fetch_add(1, std::memory_order_relaxed);
+    }
+    backIndex = old & ~freshBit;
+    // The consumer only reads the published buffer, so it can be copied while the consumer sends it.
+    // Buffers of the same size do not allocate.
+    buffers[backIndex] = buffers[published];
+}
+
+bool FrameBuffer::consume()
+{
+    if (!(middle.load(std::memory_order_relaxed) & freshBit))
+    {
+        return false;
+    }
+    frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & ~freshBit;
+    return true;
+}
+
+const std::vector<uint8_t>& FrameBuffer::front() const
+{
+    return buffers[frontIndex];
+}
+
+std::size_t FrameBuffer::getOverwrittenCount() const
+{
+    return overwritten.load(std::memory_order_relaxed);
+}
+
+SendSchedule::SendSchedule(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::duration period)
+    : next(start), period(period)
+{ }
+
+std::chrono::steady_clock::time_point SendSchedule::getNext() const
+{
+    return next;
+}
+
+std::size_t SendSchedule::skipPassed(std::chrono::steady_clock::time_point now)
+{
+    if (now <= next)
+    {
+        return 0;
+    }
+    const auto skipped = (now - next) / period;
+    next += skipped * period;
+    return static_cast<std::size_t>(skipped);
+}
+
+std::chrono::nanoseconds SendSchedule::getJitter(std::chrono::steady_clock::time_point time) const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - next);
+}
+
+void SendSchedule::advance()
+{
+    next += period;
+}
+
+void StatisticsCounter::countFrame(bool fresh, bool success, std::size_t skipped, std::chrono::nanoseconds jitter)
+{
+    ++statistics.sentFrames;
+    statistics.droppedFrames += skipped;
+    if (!fresh)
+    {
+        ++statistics.repeatedFrames;
+    }
+    if (!success)
+    {
+        ++statistics.sendErrors;
+    }
+    totalJitter += jitter;
+    statistics.maxJitter = std::max(statistics.maxJitter, jitter);
+}
+
+StreamStatistics StatisticsCounter::get(const FrameBuffer& frames) const
+{
+    StreamStatistics result = statistics;
+    result.overwrittenFrames = frames.getOverwrittenCount() - overwrittenBase;
+    if (result.sentFrames > 0)
+    {
+        result.meanJitter = totalJitter / result.sentFrames;
+    }
+    return result;
+}
+
+void StatisticsCounter::reset(const FrameBuffer& frames)
+{
+    statistics = StreamStatistics();
+    totalJitter = std::chrono::nanoseconds(0);
+    overwrittenBase = frames.getOverwrittenCount();
+}
+
+StreamingEngine::StreamingEngine(const std::vector<uint8_t>& initial, SendFunction send)
+    : frames(initial), send(std::move(send))
+{ }
+
+StreamingEngine::~StreamingEngine()
+{
+    stop();
+}
+
+void StreamingEngine::start(int rate)
+{
+    if (rate <= 0)
+    {
+        throw HueException(CURRENT_FILE_INFO, "Streaming rate must be positive");
+    }
+    if (sender.joinable())
+    {
+        throw HueException(CURRENT_FILE_INFO, "Streaming engine is already running");
+    }
+    this->rate = rate;
+    resetStatistics();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = false;
+    }
+    const std::chrono::steady_clock::duration period
+        = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(1)) / rate;
+    sender = std::thread(&StreamingEngine::run, this, period);
+}
+
+void StreamingEngine::stop()
+{
+    if (!sender.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+    }
+    stopped.notify_all();
+    sender.join();
+}
+
+bool StreamingEngine::isRunning() const
+{
+    return sender.joinable();
+}
+
+int StreamingEngine::getRate() const
+{
+    return rate;
+}
+
+std::vector<uint8_t>& StreamingEngine::getFrame()
+{
+    return frames.back();
+}
+
+void StreamingEngine::publish()
+{
+    frames.publish();
+}
+
+StreamStatistics StreamingEngine::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics.get(frames);
+}
+
+void StreamingEngine::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    statistics.reset(frames);
+}
+
+bool StreamingEngine::sendFrame(const SendFunction& send, const std::vector<uint8_t>& frame)
+{
+    try
+    {
+        return send(frame);
+    }
+    catch (...)
+    {
+        // Counted as send error, the thread keeps sending
+        return false;
+    }
+}
+
+void StreamingEngine::run(std::chrono::steady_clock::duration period)
+{
+    using std::chrono::steady_clock;
+    SendSchedule schedule(steady_clock::now(), period);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopped.wait_until(lock, schedule.getNext(), [this]() { return stopRequested; }))
+    {
+        const steady_clock::time_point now = steady_clock::now();
+        const std::size_t skipped = schedule.skipPassed(now);
+
+        lock.unlock();
+        const bool fresh = frames.consume();
+        const bool success = sendFrame(send, frames.front());
+        lock.lock();
+
+        statistics.countFrame(fresh, success, skipped, schedule.getJitter(now));
+        schedule.advance();
+    }
+}
+
+IdleTimer::IdleTimer(std::chrono::steady_clock::duration interval, std::function<void()> callback)
+    : interval(interval), callback(std::move(callback))
+{ }
+
+IdleTimer::~IdleTimer()
+{
+    stop();
+}
+
+void IdleTimer::start()
+{
+    if (interval <= std::chrono::steady_clock::duration::zero())
+    {
+        throw HueException(CURRENT_FILE_INFO, "Idle interval must be positive");
+    }
+    if (timer.joinable())
+    {
+        throw HueException(CURRENT_FILE_INFO, "Idle timer is already running");
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = false;
+    }
+    touch();
+    timer = std::thread(&IdleTimer::run, this);
+}
+
+void IdleTimer::stop()
+{
+    if (!timer.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+    }
+    stopped.notify_all();
+    timer.join();
+}
+
+bool IdleTimer::isRunning() const
+{
+    return timer.joinable();
+}
+
+void IdleTimer::touch()
+{
+    lastActivity.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+std::size_t IdleTimer::getFireCount() const
+{
+    return fireCount.load(std::memory_order_relaxed);
+}
+
+void IdleTimer::run()
+{
+    using namespace std::chrono;
+    auto last = [this]() {
+        return steady_clock::time_point(steady_clock::duration(lastActivity.load(std::memory_order_relaxed)));
+    };
+    std::unique_lock<std::mutex> lock(mutex);
+    // Activity is not signaled to the thread, it checks the time of the last activity when it wakes up
+    while (!stopped.wait_until(lock, last() + interval, [this]() { return stopRequested; }))
+    {
+        if (steady_clock::now() - last() < interval)
+        {
+            continue;
+        }
+        lock.unlock();
+        try
+        {
+            callback();
+        }
+        catch (...)
+        {
+            // The timer keeps running
+        }
+        ++fireCount;
+        touch();
+        lock.lock();
+    }
+}
+} // namespace hueplusplus
@@ -0,0 +1,111 @@
+/**
+    \file TimerScheduler.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "hueplusplus/TimerScheduler.h"
+
+#include <exception>
+#include <iostream>
+
+namespace hueplusplus
+{
+TimerScheduler::~TimerScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    changed.notify_all();
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+void TimerScheduler::schedule(std::chrono::steady_clock::duration delay, Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(Entry {std::chrono::steady_clock::now() + delay, nextSequence++, std::move(task)});
+        if (!thread.joinable())
+        {
+            thread = std::thread(&TimerScheduler::run, this);
+        }
+    }
+    changed.notify_all();
+}
+
+std::size_t TimerScheduler::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return tasks.size() + running;
+}
+
+void TimerScheduler::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return stopped || (tasks.empty() && running == 0); });
+}
+
+TimerScheduler& TimerScheduler::instance()
+{
+    static TimerScheduler scheduler;
+    return scheduler;
+}
+
+void TimerScheduler::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopped)
+    {
+        if (tasks.empty())
+        {
+            changed.wait(lock);
+            continue;
+        }
+        const std::chrono::steady_clock::time_point due = tasks.top().due;
+        if (std::chrono::steady_clock::now() < due)
+        {
+            changed.wait_until(lock, due);
+            continue;
+        }
+        // priority_queue::top is const, the entry is popped immediately afterwards
+        Task task = std::move(const_cast<Entry&>(tasks.top()).task);
+        tasks.pop();
+        ++running;
+        lock.unlock();
+        try
+        {
+            task();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "TimerScheduler: Task failed: " << e.what() << "\n";
+        }
+        catch (...)
+        {
+            std::cerr << "TimerScheduler: Task failed with unknown exception\n";
+        }
+        lock.lock();
+        --running;
+        changed.notify_all();
+    }
+}
+} // namespace hueplusplus
@@ -28,6 +28,47 @@ namespace hueplusplus
 {
 namespace utils
 {
+namespace detail
+{
+const nlohmann::json& nullValue()
+{
+    static const nlohmann::json value;
+    return value;
+}
+} // namespace detail
+
+const nlohmann::json* MemberPath::find(const nlohmann::json& json) const
+{
+    const nlohmann::json* current = &json;
+    for (const Element& element : elements)
+    {
+        if (element.isIndex)
+        {
+            if (!current->is_array() || current->size() <= element.index)
+            {
+                return nullptr;
+            }
+            current = &(*current)[element.index];
+        }
+        else
+        {
+            auto memberIt = current->find(element.key);
+            if (memberIt == current->end())
+            {
+                return nullptr;
+            }
+            current = &*memberIt;
+        }
+    }
+    return current;
+}
+
+const nlohmann::json& MemberPath::get(const nlohmann::json& json) const
+{
+    const nlohmann::json* member = find(json);
+    return member != nullptr ? *member : detail::nullValue();
+}
+
 bool validatePUTReply(const std::string& path, const nlohmann::json& request, const nlohmann::json& reply)
 {
     std::string pathAppend = path;
@@ -42,10 +83,10 @@ bool validatePUTReply(const std::string& path, const nlohmann::json& request, co
         if (success)
         {
             // Traverse through first object
-            nlohmann::json successObject = it.value()["success"];
+            const nlohmann::json& successObject = it.value()["success"];
             for (auto successIt = successObject.begin(); successIt != successObject.end(); ++successIt)
             {
-                const std::string successPath = successIt.key();
+                const std::string& successPath = successIt.key();
                 if (successPath.find(pathAppend) == 0)
                 {
                     const std::string valueKey = successPath.substr(pathAppend.size());
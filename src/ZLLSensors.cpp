@@ -36,6 +36,7 @@ constexpr const char* ZGPSwitch::typeStr;
 
 bool ZGPSwitch::isOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("on").get<bool>();
 }
 
@@ -46,6 +47,7 @@ void ZGPSwitch::setOn(bool on)
 
 int ZGPSwitch::getButtonEvent() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("buttonevent").get<int>();
 }
 
@@ -69,6 +71,7 @@ constexpr const char* ZLLSwitch::typeStr;
 
 bool ZLLSwitch::isOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("on").get<bool>();
 }
 
@@ -78,15 +81,18 @@ void ZLLSwitch::setOn(bool on)
 }
 bool ZLLSwitch::hasBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("battery") != 0;
 }
 int ZLLSwitch::getBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("battery").get<int>();
 }
 
 Alert ZLLSwitch::getLastAlert() const
 {
+    auto lock = state.lockShared();
     std::string alert = state.getValue().at("config").at("alert").get<std::string>();
     return alertFromString(alert);
 }
@@ -96,15 +102,18 @@ void ZLLSwitch::sendAlert(Alert type)
 }
 bool ZLLSwitch::isReachable() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("reachable").get<bool>();
 }
 int ZLLSwitch::getButtonEvent() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("buttonevent").get<int>();
 }
 
 time::AbsoluteTime ZLLSwitch::getLastUpdated() const
 {
+    auto lock = state.lockShared();
     const nlohmann::json& stateJson = state.getValue().at("state");
     auto it = stateJson.find("lastupdated");
     if (it == stateJson.end() || !it->is_string() || *it == "none")
@@ -118,6 +127,7 @@ constexpr const char* ZLLPresence::typeStr;
 
 bool ZLLPresence::isOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("on").get<bool>();
 }
 
@@ -127,15 +137,18 @@ void ZLLPresence::setOn(bool on)
 }
 bool ZLLPresence::hasBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("battery") != 0;
 }
 int ZLLPresence::getBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("battery").get<int>();
 }
 
 Alert ZLLPresence::getLastAlert() const
 {
+    auto lock = state.lockShared();
     std::string alert = state.getValue().at("config").at("alert").get<std::string>();
     return alertFromString(alert);
 }
@@ -145,15 +158,18 @@ void ZLLPresence::sendAlert(Alert type)
 }
 bool ZLLPresence::isReachable() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("reachable").get<bool>();
 }
 
 int ZLLPresence::getSensitivity() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("sensitivity").get<int>();
 }
 int ZLLPresence::getMaxSensitivity() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("sensitivitymax").get<int>();
 }
 void ZLLPresence::setSensitivity(int sensitivity)
@@ -162,11 +178,13 @@ void ZLLPresence::setSensitivity(int sensitivity)
 }
 bool ZLLPresence::getPresence() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("presence").get<bool>();
 }
 
 time::AbsoluteTime ZLLPresence::getLastUpdated() const
 {
+    auto lock = state.lockShared();
     const nlohmann::json& stateJson = state.getValue().at("state");
     auto it = stateJson.find("lastupdated");
     if (it == stateJson.end() || !it->is_string() || *it == "none")
@@ -180,6 +198,7 @@ constexpr const char* ZLLTemperature::typeStr;
 
 bool ZLLTemperature::isOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("on").get<bool>();
 }
 
@@ -189,15 +208,18 @@ void ZLLTemperature::setOn(bool on)
 }
 bool ZLLTemperature::hasBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("battery") != 0;
 }
 int ZLLTemperature::getBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("battery").get<int>();
 }
 
 Alert ZLLTemperature::getLastAlert() const
 {
+    auto lock = state.lockShared();
     std::string alert = state.getValue().at("config").at("alert").get<std::string>();
     return alertFromString(alert);
 }
@@ -207,16 +229,19 @@ void ZLLTemperature::sendAlert(Alert type)
 }
 bool ZLLTemperature::isReachable() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("reachable").get<bool>();
 }
 
 int ZLLTemperature::getTemperature() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("temperature").get<int>();
 }
 
 time::AbsoluteTime ZLLTemperature::getLastUpdated() const
 {
+    auto lock = state.lockShared();
     const nlohmann::json& stateJson = state.getValue().at("state");
     auto it = stateJson.find("lastupdated");
     if (it == stateJson.end() || !it->is_string() || *it == "none")
@@ -230,6 +255,7 @@ constexpr const char* ZLLLightLevel::typeStr;
 
 bool ZLLLightLevel::isOn() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("on").get<bool>();
 }
 
@@ -239,18 +265,22 @@ void ZLLLightLevel::setOn(bool on)
 }
 bool ZLLLightLevel::hasBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").count("battery") != 0;
 }
 int ZLLLightLevel::getBatteryState() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("battery").get<int>();
 }
 bool ZLLLightLevel::isReachable() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("reachable").get<bool>();
 }
 int ZLLLightLevel::getDarkThreshold() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("tholddark").get<int>();
 }
 
@@ -260,6 +290,7 @@ void ZLLLightLevel::setDarkThreshold(int threshold)
 }
 int ZLLLightLevel::getThresholdOffset() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("config").at("tholdoffset").get<int>();
 }
 
@@ -270,21 +301,25 @@ void ZLLLightLevel::setThresholdOffset(int offset)
 
 int ZLLLightLevel::getLightLevel() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("lightlevel").get<int>();
 }
 
 bool ZLLLightLevel::isDark() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("dark").get<bool>();
 }
 
 bool ZLLLightLevel::isDaylight() const
 {
+    auto lock = state.lockShared();
     return state.getValue().at("state").at("daylight").get<bool>();
 }
 
 time::AbsoluteTime ZLLLightLevel::getLastUpdated() const
 {
+    auto lock = state.lockShared();
     const nlohmann::json& stateJson = state.getValue().at("state");
     auto it = stateJson.find("lastupdated");
     if (it == stateJson.end() || !it->is_string() || *it == "none")
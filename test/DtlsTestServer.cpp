@@ -0,0 +1,275 @@
+/**
+    \file DtlsTestServer.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include "DtlsTestServer.h"
+
+#include <cstdlib>
+#include <stdexcept>
+
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/net_sockets.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/ssl_cache.h"
+#include "mbedtls/ssl_cookie.h"
+#include "mbedtls/timing.h"
+
+struct DtlsTestServer::Context
+{
+    explicit Context(DtlsTestServer& server) : server(server)
+    {
+        mbedtls_net_init(&listen_fd);
+        mbedtls_net_init(&client_fd);
+        mbedtls_ssl_init(&ssl);
+        mbedtls_ssl_config_init(&conf);
+        mbedtls_ssl_cookie_init(&cookie);
+        mbedtls_ssl_cache_init(&cache);
+        mbedtls_entropy_init(&entropy);
+        mbedtls_ctr_drbg_init(&ctr_drbg);
+    }
+    ~Context()
+    {
+        mbedtls_net_free(&client_fd);
+        mbedtls_net_free(&listen_fd);
+        mbedtls_ssl_free(&ssl);
+        mbedtls_ssl_config_free(&conf);
+        mbedtls_ssl_cookie_free(&cookie);
+        mbedtls_ssl_cache_free(&cache);
+        mbedtls_ctr_drbg_free(&ctr_drbg);
+        mbedtls_entropy_free(&entropy);
+    }
+
+    // Session cache lookup, which counts the resumed sessions
+    static int getSession(void* data, mbedtls_ssl_session* session)
+    {
+        Context* context = static_cast<Context*>(data);
+        const int ret = mbedtls_ssl_cache_get(&context->cache, session);
+        if (ret == 0)
+        {
+            ++context->server.resumed;
+        }
+        return ret;
+    }
+    static int setSession(void* data, const mbedtls_ssl_session* session)
+    {
+        return mbedtls_ssl_cache_set(&static_cast<Context*>(data)->cache, session);
+    }
+
+    DtlsTestServer& server;
+    mbedtls_net_context listen_fd;
+    mbedtls_net_context client_fd;
+    mbedtls_ssl_context ssl;
+    mbedtls_ssl_config conf;
+    mbedtls_ssl_cookie_ctx cookie;
+    mbedtls_ssl_cache_context cache;
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context ctr_drbg;
+    mbedtls_timing_delay_context timer;
+    unsigned char clientIp[16];
+    size_t clientIpLength = 0;
+};
+
+DtlsTestServer::DtlsTestServer(const std::string& identity, const std::string& pskHex, const std::string& port)
+    : identity(identity), port(port), context(std::make_unique<Context>(*this))
+{
+    for (std::size_t i = 0; i + 1 < pskHex.size(); i += 2)
+    {
+        psk.push_back(static_cast<unsigned char>(std::strtol(pskHex.substr(i, 2).c_str(), nullptr, 16)));
+    }
+}
+
+DtlsTestServer::~DtlsTestServer()
+{
+    stop();
+}
+
+void DtlsTestServer::start()
+{
+    Context& c = *context;
+    if (mbedtls_ctr_drbg_seed(&c.ctr_drbg, mbedtls_entropy_func, &c.entropy, nullptr, 0) != 0)
+    {
+        throw std::runtime_error("Failed to seed mbedtls RNG");
+    }
+    if (mbedtls_net_bind(&c.listen_fd, "127.0.0.1", port.c_str(), MBEDTLS_NET_PROTO_UDP) != 0)
+    {
+        throw std::runtime_error("Failed to bind port " + port);
+    }
+    if (mbedtls_ssl_config_defaults(
+            &c.conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_DATAGRAM, MBEDTLS_SSL_PRESET_DEFAULT)
+        != 0)
+    {
+        throw std::runtime_error("Failed to configure mbedtls");
+    }
+    mbedtls_ssl_conf_rng(&c.conf, mbedtls_ctr_drbg_random, &c.ctr_drbg);
+    // Short timeouts, so the server thread notices stop() and closeSession() quickly
+    mbedtls_ssl_conf_read_timeout(&c.conf, 20);
+    mbedtls_ssl_conf_handshake_timeout(&c.conf, 100, 800);
+    mbedtls_ssl_conf_session_cache(&c.conf, &c, &Context::getSession, &Context::setSession);
+    if (mbedtls_ssl_conf_psk(&c.conf, psk.data(), psk.size(),
+            reinterpret_cast<const unsigned char*>(identity.data()), identity.size())
+            != 0
+        || mbedtls_ssl_cookie_setup(&c.cookie, mbedtls_ctr_drbg_random, &c.ctr_drbg) != 0)
+    {
+        throw std::runtime_error("Failed to configure mbedtls");
+    }
+    mbedtls_ssl_conf_dtls_cookies(&c.conf, mbedtls_ssl_cookie_write, mbedtls_ssl_cookie_check, &c.cookie);
+    if (mbedtls_ssl_setup(&c.ssl, &c.conf) != 0)
+    {
+        throw std::runtime_error("Failed to set up mbedtls");
+    }
+    mbedtls_ssl_set_timer_cb(&c.ssl, &c.timer, mbedtls_timing_set_delay, mbedtls_timing_get_delay);
+    stopRequested = false;
+    server = std::thread(&DtlsTestServer::run, this);
+}
+
+void DtlsTestServer::stop()
+{
+    if (server.joinable())
+    {
+        stopRequested = true;
+        server.join();
+    }
+}
+
+void DtlsTestServer::setHandshakeEnabled(bool enabled)
+{
+    handshakeEnabled = enabled;
+}
+
+void DtlsTestServer::closeSession()
+{
+    closeRequested = true;
+}
+
+std::vector<std::vector<uint8_t>> DtlsTestServer::getMessages() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return messages;
+}
+
+bool DtlsTestServer::waitForMessages(std::size_t count, std::chrono::steady_clock::duration timeout) const
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return received.wait_for(lock, timeout, [&]() { return messages.size() >= count; });
+}
+
+std::size_t DtlsTestServer::getHandshakeCount() const
+{
+    return handshakes;
+}
+
+std::size_t DtlsTestServer::getResumedCount() const
+{
+    return resumed;
+}
+
+void DtlsTestServer::run()
+{
+    Context& c = *context;
+    unsigned char buffer[1024];
+    while (!stopRequested)
+    {
+        if (mbedtls_net_poll(&c.listen_fd, MBEDTLS_NET_POLL_READ, 20) <= 0)
+        {
+            continue;
+        }
+        if (!handshakeEnabled)
+        {
+            // Drop the datagram without answering
+            mbedtls_net_recv(&c.listen_fd, buffer, sizeof(buffer));
+            continue;
+        }
+        mbedtls_ssl_session_reset(&c.ssl);
+        if (mbedtls_net_accept(&c.listen_fd, &c.client_fd, c.clientIp, sizeof(c.clientIp), &c.clientIpLength) != 0)
+        {
+            continue;
+        }
+        mbedtls_ssl_set_bio(&c.ssl, &c.client_fd, mbedtls_net_send, mbedtls_net_recv, mbedtls_net_recv_timeout);
+        if (handshake())
+        {
+            receive();
+        }
+        // The next messages of the client are received by the listening socket again
+        mbedtls_net_free(&c.client_fd);
+    }
+}
+
+bool DtlsTestServer::handshake()
+{
+    Context& c = *context;
+    int ret;
+    while (true)
+    {
+        mbedtls_ssl_set_client_transport_id(&c.ssl, c.clientIp, c.clientIpLength);
+        do
+        {
+            ret = mbedtls_ssl_handshake(&c.ssl);
+        } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+        if (ret != MBEDTLS_ERR_SSL_HELLO_VERIFY_REQUIRED)
+        {
+            break;
+        }
+        // The client sends the hello again with the cookie
+        mbedtls_ssl_session_reset(&c.ssl);
+    }
+    if (ret != 0)
+    {
+        return false;
+    }
+    ++handshakes;
+    return true;
+}
+
+void DtlsTestServer::receive()
+{
+    Context& c = *context;
+    // Maximum record content length, frames for many lights take several kilobytes
+    std::vector<unsigned char> buffer(16384);
+    while (!stopRequested)
+    {
+        if (closeRequested.exchange(false))
+        {
+            mbedtls_ssl_close_notify(&c.ssl);
+            return;
+        }
+        const int ret = mbedtls_ssl_read(&c.ssl, buffer.data(), buffer.size());
+        if (ret > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            messages.emplace_back(buffer.begin(), buffer.begin() + ret);
+            received.notify_all();
+        }
+        else if (ret == MBEDTLS_ERR_SSL_CLIENT_RECONNECT)
+        {
+            // The client started a new handshake from the same port
+            if (!handshake())
+            {
+                return;
+            }
+        }
+        else if (ret != MBEDTLS_ERR_SSL_TIMEOUT && ret != MBEDTLS_ERR_SSL_WANT_READ
+            && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+        {
+            // Closed by the client or failed
+            return;
+        }
+    }
+}
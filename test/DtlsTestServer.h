@@ -0,0 +1,107 @@
+/**
+    \file DtlsTestServer.h
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#ifndef INCLUDE_HUEPLUSPLUS_DTLS_TEST_SERVER_H
+#define INCLUDE_HUEPLUSPLUS_DTLS_TEST_SERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! \brief DTLS server with a pre-shared key, which stands in for the entertainment port of a bridge
+//!
+//! Serves one client at a time on localhost and records the received messages, so EntertainmentMode
+//! can be tested and benchmarked without a bridge. Sessions are cached, so clients can resume them.
+class DtlsTestServer
+{
+public:
+    //! \brief Creates server, does not start it
+    //! \param identity PSK identity, the username of the bridge
+    //! \param pskHex Pre-shared key as hex string, the client key of the bridge
+    //! \param port UDP port to listen on
+    DtlsTestServer(const std::string& identity, const std::string& pskHex, const std::string& port = "2100");
+    DtlsTestServer(const DtlsTestServer&) = delete;
+    DtlsTestServer& operator=(const DtlsTestServer&) = delete;
+    //! \brief Stops the server thread
+    ~DtlsTestServer();
+
+    //! \brief Bind the port and start the server thread
+    //! \throws std::runtime_error when mbedtls could not be set up or the port could not be bound
+    void start();
+
+    //! \brief Stop the server thread
+    void stop();
+
+    //! \brief Ignore all received data, so handshakes time out
+    void setHandshakeEnabled(bool enabled);
+
+    //! \brief Close the current session, like the bridge when no messages are received for some time
+    void closeSession();
+
+    //! \brief Get all received messages
+    std::vector<std::vector<uint8_t>> getMessages() const;
+
+    //! \brief Wait until at least \c count messages were received
+    //! \returns false when the timeout passed before
+    bool waitForMessages(std::size_t count, std::chrono::steady_clock::duration timeout) const;
+
+    //! \brief Get number of successful handshakes, including resumed sessions
+    std::size_t getHandshakeCount() const;
+
+    //! \brief Get number of handshakes where a cached session was resumed
+    std::size_t getResumedCount() const;
+
+private:
+    struct Context;
+
+private:
+    void run();
+    //! \brief Handshake with the connected client, blocks until finished
+    bool handshake();
+    //! \brief Receive messages until the session is closed
+    void receive();
+
+private:
+    std::string identity;
+    std::vector<unsigned char> psk;
+    std::string port;
+    std::unique_ptr<Context> context;
+    std::thread server;
+
+    std::atomic<bool> stopRequested {false};
+    std::atomic<bool> closeRequested {false};
+    std::atomic<bool> handshakeEnabled {true};
+    std::atomic<std::size_t> handshakes {0};
+    std::atomic<std::size_t> resumed {0};
+
+    mutable std::mutex mutex;
+    mutable std::condition_variable received;
+    std::vector<std::vector<uint8_t>> messages;
+};
+
+#endif
@@ -35,11 +35,12 @@ class TestTransaction : public hueplusplus::StateTransaction
 public:
     TestTransaction(hueplusplus::StateTransaction& t) : hueplusplus::StateTransaction(std::move(t)) {}
 
-    nlohmann::json getRequest() const { return request; }
+    nlohmann::json getRequest() const { return request.toJson(); }
     nlohmann::json getResponse() const
     {
         nlohmann::json response;
         const std::string pathPrefix = path + '/';
+        const nlohmann::json request = getRequest();
         for (auto it = request.begin(); it != request.end(); ++it)
         {
             response.push_back({{"success", {{pathPrefix + it.key(), it.value()}}}});
@@ -51,7 +52,7 @@ public:
     decltype(auto) expectPut(const std::shared_ptr<MockHttpHandler>& handler) const
     {
         return EXPECT_CALL(
-            *handler, PUTJson("/api/" + getBridgeUsername() + path, request, getBridgeIp(), getBridgePort()));
+            *handler, PUTJson("/api/" + getBridgeUsername() + path, getRequest(), getBridgeIp(), getBridgePort()));
     }
     decltype(auto) expectSuccessfulPut(const std::shared_ptr<MockHttpHandler>& handler,
         const testing::Cardinality& cardinality = testing::AtLeast(1)) const
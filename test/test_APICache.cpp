@@ -127,6 +127,293 @@ TEST(APICache, refreshBase)
     }
 }
 
+TEST(APICache, refreshInPlace)
+{
+    using namespace ::testing;
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    const std::string path = "/test";
+    const nlohmann::json first = {{"1", {{"name", "a"}, {"state", {{"on", true}, {"xy", {0.1, 0.2}}}}}},
+        {"2", {{"name", "b"}}}, {"3", {{"name", "c"}}}};
+    const nlohmann::json second = {{"1", {{"name", "changed"}, {"state", {{"on", false}, {"xy", {0.3, 0.4}}}}}},
+        {"3", {{"name", 5}}}, {"4", {{"name", "d"}}}};
+    APICache cache(path, commands, c_refreshNever, nullptr);
+    EXPECT_CALL(*handler,
+        GETJson("/api/" + getBridgeUsername() + path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(first))
+        .WillOnce(Return(second));
+    cache.refresh();
+    const nlohmann::json& state = cache.getValue()["1"]["state"];
+    cache.refresh();
+    // Reference to entry which is still present is not invalidated
+    EXPECT_EQ(&state, &cache.getValue()["1"]["state"]);
+    EXPECT_EQ(second, cache.getValue());
+    Mock::VerifyAndClearExpectations(handler.get());
+}
+
+TEST(APICache, setArenaParsing)
+{
+    using namespace ::testing;
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    const std::string path = "/test";
+    const nlohmann::json first = {{"1", {{"name", "a"}, {"state", {{"on", true}, {"xy", {0.1, 0.2}}}}}},
+        {"2", {{"name", "b"}}}, {"3", {{"name", "c"}}}};
+    const nlohmann::json second = {{"1", {{"name", "changed"}, {"state", {{"on", false}, {"xy", {0.3, 0.4}}}}}},
+        {"3", {{"name", 5}}}, {"4", {{"name", "d"}}}, {"5", {1, 2}}};
+    auto cache = std::make_shared<APICache>(path, commands, c_refreshNever, nullptr);
+    EXPECT_FALSE(cache->getArenaParsing());
+    cache->setArenaParsing(true);
+    EXPECT_TRUE(cache->getArenaParsing());
+    EXPECT_CALL(*handler,
+        GETString("/api/" + getBridgeUsername() + path, "application/json", "{}", getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(first.dump()))
+        .WillOnce(Return(second.dump()));
+    cache->refresh();
+    EXPECT_EQ(first, cache->getValue());
+    EXPECT_EQ(nullptr, RefreshArena::current());
+    const nlohmann::json& state = cache->getValue()["1"]["state"];
+    EXPECT_EQ(ErrorCode::none, cache->tryRefresh().code);
+    // Same result as without arena, references to entries which are still present stay valid
+    EXPECT_EQ(&state, &cache->getValue()["1"]["state"]);
+    EXPECT_EQ(second, cache->getValue());
+    Mock::VerifyAndClearExpectations(handler.get());
+
+    // Child caches and entries use the setting of the root
+    APICache child(cache, "1", c_refreshNever);
+    EXPECT_TRUE(child.getArenaParsing());
+    EXPECT_CALL(*handler,
+        GETString("/api/" + getBridgeUsername() + path + "/1", "application/json", "{}", getBridgeIp(),
+            getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"name", "entry"}}.dump()));
+    child.refresh();
+    EXPECT_EQ((nlohmann::json {{"name", "entry"}}), child.getValue());
+    Mock::VerifyAndClearExpectations(handler.get());
+
+    // Error responses
+    const nlohmann::json error = {{{"error", {{"type", 1}, {"address", path}, {"description", "unauthorized user"}}}}};
+    EXPECT_CALL(*handler,
+        GETString("/api/" + getBridgeUsername() + path, "application/json", "{}", getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(error.dump()))
+        .WillOnce(Return(error.dump()))
+        .WillOnce(Return("{\"1\":"));
+    EXPECT_THROW(cache->refresh(), HueAPIResponseException);
+    EXPECT_EQ(ErrorCode::apiError, cache->tryRefresh().code);
+    EXPECT_THROW(cache->refresh(), nlohmann::json::parse_error);
+    EXPECT_EQ(nullptr, RefreshArena::current());
+    EXPECT_EQ(second.at("3"), cache->getValue().at("3"));
+}
+
+TEST(APICache, invalidate)
+{
+    using namespace ::testing;
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    const std::string path = "/test";
+    APICache cache(path, commands, c_refreshNever, nlohmann::json {{"a", 1}});
+    APICache copy = cache;
+    std::function<void()> invalidator = cache.getInvalidator();
+    EXPECT_CALL(*handler,
+        GETJson("/api/" + getBridgeUsername() + path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .Times(2)
+        .WillRepeatedly(Return(nlohmann::json {{"a", 2}}));
+    EXPECT_EQ(1, cache.getValue().at("a"));
+    invalidator();
+    // Refreshes once, even with c_refreshNever
+    EXPECT_EQ(2, cache.getValue().at("a"));
+    EXPECT_EQ(2, cache.getValue().at("a"));
+    // Copies are invalidated as well
+    EXPECT_EQ(2, copy.getValue().at("a"));
+    Mock::VerifyAndClearExpectations(handler.get());
+
+    // Does nothing when all copies are destroyed
+    std::function<void()> destroyed = APICache(path, commands, c_refreshNever, nullptr).getInvalidator();
+    destroyed();
+}
+
+TEST(APICache, refreshEntry)
+{
+    using namespace ::testing;
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    const std::string path = "/test";
+    auto cache = std::make_shared<APICache>(path, commands, c_refreshNever, nullptr);
+    EXPECT_CALL(*handler,
+        GETJson("/api/" + getBridgeUsername() + path + "/a", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"1", 2}}));
+    cache->refreshEntry("a");
+    // Value is not marked as refreshed yet
+    EXPECT_THROW(static_cast<const APICache&>(*cache).getValue(), HueException);
+    cache->markRefreshed();
+    EXPECT_EQ((nlohmann::json {{"a", {{"1", 2}}}}), static_cast<const APICache&>(*cache).getValue());
+
+    // Entry of child cache
+    APICache child(cache, "a", c_refreshNever);
+    EXPECT_CALL(*handler,
+        GETJson("/api/" + getBridgeUsername() + path + "/a/2", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json(3)));
+    child.refreshEntry("2");
+    EXPECT_EQ((nlohmann::json {{"a", {{"1", 2}, {"2", 3}}}}), static_cast<const APICache&>(*cache).getValue());
+}
+
+TEST(APICache, setEntries)
+{
+    using namespace ::testing;
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    const std::string path = "/api/" + getBridgeUsername();
+    auto cache = std::make_shared<APICache>("", commands, c_refreshNever,
+        nlohmann::json {{"lights", {{"1", 1}}}, {"scenes", {{"a", 2}}}, {"rules", nlohmann::json::object()}});
+    EXPECT_TRUE(cache->getEntries().empty());
+    cache->setEntries({"lights", "groups"});
+    EXPECT_EQ((std::vector<std::string> {"lights", "groups"}), cache->getEntries());
+    // Other entries are removed immediately
+    EXPECT_EQ((nlohmann::json {{"lights", {{"1", 1}}}}), cache->getValue());
+
+    // Only the entries are requested
+    EXPECT_CALL(*handler, GETJson(path, _, getBridgeIp(), getBridgePort())).Times(0);
+    EXPECT_CALL(*handler, GETJson(path + "/lights", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"2", 2}}));
+    EXPECT_CALL(*handler, GETJson(path + "/groups", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json::object()));
+    cache->refresh();
+    EXPECT_EQ((nlohmann::json {{"lights", {{"2", 2}}}, {"groups", nlohmann::json::object()}}), cache->getValue());
+    Mock::VerifyAndClearExpectations(handler.get());
+
+    // Child caches of other entries cannot refresh
+    APICache scenes(cache, "scenes", std::chrono::seconds(0));
+    EXPECT_THROW(scenes.refresh(), HueException);
+    EXPECT_EQ(ErrorCode::notFound, scenes.tryRefresh().code);
+    APICache lights(cache, "lights", std::chrono::seconds(0));
+    EXPECT_CALL(*handler, GETJson(path + "/lights", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json::object()));
+    EXPECT_EQ(nlohmann::json::object(), lights.getValue());
+
+    // Failed entry request
+    EXPECT_CALL(*handler, GETJson(path + "/lights", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::connection_refused))));
+    EXPECT_EQ(ErrorCode::connectionFailed, cache->tryRefresh().code);
+    EXPECT_CALL(*handler, GETJson(path + "/lights", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json::object()));
+    EXPECT_CALL(*handler, GETJson(path + "/groups", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json::object()));
+    EXPECT_EQ(ErrorCode::none, cache->tryRefresh().code);
+
+    // Unrestricted again
+    cache->setEntries({});
+    EXPECT_CALL(*handler, GETJson(path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"scenes", nlohmann::json::object()}}));
+    cache->refresh();
+    EXPECT_EQ((nlohmann::json {{"scenes", nlohmann::json::object()}}), cache->getValue());
+}
+
+TEST(APICache, setFilter)
+{
+    using namespace ::testing;
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    const std::string path = "/api/" + getBridgeUsername();
+    const nlohmann::json light = {{"name", "a"}, {"state", {{"on", true}}}, {"swupdate", {{"state", "noupdates"}}}};
+    auto cache = std::make_shared<APICache>("", commands, c_refreshNever, nullptr);
+    EXPECT_TRUE(cache->getFilter().keepsAll());
+    cache->setFilter(JsonFilter({"lights/*/state", "lights/*/name"}));
+    EXPECT_TRUE(cache->getFilter().keeps({"lights", "1", "name"}));
+
+    EXPECT_CALL(*handler, GETJson(path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"lights", {{"1", light}}}, {"scenes", {{"a", 1}}}}));
+    cache->refresh();
+    EXPECT_EQ((nlohmann::json {{"lights", {{"1", {{"name", "a"}, {"state", {{"on", true}}}}}}}}), cache->getValue());
+
+    // Child caches use the part below their path
+    auto lights = std::make_shared<APICache>(cache, "lights", c_refreshNever);
+    APICache child(lights, "1", c_refreshNever);
+    EXPECT_CALL(*handler, GETJson(path + "/lights/1", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(light));
+    child.refresh();
+    EXPECT_EQ((nlohmann::json {{"name", "a"}, {"state", {{"on", true}}}}), child.getValue());
+
+    // Own filter replaces the one of the base cache
+    child.setFilter(JsonFilter({"swupdate"}));
+    EXPECT_CALL(*handler, GETJson(path + "/lights/1", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(light));
+    EXPECT_EQ(ErrorCode::none, child.tryRefresh().code);
+    EXPECT_EQ((nlohmann::json {{"swupdate", {{"state", "noupdates"}}}}), child.getValue());
+}
+
+TEST(APICache, compact)
+{
+    using namespace ::testing;
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    const std::string path = "/api/" + getBridgeUsername();
+    const nlohmann::json light = {{"name", "a"}, {"state", {{"on", true}, {"bri", 254}, {"xy", {0.1, -0.2}}}}};
+    const nlohmann::json state
+        = {{"lights", {{"1", light}, {"2", {{"name", "b"}}}}}, {"config", {{"name", "bridge"}, {"list", {1, 2}}}}};
+    auto cache = std::make_shared<APICache>("", commands, c_refreshNever, nullptr);
+    EXPECT_EQ(0, cache->getCompactDepth());
+    cache->setCompactDepth(2);
+    EXPECT_EQ(2, cache->getCompactDepth());
+    EXPECT_CALL(*handler, GETJson(path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(state));
+    cache->refresh();
+
+    // Child caches only decode their entry
+    APICache lights(cache, "lights", c_refreshNever);
+    const APICache& constLights = lights;
+    EXPECT_EQ(state["lights"], constLights.getValue());
+    cache->compact();
+    EXPECT_EQ(state["lights"], *lights.tryGetValue());
+    cache->compact();
+    APICache config(cache, "config", c_refreshNever);
+    EXPECT_EQ(state["config"], config.getValue());
+
+    // Entries and responses of child caches are encoded
+    EXPECT_CALL(*handler, GETJson(path + "/lights", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"1", light}}));
+    lights.refresh();
+    EXPECT_CALL(*handler, GETJson(path + "/config", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(state["config"]));
+    cache->refreshEntry("config");
+    const APICache& constCache = *cache;
+    EXPECT_EQ((nlohmann::json {{"lights", {{"1", light}}}, {"config", state["config"]}}), constCache.getValue());
+    cache->compact();
+    EXPECT_EQ((nlohmann::json {{"lights", {{"1", light}}}, {"config", state["config"]}}), *constCache.tryGetValue());
+
+    // Disabling decodes everything
+    cache->compact();
+    cache->setCompactDepth(0);
+    EXPECT_EQ(light, constLights.getValue()["1"]);
+}
+
+TEST(APICache, compactKeepsDecodedOnRefresh)
+{
+    using namespace ::testing;
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    const std::string path = "/api/" + getBridgeUsername();
+    nlohmann::json light = {{"name", "a"}, {"state", {{"on", true}, {"bri", 254}}}};
+    auto cache = std::make_shared<APICache>("", commands, c_refreshNever, nullptr);
+    cache->setCompactDepth(2);
+    EXPECT_CALL(*handler, GETJson(path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"lights", {{"1", light}}}}));
+    cache->refresh();
+
+    APICache lights(cache, "lights", c_refreshNever);
+    nlohmann::json& decoded = lights.getValue().at("1");
+    light["state"]["bri"] = 100;
+    const nlohmann::json other = {{"name", "b"}};
+    EXPECT_CALL(*handler, GETJson(path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"lights", {{"1", light}, {"2", other}}}}));
+    cache->refresh();
+    // The decoded entry is updated in place instead of encoded
+    ASSERT_TRUE(decoded.is_object());
+    EXPECT_EQ(light, decoded);
+    EXPECT_EQ(&decoded, &lights.getValue().at("1"));
+    EXPECT_EQ(other, lights.getValue().at("2"));
+    cache->compact();
+    EXPECT_EQ(light, lights.getValue().at("1"));
+}
+
 TEST(APICache, getValue)
 {
     using namespace ::testing;
@@ -206,6 +493,67 @@ TEST(APICache, getValue)
     }
 }
 
+TEST(APICache, tryGetValue)
+{
+    using namespace ::testing;
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+
+    const std::string path = "/test/abc";
+    // No value cached, const does not refresh
+    {
+        const APICache cache(path, commands, c_refreshNever, nullptr);
+        EXPECT_CALL(*handler,
+            GETJson("/api/" + getBridgeUsername() + path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+            .Times(0);
+        Result<const nlohmann::json&> result = cache.tryGetValue();
+        EXPECT_FALSE(result);
+        EXPECT_EQ(ErrorCode::noValue, result.error().code);
+        Mock::VerifyAndClearExpectations(handler.get());
+    }
+    // Successful refresh
+    {
+        APICache cache(path, commands, c_refreshNever, nullptr);
+        nlohmann::json value = {{"a", "b"}};
+        EXPECT_CALL(*handler,
+            GETJson("/api/" + getBridgeUsername() + path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+            .WillOnce(Return(value));
+        Result<nlohmann::json&> result = cache.tryGetValue();
+        ASSERT_TRUE(result);
+        EXPECT_EQ(value, *result);
+        EXPECT_EQ(&*result, &cache.getValue());
+        EXPECT_EQ(&*result, &Const(cache).tryGetValue().value());
+        Mock::VerifyAndClearExpectations(handler.get());
+    }
+    // Error response keeps value
+    {
+        nlohmann::json value = {{"a", "b"}};
+        APICache cache(path, commands, std::chrono::seconds(0), value);
+        const nlohmann::json errorResponse {{"error", {{"type", 1}, {"address", path}, {"description", "Stuff"}}}};
+        EXPECT_CALL(*handler,
+            GETJson("/api/" + getBridgeUsername() + path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+            .WillOnce(Return(errorResponse));
+        Result<nlohmann::json&> result = cache.tryGetValue();
+        EXPECT_FALSE(result);
+        EXPECT_EQ(ErrorCode::apiError, result.error().code);
+        EXPECT_EQ(1, result.error().apiError);
+        EXPECT_THROW(result.value(), HueException);
+        EXPECT_EQ(value, Const(cache).getValue());
+        Mock::VerifyAndClearExpectations(handler.get());
+    }
+    // Entry missing in base cache
+    {
+        auto baseCache = std::make_shared<APICache>("", commands, c_refreshNever, nullptr);
+        APICache cache(baseCache, "abc", c_refreshNever);
+        EXPECT_CALL(
+            *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+            .WillOnce(Return(nlohmann::json {{"def", 1}}));
+        EXPECT_EQ(ErrorCode::notFound, cache.tryGetValue().error().code);
+        EXPECT_EQ(ErrorCode::notFound, Const(cache).tryGetValue().error().code);
+        Mock::VerifyAndClearExpectations(handler.get());
+    }
+}
+
 TEST(APICache, getValueBase)
 {
     using namespace ::testing;
@@ -0,0 +1,118 @@
+/**
+    \file test_ArenaJson.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <hueplusplus/ArenaJson.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+TEST(RefreshArena, allocate)
+{
+    RefreshArena arena(64);
+    EXPECT_EQ(0u, arena.getChunkCount());
+    void* first = arena.allocate(3, 1);
+    void* second = arena.allocate(8, 8);
+    EXPECT_EQ(1u, arena.getChunkCount());
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(second) % 8);
+    EXPECT_GT(static_cast<unsigned char*>(second), static_cast<unsigned char*>(first) + 2);
+    EXPECT_TRUE(arena.owns(first));
+    EXPECT_TRUE(arena.owns(second));
+    int local = 0;
+    EXPECT_FALSE(arena.owns(&local));
+    EXPECT_EQ(11u, arena.getUsedBytes());
+
+    // Larger than the chunk size
+    void* large = arena.allocate(200, 16);
+    EXPECT_EQ(2u, arena.getChunkCount());
+    EXPECT_TRUE(arena.owns(large));
+    EXPECT_TRUE(arena.owns(first));
+}
+
+TEST(RefreshArena, reset)
+{
+    RefreshArena arena(64);
+    arena.allocate(48, 1);
+    arena.allocate(48, 1);
+    arena.allocate(200, 1);
+    EXPECT_EQ(3u, arena.getChunkCount());
+    arena.reset();
+    // Chunks are merged, so the same allocations fit into one chunk
+    EXPECT_EQ(1u, arena.getChunkCount());
+    EXPECT_EQ(0u, arena.getUsedBytes());
+    arena.allocate(48, 1);
+    arena.allocate(48, 1);
+    arena.allocate(200, 1);
+    EXPECT_EQ(1u, arena.getChunkCount());
+}
+
+TEST(RefreshArena, Scope)
+{
+    EXPECT_EQ(nullptr, RefreshArena::current());
+    RefreshArena arena;
+    {
+        RefreshArena::Scope scope(arena);
+        EXPECT_EQ(&arena, RefreshArena::current());
+        {
+            // Nested scope of the same arena does not reset it
+            RefreshArena::Scope inner(arena);
+            arena.allocate(8, 8);
+        }
+        EXPECT_EQ(&arena, RefreshArena::current());
+        EXPECT_EQ(8u, arena.getUsedBytes());
+
+        RefreshArena other;
+        {
+            RefreshArena::Scope otherScope(other);
+            EXPECT_EQ(&other, RefreshArena::current());
+        }
+        EXPECT_EQ(&arena, RefreshArena::current());
+    }
+    EXPECT_EQ(nullptr, RefreshArena::current());
+    EXPECT_EQ(0u, arena.getUsedBytes());
+}
+
+TEST(ArenaJson, allocator)
+{
+    RefreshArena arena;
+    {
+        RefreshArena::Scope scope(arena);
+        ArenaString str(100, 'a');
+        EXPECT_TRUE(arena.owns(str.data()));
+        EXPECT_GE(arena.getUsedBytes(), 100u);
+    }
+    // Without a current arena, memory is allocated from the heap
+    ArenaString str(100, 'a');
+    EXPECT_FALSE(arena.owns(str.data()));
+    EXPECT_EQ(0u, arena.getUsedBytes());
+}
+
+TEST(ArenaJson, toJson)
+{
+    const nlohmann::json value = {{"object", {{"a", 1}, {"b", -2}, {"c", 3u}}}, {"array", {true, 1.5, nullptr}},
+        {"string", "a long string that does not fit into the small string buffer"}};
+    RefreshArena arena;
+    RefreshArena::Scope scope(arena);
+    ArenaJson parsed = ArenaJson::parse(value.dump());
+    EXPECT_TRUE(arena.owns(&parsed["string"].get_ref<const ArenaString&>()));
+    EXPECT_EQ(value, toJson(parsed));
+    EXPECT_EQ(nlohmann::json(), toJson(ArenaJson()));
+}
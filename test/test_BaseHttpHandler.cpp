@@ -159,6 +159,33 @@ TEST(BaseHttpHandler, GETJson)
     EXPECT_EQ(expected, handler.GETJson("UrI", testval, "192.168.2.1", 90));
 }
 
+TEST(BaseHttpHandler, GETJsonFiltered)
+{
+    using namespace ::testing;
+    MockBaseHttpHandler handler;
+
+    nlohmann::json testval;
+    testval["test"] = 100;
+    std::string expected_call = "GET UrI HTTP/1.0\r\nContent-Type: application/json\r\nContent-Length: ";
+    expected_call.append(std::to_string(testval.dump().size()));
+    expected_call.append("\r\n\r\n");
+    expected_call.append(testval.dump());
+    expected_call.append("\r\n\r\n");
+
+    EXPECT_CALL(handler, send(expected_call, "192.168.2.1", 90))
+        .Times(AtLeast(2))
+        .WillOnce(Return(""))
+        .WillOnce(Return("\r\n\r\n"))
+        .WillRepeatedly(Return("\r\n\r\n{\"test\" : \"whatever\", \"other\" : {\"a\" : 1}}"));
+    nlohmann::json expected;
+    expected["test"] = "whatever";
+    JsonFilter filter({"test"});
+
+    EXPECT_THROW(handler.GETJsonFiltered("UrI", testval, filter, "192.168.2.1", 90), HueException);
+    EXPECT_THROW(handler.GETJsonFiltered("UrI", testval, filter, "192.168.2.1", 90), nlohmann::json::parse_error);
+    EXPECT_EQ(expected, handler.GETJsonFiltered("UrI", testval, filter, "192.168.2.1", 90));
+}
+
 TEST(BaseHttpHandler, POSTJson)
 {
     using namespace ::testing;
@@ -211,6 +238,36 @@ TEST(BaseHttpHandler, PUTJson)
     EXPECT_EQ(expected, handler.PUTJson("UrI", testval, "192.168.2.1", 90));
 }
 
+TEST(BaseHttpHandler, PUTSerialized)
+{
+    using namespace ::testing;
+    MockBaseHttpHandler handler;
+
+    nlohmann::json testval;
+    testval["test"] = 100;
+    const std::string body = testval.dump();
+    // Same message as PUTJson
+    std::string expected_call = "PUT /api/UrI HTTP/1.0\r\nContent-Type: application/json\r\nContent-Length: ";
+    expected_call.append(std::to_string(body.size()));
+    expected_call.append("\r\n\r\n");
+    expected_call.append(body);
+    expected_call.append("\r\n\r\n");
+
+    EXPECT_CALL(handler, send(expected_call, "192.168.2.1", 90))
+        .Times(AtLeast(2))
+        .WillOnce(Return(""))
+        .WillOnce(Return("\r\n\r\n"))
+        .WillRepeatedly(Return("\r\n\r\n{\"test\" : \"whatever\"}"));
+    nlohmann::json expected;
+    expected["test"] = "whatever";
+
+    const std::string prefix = "/api/user";
+    const MessagePart prefixPart {prefix.data(), 4};
+    EXPECT_THROW(handler.PUTSerialized(prefixPart, "/UrI", body, "192.168.2.1", 90), HueException);
+    EXPECT_THROW(handler.PUTSerialized(prefixPart, "/UrI", body, "192.168.2.1", 90), nlohmann::json::parse_error);
+    EXPECT_EQ(expected, handler.PUTSerialized(prefixPart, "/UrI", body, "192.168.2.1", 90));
+}
+
 TEST(BaseHttpHandler, DELETEJson)
 {
     using namespace ::testing;
@@ -281,6 +281,43 @@ TEST(Bridge, getLight)
     EXPECT_EQ(test_light_1.getColorType(), ColorType::TEMPERATURE);
 }
 
+TEST(Bridge, getLightAfterRefresh)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    nlohmann::json hue_bridge_state {{"lights",
+        {{"1",
+            {{"state",
+                 {{"on", true}, {"bri", 254}, {"ct", 366}, {"alert", "none"}, {"colormode", "ct"},
+                     {"reachable", true}}},
+                {"swupdate", {{"state", "noupdates"}, {"lastinstall", nullptr}}}, {"type", "Color temperature light"},
+                {"name", "Hue ambiance lamp 1"}, {"modelid", "LTW001"}, {"manufacturername", "Philips"},
+                {"uniqueid", "00:00:00:00:00:00:00:00-00"}, {"swversion", "5.50.1.19085"}}}}}};
+    nlohmann::json refreshed_state = hue_bridge_state;
+    refreshed_state["lights"]["1"]["state"]["on"] = false;
+    refreshed_state["lights"]["1"]["name"] = "New name";
+
+    // The light never requests its own state
+    EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername() + "/lights/1", _, getBridgeIp(), getBridgePort()))
+        .Times(0);
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .Times(2)
+        .WillOnce(Return(hue_bridge_state))
+        .WillOnce(Return(refreshed_state));
+    Bridge test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+
+    Bridge::LightList::Handle light = test_bridge.lights().get(1);
+    EXPECT_TRUE(light->isOn());
+
+    test_bridge.refresh();
+    // Same light, with the state of the refreshed list
+    EXPECT_EQ(light, test_bridge.lights().get(1));
+    EXPECT_FALSE(light->isOn());
+    EXPECT_EQ("New name", light->getName());
+    EXPECT_FALSE(test_bridge.lights().getAll().at(0)->isOn());
+}
+
 TEST(Bridge, SharedState)
 {
     using namespace ::testing;
@@ -379,10 +416,10 @@ TEST(Bridge, getAllLights)
 
     Bridge test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
 
-    std::vector<Light> test_lights = test_bridge.lights().getAll();
+    std::vector<ResourceHandle<Light>> test_lights = test_bridge.lights().getAll();
     ASSERT_EQ(1, test_lights.size());
-    EXPECT_EQ(test_lights[0].getName(), "Hue ambiance lamp 1");
-    EXPECT_EQ(test_lights[0].getColorType(), ColorType::TEMPERATURE);
+    EXPECT_EQ(test_lights[0]->getName(), "Hue ambiance lamp 1");
+    EXPECT_EQ(test_lights[0]->getColorType(), ColorType::TEMPERATURE);
 }
 
 TEST(Bridge, lightExists)
@@ -530,10 +567,10 @@ TEST(Bridge, getAllGroups)
 
     Bridge test_bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
 
-    std::vector<Group> test_groups = test_bridge.groups().getAll();
+    std::vector<ResourceHandle<Group>> test_groups = test_bridge.groups().getAll();
     ASSERT_EQ(1, test_groups.size());
-    EXPECT_EQ(test_groups[0].getName(), "Group 1");
-    EXPECT_EQ(test_groups[0].getType(), "LightGroup");
+    EXPECT_EQ(test_groups[0]->getName(), "Group 1");
+    EXPECT_EQ(test_groups[0]->getType(), "LightGroup");
 }
 
 TEST(Bridge, createGroup)
@@ -558,6 +595,194 @@ TEST(Bridge, createGroup)
     EXPECT_EQ(0, test_bridge.groups().create(create));
 }
 
+TEST(Bridge, bootstrapFullState)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    nlohmann::json bridgeState {{"config", {{"mac", "00:11:22:33:44:55"}}}, {"lights", {{"1", {}}, {"2", {}}}},
+        {"groups", {{"1", {}}}}, {"schedules", nlohmann::json::object()}, {"scenes", nlohmann::json::object()},
+        {"sensors", {{"1", {}}, {"2", {}}, {"3", {}}}}, {"rules", nlohmann::json::object()}};
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(bridgeState));
+    Bridge bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+
+    Bridge::LoadReport report = bridge.bootstrap();
+    EXPECT_EQ(Bridge::LoadMode::fullState, report.mode);
+    std::vector<std::string> names;
+    std::vector<std::size_t> counts;
+    for (const Bridge::ListTiming& timing : report.lists)
+    {
+        names.push_back(timing.name);
+        counts.push_back(timing.count);
+        // All lists are loaded by one request
+        EXPECT_EQ(report.total, timing.duration);
+    }
+    EXPECT_EQ((std::vector<std::string> {"config", "lights", "groups", "schedules", "scenes", "sensors", "rules"}),
+        names);
+    EXPECT_EQ((std::vector<std::size_t> {1, 2, 1, 0, 0, 3, 0}), counts);
+    // No further requests
+    EXPECT_TRUE(bridge.lights().exists(2));
+    EXPECT_FALSE(bridge.groups().exists(2));
+    EXPECT_EQ("00:11:22:33:44:55", bridge.config().getMACAddress());
+}
+
+TEST(Bridge, bootstrapPerList)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    const std::string prefix = "/api/" + getBridgeUsername();
+    Sequence s;
+    EXPECT_CALL(*handler, GETJson(prefix + "/config", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .InSequence(s)
+        .WillOnce(Return(nlohmann::json {{"mac", "00:11:22:33:44:55"}}));
+    EXPECT_CALL(*handler, GETJson(prefix + "/lights", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .InSequence(s)
+        .WillOnce(Return(nlohmann::json {{"1", {}}, {"2", {}}}));
+    for (const char* list : {"/groups", "/schedules", "/scenes", "/sensors", "/rules"})
+    {
+        EXPECT_CALL(*handler, GETJson(prefix + list, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+            .InSequence(s)
+            .WillOnce(Return(nlohmann::json::object()));
+    }
+    Bridge bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+
+    Bridge::LoadReport report = bridge.bootstrap(Bridge::LoadMode::perList);
+    EXPECT_EQ(Bridge::LoadMode::perList, report.mode);
+    ASSERT_EQ(7, report.lists.size());
+    std::chrono::steady_clock::duration sum = std::chrono::steady_clock::duration::zero();
+    for (const Bridge::ListTiming& timing : report.lists)
+    {
+        sum += timing.duration;
+    }
+    EXPECT_EQ(report.total, sum);
+    EXPECT_EQ("lights", report.lists[1].name);
+    EXPECT_EQ(2, report.lists[1].count);
+    EXPECT_EQ(1, report.lists[0].count);
+    // The full state is not requested afterwards
+    EXPECT_TRUE(bridge.lights().exists(2));
+    EXPECT_TRUE(bridge.sensors().getAll().empty());
+    EXPECT_EQ("00:11:22:33:44:55", bridge.config().getMACAddress());
+}
+
+TEST(Bridge, bootstrapPerListError)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    const std::string prefix = "/api/" + getBridgeUsername();
+    EXPECT_CALL(*handler, GETJson(prefix + "/config", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json::object()));
+    EXPECT_CALL(*handler, GETJson(prefix + "/lights", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::connection_refused))));
+    Bridge bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    EXPECT_THROW(bridge.bootstrap(Bridge::LoadMode::perList), std::system_error);
+
+    // State is not marked as up to date, so the next access requests the full state
+    EXPECT_CALL(*handler, GETJson(prefix, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"lights", nlohmann::json::object()}}));
+    EXPECT_TRUE(bridge.lights().getAll().empty());
+}
+
+TEST(Bridge, setSections)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    const std::string prefix = "/api/" + getBridgeUsername();
+    Bridge bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    EXPECT_TRUE(bridge.getSections().empty());
+    bridge.setSections({Bridge::Section::groups, Bridge::Section::lights, Bridge::Section::lights});
+    // Ordered like the full state, without duplicates
+    EXPECT_EQ((std::vector<Bridge::Section> {Bridge::Section::lights, Bridge::Section::groups}), bridge.getSections());
+
+    EXPECT_CALL(*handler, GETJson(prefix, _, getBridgeIp(), getBridgePort())).Times(0);
+    EXPECT_CALL(*handler, GETJson(prefix + "/lights", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"1", {}}}));
+    EXPECT_CALL(*handler, GETJson(prefix + "/groups", nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json::object()));
+    // Uses per list mode, because only some sections are loaded
+    Bridge::LoadReport report = bridge.bootstrap();
+    EXPECT_EQ(Bridge::LoadMode::perList, report.mode);
+    ASSERT_EQ(2, report.lists.size());
+    EXPECT_EQ("lights", report.lists[0].name);
+    EXPECT_EQ(1, report.lists[0].count);
+    EXPECT_EQ("groups", report.lists[1].name);
+
+    EXPECT_TRUE(bridge.lights().exists(1));
+    EXPECT_FALSE(bridge.groups().exists(1));
+    EXPECT_THROW(bridge.scenes().getAll(), HueException);
+    EXPECT_THROW(bridge.config().refresh(true), HueException);
+}
+
+TEST(Bridge, setCompactState)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    const nlohmann::json light = {{"state", {{"on", true}, {"bri", 254}, {"reachable", true}}},
+        {"type", "Dimmable light"}, {"name", "Hue lamp"}, {"modelid", "LWB004"},
+        {"uniqueid", "00:00:00:00:00:00:00:00-00"}, {"swversion", "5.50.1.19085"}};
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"lights", {{"1", light}, {"2", light}}}}));
+    // Shared state is read from the bootstrapped state without further requests
+    Bridge bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler, "", std::chrono::seconds(10), true);
+    bridge.setCompactState(true);
+    Bridge::LoadReport report = bridge.bootstrap();
+    EXPECT_EQ(2, report.lists[1].count);
+
+    ResourceHandle<Light> l = bridge.lights().get(1);
+    EXPECT_EQ("Hue lamp", l->getName());
+    EXPECT_TRUE(l->isOn());
+    bridge.compactState();
+    EXPECT_EQ(254, l->getBrightness());
+    EXPECT_EQ(2, bridge.lights().getAll().size());
+}
+
+TEST(Bridge, setCompactStateTransaction)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    const nlohmann::json light = {{"state", {{"on", true}, {"bri", 254}, {"reachable", true}}},
+        {"type", "Dimmable light"}, {"name", "Hue lamp"}, {"modelid", "LWB004"},
+        {"uniqueid", "00:00:00:00:00:00:00:00-00"}, {"swversion", "5.50.1.19085"}};
+    const std::string lightPath = "/api/" + getBridgeUsername() + "/lights/1";
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"lights", {{"1", light}}}}));
+    Bridge bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler, "", std::chrono::seconds(10), true);
+    bridge.setCompactState(true);
+    bridge.bootstrap();
+
+    ResourceHandle<Light> l = bridge.lights().get(1);
+    StateTransaction transaction = l->transaction();
+    transaction.setBrightness(100);
+    // The refresh keeps the decoded light, so the transaction still applies its changes
+    EXPECT_CALL(*handler, GETJson(lightPath, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(light));
+    l->refresh(true);
+    EXPECT_CALL(*handler, PUTJson(lightPath + "/state", nlohmann::json {{"bri", 100}}, getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{{"success", {{"/lights/1/state/bri", 100}}}}}));
+    EXPECT_TRUE(transaction.commit());
+    const Light& cLight = *l;
+    EXPECT_EQ(100, cLight.getBrightness());
+    EXPECT_EQ("Hue lamp", cLight.getName());
+}
+
+TEST(Bridge, setFilter)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> handler = std::make_shared<MockHttpHandler>();
+    Bridge bridge(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    bridge.setFilter(JsonFilter({"lights/*/name", "lights/*/type"}));
+    EXPECT_TRUE(bridge.getFilter().keeps({"lights", "1", "name"}));
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(nlohmann::json {{"lights", {{"1", {{"name", "a"}, {"modelid", "LCT001"}}}}},
+            {"scenes", {{"1", {{"name", "scene"}}}}}}));
+    Bridge::LoadReport report = bridge.bootstrap();
+    EXPECT_EQ(1, report.lists[1].count);
+    EXPECT_EQ(0, report.lists[4].count);
+}
+
 #define IGNORE_EXCEPTIONS(statement)                                                                                   \
     try                                                                                                                \
     {                                                                                                                  \
@@ -0,0 +1,199 @@
+/**
+    \file test_BridgeManager.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <future>
+#include <thread>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "testhelper.h"
+
+#include "hueplusplus/BridgeManager.h"
+#include "mocks/mock_HttpHandler.h"
+
+using namespace hueplusplus;
+using namespace testing;
+
+class BridgeManagerTest : public Test
+{
+protected:
+    std::shared_ptr<MockHttpHandler> handler;
+    nlohmann::json light;
+    std::string ip1 = "192.168.2.1";
+    std::string ip2 = "192.168.2.2";
+
+protected:
+    BridgeManagerTest()
+        : handler(std::make_shared<MockHttpHandler>()),
+          light({{"state", {{"on", false}, {"bri", 254}, {"reachable", true}}}, {"type", "Dimmable light"},
+              {"name", "Hue lamp"}, {"modelid", "LWB004"}, {"uniqueid", "00:00:00:00:00:00:00:00-00"},
+              {"swversion", "5.50.1.19085"}})
+    { }
+
+    Bridge getBridge(const std::string& ip) { return Bridge(ip, 80, getBridgeUsername(), handler); }
+
+    void expectBridgeState(const std::string& ip, const nlohmann::json& lights)
+    {
+        EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), ip, 80))
+            .WillRepeatedly(Return(nlohmann::json {{"lights", lights}}));
+    }
+};
+
+TEST_F(BridgeManagerTest, addBridge)
+{
+    BridgeManager manager(2);
+    EXPECT_EQ(2, manager.getExecutor().getThreadCount());
+    EXPECT_TRUE(manager.getBridgeNames().empty());
+
+    Bridge& b = manager.addBridge("b", getBridge(ip2));
+    Bridge& a = manager.addBridge("a", getBridge(ip1));
+    EXPECT_EQ(ip1, a.getBridgeIP());
+    EXPECT_EQ(&a, &manager.getBridge("a"));
+    EXPECT_EQ(&b, &manager.getBridge("b"));
+    EXPECT_TRUE(manager.hasBridge("a"));
+    EXPECT_FALSE(manager.hasBridge("c"));
+    EXPECT_EQ((std::vector<std::string> {"a", "b"}), manager.getBridgeNames());
+    EXPECT_THROW(manager.addBridge("a", getBridge(ip1)), HueException);
+    EXPECT_THROW(manager.getBridge("c"), HueException);
+}
+
+TEST_F(BridgeManagerTest, removeBridge)
+{
+    BridgeManager manager(2);
+    manager.addBridge("a", getBridge(ip1));
+    std::atomic<bool> executed {false};
+    manager.submit("a", [&](Bridge&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        executed = true;
+    });
+    EXPECT_TRUE(manager.removeBridge("a"));
+    // Waits for pending tasks
+    EXPECT_TRUE(executed);
+    EXPECT_FALSE(manager.hasBridge("a"));
+    EXPECT_FALSE(manager.removeBridge("a"));
+}
+
+TEST_F(BridgeManagerTest, submitWhileRemoving)
+{
+    BridgeManager manager(2);
+    manager.addBridge("a", getBridge(ip1));
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    manager.submit("a", [released](Bridge&) { released.wait(); });
+    std::future<bool> removed = std::async(std::launch::async, [&]() { return manager.removeBridge("a"); });
+    // Give removeBridge time to start waiting for the strand
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    std::future<std::string> ip = manager.submit("a", [](Bridge& bridge) { return bridge.getBridgeIP(); });
+    release.set_value();
+    EXPECT_TRUE(removed.get());
+    EXPECT_FALSE(manager.hasBridge("a"));
+    // The task keeps the removed bridge alive
+    EXPECT_EQ(ip1, ip.get());
+}
+
+TEST_F(BridgeManagerTest, submit)
+{
+    BridgeManager manager(2);
+    manager.addBridge("a", getBridge(ip1));
+    std::future<std::string> ip = manager.submit("a", [](Bridge& bridge) { return bridge.getBridgeIP(); });
+    EXPECT_EQ(ip1, ip.get());
+    EXPECT_THROW(manager.submit("b", [](Bridge&) { return 0; }), HueException);
+}
+
+TEST_F(BridgeManagerTest, refreshAll)
+{
+    BridgeManager manager(2);
+    manager.addBridge("a", getBridge(ip1));
+    manager.addBridge("b", getBridge(ip2));
+    EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), ip1, 80))
+        .WillOnce(Return(nlohmann::json::object()));
+    EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), ip2, 80))
+        .WillOnce(Return(nlohmann::json::object()));
+    manager.refreshAll();
+
+    // Error of one bridge is rethrown after all are refreshed
+    EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), ip1, 80))
+        .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::connection_refused))));
+    EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), ip2, 80))
+        .WillOnce(Return(nlohmann::json::object()));
+    EXPECT_THROW(manager.refreshAll(), std::system_error);
+}
+
+TEST_F(BridgeManagerTest, bootstrapAll)
+{
+    BridgeManager manager(2);
+    manager.addBridge("a", getBridge(ip1));
+    manager.addBridge("b", getBridge(ip2));
+    expectBridgeState(ip1, {{"1", light}, {"2", light}});
+    expectBridgeState(ip2, {{"1", light}});
+
+    std::map<std::string, Bridge::LoadReport> reports = manager.bootstrapAll();
+    ASSERT_EQ(2, reports.size());
+    EXPECT_EQ("lights", reports["a"].lists[1].name);
+    EXPECT_EQ(2, reports["a"].lists[1].count);
+    EXPECT_EQ(1, reports["b"].lists[1].count);
+}
+
+TEST_F(BridgeManagerTest, getAllLights)
+{
+    BridgeManager manager(2);
+    EXPECT_TRUE(manager.getAllLights().empty());
+    manager.addBridge("b", getBridge(ip2));
+    manager.addBridge("a", getBridge(ip1));
+    expectBridgeState(ip1, {{"2", light}, {"1", light}});
+    expectBridgeState(ip2, {{"1", light}});
+
+    std::vector<LightHandle> lights = manager.getAllLights();
+    EXPECT_EQ((std::vector<LightHandle> {{"a", 1}, {"a", 2}, {"b", 1}}), lights);
+    EXPECT_EQ("a/2", lights[1].toString());
+    EXPECT_EQ(1, manager.getLight(lights[2])->getId());
+    EXPECT_EQ(manager.getBridge("a").lights().get(2), manager.getLight(lights[1]));
+    EXPECT_THROW(manager.getLight({"c", 1}), HueException);
+}
+
+TEST_F(BridgeManagerTest, forEachLight)
+{
+    BridgeManager manager(2);
+    manager.addBridge("a", getBridge(ip1));
+    manager.addBridge("b", getBridge(ip2));
+    expectBridgeState(ip1, {{"1", light}, {"2", light}});
+    expectBridgeState(ip2, {{"1", light}});
+    nlohmann::json reply = {{{"success", {{"/lights/1/state/on", true}}}}};
+    nlohmann::json reply2 = {{{"success", {{"/lights/2/state/on", true}}}}};
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/1/state", _, ip1, 80))
+        .WillOnce(Return(reply));
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/2/state", _, ip1, 80))
+        .WillOnce(Return(reply2));
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/1/state", _, ip2, 80))
+        .WillOnce(Return(nlohmann::json::array()));
+
+    std::vector<std::future<bool>> results = manager.forEachLight(
+        {{"a", 1}, {"b", 1}, {"a", 2}, {"c", 1}, {"b", 5}}, [](Light& l) { return l.on(); });
+    ASSERT_EQ(5, results.size());
+    EXPECT_TRUE(results[0].get());
+    // Empty reply is a failure
+    EXPECT_FALSE(results[1].get());
+    EXPECT_TRUE(results[2].get());
+    // Unknown bridge and light
+    EXPECT_THROW(results[3].get(), HueException);
+    EXPECT_THROW(results[4].get(), HueException);
+}
@@ -0,0 +1,109 @@
+/**
+    \file test_ColorConversion.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <cstdlib>
+#include <vector>
+
+#include <hueplusplus/ColorConversion.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+namespace
+{
+// Colors in a grid over the RGB cube, the count is not a multiple of the block size
+std::vector<RGB> createColors()
+{
+    std::vector<RGB> colors;
+    for (int r = 0; r < 256; r += 15)
+    {
+        for (int g = 0; g < 256; g += 15)
+        {
+            for (int b = 0; b < 256; b += 15)
+            {
+                colors.push_back(RGB {static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b)});
+            }
+        }
+    }
+    colors.push_back(RGB {1, 2, 3});
+    return colors;
+}
+} // namespace
+
+TEST(ColorConversion, convertToXY)
+{
+    const std::vector<RGB> colors = createColors();
+    std::vector<XYBrightness> result(colors.size());
+    convertToXY(colors.data(), colors.size(), result.data());
+    for (std::size_t i = 0; i < colors.size(); ++i)
+    {
+        const XYBrightness expected = colors[i].toXY();
+        EXPECT_NEAR(expected.xy.x, result[i].xy.x, 1e-5f) << i;
+        EXPECT_NEAR(expected.xy.y, result[i].xy.y, 1e-5f) << i;
+        EXPECT_FLOAT_EQ(expected.brightness, result[i].brightness) << i;
+    }
+    // Nothing is written for empty input
+    convertToXY(nullptr, 0, nullptr);
+}
+
+TEST(ColorConversion, convertToXYGamut)
+{
+    const std::vector<RGB> colors = {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {255, 255, 255}, {0, 0, 0}};
+    const std::vector<ColorGamut> gamuts
+        = {gamut::gamutA, gamut::gamutB, gamut::gamutC, gamut::gamutA, gamut::maxGamut};
+    std::vector<XYBrightness> result(colors.size());
+    convertToXY(colors.data(), colors.size(), result.data(), gamuts.data());
+    for (std::size_t i = 0; i < colors.size(); ++i)
+    {
+        const XYBrightness expected = colors[i].toXY(gamuts[i]);
+        EXPECT_NEAR(expected.xy.x, result[i].xy.x, 1e-5f) << i;
+        EXPECT_NEAR(expected.xy.y, result[i].xy.y, 1e-5f) << i;
+        EXPECT_FLOAT_EQ(expected.brightness, result[i].brightness) << i;
+    }
+}
+
+TEST(ColorConversion, convertToRGB)
+{
+    const std::vector<RGB> colors = createColors();
+    std::vector<XYBrightness> xy(colors.size());
+    for (std::size_t i = 0; i < colors.size(); ++i)
+    {
+        xy[i] = colors[i].toXY(gamut::gamutC);
+    }
+    std::vector<RGB> result(colors.size());
+    convertToRGB(xy.data(), xy.size(), result.data());
+    std::vector<ColorGamut> gamuts(colors.size(), gamut::gamutA);
+    std::vector<RGB> corrected(colors.size());
+    convertToRGB(xy.data(), xy.size(), corrected.data(), gamuts.data());
+    for (std::size_t i = 0; i < colors.size(); ++i)
+    {
+        // Lookup table with interpolation differs by rounding
+        const RGB expected = RGB::fromXY(xy[i]);
+        EXPECT_LE(std::abs(expected.r - result[i].r), 1) << i;
+        EXPECT_LE(std::abs(expected.g - result[i].g), 1) << i;
+        EXPECT_LE(std::abs(expected.b - result[i].b), 1) << i;
+        const RGB expectedCorrected = RGB::fromXY(xy[i], gamut::gamutA);
+        EXPECT_LE(std::abs(expectedCorrected.r - corrected[i].r), 1) << i;
+        EXPECT_LE(std::abs(expectedCorrected.g - corrected[i].g), 1) << i;
+        EXPECT_LE(std::abs(expectedCorrected.b - corrected[i].b), 1) << i;
+    }
+}
@@ -19,6 +19,8 @@
     along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
 **/
 
+#include <algorithm>
+#include <cmath>
 #include <random>
 
 #include <hueplusplus/ColorUnits.h>
@@ -217,6 +219,79 @@ TEST(RGB, fromXY)
     EXPECT_LE(maxDiffB, 64);
 }
 
+TEST(ColorUnits, srgb)
+{
+    for (int i = 0; i < 256; ++i)
+    {
+        EXPECT_EQ(srgb::toLinearExact(i / 255.f), srgb::toLinear(static_cast<uint8_t>(i))) << i;
+    }
+    EXPECT_EQ(0.f, srgb::toLinear(0));
+    EXPECT_FLOAT_EQ(1.f, srgb::toLinear(255));
+
+    // Linear part, table and values outside of the table
+    for (float value = 1e-4f; value < 1000.f; value *= 1.001f)
+    {
+        const float exact = srgb::fromLinearExact(value);
+        EXPECT_NEAR(exact, srgb::fromLinear(value), exact * 1e-5f) << value;
+    }
+    EXPECT_EQ(0.f, srgb::fromLinear(0.f));
+    EXPECT_FLOAT_EQ(1.f, srgb::fromLinear(1.f));
+}
+
+TEST(RGB, gammaTable)
+{
+    std::mt19937 rng {12374682};
+    std::uniform_int_distribution<int> dist(0, 255);
+    for (int i = 0; i < 1000; ++i)
+    {
+        const RGB rgb {
+            static_cast<uint8_t>(dist(rng)), static_cast<uint8_t>(dist(rng)), static_cast<uint8_t>(dist(rng))};
+        // Forward table is exact
+        EXPECT_EQ(rgb.toXY(), rgb.toXY(GammaCorrection::table));
+        EXPECT_EQ(rgb.toXY(gamut::gamutB), rgb.toXY(gamut::gamutB, GammaCorrection::table));
+
+        const XYBrightness xy = rgb.toXY();
+        const RGB exact = RGB::fromXY(xy);
+        const RGB table = RGB::fromXY(xy, GammaCorrection::table);
+        EXPECT_LE(std::abs(exact.r - table.r), 1);
+        EXPECT_LE(std::abs(exact.g - table.g), 1);
+        EXPECT_LE(std::abs(exact.b - table.b), 1);
+        const RGB exactGamut = RGB::fromXY(xy, gamut::gamutA);
+        const RGB tableGamut = RGB::fromXY(xy, gamut::gamutA, GammaCorrection::table);
+        EXPECT_LE(std::abs(exactGamut.r - tableGamut.r), 1);
+        EXPECT_LE(std::abs(exactGamut.g - tableGamut.g), 1);
+        EXPECT_LE(std::abs(exactGamut.b - tableGamut.b), 1);
+    }
+}
+
+TEST(GamutTable, toXY)
+{
+    for (const ColorGamut& gamut : {gamut::gamutA, gamut::gamutB, gamut::gamutC, gamut::maxGamut})
+    {
+        const GamutTable table(gamut);
+        EXPECT_EQ(gamut.redCorner, table.getGamut().redCorner);
+        EXPECT_EQ(RGB({0, 0, 0}).toXY(gamut), table.toXY(RGB({0, 0, 0})));
+        // Grid over all colors, including the largest values
+        float maxDiff = 0.f;
+        for (int r = 0; r < 256; r += 5)
+        {
+            for (int g = 0; g < 256; g += 5)
+            {
+                for (int b = 0; b < 256; b += 5)
+                {
+                    const RGB rgb {static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b)};
+                    const XYBrightness expected = rgb.toXY(gamut);
+                    const XYBrightness result = table.toXY(rgb);
+                    EXPECT_EQ(expected.brightness, result.brightness);
+                    maxDiff = std::max(
+                        {maxDiff, std::abs(expected.xy.x - result.xy.x), std::abs(expected.xy.y - result.xy.y)});
+                }
+            }
+        }
+        EXPECT_LT(maxDiff, 2e-4f);
+    }
+}
+
 TEST(ColorUnits, kelvinToMired)
 {
     EXPECT_EQ(10000, kelvinToMired(100));
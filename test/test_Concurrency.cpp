@@ -0,0 +1,371 @@
+/**
+    \file test_Concurrency.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+// These tests are most useful when built with -Dhueplusplus_TSAN=ON, so ThreadSanitizer reports data races.
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "testhelper.h"
+
+#include "hueplusplus/APICache.h"
+#include "hueplusplus/Bridge.h"
+#include "mocks/mock_HttpHandler.h"
+
+using namespace hueplusplus;
+using namespace testing;
+
+namespace
+{
+constexpr int numReaders = 4;
+constexpr int numIterations = 200;
+
+nlohmann::json getLightState(bool on, int bri, const std::string& name)
+{
+    return {{"state", {{"on", on}, {"bri", bri}, {"alert", "none"}, {"reachable", true}, {"effect", "none"}}},
+        {"swupdate", {{"state", "noupdates"}, {"lastinstall", nullptr}}}, {"type", "Dimmable light"},
+        {"name", name}, {"modelid", "LWB004"}, {"manufacturername", "Philips"}, {"productname", "Hue bloom"},
+        {"uniqueid", "00:00:00:00:00:00:00:00-00"}, {"swversion", "5.50.1.19085"}};
+}
+
+// Runs all functions in parallel and waits until they are finished
+void runParallel(const std::vector<std::function<void()>>& functions)
+{
+    std::atomic<bool> start {false};
+    std::vector<std::thread> threads;
+    for (const auto& f : functions)
+    {
+        threads.emplace_back([&start, &f]() {
+            while (!start)
+            {
+                std::this_thread::yield();
+            }
+            f();
+        });
+    }
+    start = true;
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+}
+} // namespace
+
+class ConcurrencyTest : public TestWithParam<bool>
+{
+protected:
+    std::shared_ptr<MockHttpHandler> handler;
+    nlohmann::json lightA;
+    nlohmann::json lightB;
+    nlohmann::json bridgeState;
+    std::string lightsPath;
+
+protected:
+    ConcurrencyTest()
+        : handler(std::make_shared<MockHttpHandler>()),
+          lightA(getLightState(true, 100, "A")),
+          lightB(getLightState(false, 200, "B")),
+          bridgeState({{"lights", {{"1", lightA}, {"2", lightB}}}}),
+          lightsPath("/api/" + getBridgeUsername() + "/lights")
+    {
+        EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername(), nlohmann::json::object(), getBridgeIp(), 80))
+            .Times(AtLeast(1))
+            .WillRepeatedly(Return(bridgeState));
+        // With shared state, lights are refreshed separately on first access
+        EXPECT_CALL(*handler, GETJson(lightsPath + "/1", nlohmann::json::object(), getBridgeIp(), 80))
+            .WillRepeatedly(Return(lightA));
+        EXPECT_CALL(*handler, GETJson(lightsPath + "/2", nlohmann::json::object(), getBridgeIp(), 80))
+            .WillRepeatedly(Return(lightB));
+    }
+
+    Bridge getBridge()
+    {
+        return Bridge(
+            getBridgeIp(), getBridgePort(), getBridgeUsername(), handler, "", std::chrono::seconds(10), GetParam());
+    }
+};
+
+TEST_P(ConcurrencyTest, readWhileRefresh)
+{
+    Bridge bridge = getBridge();
+    ResourceHandle<Light> handle = bridge.lights().get(1);
+    Light& light = *handle;
+    const Light& cLight = light;
+    EXPECT_EQ("A", light.getName());
+    // Refreshes alternate between two different states
+    std::atomic<int> refreshCount {0};
+    EXPECT_CALL(*handler, GETJson(lightsPath + "/1", nlohmann::json::object(), getBridgeIp(), 80))
+        .WillRepeatedly(InvokeWithoutArgs([&]() { return (++refreshCount % 2) ? lightB : lightA; }));
+
+    std::atomic<int> mismatches {0};
+    std::vector<std::function<void()>> functions;
+    for (int i = 0; i < numReaders; ++i)
+    {
+        functions.emplace_back([&]() {
+            for (int j = 0; j < numIterations; ++j)
+            {
+                std::string name = cLight.getName();
+                if (name != "A" && name != "B")
+                {
+                    ++mismatches;
+                }
+                cLight.isOn();
+                cLight.getBrightness();
+                cLight.getDecodedState();
+            }
+        });
+    }
+    functions.emplace_back([&]() {
+        for (int j = 0; j < numIterations; ++j)
+        {
+            light.refresh(true);
+        }
+    });
+    runParallel(functions);
+    EXPECT_EQ(0, mismatches);
+    EXPECT_EQ(numIterations, refreshCount);
+    // Even number of refreshes restores the first state
+    EXPECT_EQ("A", cLight.getName());
+    EXPECT_TRUE(cLight.isOn());
+}
+
+TEST_P(ConcurrencyTest, listAccessWhileRefresh)
+{
+    EXPECT_CALL(*handler, GETJson(lightsPath, nlohmann::json::object(), getBridgeIp(), 80))
+        .WillRepeatedly(Return(bridgeState["lights"]));
+    Bridge bridge = getBridge();
+
+    std::atomic<int> mismatches {0};
+    std::vector<std::function<void()>> functions;
+    for (int i = 0; i < numReaders; ++i)
+    {
+        functions.emplace_back([&]() {
+            for (int j = 0; j < numIterations; ++j)
+            {
+                if (bridge.lights().get(2)->getName() != "B" || !bridge.lights().exists(1)
+                    || bridge.lights().getAll().size() != 2)
+                {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    functions.emplace_back([&]() {
+        for (int j = 0; j < numIterations; ++j)
+        {
+            bridge.lights().refresh();
+        }
+    });
+    runParallel(functions);
+    EXPECT_EQ(0, mismatches);
+}
+
+TEST_P(ConcurrencyTest, commitWhileReading)
+{
+    // Confirm all brightness changes
+    EXPECT_CALL(*handler, PUTJson(lightsPath + "/1/state", _, getBridgeIp(), 80))
+        .WillRepeatedly(Invoke([](const std::string&, const nlohmann::json& body, const std::string&, int) {
+            nlohmann::json reply = nlohmann::json::array();
+            for (auto it = body.begin(); it != body.end(); ++it)
+            {
+                reply.push_back({{"success", {{"/lights/1/state/" + it.key(), it.value()}}}});
+            }
+            return reply;
+        }));
+    Bridge bridge = getBridge();
+    ResourceHandle<Light> handle = bridge.lights().get(1);
+    Light& light = *handle;
+    const Light& cLight = light;
+    EXPECT_EQ(100, light.getBrightness());
+
+    std::atomic<int> failures {0};
+    std::vector<std::function<void()>> functions;
+    for (int i = 0; i < numReaders; ++i)
+    {
+        functions.emplace_back([&]() {
+            for (int j = 0; j < numIterations; ++j)
+            {
+                const unsigned int bri = cLight.getBrightness();
+                if (bri != 100 && (bri < 10 || bri >= 10 + numReaders))
+                {
+                    ++failures;
+                }
+            }
+        });
+        functions.emplace_back([&, i]() {
+            for (int j = 0; j < numIterations / 10; ++j)
+            {
+                if (!light.transaction().setBrightness(static_cast<uint8_t>(10 + i)).commit(false))
+                {
+                    ++failures;
+                }
+            }
+        });
+    }
+    runParallel(functions);
+    EXPECT_EQ(0, failures);
+    EXPECT_TRUE(cLight.isOn());
+}
+
+TEST_P(ConcurrencyTest, readDuringGetterRefresh)
+{
+    Bridge bridge = getBridge();
+    ResourceHandle<Light> handle = bridge.lights().get(1);
+    Light& light = *handle;
+    const Light& cLight = light;
+    EXPECT_EQ("A", light.getName());
+    light.setRefreshDuration(std::chrono::seconds(0));
+
+    // Another thread must be able to read while the getter waits for the response
+    bool readDuringRequest = false;
+    std::future<std::string> name;
+    EXPECT_CALL(*handler, GETJson(lightsPath + "/1", nlohmann::json::object(), getBridgeIp(), 80))
+        .WillOnce(InvokeWithoutArgs([&]() {
+            name = std::async(std::launch::async, [&]() { return cLight.getName(); });
+            readDuringRequest = name.wait_for(std::chrono::seconds(1)) == std::future_status::ready;
+            return lightB;
+        }));
+    EXPECT_EQ("B", light.getName());
+    EXPECT_TRUE(readDuringRequest);
+    EXPECT_EQ("A", name.get());
+}
+
+TEST_P(ConcurrencyTest, parallelReaders)
+{
+    Bridge bridge = getBridge();
+    bridge.setCompactState(true);
+    ResourceHandle<Light> handleA = bridge.lights().get(1);
+    ResourceHandle<Light> handleB = bridge.lights().get(2);
+    handleB->setStateDecoding(true);
+    EXPECT_EQ("A", handleA->getName());
+    EXPECT_EQ(200, handleB->getBrightness());
+    // Readers decode the compact state again
+    bridge.compactState();
+    const Light& cLightA = *handleA;
+    const Light& cLightB = *handleB;
+
+    std::atomic<int> mismatches {0};
+    std::vector<std::function<void()>> functions;
+    for (int i = 0; i < 2 * numReaders; ++i)
+    {
+        functions.emplace_back([&]() {
+            for (int j = 0; j < numIterations; ++j)
+            {
+                if (cLightA.getName() != "A" || !cLightA.isOn() || cLightA.getBrightness() != 100
+                    || cLightB.getName() != "B" || cLightB.isOn() || cLightB.getDecodedState().bri != 200)
+                {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    runParallel(functions);
+    EXPECT_EQ(0, mismatches);
+}
+
+TEST_P(ConcurrencyTest, commitAfterRemovingRefresh)
+{
+    EXPECT_CALL(*handler, PUTJson(lightsPath + "/1/state", _, getBridgeIp(), 80))
+        .WillOnce(Return(nlohmann::json {{{"success", {{"/lights/1/state/bri", 50}}}}}));
+    Bridge bridge = getBridge();
+    ResourceHandle<Light> handle = bridge.lights().get(1);
+    StateTransaction transaction = handle->transaction();
+    transaction.setBrightness(50);
+
+    // The light is removed from the cached state before the transaction is committed
+    EXPECT_CALL(*handler, GETJson(lightsPath, nlohmann::json::object(), getBridgeIp(), 80))
+        .WillOnce(Return(nlohmann::json {{"2", lightB}}));
+    bridge.lights().refresh();
+    EXPECT_FALSE(bridge.lights().exists(1));
+    EXPECT_TRUE(transaction.commit());
+}
+
+INSTANTIATE_TEST_SUITE_P(SharedState, ConcurrencyTest, Values(false, true));
+
+TEST(APICacheConcurrency, readersShareLock)
+{
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+    auto root = std::make_shared<APICache>("", commands, c_refreshNever,
+        nlohmann::json {{"lights", {{"1", getLightState(true, 100, "A")}}}});
+    root->setCompactDepth(2);
+    auto lights = std::make_shared<APICache>(root, "lights", c_refreshNever);
+    const APICache light(lights, "1", c_refreshNever);
+
+    // Every reader waits until all readers hold the shared lock at the same time
+    std::atomic<int> holding {0};
+    std::atomic<int> mismatches {0};
+    std::vector<std::function<void()>> functions;
+    for (int i = 0; i < numReaders; ++i)
+    {
+        functions.emplace_back([&]() {
+            auto lock = light.lockShared();
+            ++holding;
+            const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (holding < numReaders && std::chrono::steady_clock::now() < timeout)
+            {
+                std::this_thread::yield();
+            }
+            // Fails after the timeout when the readers block each other
+            if (holding < numReaders || light.getValue().at("name") != "A")
+            {
+                ++mismatches;
+            }
+        });
+    }
+    runParallel(functions);
+    EXPECT_EQ(0, mismatches);
+}
+
+TEST(BridgeFinderConcurrency, addUsername)
+{
+    auto handler = std::make_shared<MockHttpHandler>();
+    BridgeFinder finder(handler);
+    BridgeFinder::BridgeIdentification bridgeId {getBridgeIp(), getBridgePort(), getBridgeMac()};
+    finder.addUsername(getBridgeMac(), getBridgeUsername());
+
+    std::atomic<int> mismatches {0};
+    std::vector<std::function<void()>> functions;
+    for (int i = 0; i < numReaders; ++i)
+    {
+        functions.emplace_back([&, i]() {
+            for (int j = 0; j < numIterations; ++j)
+            {
+                finder.addUsername(std::to_string(i * numIterations + j), "user");
+                finder.addClientKey(getBridgeMac(), "key");
+                if (finder.getBridge(bridgeId).getUsername() != getBridgeUsername())
+                {
+                    ++mismatches;
+                }
+                finder.getAllUsernames();
+            }
+        });
+    }
+    runParallel(functions);
+    EXPECT_EQ(0, mismatches);
+    EXPECT_EQ(numReaders * numIterations + 1, finder.getAllUsernames().size());
+}
@@ -0,0 +1,194 @@
+/**
+    \file test_EffectTimeline.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <hueplusplus/EffectTimeline.h>
+#include <hueplusplus/HueException.h>
+#include <hueplusplus/HueStream.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+using std::chrono::milliseconds;
+
+TEST(EffectTimeline, addKeyframe)
+{
+    EffectTimeline timeline(2);
+    EXPECT_EQ(2, timeline.getLightCount());
+    EXPECT_EQ(0, timeline.getKeyframeCount(0));
+    timeline.addKeyframe(0, milliseconds(100), RGB {255, 0, 0});
+    timeline.addKeyframe(0, milliseconds(0), RGB {0, 255, 0});
+    EXPECT_EQ(2, timeline.getKeyframeCount(0));
+    EXPECT_EQ(0, timeline.getKeyframeCount(1));
+    // Inserted sorted by time
+    EXPECT_EQ(RGB({0, 255, 0}), timeline.getColor(0, milliseconds(0)));
+    EXPECT_EQ(RGB({255, 0, 0}), timeline.getColor(0, milliseconds(100)));
+    // Light without keyframes is black
+    EXPECT_EQ(RGB({0, 0, 0}), timeline.getColor(1, milliseconds(0)));
+
+    EXPECT_THROW(timeline.addKeyframe(2, milliseconds(0), RGB {0, 0, 0}), HueException);
+    EXPECT_THROW(timeline.getKeyframeCount(2), HueException);
+    EXPECT_THROW(timeline.getColor(2, milliseconds(0)), HueException);
+
+    timeline.clear(0);
+    EXPECT_EQ(0, timeline.getKeyframeCount(0));
+    timeline.addKeyframe(1, milliseconds(0), RGB {0, 0, 0});
+    timeline.clear();
+    EXPECT_EQ(0, timeline.getKeyframeCount(1));
+}
+
+TEST(EffectTimeline, getColor)
+{
+    EffectTimeline timeline(1);
+    timeline.addKeyframe(0, milliseconds(100), RGB {0, 0, 0});
+    timeline.addKeyframe(0, milliseconds(200), RGB {255, 255, 255});
+    // Color of the first and last keyframe outside of the keyframes
+    EXPECT_EQ(RGB({0, 0, 0}), timeline.getColor(0, milliseconds(0)));
+    EXPECT_EQ(RGB({255, 255, 255}), timeline.getColor(0, milliseconds(300)));
+    // Half of the perceived lightness, which is a quarter of the linear intensity
+    EXPECT_EQ(RGB({99, 99, 99}), timeline.getColor(0, milliseconds(150)));
+
+    // Same time replaces the color from then on
+    timeline.addKeyframe(0, milliseconds(200), RGB {255, 0, 0});
+    EXPECT_EQ(RGB({255, 0, 0}), timeline.getColor(0, milliseconds(200)));
+    EXPECT_EQ(RGB({99, 99, 99}), timeline.getColor(0, milliseconds(150)));
+}
+
+TEST(EffectTimeline, easing)
+{
+    EffectTimeline timeline(5);
+    const Easing easings[] = {Easing::step, Easing::linear, Easing::easeIn, Easing::easeOut, Easing::easeInOut};
+    for (std::size_t i = 0; i < 5; ++i)
+    {
+        timeline.addKeyframe(i, milliseconds(0), RGB {0, 0, 0}, easings[i]);
+        timeline.addKeyframe(i, milliseconds(1000), RGB {255, 255, 255});
+    }
+    std::vector<uint8_t> message = huestream::createMessage({1, 2, 3, 4, 5}, huestream::ColorSpace::xyBrightness);
+    // Brightness is the gamma corrected value of lightness cubed
+    auto brightness = [&](std::size_t i) { return huestream::getChannel(message, i, 2) / 65535.f; };
+    auto expected = [](float lightness) { return srgb::fromLinearExact(lightness * lightness * lightness); };
+
+    timeline.evaluate(milliseconds(500), message);
+    EXPECT_EQ(0, brightness(0));
+    EXPECT_NEAR(expected(0.5f), brightness(1), 1e-4f);
+    EXPECT_NEAR(expected(0.125f), brightness(2), 1e-4f);
+    EXPECT_NEAR(expected(0.875f), brightness(3), 1e-4f);
+    EXPECT_NEAR(expected(0.5f), brightness(4), 1e-4f);
+
+    timeline.evaluate(milliseconds(250), message);
+    EXPECT_EQ(0, brightness(0));
+    EXPECT_NEAR(expected(0.25f), brightness(1), 1e-4f);
+    EXPECT_NEAR(expected(0.015625f), brightness(2), 1e-4f);
+    EXPECT_NEAR(expected(0.578125f), brightness(3), 1e-4f);
+    EXPECT_NEAR(expected(0.0625f), brightness(4), 1e-4f);
+
+    timeline.evaluate(milliseconds(1000), message);
+    for (std::size_t i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ(65535, huestream::getChannel(message, i, 2)) << i;
+    }
+}
+
+TEST(EffectTimeline, loop)
+{
+    EffectTimeline timeline(1);
+    EXPECT_EQ(milliseconds(0), timeline.getLoopDuration());
+    timeline.addKeyframe(0, milliseconds(0), RGB {255, 0, 0}, Easing::step);
+    timeline.addKeyframe(0, milliseconds(500), RGB {0, 0, 255}, Easing::step);
+    EXPECT_EQ(RGB({0, 0, 255}), timeline.getColor(0, milliseconds(1200)));
+
+    timeline.setLoopDuration(milliseconds(1000));
+    EXPECT_EQ(milliseconds(1000), timeline.getLoopDuration());
+    EXPECT_EQ(RGB({255, 0, 0}), timeline.getColor(0, milliseconds(1200)));
+    EXPECT_EQ(RGB({0, 0, 255}), timeline.getColor(0, milliseconds(1700)));
+    EXPECT_EQ(RGB({0, 0, 255}), timeline.getColor(0, milliseconds(-200)));
+}
+
+TEST(EffectTimeline, evaluateRGB)
+{
+    EffectTimeline timeline(3);
+    timeline.addKeyframe(0, milliseconds(0), RGB {255, 0, 0});
+    timeline.addKeyframe(1, milliseconds(0), RGB {0, 0, 0});
+    timeline.addKeyframe(1, milliseconds(100), RGB {0, 255, 0});
+    std::vector<uint8_t> message = huestream::createMessage({1, 2, 3}, huestream::ColorSpace::rgb);
+    huestream::setChannels(message, 2, 1, 2, 3);
+
+    timeline.evaluate(milliseconds(100), message);
+    const std::vector<uint8_t> expected = {0x00, 0x00, 0x01, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+        0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x01, 0x00, 0x02, 0x00, 0x03};
+    EXPECT_EQ(expected, std::vector<uint8_t>(message.begin() + huestream::headerSize, message.end()));
+
+    // 16 bit channels between the 8 bit values
+    timeline.evaluate(milliseconds(1), message);
+    EXPECT_GT(huestream::getChannel(message, 1, 1), 0);
+    EXPECT_LT(huestream::getChannel(message, 1, 1), 257);
+
+    // Fewer lights in the message
+    std::vector<uint8_t> small = huestream::createMessage({1}, huestream::ColorSpace::rgb);
+    timeline.evaluate(milliseconds(0), small);
+    EXPECT_EQ(65535, huestream::getChannel(small, 0, 0));
+}
+
+TEST(EffectTimeline, evaluateXY)
+{
+    EffectTimeline timeline(3);
+    timeline.addKeyframe(0, milliseconds(0), RGB {255, 0, 0});
+    timeline.addKeyframe(1, milliseconds(0), RGB {30, 200, 120});
+    timeline.addKeyframe(2, milliseconds(0), RGB {0, 0, 0});
+    std::vector<uint8_t> message = huestream::createMessage({1, 2, 3}, huestream::ColorSpace::xyBrightness);
+    const ColorGamut gamuts[] = {gamut::gamutA, gamut::gamutC, gamut::gamutC};
+    timeline.evaluate(milliseconds(0), message, gamuts);
+
+    const RGB colors[] = {{255, 0, 0}, {30, 200, 120}, {0, 0, 0}};
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        const XYBrightness expected = colors[i].toXY(gamuts[i]);
+        EXPECT_NEAR(expected.xy.x, huestream::getChannel(message, i, 0) / 65535.f, 1e-3f) << i;
+        EXPECT_NEAR(expected.xy.y, huestream::getChannel(message, i, 1) / 65535.f, 1e-3f) << i;
+        EXPECT_NEAR(expected.brightness, huestream::getChannel(message, i, 2) / 65535.f, 1e-3f) << i;
+    }
+}
+
+TEST(EffectTimeline, render)
+{
+    EffectTimeline timeline(2);
+    timeline.addKeyframe(0, milliseconds(0), RGB {0, 0, 0});
+    timeline.addKeyframe(0, milliseconds(100), RGB {255, 128, 0});
+    timeline.addKeyframe(1, milliseconds(50), RGB {0, 0, 255}, Easing::easeInOut);
+    timeline.addKeyframe(1, milliseconds(80), RGB {255, 255, 0});
+    const std::vector<uint8_t> message = huestream::createMessage({1, 2}, huestream::ColorSpace::rgb);
+
+    std::vector<uint8_t> output = {0xAA};
+    timeline.render(milliseconds(0), milliseconds(20), 6, message, output);
+    ASSERT_EQ(1 + 6 * message.size(), output.size());
+    EXPECT_EQ(0xAA, output[0]);
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        std::vector<uint8_t> frame = message;
+        timeline.evaluate(milliseconds(20 * i), frame);
+        const auto begin = output.begin() + 1 + i * message.size();
+        EXPECT_EQ(frame, std::vector<uint8_t>(begin, begin + message.size())) << i;
+    }
+
+    // Rendering twice gives the same frames
+    std::vector<uint8_t> second = {0xAA};
+    timeline.render(milliseconds(0), milliseconds(20), 6, message, second);
+    EXPECT_EQ(output, second);
+}
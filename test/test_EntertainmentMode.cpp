@@ -0,0 +1,339 @@
+/**
+    \file test_EntertainmentMode.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+    Copyright (C) 2020  Moritz Wirger	- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "DtlsTestServer.h"
+#include "testhelper.h"
+
+#include "hueplusplus/EntertainmentMode.h"
+#include "hueplusplus/HueException.h"
+#include "hueplusplus/LibConfig.h"
+#include "mocks/mock_HttpHandler.h"
+
+using namespace hueplusplus;
+using namespace testing;
+
+namespace
+{
+class EntertainmentConfig : public Config
+{
+public:
+    EntertainmentConfig(std::chrono::steady_clock::duration keepAlive)
+    {
+        entertainmentHandshakeTimeout = std::chrono::milliseconds(500);
+        entertainmentKeepAliveInterval = keepAlive;
+    }
+};
+
+const std::string clientKey = "0123456789abcdef0123456789abcdef";
+} // namespace
+
+class EntertainmentModeTest : public Test
+{
+protected:
+    std::shared_ptr<MockHttpHandler> handler;
+    Bridge bridge;
+    Group group;
+    DtlsTestServer server;
+    Config savedConfig;
+
+protected:
+    EntertainmentModeTest()
+        : handler(std::make_shared<MockHttpHandler>()),
+          bridge("127.0.0.1", getBridgePort(), getBridgeUsername(), handler, clientKey),
+          group(1, HueCommandAPI("127.0.0.1", getBridgePort(), getBridgeUsername(), handler),
+              std::chrono::steady_clock::duration::max(),
+              {{"name", "Entertainment"}, {"type", "Entertainment"}, {"lights", nlohmann::json::array()},
+                  {"action", nlohmann::json::object()}, {"state", nlohmann::json::object()}}),
+          server(getBridgeUsername(), clientKey),
+          savedConfig(Config::instance())
+    {
+        // Streaming is enabled and disabled on the bridge with PUT requests
+        EXPECT_CALL(*handler,
+            PUTJson("/api/" + getBridgeUsername() + "/groups/1", _, "127.0.0.1", getBridgePort()))
+            .WillRepeatedly(Invoke([](const std::string&, const nlohmann::json& body, const std::string&, int) {
+                return nlohmann::json {{{"success", {{"/groups/1/stream/active", body["stream"]["active"]}}}}};
+            }));
+        Config::instance() = EntertainmentConfig(std::chrono::steady_clock::duration::zero());
+        server.start();
+    }
+    ~EntertainmentModeTest() { Config::instance() = savedConfig; }
+
+    // Adds color lights with the given ids to the bridge and returns an entertainment group of them
+    Group createGroup(const std::vector<int>& lightIds)
+    {
+        nlohmann::json lights = nlohmann::json::object();
+        nlohmann::json groupLights = nlohmann::json::array();
+        for (int id : lightIds)
+        {
+            lights[std::to_string(id)] = {{"state", {{"on", true}, {"bri", 254}, {"colormode", "xy"}}},
+                {"type", "Extended color light"}, {"name", "Hue color lamp " + std::to_string(id)},
+                {"modelid", "LCT016"}, {"swversion", "1.50.2_r30933"}};
+            groupLights.push_back(std::to_string(id));
+        }
+        EXPECT_CALL(*handler, GETJson("/api/" + getBridgeUsername(), _, "127.0.0.1", getBridgePort()))
+            .WillRepeatedly(Return(nlohmann::json {{"lights", lights}}));
+        return Group(1, HueCommandAPI("127.0.0.1", getBridgePort(), getBridgeUsername(), handler),
+            std::chrono::steady_clock::duration::max(),
+            {{"name", "Entertainment"}, {"type", "Entertainment"}, {"lights", groupLights},
+                {"action", nlohmann::json::object()}, {"state", nlohmann::json::object()}});
+    }
+
+    // Connects, sends the current colors and returns the message received by the server
+    std::vector<uint8_t> receive(EntertainmentMode& entertainment)
+    {
+        if (entertainment.getConnectionState() != ConnectionState::connected)
+        {
+            EXPECT_TRUE(entertainment.connect());
+        }
+        const std::size_t count = server.getMessages().size() + 1;
+        EXPECT_TRUE(entertainment.update());
+        EXPECT_TRUE(server.waitForMessages(count, std::chrono::seconds(2)));
+        return server.getMessages().back();
+    }
+};
+
+TEST_F(EntertainmentModeTest, connect)
+{
+    EntertainmentMode entertainment(bridge, group);
+    EXPECT_EQ(ConnectionState::disconnected, entertainment.getConnectionState());
+    ASSERT_TRUE(entertainment.connect());
+    EXPECT_EQ(ConnectionState::connected, entertainment.getConnectionState());
+
+    EXPECT_TRUE(entertainment.update());
+    ASSERT_TRUE(server.waitForMessages(1, std::chrono::seconds(2)));
+    // The server counts the handshake after the client finished it, so only check after it received a message
+    EXPECT_EQ(1, server.getHandshakeCount());
+    const std::vector<uint8_t> message = server.getMessages().front();
+    EXPECT_EQ("HueStream", std::string(message.begin(), message.begin() + 9));
+
+    EXPECT_TRUE(entertainment.disconnect());
+    EXPECT_EQ(ConnectionState::disconnected, entertainment.getConnectionState());
+}
+
+TEST_F(EntertainmentModeTest, pollConnect)
+{
+    EntertainmentMode entertainment(bridge, group);
+    ASSERT_TRUE(entertainment.startConnect());
+    EXPECT_EQ(ConnectionState::handshaking, entertainment.getConnectionState());
+    EXPECT_FALSE(entertainment.startConnect());
+    ConnectionState state;
+    while ((state = entertainment.pollConnect()) == ConnectionState::handshaking)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(ConnectionState::connected, state);
+    EXPECT_TRUE(entertainment.update());
+    EXPECT_TRUE(server.waitForMessages(1, std::chrono::seconds(2)));
+}
+
+TEST_F(EntertainmentModeTest, handshakeTimeout)
+{
+    server.setHandshakeEnabled(false);
+    EntertainmentMode entertainment(bridge, group);
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(entertainment.connect());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_EQ(ConnectionState::disconnected, entertainment.getConnectionState());
+    EXPECT_FALSE(entertainment.update());
+
+    // Connecting again works when the server answers
+    server.setHandshakeEnabled(true);
+    EXPECT_TRUE(entertainment.connect());
+}
+
+TEST_F(EntertainmentModeTest, keepAlive)
+{
+    Config::instance() = EntertainmentConfig(std::chrono::milliseconds(50));
+    EntertainmentMode entertainment(bridge, group);
+    ASSERT_TRUE(entertainment.connect());
+    EXPECT_TRUE(entertainment.update());
+    // The frame is sent again without calling update
+    ASSERT_TRUE(server.waitForMessages(4, std::chrono::seconds(2)));
+    const std::vector<std::vector<uint8_t>> messages = server.getMessages();
+    for (const std::vector<uint8_t>& message : messages)
+    {
+        EXPECT_EQ(messages.front(), message);
+    }
+}
+
+TEST_F(EntertainmentModeTest, reconnect)
+{
+    EntertainmentMode entertainment(bridge, group);
+    EXPECT_FALSE(entertainment.reconnect());
+    ASSERT_TRUE(entertainment.connect());
+    EXPECT_TRUE(entertainment.update());
+    ASSERT_TRUE(server.waitForMessages(1, std::chrono::seconds(2)));
+
+    // The session is resumed when the bridge closed the connection
+    server.closeSession();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // Sending starts the reconnect without waiting for the handshake
+    EXPECT_FALSE(entertainment.update());
+    EXPECT_EQ(ConnectionState::handshaking, entertainment.getConnectionState());
+    ConnectionState state;
+    while ((state = entertainment.pollConnect()) == ConnectionState::handshaking)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(ConnectionState::connected, state);
+    EXPECT_TRUE(entertainment.update());
+    EXPECT_TRUE(server.waitForMessages(2, std::chrono::seconds(2)));
+    EXPECT_EQ(1, entertainment.getReconnectCount());
+    EXPECT_EQ(2, server.getHandshakeCount());
+    EXPECT_EQ(1, server.getResumedCount());
+
+    EXPECT_TRUE(entertainment.reconnect());
+    EXPECT_EQ(2, entertainment.getReconnectCount());
+    EXPECT_TRUE(entertainment.update());
+    EXPECT_TRUE(server.waitForMessages(3, std::chrono::seconds(2)));
+}
+
+TEST_F(EntertainmentModeTest, reconnectWhileSending)
+{
+    EntertainmentMode entertainment(bridge, group);
+    ASSERT_TRUE(entertainment.connect());
+    entertainment.startSending(100);
+    ASSERT_TRUE(server.waitForMessages(1, std::chrono::seconds(2)));
+
+    // The sender thread continues the handshake with every frame, until frames arrive again
+    server.closeSession();
+    const std::size_t count = server.getMessages().size();
+    EXPECT_TRUE(server.waitForMessages(count + 3, std::chrono::seconds(2)));
+    EXPECT_EQ(1, entertainment.getReconnectCount());
+    EXPECT_EQ(1, server.getResumedCount());
+    EXPECT_EQ(ConnectionState::connected, entertainment.getConnectionState());
+    entertainment.stopSending();
+}
+
+TEST_F(EntertainmentModeTest, lightIndices)
+{
+    std::vector<int> lightIds;
+    for (int id = 1; id <= 300; ++id)
+    {
+        lightIds.push_back(id);
+    }
+    Group lightGroup = createGroup(lightIds);
+    EntertainmentMode entertainment(bridge, lightGroup);
+    EXPECT_EQ(300, entertainment.getLightCount());
+    EXPECT_EQ(lightIds, entertainment.getLightIds());
+    // Indices above 255 are valid
+    EXPECT_TRUE(entertainment.setColorRGB(299, 255, 0, 0));
+    EXPECT_FALSE(entertainment.setColorRGB(300, 255, 0, 0));
+    EXPECT_TRUE(entertainment.setColorRGB16(256, 1, 2, 3));
+    EXPECT_NO_THROW(entertainment.getColorGamut(299));
+    EXPECT_THROW(entertainment.getColorGamut(300), HueException);
+
+    const std::vector<uint8_t> message = receive(entertainment);
+    ASSERT_EQ(300, huestream::getLightCount(message));
+    EXPECT_EQ(0xFFFF, huestream::getChannel(message, 299, 0));
+    EXPECT_EQ(2, huestream::getChannel(message, 256, 1));
+}
+
+TEST_F(EntertainmentModeTest, setColorsRGB)
+{
+    Group lightGroup = createGroup({1, 2, 3});
+    EntertainmentMode entertainment(bridge, lightGroup);
+    const RGB colors[] = {{255, 0, 0}, {0, 128, 255}, {10, 20, 30}};
+    EXPECT_FALSE(entertainment.setColorsRGB(colors, 3, 1));
+    EXPECT_FALSE(entertainment.setColorsRGB(colors, 1, 4));
+    EXPECT_TRUE(entertainment.setColorsRGB(colors, 0, 3));
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        entertainment.setColorRGB(i, colors[i].r, colors[i].g, colors[i].b);
+    }
+    const std::vector<uint8_t> expected = receive(entertainment);
+    entertainment.setColorsRGB(colors + 1, 1);
+    EXPECT_EQ(huestream::to16Bit(128), huestream::getChannel(receive(entertainment), 0, 1));
+    EXPECT_TRUE(entertainment.setColorsRGB(colors, 3));
+    EXPECT_EQ(expected, receive(entertainment));
+}
+
+TEST_F(EntertainmentModeTest, setColorsXY)
+{
+    Group lightGroup = createGroup({1, 2, 3});
+    for (huestream::ColorSpace colorSpace : {huestream::ColorSpace::rgb, huestream::ColorSpace::xyBrightness})
+    {
+        EntertainmentMode entertainment(bridge, lightGroup, colorSpace);
+        const XYBrightness colors[] = {{{0.7f, 0.3f}, 1.f}, {{0.2f, 0.6f}, 0.5f}, {{0.3f, 0.3f}, 0.f}};
+        EXPECT_FALSE(entertainment.setColorsXY(colors, 3, 1));
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            entertainment.setColorXY(i, colors[i]);
+        }
+        const std::vector<uint8_t> expected = receive(entertainment);
+        entertainment.setColorsRGB(std::vector<RGB>(3, RGB {0, 0, 0}).data(), 3);
+        receive(entertainment);
+        EXPECT_TRUE(entertainment.setColorsXY(colors, 3));
+        const std::vector<uint8_t> message = receive(entertainment);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t channel = 0; channel < 3; ++channel)
+            {
+                // Batch conversion may differ by rounding
+                EXPECT_NEAR(huestream::getChannel(expected, i, channel), huestream::getChannel(message, i, channel),
+                    huestream::to16Bit(1))
+                    << "light " << i << ", channel " << channel;
+            }
+        }
+        entertainment.disconnect();
+    }
+}
+
+TEST_F(EntertainmentModeTest, setChannels)
+{
+    Group lightGroup = createGroup({1, 2});
+    EntertainmentMode entertainment(bridge, lightGroup);
+    const uint16_t channels[] = {1, 2, 3, 0xFFFF, 0x8000, 0};
+    EXPECT_FALSE(entertainment.setChannels(channels, 2, 1));
+    EXPECT_TRUE(entertainment.setChannels(channels, 2));
+    std::vector<uint8_t> expected = huestream::createMessage({1, 2}, huestream::ColorSpace::rgb);
+    huestream::setChannels(expected, 0, 1, 2, 3);
+    huestream::setChannels(expected, 1, 0xFFFF, 0x8000, 0);
+    EXPECT_EQ(expected, receive(entertainment));
+}
+
+TEST_F(EntertainmentModeTest, hueStreamV2)
+{
+    const std::string configurationId = "1a8d99cc-967b-44f2-9202-43f976c0fa6b";
+    EXPECT_THROW(EntertainmentMode(bridge, group, "1a8d99cc", {0}), HueException);
+
+    EntertainmentMode entertainment(bridge, group, configurationId, {0, 3, 4});
+    EXPECT_EQ(3, entertainment.getLightCount());
+    EXPECT_EQ((std::vector<int> {0, 3, 4}), entertainment.getLightIds());
+    EXPECT_TRUE(entertainment.setColorRGB(1, 255, 0, 128));
+    EXPECT_FALSE(entertainment.setColorRGB(3, 255, 0, 128));
+    const uint16_t channels[] = {1, 2, 3};
+    EXPECT_TRUE(entertainment.setChannels(channels, 1, 2));
+
+    std::vector<uint8_t> expected = huestream::createMessageV2(configurationId, {0, 3, 4}, huestream::ColorSpace::rgb);
+    huestream::setChannels(expected, 1, 0xFFFF, 0, 0x8080);
+    huestream::setChannels(expected, 2, 1, 2, 3);
+    EXPECT_EQ(expected, receive(entertainment));
+}
@@ -0,0 +1,147 @@
+/**
+    \file test_Executor.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <hueplusplus/Executor.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+TEST(Executor, Constructor)
+{
+    Executor executor(3);
+    EXPECT_EQ(3, executor.getThreadCount());
+    EXPECT_EQ(0, executor.getPendingCount());
+    Executor single(0);
+    EXPECT_EQ(1, single.getThreadCount());
+    EXPECT_GE(Executor::defaultThreadCount(), 4);
+}
+
+TEST(Executor, strandOrder)
+{
+    Executor executor(4);
+    // Tasks of one strand never run in parallel, so no synchronization is needed
+    std::vector<int> order;
+    for (int i = 0; i < 100; ++i)
+    {
+        executor.post(1, [&order, i] { order.push_back(i); });
+    }
+    executor.waitIdle();
+    ASSERT_EQ(100, order.size());
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(i, order[i]);
+    }
+    EXPECT_EQ(0, executor.getPendingCount());
+}
+
+TEST(Executor, strandsParallel)
+{
+    Executor executor(2);
+    std::atomic<bool> firstStarted {false};
+    std::atomic<bool> secondDone {false};
+    // First strand waits for the second, which only works if they run in parallel
+    std::future<bool> first = executor.submit(0, [&] {
+        firstStarted = true;
+        while (!secondDone)
+        {
+            std::this_thread::yield();
+        }
+        return true;
+    });
+    std::future<void> second = executor.submit(1, [&] {
+        while (!firstStarted)
+        {
+            std::this_thread::yield();
+        }
+        secondDone = true;
+    });
+    EXPECT_TRUE(first.get());
+    second.get();
+}
+
+TEST(Executor, fairness)
+{
+    Executor executor(1);
+    std::vector<int> order;
+    // Block the only thread until all tasks are posted
+    std::promise<void> posted;
+    std::shared_future<void> postedFuture = posted.get_future().share();
+    executor.post(0, [postedFuture] { postedFuture.wait(); });
+    executor.post(0, [&] { order.push_back(0); });
+    executor.post(0, [&] { order.push_back(0); });
+    executor.post(1, [&] { order.push_back(1); });
+    executor.post(2, [&] { order.push_back(2); });
+    posted.set_value();
+    executor.waitIdle();
+    // Strands take turns, so the other strands run before the remaining tasks of strand 0
+    EXPECT_EQ((std::vector<int> {1, 2, 0, 0}), order);
+}
+
+TEST(Executor, submit)
+{
+    Executor executor(2);
+    std::future<int> value = executor.submit(0, [] { return 42; });
+    std::future<int> error = executor.submit(0, []() -> int { throw std::runtime_error("test"); });
+    EXPECT_EQ(42, value.get());
+    EXPECT_THROW(error.get(), std::runtime_error);
+}
+
+TEST(Executor, postFromTask)
+{
+    Executor executor(2);
+    std::atomic<int> count {0};
+    executor.post(0, [&] {
+        ++count;
+        executor.post(1, [&] { ++count; });
+    });
+    executor.waitIdle();
+    EXPECT_EQ(2, count);
+}
+
+TEST(Executor, exception)
+{
+    Executor executor(1);
+    bool executed = false;
+    executor.post(0, [] { throw std::runtime_error("test"); });
+    executor.post(0, [] { throw 1; });
+    executor.post(0, [&] { executed = true; });
+    executor.waitIdle();
+    EXPECT_TRUE(executed);
+}
+
+TEST(Executor, destructor)
+{
+    std::atomic<int> count {0};
+    {
+        Executor executor(1);
+        for (int i = 0; i < 10; ++i)
+        {
+            executor.post(i % 2, [&] { ++count; });
+        }
+    }
+    // Posted tasks are still run
+    EXPECT_EQ(10, count);
+}
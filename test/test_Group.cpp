@@ -115,6 +115,28 @@ TEST_F(GroupTest, getLightIds)
     EXPECT_EQ(std::vector<int>({1, 2, 4}), Const(group).getLightIds());
 }
 
+TEST_F(GroupTest, getLightLocations)
+{
+    const int id = 1;
+    groupState["type"] = "Entertainment";
+    groupState["locations"] = {{"1", {-0.5, 0.25, 1.0}}, {"2", {1.0, -1.0}}};
+    expectGetState(id);
+    Group group(id, commands, std::chrono::seconds(0), nullptr);
+    const std::vector<LightLocation> locations = Const(group).getLightLocations();
+    ASSERT_EQ(3, locations.size());
+    EXPECT_FLOAT_EQ(-0.5f, locations[0].x);
+    EXPECT_FLOAT_EQ(0.25f, locations[0].y);
+    EXPECT_FLOAT_EQ(1.f, locations[0].z);
+    // Two coordinates have z = 0
+    EXPECT_FLOAT_EQ(1.f, locations[1].x);
+    EXPECT_FLOAT_EQ(-1.f, locations[1].y);
+    EXPECT_FLOAT_EQ(0.f, locations[1].z);
+    // Light without location
+    EXPECT_FLOAT_EQ(0.f, locations[2].x);
+    EXPECT_FLOAT_EQ(0.f, locations[2].y);
+    EXPECT_FLOAT_EQ(0.f, locations[2].z);
+}
+
 TEST_F(GroupTest, getRoomType)
 {
     const int id = 1;
@@ -26,6 +26,7 @@
 #include "testhelper.h"
 
 #include "hueplusplus/Bridge.h"
+#include "hueplusplus/HueExceptionMacro.h"
 #include <nlohmann/json.hpp>
 #include "mocks/mock_HttpHandler.h"
 
@@ -101,6 +102,159 @@ TEST(HueCommandAPI, PUTRequest)
     }
 }
 
+TEST(HueCommandAPI, PUTSerializedRequest)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> httpHandler = std::make_shared<MockHttpHandler>();
+
+    HueCommandAPI api(getBridgeIp(), getBridgePort(), getBridgeUsername(), httpHandler);
+    const nlohmann::json request = {{"on", true}, {"xy", {0.5, 0.25}}};
+    const std::string body = request.dump();
+    nlohmann::json result = nlohmann::json::object();
+    result["ok"] = true;
+
+    // Default implementation of IHttpHandler forwards to PUTJson
+    // empty path
+    {
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername(), request, getBridgeIp(), 80))
+            .WillOnce(Return(result));
+        EXPECT_EQ(result, api.PUTSerializedRequest("", body));
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // not empty path, starting with slash
+    {
+        const std::string path = "/test";
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, request, getBridgeIp(), 80))
+            .WillOnce(Return(result));
+        EXPECT_EQ(result, api.PUTSerializedRequest(path, body));
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // not empty path, not starting with slash
+    {
+        const std::string path = "test";
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + '/' + path, request, getBridgeIp(), 80))
+            .WillOnce(Return(result));
+        EXPECT_EQ(result, api.PUTSerializedRequest(path, body));
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // recoverable error
+    {
+        const std::string path = "/test";
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, request, getBridgeIp(), 80))
+            .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::connection_reset))))
+            .WillOnce(Return(result));
+        EXPECT_EQ(result, api.PUTSerializedRequest(path, body));
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // api returns error
+    {
+        const std::string path = "/test";
+        const nlohmann::json errorResponse {{"error", {{"type", 10}, {"address", path}, {"description", "Stuff"}}}};
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, request, getBridgeIp(), 80))
+            .WillOnce(Return(errorResponse));
+        EXPECT_THROW(api.PUTSerializedRequest(path, body), HueAPIResponseException);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+}
+
+TEST(HueCommandAPI, tryPUTRequest)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> httpHandler = std::make_shared<MockHttpHandler>();
+
+    HueCommandAPI api(getBridgeIp(), getBridgePort(), getBridgeUsername(), httpHandler);
+    nlohmann::json request;
+    nlohmann::json result = nlohmann::json::object();
+    result["ok"] = true;
+    const std::string path = "/test";
+
+    // success
+    {
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, request, getBridgeIp(), 80))
+            .WillOnce(Return(result));
+        Result<nlohmann::json> response = api.tryPUTRequest(path, request);
+        ASSERT_TRUE(response);
+        EXPECT_EQ(result, response.value());
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // recoverable error
+    {
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, request, getBridgeIp(), 80))
+            .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::connection_reset))))
+            .WillOnce(Return(result));
+        EXPECT_EQ(result, api.tryPUTRequest(path, request).value());
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // recoverable error x2
+    {
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, request, getBridgeIp(), 80))
+            .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::connection_reset))))
+            .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::connection_reset))));
+        Result<nlohmann::json> response = api.tryPUTRequest(path, request);
+        EXPECT_FALSE(response);
+        EXPECT_EQ(ErrorCode::busy, response.error().code);
+        EXPECT_EQ(std::make_error_code(std::errc::connection_reset), response.error().systemError);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // unrecoverable error
+    {
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, request, getBridgeIp(), 80))
+            .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::not_enough_memory))));
+        EXPECT_EQ(ErrorCode::connectionFailed, api.tryPUTRequest(path, request).error().code);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // invalid response
+    {
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, request, getBridgeIp(), 80))
+            .WillOnce(Throw(HueException(CURRENT_FILE_INFO, "Failed to find body in response")));
+        EXPECT_EQ(ErrorCode::invalidResponse, api.tryPUTRequest(path, request).error().code);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // api returns error
+    {
+        const nlohmann::json errorResponse {{"error", {{"type", 201}, {"address", path}, {"description", "Stuff"}}}};
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, request, getBridgeIp(), 80))
+            .WillOnce(Return(errorResponse));
+        Result<nlohmann::json> response = api.tryPUTRequest(path, request);
+        EXPECT_FALSE(response);
+        EXPECT_EQ(ErrorCode::apiError, response.error().code);
+        EXPECT_EQ(201, response.error().apiError);
+        EXPECT_THROW(response.value(), HueException);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+    // api returns error in array, with type as string
+    {
+        const nlohmann::json errorResponse {{{"success", {{path + "/on", true}}}},
+            {{"error", {{"type", "7"}, {"address", path}, {"description", "Stuff"}}}}};
+        EXPECT_CALL(*httpHandler, PUTJson("/api/" + getBridgeUsername() + path, request, getBridgeIp(), 80))
+            .WillOnce(Return(errorResponse));
+        Result<nlohmann::json> response = api.tryPUTRequest(path, request);
+        EXPECT_EQ(ErrorCode::apiError, response.error().code);
+        EXPECT_EQ(7, response.error().apiError);
+        Mock::VerifyAndClearExpectations(httpHandler.get());
+    }
+}
+
+TEST(HueCommandAPI, tryRequests)
+{
+    using namespace ::testing;
+    std::shared_ptr<MockHttpHandler> httpHandler = std::make_shared<MockHttpHandler>();
+
+    HueCommandAPI api(getBridgeIp(), getBridgePort(), getBridgeUsername(), httpHandler);
+    nlohmann::json request;
+    nlohmann::json result = nlohmann::json::object();
+    result["ok"] = true;
+    const std::string path = "test";
+    const std::string uri = "/api/" + getBridgeUsername() + '/' + path;
+
+    EXPECT_CALL(*httpHandler, GETJson(uri, request, getBridgeIp(), 80)).WillOnce(Return(result));
+    EXPECT_EQ(result, api.tryGETRequest(path, request).value());
+    EXPECT_CALL(*httpHandler, DELETEJson(uri, request, getBridgeIp(), 80)).WillOnce(Return(result));
+    EXPECT_EQ(result, api.tryDELETERequest(path, request).value());
+    EXPECT_CALL(*httpHandler, POSTJson(uri, request, getBridgeIp(), 80)).WillOnce(Return(result));
+    EXPECT_EQ(result, api.tryPOSTRequest(path, request).value());
+}
+
 TEST(HueCommandAPI, GETRequest)
 {
     using namespace ::testing;
@@ -0,0 +1,147 @@
+/**
+    \file test_HueStream.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <hueplusplus/HueException.h>
+#include <hueplusplus/HueStream.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+TEST(HueStream, createMessage)
+{
+    const std::vector<uint8_t> expected = {'H', 'u', 'e', 'S', 't', 'r', 'e', 'a', 'm', 0x01, 0x00, 0x00, 0x00, 0x00,
+        0x01, 0x00, 0x00, 0x00, 0x03, 0, 0, 0, 0, 0, 0, 0x00, 0x01, 0x2C, 0, 0, 0, 0, 0, 0};
+    const std::vector<uint8_t> message = huestream::createMessage({3, 300}, huestream::ColorSpace::xyBrightness);
+    EXPECT_EQ(expected, message);
+    EXPECT_EQ(2, huestream::getLightCount(message));
+    EXPECT_EQ(huestream::ColorSpace::xyBrightness, huestream::getColorSpace(message));
+
+    std::vector<uint8_t> empty = huestream::createMessage({}, huestream::ColorSpace::rgb);
+    EXPECT_EQ(huestream::headerSize, empty.size());
+    EXPECT_EQ(0, huestream::getLightCount(empty));
+    EXPECT_EQ(huestream::ColorSpace::rgb, huestream::getColorSpace(empty));
+    huestream::setColorSpace(empty, huestream::ColorSpace::xyBrightness);
+    EXPECT_EQ(0x01, empty[14]);
+}
+
+TEST(HueStream, setChannels)
+{
+    std::vector<uint8_t> message = huestream::createMessage({1, 2}, huestream::ColorSpace::rgb);
+    huestream::setChannels(message, 1, 0x1234, 0xABCD, 0x00FF);
+    const std::vector<uint8_t> light = {0x00, 0x00, 0x02, 0x12, 0x34, 0xAB, 0xCD, 0x00, 0xFF};
+    EXPECT_EQ(light, std::vector<uint8_t>(message.begin() + 25, message.end()));
+    EXPECT_EQ(0x1234, huestream::getChannel(message, 1, 0));
+    EXPECT_EQ(0xABCD, huestream::getChannel(message, 1, 1));
+    EXPECT_EQ(0x00FF, huestream::getChannel(message, 1, 2));
+    // First light is unchanged
+    EXPECT_EQ(0, huestream::getChannel(message, 0, 0));
+}
+
+TEST(HueStream, setChannelsBulk)
+{
+    std::vector<uint8_t> message = huestream::createMessage({1, 2, 3}, huestream::ColorSpace::rgb);
+    const uint16_t channels[] = {0x1234, 0xABCD, 0x00FF, 0xFFFF, 0x0001, 0x8000};
+    huestream::setChannels(message, 1, channels, 2);
+    const std::vector<uint8_t> lights
+        = {0x00, 0x00, 0x02, 0x12, 0x34, 0xAB, 0xCD, 0x00, 0xFF, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0x00, 0x01, 0x80, 0x00};
+    EXPECT_EQ(lights, std::vector<uint8_t>(message.begin() + 25, message.end()));
+    // First light is unchanged
+    EXPECT_EQ(0, huestream::getChannel(message, 0, 0));
+
+    // Same result as setting each light
+    std::vector<uint8_t> expected = huestream::createMessage({1, 2, 3}, huestream::ColorSpace::rgb);
+    huestream::setChannels(expected, 1, 0x1234, 0xABCD, 0x00FF);
+    huestream::setChannels(expected, 2, 0xFFFF, 0x0001, 0x8000);
+    EXPECT_EQ(expected, message);
+}
+
+TEST(HueStream, toChannel)
+{
+    EXPECT_EQ(0, huestream::to16Bit(0));
+    EXPECT_EQ(0x8080, huestream::to16Bit(128));
+    EXPECT_EQ(0xFFFF, huestream::to16Bit(255));
+
+    EXPECT_EQ(0, huestream::toChannel(0.f));
+    EXPECT_EQ(32768, huestream::toChannel(0.5f));
+    EXPECT_EQ(65535, huestream::toChannel(1.f));
+    EXPECT_EQ(0, huestream::toChannel(-0.5f));
+    EXPECT_EQ(65535, huestream::toChannel(2.f));
+    // Low brightness keeps its precision, 8 bit would round both to the same value
+    EXPECT_NE(huestream::toChannel(0.001f), huestream::toChannel(0.002f));
+}
+
+TEST(HueStream, setXYBrightness)
+{
+    std::vector<uint8_t> message = huestream::createMessage({1}, huestream::ColorSpace::xyBrightness);
+    huestream::setXYBrightness(message, 0, {{0.25f, 0.75f}, 1.f});
+    EXPECT_EQ(16384, huestream::getChannel(message, 0, 0));
+    EXPECT_EQ(49151, huestream::getChannel(message, 0, 1));
+    EXPECT_EQ(65535, huestream::getChannel(message, 0, 2));
+}
+
+TEST(HueStream, createMessageV2)
+{
+    const std::string configurationId = "1a8d99cc-967b-44f2-9202-43f976c0fa6b";
+    std::vector<uint8_t> expected = {'H', 'u', 'e', 'S', 't', 'r', 'e', 'a', 'm', 0x02, 0x00, 0x00, 0x00, 0x00, 0x01,
+        0x00};
+    expected.insert(expected.end(), configurationId.begin(), configurationId.end());
+    expected.insert(expected.end(), {0x00, 0, 0, 0, 0, 0, 0, 0x05, 0, 0, 0, 0, 0, 0});
+    const std::vector<uint8_t> message
+        = huestream::createMessageV2(configurationId, {0, 5}, huestream::ColorSpace::xyBrightness);
+    EXPECT_EQ(expected, message);
+    EXPECT_EQ(huestream::headerSizeV2 + 2 * huestream::channelSize, message.size());
+    EXPECT_EQ(huestream::Version::v2, huestream::getVersion(message));
+    EXPECT_EQ(2, huestream::getLightCount(message));
+    EXPECT_EQ(huestream::ColorSpace::xyBrightness, huestream::getColorSpace(message));
+    EXPECT_EQ(huestream::Version::v1, huestream::getVersion(huestream::createMessage({1}, huestream::ColorSpace::rgb)));
+
+    const std::vector<uint8_t> empty = huestream::createMessageV2(configurationId, {}, huestream::ColorSpace::rgb);
+    EXPECT_EQ(huestream::headerSizeV2, empty.size());
+    EXPECT_EQ(0, huestream::getLightCount(empty));
+
+    EXPECT_THROW(huestream::createMessageV2("1a8d99cc", {0}, huestream::ColorSpace::rgb), HueException);
+}
+
+TEST(HueStream, setChannelsV2)
+{
+    const std::string configurationId = "1a8d99cc-967b-44f2-9202-43f976c0fa6b";
+    std::vector<uint8_t> message = huestream::createMessageV2(configurationId, {0, 1, 7}, huestream::ColorSpace::rgb);
+    huestream::setChannels(message, 1, 0x1234, 0xABCD, 0x00FF);
+    const uint16_t channels[] = {0xFFFF, 0x0001, 0x8000};
+    huestream::setChannels(message, 2, channels, 1);
+    const std::vector<uint8_t> entries = {0x00, 0, 0, 0, 0, 0, 0, 0x01, 0x12, 0x34, 0xAB, 0xCD, 0x00, 0xFF, 0x07, 0xFF,
+        0xFF, 0x00, 0x01, 0x80, 0x00};
+    EXPECT_EQ(entries, std::vector<uint8_t>(message.begin() + huestream::headerSizeV2, message.end()));
+    // Header is unchanged
+    EXPECT_EQ(configurationId,
+        std::string(message.begin() + huestream::headerSize, message.begin() + huestream::headerSizeV2));
+    EXPECT_EQ(0x1234, huestream::getChannel(message, 1, 0));
+    EXPECT_EQ(0xABCD, huestream::getChannel(message, 1, 1));
+    EXPECT_EQ(0x8000, huestream::getChannel(message, 2, 2));
+    EXPECT_EQ(0, huestream::getChannel(message, 0, 0));
+
+    huestream::setColorSpace(message, huestream::ColorSpace::xyBrightness);
+    huestream::setXYBrightness(message, 0, {{0.25f, 0.75f}, 1.f});
+    EXPECT_EQ(16384, huestream::getChannel(message, 0, 0));
+    EXPECT_EQ(49151, huestream::getChannel(message, 0, 1));
+    EXPECT_EQ(65535, huestream::getChannel(message, 0, 2));
+}
@@ -0,0 +1,126 @@
+/**
+    \file test_JsonFilter.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <hueplusplus/JsonFilter.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+namespace
+{
+const nlohmann::json light1 = {{"state", {{"on", true}, {"xy", {0.1, 0.2}}}}, {"name", "a"},
+    {"type", "Extended color light"},
+    {"capabilities", {{"control", {{"ct", {{"min", 153}}}}}, {"streaming", {{"proxy", true}}}}},
+    {"swupdate", {{"state", "noupdates"}}}};
+const nlohmann::json light2 = {{"name", "b"}, {"config", {{"archetype", "sultanbulb"}}}};
+const nlohmann::json lights = {{"lights", {{"1", light1}, {"2", light2}}}, {"scenes", {{"abc", {{"name", "scene"}}}}},
+    {"rules", {{"1", {{"conditions", {{{"address", "/sensors/1"}, {"operator", "dx"}}}}}}}}};
+} // namespace
+
+TEST(JsonFilter, keeps)
+{
+    JsonFilter all;
+    EXPECT_TRUE(all.keepsAll());
+    EXPECT_TRUE(all.keeps({"anything"}));
+
+    JsonFilter filter({"lights/*/state", "lights/*/name"});
+    EXPECT_FALSE(filter.keepsAll());
+    EXPECT_TRUE(filter.keeps({"lights"}));
+    EXPECT_TRUE(filter.keeps({"lights", "1"}));
+    EXPECT_TRUE(filter.keeps({"lights", "1", "state", "on"}));
+    EXPECT_TRUE(filter.keeps({"lights", "2", "name"}));
+    EXPECT_FALSE(filter.keeps({"lights", "1", "type"}));
+    EXPECT_FALSE(filter.keeps({"scenes"}));
+
+    EXPECT_TRUE(JsonFilter({"lights", ""}).keepsAll());
+}
+
+TEST(JsonFilter, getChild)
+{
+    JsonFilter filter({"lights/*/state", "lights/1/name", "config"});
+    JsonFilter lightList = filter.getChild("lights");
+    EXPECT_FALSE(lightList.keepsAll());
+    EXPECT_TRUE(lightList.keeps({"2", "state"}));
+    EXPECT_FALSE(lightList.keeps({"2", "name"}));
+    JsonFilter light = lightList.getChild("1");
+    EXPECT_TRUE(light.keeps({"name"}));
+    EXPECT_FALSE(light.keeps({"type"}));
+    EXPECT_TRUE(light.getChild("state").keepsAll());
+    EXPECT_TRUE(filter.getChild("config").keepsAll());
+
+    // Nothing of the scenes is kept
+    JsonFilter scenes = filter.getChild("scenes");
+    EXPECT_FALSE(scenes.keepsAll());
+    EXPECT_FALSE(scenes.keeps({"abc"}));
+    EXPECT_EQ(nlohmann::json::object(), scenes.parse(lights["scenes"].dump()));
+
+    EXPECT_TRUE(JsonFilter().getChild("lights").keepsAll());
+}
+
+TEST(JsonFilter, parse)
+{
+    const std::string text = lights.dump();
+    EXPECT_EQ(lights, JsonFilter().parse(text));
+
+    JsonFilter filter({"lights/*/state", "lights/*/name", "lights/*/capabilities/control"});
+    const nlohmann::json expected = {{"lights",
+        {{"1",
+             {{"state", {{"on", true}, {"xy", {0.1, 0.2}}}}, {"name", "a"},
+                 {"capabilities", {{"control", {{"ct", {{"min", 153}}}}}}}}},
+            {"2", {{"name", "b"}}}}}};
+    EXPECT_EQ(expected, filter.parse(text));
+    EXPECT_EQ(expected, filter.apply(lights));
+
+    // Paths through arrays
+    JsonFilter arrayFilter({"rules/*/conditions/*/address"});
+    const nlohmann::json expectedRules = {{"rules", {{"1", {{"conditions", {{{"address", "/sensors/1"}}}}}}}}};
+    EXPECT_EQ(expectedRules, arrayFilter.parse(text));
+    EXPECT_EQ(expectedRules, arrayFilter.apply(lights));
+
+    EXPECT_THROW(filter.parse("{\"lights\":"), nlohmann::json::parse_error);
+}
+
+TEST(JsonFilter, parseArena)
+{
+    const std::string text = lights.dump();
+    RefreshArena arena;
+    RefreshArena::Scope scope(arena);
+    EXPECT_EQ(lights, toJson(JsonFilter().parseArena(text)));
+
+    JsonFilter filter({"lights/*/name", "rules/*/conditions/*/address"});
+    const nlohmann::json expected = {{"lights", {{"1", {{"name", "a"}}}, {"2", {{"name", "b"}}}}},
+        {"rules", {{"1", {{"conditions", {{{"address", "/sensors/1"}}}}}}}}};
+    EXPECT_EQ(expected, toJson(filter.parseArena(text)));
+    EXPECT_GT(arena.getUsedBytes(), 0u);
+
+    EXPECT_THROW(filter.parseArena("{\"lights\":"), nlohmann::json::parse_error);
+}
+
+TEST(JsonFilter, parseErrorResponse)
+{
+    // Error responses are arrays and always kept completely
+    const nlohmann::json error
+        = {{{"error", {{"type", 1}, {"address", "/lights"}, {"description", "unauthorized user"}}}}};
+    JsonFilter filter({"lights/*/state"});
+    EXPECT_EQ(error, filter.parse(error.dump()));
+    EXPECT_EQ(error, filter.apply(error));
+}
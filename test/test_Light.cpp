@@ -27,6 +27,7 @@
 
 #include "hueplusplus/Bridge.h"
 #include "hueplusplus/Light.h"
+#include "hueplusplus/TimerScheduler.h"
 #include <nlohmann/json.hpp>
 #include "mocks/mock_HttpHandler.h"
 
@@ -785,3 +786,87 @@ TEST_F(HueLightTest, setColorLoop)
     EXPECT_EQ(false, test_light_2.setColorLoop(false));
     EXPECT_EQ(false, test_light_3.setColorLoop(true));
 }
+
+TEST_F(HueLightTest, getDecodedState)
+{
+    const Light ctest_light_1 = test_bridge.lights().get(1);
+    Light test_light_3 = test_bridge.lights().get(3);
+
+    const DecodedLightState& state1 = ctest_light_1.getDecodedState();
+    EXPECT_TRUE(state1.on);
+    EXPECT_TRUE(state1.reachable);
+    EXPECT_EQ(254, state1.bri);
+    EXPECT_EQ(366, state1.ct);
+    EXPECT_EQ(0, state1.hue);
+    EXPECT_EQ(ColorMode::TEMPERATURE, state1.colormode);
+
+    const DecodedLightState& state3 = test_light_3.getDecodedState();
+    EXPECT_FALSE(state3.on);
+    EXPECT_EQ(12345, state3.hue);
+    EXPECT_EQ(123, state3.sat);
+    EXPECT_FLOAT_EQ(0.102f, state3.xy.x);
+    EXPECT_FLOAT_EQ(0.102f, state3.xy.y);
+}
+
+TEST_F(HueLightTest, setStateDecoding)
+{
+    using namespace ::testing;
+    Light test_light_3 = test_bridge.lights().get(3);
+    EXPECT_FALSE(test_light_3.isStateDecodingEnabled());
+    test_light_3.setStateDecoding(true);
+    EXPECT_TRUE(test_light_3.isStateDecodingEnabled());
+
+    EXPECT_FALSE(test_light_3.isOn());
+    EXPECT_EQ(254, test_light_3.getBrightness());
+    EXPECT_EQ(366, test_light_3.getColorTemperature());
+    EXPECT_EQ((HueSaturation {12345, 123}), test_light_3.getColorHueSaturation());
+
+    // Decoded state is updated by transactions
+    nlohmann::json prep_ret = {{{"success", {{"/lights/3/state/on", true}}}},
+        {{"success", {{"/lights/3/state/hue", 200}}}}, {{"success", {{"/lights/3/state/sat", 100}}}}};
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/3/state", _, getBridgeIp(), 80))
+        .WillOnce(Return(prep_ret));
+    EXPECT_TRUE(test_light_3.setColorHueSaturation({200, 100}));
+    const Light& ctest_light_3 = test_light_3;
+    EXPECT_TRUE(ctest_light_3.isOn());
+    EXPECT_EQ((HueSaturation {200, 100}), ctest_light_3.getColorHueSaturation());
+    EXPECT_EQ(ColorMode::TEMPERATURE, ctest_light_3.getDecodedState().colormode);
+}
+
+TEST_F(HueLightTest, setAsyncAlerts)
+{
+    using namespace ::testing;
+    Light test_light_3 = test_bridge.lights().get(3);
+    EXPECT_FALSE(test_light_3.isAsyncAlertsEnabled());
+    test_light_3.setAsyncAlerts(true);
+    EXPECT_TRUE(test_light_3.isAsyncAlertsEnabled());
+
+    std::vector<nlohmann::json> requests;
+    EXPECT_CALL(*handler, PUTJson("/api/" + getBridgeUsername() + "/lights/3/state", _, getBridgeIp(), 80))
+        .Times(3)
+        .WillRepeatedly(Invoke([&](const std::string&, const nlohmann::json& request, const std::string&, int) {
+            requests.push_back(request);
+            nlohmann::json response;
+            for (auto it = request.begin(); it != request.end(); ++it)
+            {
+                response.push_back({{"success", {{"/lights/3/state/" + it.key(), it.value()}}}});
+            }
+            return response;
+        }));
+    EXPECT_TRUE(test_light_3.alertTemperature(400));
+    TimerScheduler::instance().waitIdle();
+
+    ASSERT_EQ(3, requests.size());
+    EXPECT_EQ(400, requests[0].at("ct"));
+    EXPECT_EQ((nlohmann::json {{"alert", "select"}}), requests[1]);
+    EXPECT_EQ((nlohmann::json {{"ct", 366}, {"on", false}, {"transitiontime", 1}}), requests[2]);
+
+    // The cached state still has the alert color, so it is refreshed after restoring
+    EXPECT_CALL(
+        *handler, GETJson("/api/" + getBridgeUsername() + "/lights/3", nlohmann::json::object(), getBridgeIp(), 80))
+        .WillOnce(Return(hue_bridge_state["lights"]["3"]));
+    EXPECT_EQ(366, test_light_3.getColorTemperature());
+    EXPECT_FALSE(test_light_3.isOn());
+    // Next transaction is trimmed using the restored state, so no request is sent
+    EXPECT_TRUE(test_light_3.transaction().setColorTemperature(366).setOn(false).commit());
+}
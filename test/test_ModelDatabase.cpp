@@ -0,0 +1,95 @@
+/**
+    \file test_ModelDatabase.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <hueplusplus/Light.h>
+#include <hueplusplus/ModelDatabase.h>
+#include <hueplusplus/ModelPictures.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+TEST(ModelDatabase, find)
+{
+    const ModelDatabase& db = ModelDatabase::instance();
+    EXPECT_EQ(nullptr, db.find(""));
+    EXPECT_EQ(nullptr, db.find("LCT"));
+    EXPECT_EQ(nullptr, db.find("ZZZ999"));
+
+    const ModelInfo* info = db.find("LCT001");
+    ASSERT_NE(nullptr, info);
+    EXPECT_STREQ("LCT001", info->modelId);
+    EXPECT_STREQ("e27_waca", info->picture);
+    EXPECT_EQ(ModelGamut::B, info->gamut);
+    EXPECT_TRUE(info->hasFeatures(modelfeature::color | modelfeature::colorTemperature));
+    EXPECT_EQ(ColorType::GAMUT_B_TEMPERATURE, info->getColorType());
+
+    info = db.find("LST001");
+    ASSERT_NE(nullptr, info);
+    EXPECT_EQ(ModelGamut::A, info->gamut);
+    EXPECT_FALSE(info->hasFeatures(modelfeature::colorTemperature));
+    EXPECT_EQ(ColorType::GAMUT_A, info->getColorType());
+
+    info = db.find("LTW001");
+    ASSERT_NE(nullptr, info);
+    EXPECT_EQ(ModelGamut::UNKNOWN, info->gamut);
+    EXPECT_TRUE(info->hasFeatures(modelfeature::colorTemperature));
+    EXPECT_EQ(ColorType::UNDEFINED, info->getColorType());
+
+    // First and last entry of the table
+    EXPECT_NE(nullptr, db.find("BSB001"));
+    EXPECT_NE(nullptr, db.find("SWT001"));
+}
+
+TEST(ModelDatabase, add)
+{
+    ModelDatabase& db = ModelDatabase::instance();
+    db.add("ABC001", "abc", ModelGamut::C, modelfeature::brightness | modelfeature::color);
+    const ModelInfo* info = db.find("ABC001");
+    ASSERT_NE(nullptr, info);
+    EXPECT_STREQ("ABC001", info->modelId);
+    EXPECT_STREQ("abc", info->picture);
+    EXPECT_EQ(ColorType::GAMUT_C, info->getColorType());
+    EXPECT_EQ("abc", getPictureOfModel("ABC001"));
+
+    // Replace existing
+    db.add("ABC001", "def", ModelGamut::A, 0);
+    EXPECT_EQ(info, db.find("ABC001"));
+    EXPECT_STREQ("def", info->picture);
+    EXPECT_EQ(ModelGamut::A, info->gamut);
+
+    // Override built in model
+    db.add("LCT001", "override", ModelGamut::C, 0);
+    EXPECT_EQ("override", getPictureOfModel("LCT001"));
+
+    db.clearAdded();
+    EXPECT_EQ(nullptr, db.find("ABC001"));
+    EXPECT_EQ("e27_waca", getPictureOfModel("LCT001"));
+}
+
+TEST(ModelPictures, getPictureOfModel)
+{
+    EXPECT_EQ("e27_waca", getPictureOfModel("LCT001"));
+    EXPECT_EQ("iris", getPictureOfModel("LLC006"));
+    EXPECT_EQ("motion_sensor", getPictureOfModel("SML001"));
+    EXPECT_EQ("", getPictureOfModel("LCT015"));
+    EXPECT_EQ("", getPictureOfModel("unknown"));
+}
@@ -175,6 +175,81 @@ TEST(ResourceList, get)
     }
 }
 
+TEST(ResourceList, tryGet)
+{
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+
+    const std::string path = "/resources";
+    const int id = 2;
+    const nlohmann::json response = {{std::to_string(id), {{"resource", "state"}}}};
+    ResourceList<TestResource, int> list(commands, path, std::chrono::steady_clock::duration::max());
+    EXPECT_CALL(*handler,
+        GETJson("/api/" + getBridgeUsername() + path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Throw(std::system_error(std::make_error_code(std::errc::not_enough_memory))))
+        .WillOnce(Return(response));
+
+    // Refresh fails
+    Result<ResourceHandle<TestResource>> failed = list.tryGet(id);
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(ErrorCode::connectionFailed, failed.error().code);
+    EXPECT_EQ(std::make_error_code(std::errc::not_enough_memory), failed.error().systemError);
+
+    Result<ResourceHandle<TestResource>> r = list.tryGet(id);
+    ASSERT_TRUE(r);
+    EXPECT_EQ(id, (*r)->id);
+    EXPECT_EQ(*r, list.get(id));
+
+    Result<ResourceHandle<TestResource>> missing = list.tryGet(4);
+    EXPECT_FALSE(missing);
+    EXPECT_EQ(ErrorCode::notFound, missing.error().code);
+}
+
+TEST(ResourceList, getCached)
+{
+    auto handler = std::make_shared<MockHttpHandler>();
+    HueCommandAPI commands(getBridgeIp(), getBridgePort(), getBridgeUsername(), handler);
+
+    const std::string path = "/resources";
+    const int id = 2;
+    const int id2 = 3;
+    const nlohmann::json state = {{"resource", "state"}};
+    const nlohmann::json response = {{std::to_string(id), state}, {std::to_string(id2), state}};
+
+    MockFunction<TestResource(int, const nlohmann::json&, const std::shared_ptr<APICache>&)> factory;
+    EXPECT_CALL(factory, Call(id, state, std::shared_ptr<APICache>()))
+        .Times(2)
+        .WillRepeatedly(Return(TestResource(id, commands, std::chrono::steady_clock::duration::max(), nullptr)));
+    EXPECT_CALL(factory, Call(id2, state, std::shared_ptr<APICache>()))
+        .WillOnce(Return(TestResource(id2, commands, std::chrono::steady_clock::duration::max(), nullptr)));
+
+    ResourceList<TestResource, int> list(
+        commands, path, std::chrono::steady_clock::duration::max(), factory.AsStdFunction());
+    EXPECT_CALL(*handler,
+        GETJson("/api/" + getBridgeUsername() + path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
+        .WillOnce(Return(response))
+        .WillOnce(Return(nlohmann::json {{std::to_string(id2), state}}))
+        .WillOnce(Return(response));
+
+    // Resources are only constructed once
+    ResourceHandle<TestResource> r = list.get(id);
+    EXPECT_EQ(r, list.get(id));
+    ResourceHandle<TestResource> r2 = list.get(id2);
+    EXPECT_THAT(list.getAll(), ElementsAre(r, r2));
+
+    // Removed resources are dropped on refresh, but existing handles stay valid
+    list.refresh();
+    EXPECT_THROW(list.get(id), HueException);
+    EXPECT_EQ(id, r->id);
+    EXPECT_EQ(r2, list.get(id2));
+
+    // Resource is constructed again after it reappears
+    list.refresh();
+    EXPECT_EQ(id, list.get(id)->id);
+    EXPECT_NE(r, list.get(id));
+    EXPECT_EQ(r2, list.get(id2));
+}
+
 TEST(ResourceList, exists)
 {
     auto handler = std::make_shared<MockHttpHandler>();
@@ -206,8 +281,9 @@ TEST(ResourceList, getAll)
         GETJson("/api/" + getBridgeUsername() + path, nlohmann::json::object(), getBridgeIp(), getBridgePort()))
         .WillOnce(Return(response));
 
+    auto getId = [](const ResourceHandle<TestResource>& r) { return r->id; };
     auto resources = list.getAll();
-    EXPECT_THAT(resources, ElementsAre(testing::Field("id", &TestResource::id, Eq(id))));
+    EXPECT_THAT(resources, ElementsAre(ResultOf(getId, id)));
 
     const int id2 = 3;
     const nlohmann::json response2 = {{std::to_string(id), {{"r", "s"}}}, {std::to_string(id2), {{"b", "c"}}}};
@@ -217,8 +293,7 @@ TEST(ResourceList, getAll)
         .WillOnce(Return(response2));
     list.refresh();
     auto resources2 = list.getAll();
-    EXPECT_THAT(resources2,
-        ElementsAre(testing::Field("id", &TestResource::id, Eq(id)), testing::Field("id", &TestResource::id, Eq(id2))));
+    EXPECT_THAT(resources2, ElementsAre(ResultOf(getId, id), ResultOf(getId, id2)));
 }
 
 TEST(ResourceList, remove)
@@ -0,0 +1,191 @@
+/**
+    \file test_SpatialMapping.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <hueplusplus/HueException.h>
+#include <hueplusplus/HueStream.h>
+#include <hueplusplus/SpatialMapping.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+namespace
+{
+// Samples one channel of the grid at a location without precomputed weights
+float referenceSample(const ColorGrid& grid, std::size_t channel, const LightLocation& location)
+{
+    const float coordinates[] = {location.x, location.y, location.z};
+    const std::size_t sizes[] = {grid.getWidth(), grid.getHeight(), grid.getDepth()};
+    std::size_t low[3];
+    std::size_t high[3];
+    float fraction[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const float clamped = std::min(std::max(coordinates[axis], -1.f), 1.f);
+        const float position = std::min(
+            std::max((clamped + 1.f) / 2.f * sizes[axis] - 0.5f, 0.f), static_cast<float>(sizes[axis] - 1));
+        low[axis] = static_cast<std::size_t>(std::floor(position));
+        high[axis] = std::min(low[axis] + 1, sizes[axis] - 1);
+        fraction[axis] = position - low[axis];
+    }
+    float result = 0.f;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        float weight = 1.f;
+        std::size_t cell[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const bool upper = (corner >> axis & 1) != 0;
+            cell[axis] = upper ? high[axis] : low[axis];
+            weight *= upper ? fraction[axis] : 1.f - fraction[axis];
+        }
+        result += weight * grid.getChannel(channel)[grid.getIndex(cell[0], cell[1], cell[2])];
+    }
+    return result;
+}
+} // namespace
+
+TEST(ColorGrid, setColor)
+{
+    EXPECT_THROW(ColorGrid(0, 1), HueException);
+    EXPECT_THROW(ColorGrid(1, 1, 0), HueException);
+
+    ColorGrid grid(4, 3, 2);
+    EXPECT_EQ(4, grid.getWidth());
+    EXPECT_EQ(3, grid.getHeight());
+    EXPECT_EQ(2, grid.getDepth());
+    EXPECT_EQ(0, grid.getIndex(0, 0, 0));
+    EXPECT_EQ(4 * 3 + 4 + 1, grid.getIndex(1, 1, 1));
+    EXPECT_EQ(0.f, grid.getChannel(0)[0]);
+
+    grid.setColor(1, 1, 1, RGB {255, 0, 51});
+    const std::size_t index = grid.getIndex(1, 1, 1);
+    EXPECT_FLOAT_EQ(1.f, grid.getChannel(0)[index]);
+    EXPECT_FLOAT_EQ(0.f, grid.getChannel(1)[index]);
+    EXPECT_FLOAT_EQ(0.2f, grid.getChannel(2)[index]);
+    grid.setColor(3, 2, 0, 0.1f, 0.2f, 0.3f);
+    EXPECT_FLOAT_EQ(0.3f, grid.getChannel(2)[grid.getIndex(3, 2, 0)]);
+
+    grid.fill(RGB {0, 255, 0});
+    for (std::size_t i = 0; i < 4 * 3 * 2; ++i)
+    {
+        EXPECT_EQ(0.f, grid.getChannel(0)[i]);
+        EXPECT_EQ(1.f, grid.getChannel(1)[i]);
+        EXPECT_EQ(0.f, grid.getChannel(2)[i]);
+    }
+}
+
+TEST(SpatialMapping, gradient)
+{
+    // Red on the left, blue on the right
+    ColorGrid grid(2, 1);
+    grid.setColor(0, 0, 0, RGB {255, 0, 0});
+    grid.setColor(1, 0, 0, RGB {0, 0, 255});
+    const SpatialMapping mapping(
+        {{-1.f, 0.f, 0.f}, {1.f, 0.5f, 0.f}, {0.f, -1.f, 1.f}, {-0.5f, 0.f, 0.f}, {5.f, 0.f, 0.f}}, 2, 1);
+    EXPECT_EQ(5, mapping.getLightCount());
+
+    RGB colors[5];
+    mapping.sample(grid, 0, 5, colors);
+    EXPECT_EQ((RGB {255, 0, 0}), colors[0]);
+    EXPECT_EQ((RGB {0, 0, 255}), colors[1]);
+    EXPECT_EQ((RGB {128, 0, 128}), colors[2]);
+    // Cell centers are at -0.5 and 0.5
+    EXPECT_EQ((RGB {255, 0, 0}), colors[3]);
+    // Clamped to the grid
+    EXPECT_EQ((RGB {0, 0, 255}), colors[4]);
+
+    uint16_t channels[6];
+    mapping.sample(grid, 1, 2, channels);
+    EXPECT_EQ(0, channels[0]);
+    EXPECT_EQ(0xFFFF, channels[2]);
+    EXPECT_EQ(0x8000, channels[3]);
+    EXPECT_EQ(0, channels[4]);
+    EXPECT_EQ(0x8000, channels[5]);
+
+    EXPECT_THROW(mapping.sample(ColorGrid(2, 2), 0, 5, colors), HueException);
+    EXPECT_THROW(SpatialMapping({}, 0, 1), HueException);
+    // Lights out of range
+    EXPECT_THROW(mapping.sample(grid, 1, 5, colors), HueException);
+    EXPECT_THROW(mapping.sample(grid, 6, 0, colors), HueException);
+    EXPECT_THROW(mapping.sample(grid, 1, static_cast<std::size_t>(-1), channels), HueException);
+    EXPECT_NO_THROW(mapping.sample(grid, 5, 0, colors));
+}
+
+TEST(SpatialMapping, volume)
+{
+    // Dark floor and bright ceiling
+    ColorGrid grid(3, 3, 2);
+    for (std::size_t x = 0; x < 3; ++x)
+    {
+        for (std::size_t y = 0; y < 3; ++y)
+        {
+            grid.setColor(x, y, 0, RGB {0, 0, 0});
+            grid.setColor(x, y, 1, RGB {255, 255, 255});
+        }
+    }
+    grid.setColor(1, 1, 1, RGB {255, 0, 0});
+    const SpatialMapping mapping({{0.f, 0.f, -1.f}, {0.f, 0.f, 1.f}, {1.f, 1.f, 1.f}, {0.f, 0.f, 0.f}}, 3, 3, 2);
+    RGB colors[4];
+    mapping.sample(grid, 0, 4, colors);
+    EXPECT_EQ((RGB {0, 0, 0}), colors[0]);
+    EXPECT_EQ((RGB {255, 0, 0}), colors[1]);
+    EXPECT_EQ((RGB {255, 255, 255}), colors[2]);
+    EXPECT_EQ((RGB {128, 0, 0}), colors[3]);
+}
+
+TEST(SpatialMapping, manyLights)
+{
+    ColorGrid grid(8, 6, 4);
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        for (std::size_t i = 0; i < 8 * 6 * 4; ++i)
+        {
+            grid.getChannel(channel)[i] = static_cast<float>((i * 37 + channel * 11) % 101) / 100.f;
+        }
+    }
+    std::vector<LightLocation> locations;
+    for (int i = 0; i < 37; ++i)
+    {
+        locations.push_back(LightLocation {
+            std::sin(i * 1.3f) * 1.1f, std::cos(i * 0.7f), static_cast<float>(i % 9) / 4.f - 1.f});
+    }
+    const SpatialMapping mapping(locations, 8, 6, 4);
+    std::vector<uint16_t> channels(locations.size() * 3);
+    mapping.sample(grid, 0, locations.size(), channels.data());
+    for (std::size_t i = 0; i < locations.size(); ++i)
+    {
+        for (std::size_t channel = 0; channel < 3; ++channel)
+        {
+            const uint16_t expected = huestream::toChannel(referenceSample(grid, channel, locations[i]));
+            EXPECT_NEAR(expected, channels[i * 3 + channel], 1) << "light " << i << ", channel " << channel;
+        }
+    }
+
+    // Sampling a part gives the same colors, also when it does not start at a multiple of four
+    std::vector<uint16_t> part(5 * 3);
+    mapping.sample(grid, 31, 5, part.data());
+    EXPECT_EQ(std::vector<uint16_t>(channels.begin() + 31 * 3, channels.begin() + 36 * 3), part);
+}
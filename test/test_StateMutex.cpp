@@ -0,0 +1,124 @@
+/**
+    \file test_StateMutex.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <hueplusplus/StateMutex.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+TEST(StateMutex, recursive)
+{
+    StateMutex mutex;
+    EXPECT_FALSE(mutex.isLocked());
+    {
+        std::lock_guard<StateMutex> outer(mutex);
+        std::lock_guard<StateMutex> inner(mutex);
+        EXPECT_TRUE(mutex.isLockedExclusively());
+        {
+            // Counts as another exclusive lock
+            std::shared_lock<StateMutex> shared(mutex);
+            EXPECT_TRUE(mutex.isLockedExclusively());
+        }
+        EXPECT_TRUE(mutex.isLockedExclusively());
+    }
+    EXPECT_FALSE(mutex.isLocked());
+    {
+        std::shared_lock<StateMutex> outer(mutex);
+        std::shared_lock<StateMutex> inner(mutex);
+        EXPECT_TRUE(mutex.isLocked());
+        EXPECT_FALSE(mutex.isLockedExclusively());
+    }
+    EXPECT_FALSE(mutex.isLocked());
+    // Still usable after all locks were released
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST(StateMutex, upgradeThrows)
+{
+    StateMutex mutex;
+    std::shared_lock<StateMutex> shared(mutex);
+    EXPECT_THROW(mutex.lock(), std::system_error);
+    EXPECT_FALSE(mutex.try_lock());
+    EXPECT_TRUE(mutex.isLocked());
+    EXPECT_FALSE(mutex.isLockedExclusively());
+}
+
+TEST(StateMutex, otherThreads)
+{
+    StateMutex mutex;
+    bool sharedLocked = false;
+    bool exclusiveLocked = false;
+    {
+        std::shared_lock<StateMutex> shared(mutex);
+        std::thread([&] {
+            EXPECT_FALSE(mutex.isLocked());
+            sharedLocked = mutex.try_lock_shared();
+            mutex.unlock_shared();
+            exclusiveLocked = mutex.try_lock();
+        }).join();
+    }
+    EXPECT_TRUE(sharedLocked);
+    EXPECT_FALSE(exclusiveLocked);
+    {
+        std::lock_guard<StateMutex> exclusive(mutex);
+        std::thread([&] { sharedLocked = mutex.try_lock_shared(); }).join();
+    }
+    EXPECT_FALSE(sharedLocked);
+}
+
+TEST(StateMutex, parallelReaders)
+{
+    StateMutex mutex;
+    constexpr int numReaders = 4;
+    std::atomic<int> holding {0};
+    std::atomic<int> maxHolding {0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numReaders; ++i)
+    {
+        threads.emplace_back([&] {
+            std::shared_lock<StateMutex> lock(mutex);
+            int current = ++holding;
+            int max = maxHolding.load();
+            while (current > max && !maxHolding.compare_exchange_weak(max, current)) { }
+            // All readers hold the lock at the same time, otherwise this would never finish
+            while (maxHolding.load() < numReaders)
+            {
+                std::this_thread::yield();
+            }
+            --holding;
+        });
+    }
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+    EXPECT_EQ(numReaders, maxHolding.load());
+    EXPECT_EQ(0, holding.load());
+}
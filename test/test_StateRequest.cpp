@@ -0,0 +1,173 @@
+/**
+    \file test_StateRequest.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <hueplusplus/StateRequest.h>
+#include <hueplusplus/Utils.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+namespace
+{
+StateRequest makeFullRequest()
+{
+    StateRequest request;
+    request.setOn(true);
+    request.setBrightness(254);
+    request.setHue(65535);
+    request.setSaturation(0);
+    request.setXY(0.3127f, 0.329f);
+    request.setColorTemperature(153);
+    request.setEffect(StateRequest::Effect::colorloop);
+    request.setAlert(StateRequest::Alert::lselect);
+    request.setTransition(0);
+    request.setBrightnessIncrement(-254);
+    request.setSaturationIncrement(10);
+    request.setHueIncrement(-65534);
+    request.setColorTemperatureIncrement(12);
+    request.setXYIncrement(-0.5f, 0.1f);
+    return request;
+}
+} // namespace
+
+TEST(StateRequest, toJson)
+{
+    EXPECT_EQ(nlohmann::json::object(), StateRequest().toJson());
+    const nlohmann::json expected = {{"on", true}, {"bri", 254}, {"hue", 65535}, {"sat", 0},
+        {"xy", {0.3127f, 0.329f}}, {"ct", 153}, {"effect", "colorloop"}, {"alert", "lselect"},
+        {"transitiontime", 0}, {"bri_inc", -254}, {"sat_inc", 10}, {"hue_inc", -65534}, {"ct_inc", 12},
+        {"xy_inc", {-0.5f, 0.1f}}};
+    StateRequest request = makeFullRequest();
+    EXPECT_EQ(expected, request.toJson());
+    EXPECT_EQ(StateRequest::fieldCount, request.size());
+    request.remove(StateRequest::xy);
+    EXPECT_FALSE(request.has(StateRequest::xy));
+    EXPECT_EQ(StateRequest::fieldCount - 1, request.size());
+}
+
+TEST(StateRequest, serialize)
+{
+    std::string buffer = "previous content";
+    StateRequest().serialize(buffer);
+    EXPECT_EQ("{}", buffer);
+
+    StateRequest request = makeFullRequest();
+    request.serialize(buffer);
+    EXPECT_EQ(request.toJson(), nlohmann::json::parse(buffer));
+
+    StateRequest single;
+    single.setAlert(StateRequest::Alert::select);
+    single.serialize(buffer);
+    EXPECT_EQ("{\"alert\":\"select\"}", buffer);
+
+    // Floating point values keep their exact value
+    StateRequest xy;
+    xy.setXY(1.f, 0.f);
+    xy.setXYIncrement(-0.5f, 0.25f);
+    xy.serialize(buffer);
+    EXPECT_EQ("{\"xy\":[1.0,0.0],\"xy_inc\":[-0.5,0.25]}", buffer);
+    xy.setXY(0.1f, 1e-5f);
+    xy.serialize(buffer);
+    const nlohmann::json parsed = nlohmann::json::parse(buffer);
+    EXPECT_EQ(static_cast<double>(0.1f), parsed.at("xy").at(0).get<double>());
+    EXPECT_EQ(static_cast<double>(1e-5f), parsed.at("xy").at(1).get<double>());
+}
+
+TEST(StateRequest, trim)
+{
+    const nlohmann::json state = {{"on", true}, {"bri", 200}, {"hue", 100}, {"sat", 50}, {"xy", {0.5, 0.5}},
+        {"ct", 300}, {"effect", "none"}, {"colormode", "xy"}};
+    {
+        StateRequest request;
+        request.setOn(true);
+        request.setBrightness(200);
+        request.setEffect(StateRequest::Effect::none);
+        request.setXY(0.50001f, 0.5f);
+        request.setTransition(1);
+        request.trim(state);
+        EXPECT_EQ(StateRequest::transitiontime, request.getFields());
+    }
+    // Color fields are only trimmed with matching colormode
+    {
+        StateRequest request;
+        request.setHue(100);
+        request.setSaturation(50);
+        request.setColorTemperature(300);
+        request.trim(state);
+        EXPECT_EQ(StateRequest::hue | StateRequest::sat | StateRequest::ct, request.getFields());
+    }
+    // Different values
+    {
+        StateRequest request;
+        request.setOn(false);
+        request.setBrightness(20);
+        request.setXY(0.4f, 0.5f);
+        request.trim(state);
+        EXPECT_EQ(StateRequest::on | StateRequest::bri | StateRequest::xy, request.getFields());
+    }
+}
+
+TEST(StateRequest, validateReply)
+{
+    const std::string path = "/lights/1/state";
+    StateRequest request = makeFullRequest();
+    const nlohmann::json json = request.toJson();
+    nlohmann::json reply;
+    for (auto it = json.begin(); it != json.end(); ++it)
+    {
+        reply.push_back({{"success", {{path + '/' + it.key(), it.value()}}}});
+    }
+    EXPECT_TRUE(request.validateReply(path, reply));
+    EXPECT_TRUE(request.validateReply(path + '/', reply));
+    EXPECT_EQ(utils::validatePUTReply(path, json, reply), request.validateReply(path, reply));
+
+    // Empty reply
+    EXPECT_FALSE(request.validateReply(path, nlohmann::json::array()));
+    // Different path
+    EXPECT_FALSE(request.validateReply("/lights/2/state", reply));
+    // Field not in request
+    StateRequest on;
+    on.setOn(true);
+    EXPECT_FALSE(on.validateReply(path, reply));
+    // Different value
+    on.setOn(false);
+    EXPECT_FALSE(on.validateReply(path, {{{"success", {{path + "/on", true}}}}}));
+    // Updated.
+    EXPECT_TRUE(on.validateReply(path, {{{"success", {{path + "/on", "Updated."}}}}}));
+    // Xy with tolerance
+    StateRequest xy;
+    xy.setXY(0.5f, 0.5f);
+    EXPECT_TRUE(xy.validateReply(path, {{{"success", {{path + "/xy", {0.50001, 0.5}}}}}}));
+    EXPECT_FALSE(xy.validateReply(path, {{{"success", {{path + "/xy", {0.51, 0.5}}}}}}));
+}
+
+TEST(StateRequest, applyTo)
+{
+    nlohmann::json state = {{"on", false}, {"bri", 1}, {"colormode", "ct"}};
+    StateRequest request;
+    request.setOn(true);
+    request.setXY(0.25f, 0.75f);
+    request.setTransition(3);
+    request.applyTo(state);
+    const nlohmann::json expected = {{"on", true}, {"bri", 1}, {"xy", {0.25, 0.75}}, {"colormode", "ct"}};
+    EXPECT_EQ(expected, state);
+}
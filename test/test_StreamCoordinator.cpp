@@ -0,0 +1,259 @@
+/**
+    \file test_StreamCoordinator.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <hueplusplus/HueException.h>
+#include <hueplusplus/StreamCoordinator.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+TEST(StreamCoordinator, sessions)
+{
+    StreamCoordinator coordinator;
+    EXPECT_EQ(0, coordinator.getSessionCount());
+    const std::size_t first = coordinator.addSession({1}, [](const std::vector<uint8_t>&) { return true; });
+    const std::size_t second = coordinator.addSession({2, 2}, [](const std::vector<uint8_t>&) { return true; });
+    EXPECT_EQ(2, coordinator.getSessionCount());
+    EXPECT_EQ(std::vector<uint8_t> {1}, coordinator.getFrame(first));
+    EXPECT_EQ((std::vector<uint8_t> {2, 2}), coordinator.getFrame(second));
+
+    coordinator.removeSession(first);
+    EXPECT_EQ(1, coordinator.getSessionCount());
+    EXPECT_THROW(coordinator.getFrame(first), HueException);
+    EXPECT_THROW(coordinator.removeSession(first), HueException);
+    EXPECT_THROW(coordinator.publish(5), HueException);
+    EXPECT_THROW(coordinator.getStatistics(5), HueException);
+    // Ids of the other sessions stay valid
+    EXPECT_EQ((std::vector<uint8_t> {2, 2}), coordinator.getFrame(second));
+    // Slots of removed sessions are reused
+    EXPECT_EQ(first, coordinator.addSession({3}, [](const std::vector<uint8_t>&) { return true; }));
+    EXPECT_EQ(std::vector<uint8_t> {3}, coordinator.getFrame(first));
+    EXPECT_EQ(2, coordinator.getSessionCount());
+}
+
+TEST(StreamCoordinator, start)
+{
+    StreamCoordinator coordinator;
+    EXPECT_FALSE(coordinator.isRunning());
+    EXPECT_THROW(coordinator.start(0), HueException);
+    coordinator.start(50);
+    EXPECT_TRUE(coordinator.isRunning());
+    EXPECT_EQ(50, coordinator.getRate());
+    EXPECT_THROW(coordinator.start(50), HueException);
+    coordinator.stop();
+    EXPECT_FALSE(coordinator.isRunning());
+    coordinator.stop();
+    // Without sessions, nothing is counted
+    EXPECT_EQ(0, coordinator.getSkewStatistics().ticks);
+}
+
+TEST(StreamCoordinator, publishTogether)
+{
+    // Both sessions always get the same value, so frames sent at the same time must be equal
+    std::mutex mutex;
+    std::vector<std::pair<int, uint8_t>> sent;
+    StreamCoordinator coordinator;
+    for (int i = 0; i < 2; ++i)
+    {
+        coordinator.addSession({0}, [&, i](const std::vector<uint8_t>& frame) {
+            std::lock_guard<std::mutex> lock(mutex);
+            sent.emplace_back(i, frame[0]);
+            return true;
+        });
+    }
+    coordinator.start(500);
+    for (int value = 1; value < 20000; ++value)
+    {
+        coordinator.getFrame(0)[0] = static_cast<uint8_t>(value);
+        coordinator.getFrame(1)[0] = static_cast<uint8_t>(value);
+        coordinator.publish();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    coordinator.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_GE(sent.size(), 2);
+    ASSERT_EQ(0, sent.size() % 2);
+    for (std::size_t i = 0; i < sent.size(); i += 2)
+    {
+        EXPECT_EQ(0, sent[i].first);
+        EXPECT_EQ(1, sent[i + 1].first);
+        EXPECT_EQ(sent[i].second, sent[i + 1].second) << i;
+    }
+    EXPECT_EQ(static_cast<uint8_t>(19999), sent.back().second);
+    const StreamStatistics first = coordinator.getStatistics(0);
+    const StreamStatistics second = coordinator.getStatistics(1);
+    EXPECT_EQ(sent.size() / 2, first.sentFrames);
+    EXPECT_EQ(sent.size() / 2, second.sentFrames);
+    EXPECT_EQ(first.repeatedFrames, second.repeatedFrames);
+    EXPECT_EQ(sent.size() / 2, coordinator.getSkewStatistics().ticks);
+}
+
+TEST(StreamCoordinator, publishSession)
+{
+    std::mutex mutex;
+    std::vector<std::vector<uint8_t>> sent;
+    StreamCoordinator coordinator;
+    for (int i = 0; i < 2; ++i)
+    {
+        coordinator.addSession({0}, [&](const std::vector<uint8_t>& frame) {
+            std::lock_guard<std::mutex> lock(mutex);
+            sent.push_back(frame);
+            return true;
+        });
+    }
+    coordinator.getFrame(0)[0] = 1;
+    coordinator.getFrame(1)[0] = 2;
+    // Only the first session is published
+    coordinator.publish(0);
+    coordinator.start(200);
+    while (coordinator.getStatistics(1).sentFrames < 2)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    coordinator.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_GE(sent.size(), 2);
+    EXPECT_EQ(std::vector<uint8_t> {1}, sent[0]);
+    EXPECT_EQ(std::vector<uint8_t> {0}, sent[1]);
+    EXPECT_EQ(sent.size() / 2, coordinator.getStatistics(1).repeatedFrames);
+    EXPECT_EQ(sent.size() / 2 - 1, coordinator.getStatistics(0).repeatedFrames);
+}
+
+TEST(StreamCoordinator, skew)
+{
+    std::atomic<int> calls {0};
+    StreamCoordinator coordinator;
+    // Sending the first session takes 2ms, so the second session is sent later
+    coordinator.addSession({0}, [&](const std::vector<uint8_t>&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return true;
+    });
+    coordinator.addSession({0}, [&](const std::vector<uint8_t>&) {
+        ++calls;
+        return true;
+    });
+    coordinator.start(100);
+    while (calls < 3)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    coordinator.stop();
+    const SkewStatistics skew = coordinator.getSkewStatistics();
+    EXPECT_GE(skew.ticks, 3);
+    EXPECT_GE(skew.meanSkew, std::chrono::milliseconds(2));
+    EXPECT_GE(skew.maxSkew, skew.meanSkew);
+    EXPECT_GE(coordinator.getStatistics(1).meanJitter, std::chrono::milliseconds(2));
+
+    coordinator.resetStatistics();
+    EXPECT_EQ(0, coordinator.getSkewStatistics().ticks);
+    EXPECT_EQ(0, coordinator.getStatistics(0).sentFrames);
+}
+
+TEST(StreamCoordinator, sendErrors)
+{
+    std::atomic<int> calls {0};
+    StreamCoordinator coordinator;
+    coordinator.addSession({0}, [](const std::vector<uint8_t>&) -> bool { throw std::runtime_error("send failed"); });
+    coordinator.addSession({0}, [&](const std::vector<uint8_t>&) {
+        ++calls;
+        return true;
+    });
+    coordinator.start(200);
+    while (calls < 3)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    coordinator.stop();
+    // Errors of one session do not affect the others
+    const StreamStatistics failed = coordinator.getStatistics(0);
+    EXPECT_EQ(failed.sentFrames, failed.sendErrors);
+    EXPECT_EQ(0, coordinator.getStatistics(1).sendErrors);
+    EXPECT_EQ(calls, coordinator.getStatistics(1).sentFrames);
+}
+
+TEST(StreamCoordinator, removeWhileRunning)
+{
+    std::atomic<int> removedCalls {0};
+    std::atomic<int> calls {0};
+    StreamCoordinator coordinator;
+    const std::size_t removed = coordinator.addSession({0}, [&](const std::vector<uint8_t>&) {
+        ++removedCalls;
+        return true;
+    });
+    coordinator.start(200);
+    while (removedCalls < 2)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    coordinator.removeSession(removed);
+    const int callsAfterRemove = removedCalls;
+    coordinator.addSession({0}, [&](const std::vector<uint8_t>&) {
+        ++calls;
+        return true;
+    });
+    while (calls < 3)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    coordinator.stop();
+    EXPECT_EQ(callsAfterRemove, removedCalls);
+    EXPECT_EQ(1, coordinator.getSessionCount());
+}
+
+TEST(StreamCoordinator, publishWhileRemoving)
+{
+    StreamCoordinator coordinator;
+    const std::size_t session = coordinator.addSession({0}, [](const std::vector<uint8_t>&) { return true; });
+    coordinator.start(200);
+    std::atomic<bool> done {false};
+    std::thread publisher([&]() {
+        while (!done)
+        {
+            try
+            {
+                coordinator.publish(session);
+            }
+            catch (const HueException&)
+            {
+                // Removed at the moment
+            }
+        }
+    });
+    for (int i = 0; i < 100; ++i)
+    {
+        coordinator.removeSession(session);
+        EXPECT_EQ(session, coordinator.addSession({0}, [](const std::vector<uint8_t>&) { return true; }));
+    }
+    done = true;
+    publisher.join();
+    coordinator.stop();
+    EXPECT_EQ(1, coordinator.getSessionCount());
+}
@@ -0,0 +1,315 @@
+/**
+    \file test_StreamingEngine.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <hueplusplus/HueException.h>
+#include <hueplusplus/StreamingEngine.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+TEST(FrameBuffer, publishConsume)
+{
+    FrameBuffer frames({0, 0});
+    EXPECT_FALSE(frames.consume());
+    EXPECT_EQ((std::vector<uint8_t> {0, 0}), frames.front());
+
+    frames.back()[0] = 1;
+    frames.publish();
+    // Back buffer keeps the published frame
+    EXPECT_EQ((std::vector<uint8_t> {1, 0}), frames.back());
+    EXPECT_EQ((std::vector<uint8_t> {0, 0}), frames.front());
+    EXPECT_TRUE(frames.consume());
+    EXPECT_EQ((std::vector<uint8_t> {1, 0}), frames.front());
+    EXPECT_FALSE(frames.consume());
+    EXPECT_EQ((std::vector<uint8_t> {1, 0}), frames.front());
+
+    // Unconsumed frames are overwritten
+    frames.back()[1] = 2;
+    frames.publish();
+    frames.back()[1] = 3;
+    frames.publish();
+    EXPECT_EQ(1, frames.getOverwrittenCount());
+    EXPECT_TRUE(frames.consume());
+    EXPECT_EQ((std::vector<uint8_t> {1, 3}), frames.front());
+    EXPECT_EQ((std::vector<uint8_t> {1, 3}), frames.back());
+}
+
+TEST(FrameBuffer, noTornFrames)
+{
+    // Producer writes frames where all bytes are equal, the consumer must never see mixed frames
+    FrameBuffer frames(std::vector<uint8_t>(64, 0));
+    std::atomic<bool> done {false};
+    std::thread producer([&] {
+        for (int i = 1; i < 20000; ++i)
+        {
+            std::vector<uint8_t>& frame = frames.back();
+            std::fill(frame.begin(), frame.end(), static_cast<uint8_t>(i));
+            frames.publish();
+        }
+        done = true;
+    });
+    std::size_t torn = 0;
+    while (!done)
+    {
+        frames.consume();
+        const std::vector<uint8_t>& frame = frames.front();
+        if (std::count(frame.begin(), frame.end(), frame.front()) != static_cast<long>(frame.size()))
+        {
+            ++torn;
+        }
+    }
+    producer.join();
+    EXPECT_EQ(0, torn);
+    frames.consume();
+    EXPECT_EQ(std::vector<uint8_t>(64, static_cast<uint8_t>(19999)), frames.front());
+}
+
+TEST(StreamingEngine, start)
+{
+    StreamingEngine engine({0}, [](const std::vector<uint8_t>&) { return true; });
+    EXPECT_FALSE(engine.isRunning());
+    EXPECT_THROW(engine.start(0), HueException);
+    engine.start(50);
+    EXPECT_TRUE(engine.isRunning());
+    EXPECT_EQ(50, engine.getRate());
+    EXPECT_THROW(engine.start(50), HueException);
+    engine.stop();
+    EXPECT_FALSE(engine.isRunning());
+    // Stop twice does nothing
+    engine.stop();
+    engine.start(25);
+    EXPECT_TRUE(engine.isRunning());
+}
+
+TEST(SendSchedule, skipPassed)
+{
+    using std::chrono::milliseconds;
+    const std::chrono::steady_clock::time_point start {std::chrono::seconds(100)};
+    SendSchedule schedule(start, milliseconds(10));
+    EXPECT_EQ(start, schedule.getNext());
+    // Woken up early or in time
+    EXPECT_EQ(0, schedule.skipPassed(start - milliseconds(1)));
+    EXPECT_EQ(0, schedule.skipPassed(start + milliseconds(3)));
+    EXPECT_EQ(start, schedule.getNext());
+    EXPECT_EQ(milliseconds(3), schedule.getJitter(start + milliseconds(3)));
+    schedule.advance();
+    EXPECT_EQ(start + milliseconds(10), schedule.getNext());
+
+    // Late by more than two periods, the send times which passed completely are skipped
+    EXPECT_EQ(2, schedule.skipPassed(start + milliseconds(35)));
+    EXPECT_EQ(start + milliseconds(30), schedule.getNext());
+    EXPECT_EQ(milliseconds(5), schedule.getJitter(start + milliseconds(35)));
+    // Send times stay aligned to the start
+    schedule.advance();
+    EXPECT_EQ(start + milliseconds(40), schedule.getNext());
+}
+
+TEST(StatisticsCounter, countFrame)
+{
+    using std::chrono::milliseconds;
+    FrameBuffer frames({0});
+    StatisticsCounter counter;
+    EXPECT_EQ(0, counter.get(frames).sentFrames);
+    EXPECT_EQ(milliseconds(0), counter.get(frames).meanJitter);
+
+    counter.countFrame(true, true, 0, milliseconds(1));
+    counter.countFrame(false, false, 2, milliseconds(5));
+    counter.countFrame(false, true, 1, milliseconds(3));
+    frames.publish();
+    frames.publish();
+    StreamStatistics statistics = counter.get(frames);
+    EXPECT_EQ(3, statistics.sentFrames);
+    EXPECT_EQ(2, statistics.repeatedFrames);
+    EXPECT_EQ(3, statistics.droppedFrames);
+    EXPECT_EQ(1, statistics.sendErrors);
+    EXPECT_EQ(1, statistics.overwrittenFrames);
+    EXPECT_EQ(milliseconds(3), statistics.meanJitter);
+    EXPECT_EQ(milliseconds(5), statistics.maxJitter);
+
+    // Frames overwritten before the reset are not counted
+    counter.reset(frames);
+    statistics = counter.get(frames);
+    EXPECT_EQ(0, statistics.sentFrames);
+    EXPECT_EQ(0, statistics.overwrittenFrames);
+    EXPECT_EQ(milliseconds(0), statistics.maxJitter);
+}
+
+TEST(StreamingEngine, repeatsFrames)
+{
+    std::mutex mutex;
+    std::condition_variable sentCondition;
+    std::vector<std::vector<uint8_t>> sent;
+    StreamingEngine engine({0}, [&](const std::vector<uint8_t>& frame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sent.push_back(frame);
+        sentCondition.notify_all();
+        return true;
+    });
+    engine.getFrame()[0] = 1;
+    engine.publish();
+    engine.start(200);
+    {
+        // Wait for the sent frames instead of a fixed time, the schedule is tested with SendSchedule
+        std::unique_lock<std::mutex> lock(mutex);
+        sentCondition.wait(lock, [&]() { return sent.size() >= 5; });
+    }
+    engine.stop();
+
+    StreamStatistics statistics = engine.getStatistics();
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(sent.size(), statistics.sentFrames);
+    // Frames are repeated while nothing is published
+    EXPECT_EQ(std::vector<std::vector<uint8_t>>(sent.size(), {1}), sent);
+    EXPECT_EQ(sent.size() - 1, statistics.repeatedFrames);
+    EXPECT_EQ(0, statistics.sendErrors);
+    EXPECT_GE(statistics.maxJitter, statistics.meanJitter);
+
+    engine.resetStatistics();
+    EXPECT_EQ(0, engine.getStatistics().sentFrames);
+}
+
+TEST(StreamingEngine, droppedFrames)
+{
+    std::atomic<int> calls {0};
+    StreamingEngine engine({0}, [&](const std::vector<uint8_t>&) {
+        // Sending takes longer than three periods, so at least two send times pass completely
+        if (calls++ == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(35));
+        }
+        return true;
+    });
+    engine.start(100);
+    while (calls < 3)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engine.stop();
+    EXPECT_GE(engine.getStatistics().droppedFrames, 2);
+}
+
+TEST(StreamingEngine, sendErrors)
+{
+    std::atomic<int> calls {0};
+    StreamingEngine engine({0}, [&](const std::vector<uint8_t>&) -> bool {
+        const int call = ++calls;
+        if (call % 4 == 2)
+        {
+            throw std::runtime_error("send failed");
+        }
+        else if (call % 4 == 0)
+        {
+            throw 1;
+        }
+        return false;
+    });
+    engine.start(200);
+    while (calls < 4)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engine.stop();
+    StreamStatistics statistics = engine.getStatistics();
+    EXPECT_EQ(statistics.sentFrames, statistics.sendErrors);
+}
+
+TEST(StreamingEngine, overwrittenFrames)
+{
+    StreamingEngine engine({0}, [](const std::vector<uint8_t>&) { return true; });
+    engine.getFrame()[0] = 1;
+    engine.publish();
+    engine.getFrame()[0] = 2;
+    engine.publish();
+    EXPECT_EQ(1, engine.getStatistics().overwrittenFrames);
+    engine.start(50);
+    engine.stop();
+    // Reset by start
+    EXPECT_EQ(0, engine.getStatistics().overwrittenFrames);
+}
+
+TEST(IdleTimer, start)
+{
+    IdleTimer timer(std::chrono::milliseconds(100), []() {});
+    EXPECT_FALSE(timer.isRunning());
+    timer.start();
+    EXPECT_TRUE(timer.isRunning());
+    EXPECT_THROW(timer.start(), HueException);
+    timer.stop();
+    EXPECT_FALSE(timer.isRunning());
+    timer.stop();
+
+    IdleTimer zero(std::chrono::milliseconds(0), []() {});
+    EXPECT_THROW(zero.start(), HueException);
+}
+
+TEST(IdleTimer, firesWhenIdle)
+{
+    std::atomic<int> calls {0};
+    IdleTimer timer(std::chrono::milliseconds(10), [&]() {
+        const int call = ++calls;
+        if (call == 2)
+        {
+            throw std::runtime_error("keep alive failed");
+        }
+        else if (call == 3)
+        {
+            throw 1;
+        }
+    });
+    timer.start();
+    while (calls < 4)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    timer.stop();
+    // Exceptions do not stop the timer
+    EXPECT_EQ(4, timer.getFireCount());
+}
+
+TEST(IdleTimer, touch)
+{
+    std::atomic<int> calls {0};
+    IdleTimer timer(std::chrono::milliseconds(50), [&]() { ++calls; });
+    timer.start();
+    // Activity more often than the interval, timing is not exact on loaded machines
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        timer.touch();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_LE(calls, 1);
+    while (calls == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    timer.stop();
+    EXPECT_EQ(calls, timer.getFireCount());
+}
@@ -0,0 +1,81 @@
+/**
+    \file test_TimerScheduler.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <hueplusplus/TimerScheduler.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+TEST(TimerScheduler, schedule)
+{
+    using namespace std::chrono;
+    TimerScheduler scheduler;
+    EXPECT_EQ(0, scheduler.getPendingCount());
+    // Only accessed from the scheduler thread until waitIdle returns
+    std::vector<int> order;
+    const auto start = steady_clock::now();
+    scheduler.schedule(milliseconds(30), [&] { order.push_back(3); });
+    scheduler.schedule(milliseconds(10), [&] { order.push_back(1); });
+    scheduler.schedule(milliseconds(10), [&] { order.push_back(2); });
+    scheduler.waitIdle();
+    EXPECT_GE(steady_clock::now() - start, milliseconds(30));
+    EXPECT_EQ((std::vector<int> {1, 2, 3}), order);
+    EXPECT_EQ(0, scheduler.getPendingCount());
+}
+
+TEST(TimerScheduler, scheduleFromTask)
+{
+    TimerScheduler scheduler;
+    std::vector<int> order;
+    scheduler.schedule(std::chrono::seconds(0), [&] {
+        order.push_back(1);
+        scheduler.schedule(std::chrono::seconds(0), [&] { order.push_back(2); });
+    });
+    scheduler.waitIdle();
+    EXPECT_EQ((std::vector<int> {1, 2}), order);
+}
+
+TEST(TimerScheduler, exception)
+{
+    TimerScheduler scheduler;
+    bool executed = false;
+    scheduler.schedule(std::chrono::seconds(0), [] { throw std::runtime_error("test"); });
+    scheduler.schedule(std::chrono::seconds(0), [] { throw 1; });
+    scheduler.schedule(std::chrono::seconds(0), [&] { executed = true; });
+    scheduler.waitIdle();
+    EXPECT_TRUE(executed);
+}
+
+TEST(TimerScheduler, destructor)
+{
+    std::atomic<bool> executed {false};
+    {
+        TimerScheduler scheduler;
+        scheduler.schedule(std::chrono::hours(1), [&] { executed = true; });
+        EXPECT_EQ(1, scheduler.getPendingCount());
+    }
+    EXPECT_FALSE(executed);
+}
@@ -0,0 +1,71 @@
+/**
+    \file test_Utils.cpp
+    Copyright Notice\n
+    Copyright (C) 2020  Jan Rogall		- developer\n
+
+    This file is part of hueplusplus.
+
+    hueplusplus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    hueplusplus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with hueplusplus.  If not, see <http://www.gnu.org/licenses/>.
+**/
+
+#include <hueplusplus/Utils.h>
+
+#include <gtest/gtest.h>
+
+using namespace hueplusplus;
+
+namespace
+{
+const nlohmann::json value = {{"a", {{"b", {1, {{"c", "d"}}}}}}, {"e", nullptr}};
+} // namespace
+
+TEST(Utils, findMember)
+{
+    EXPECT_EQ(&value, utils::findMember(value));
+    EXPECT_EQ(&value["a"]["b"], utils::findMember(value, "a", "b"));
+    EXPECT_EQ(&value["a"]["b"][1]["c"], utils::findMember(value, "a", "b", 1, "c"));
+    EXPECT_EQ(&value["e"], utils::findMember(value, "e"));
+    EXPECT_EQ(nullptr, utils::findMember(value, "b"));
+    EXPECT_EQ(nullptr, utils::findMember(value, "a", "b", 2));
+    EXPECT_EQ(nullptr, utils::findMember(value, "a", 0));
+    EXPECT_EQ(nullptr, utils::findMember(value, "a", "b", 0, "c"));
+    EXPECT_EQ(nullptr, utils::findMember(value, 0));
+}
+
+TEST(Utils, safeGetMemberRef)
+{
+    EXPECT_EQ(&value["a"]["b"][1]["c"], &utils::safeGetMemberRef(value, "a", "b", 1, "c"));
+    EXPECT_EQ(nullptr, utils::safeGetMemberRef(value, "a", "c"));
+    EXPECT_EQ(nullptr, utils::safeGetMemberRef(value, "a", "b", 2));
+    // Same result as the copying version
+    EXPECT_EQ(utils::safeGetMember(value, "a", "b"), utils::safeGetMemberRef(value, "a", "b"));
+    EXPECT_EQ(utils::safeGetMember(value, "x", 0), utils::safeGetMemberRef(value, "x", 0));
+}
+
+TEST(Utils, MemberPath)
+{
+    const utils::MemberPath path {"a", "b", 1, "c"};
+    EXPECT_EQ(&value["a"]["b"][1]["c"], path.find(value));
+    EXPECT_EQ(&value["a"]["b"][1]["c"], &path.get(value));
+    EXPECT_EQ(&value, utils::MemberPath({}).find(value));
+
+    const utils::MemberPath stringPath {std::string("a"), "b", std::size_t(0)};
+    EXPECT_EQ(&value["a"]["b"][0], stringPath.find(value));
+
+    const utils::MemberPath missing {"a", "b", 2};
+    EXPECT_EQ(nullptr, missing.find(value));
+    EXPECT_EQ(nullptr, missing.get(value));
+    EXPECT_EQ(nullptr, utils::MemberPath({0}).find(value));
+    EXPECT_EQ(nullptr, utils::MemberPath({"a", "x"}).find(value));
+}